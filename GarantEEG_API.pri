@@ -6,7 +6,26 @@ LIBS += -lwsock32
 
 SOURCES += \
     $$PWD/src/EEG8.cpp \
+    $$PWD/src/EegReplay.cpp \
     $$PWD/src/GarantEEG_API_CPP.cpp \
+    $$PWD/src/Filtering/BaseFilter.cpp \
+    $$PWD/src/Filtering/ZeroPhaseFilter.cpp \
+    $$PWD/src/Filtering/FilterWorkerPool.cpp \
+    $$PWD/src/Filtering/FirFilter.cpp \
+    $$PWD/src/Filtering/RealFft.cpp \
+    $$PWD/src/Filtering/Resampler.cpp \
+    $$PWD/src/Filtering/NotchFilter.cpp \
+    $$PWD/src/Filtering/FixedPointFilter.cpp \
+    $$PWD/src/Recording/BdfHeader.cpp \
+    $$PWD/src/Recording/BdfReader.cpp \
+    $$PWD/src/Recording/BdfRepair.cpp \
+    $$PWD/src/Recording/BdfWriter.cpp \
+    $$PWD/src/Recording/DerivedWriter.cpp \
+    $$PWD/src/Recording/GcrConvert.cpp \
+    $$PWD/src/Recording/GcrFile.cpp \
+    $$PWD/src/Recording/MappedFile.cpp \
+    $$PWD/src/Recording/RiceCoder.cpp \
+    $$PWD/src/Recording/SegmentedWriter.cpp \
     $$PWD/src/Filtering/dspfilter/Bessel.cpp \
     $$PWD/src/Filtering/dspfilter/Biquad.cpp \
     $$PWD/src/Filtering/dspfilter/Butterworth.cpp \
@@ -18,17 +37,22 @@ SOURCES += \
     $$PWD/src/Filtering/dspfilter/Documentation.cpp \
     $$PWD/src/Filtering/dspfilter/Elliptic.cpp \
     $$PWD/src/Filtering/dspfilter/Filter.cpp \
+    $$PWD/src/Filtering/dspfilter/FrequencyResponse.cpp \
     $$PWD/src/Filtering/dspfilter/Legendre.cpp \
     $$PWD/src/Filtering/dspfilter/Param.cpp \
     $$PWD/src/Filtering/dspfilter/PoleFilter.cpp \
+    $$PWD/src/Filtering/dspfilter/PrototypeCache.cpp \
     $$PWD/src/Filtering/dspfilter/RBJ.cpp \
     $$PWD/src/Filtering/dspfilter/RootFinder.cpp \
+    $$PWD/src/Filtering/dspfilter/SimdUtilities.cpp \
+    $$PWD/src/Filtering/dspfilter/SimdUtilitiesAvx.cpp \
     $$PWD/src/Filtering/dspfilter/State.cpp
 
 HEADERS  += $$PWD/include/GarantEEG_API_Types.h \
     $$PWD/include/GarantEEG_API_C.h \ \
     $$PWD/include/GarantEEG_API_CPP.h \
     $$PWD/src/EEG8.h \
+    $$PWD/src/EegReplay.h \
     $$PWD/src/Filtering/BaseFilter.h \
     $$PWD/src/Filtering/dspfilter/Bessel.h \
     $$PWD/src/Filtering/dspfilter/Biquad.h \
@@ -42,16 +66,39 @@ HEADERS  += $$PWD/include/GarantEEG_API_Types.h \
     $$PWD/src/Filtering/dspfilter/Dsp.h \
     $$PWD/src/Filtering/dspfilter/Elliptic.h \
     $$PWD/src/Filtering/dspfilter/Filter.h \
+    $$PWD/src/Filtering/dspfilter/FrequencyResponse.h \
     $$PWD/src/Filtering/dspfilter/Layout.h \
     $$PWD/src/Filtering/dspfilter/Legendre.h \
     $$PWD/src/Filtering/dspfilter/MathSupplement.h \
     $$PWD/src/Filtering/dspfilter/Params.h \
     $$PWD/src/Filtering/dspfilter/PoleFilter.h \
+    $$PWD/src/Filtering/dspfilter/PrototypeCache.h \
     $$PWD/src/Filtering/dspfilter/RBJ.h \
     $$PWD/src/Filtering/dspfilter/RootFinder.h \
+    $$PWD/src/Filtering/dspfilter/SimdKernels.h \
+    $$PWD/src/Filtering/dspfilter/SimdUtilities.h \
     $$PWD/src/Filtering/dspfilter/SmoothedFilter.h \
     $$PWD/src/Filtering/dspfilter/State.h \
     $$PWD/src/Filtering/dspfilter/Types.h \
     $$PWD/src/Filtering/dspfilter/Utilities.h \
     $$PWD/src/Filtering/ButterworthFilter.hpp \
+    $$PWD/src/Filtering/ZeroPhaseFilter.h \
+    $$PWD/src/Filtering/FilterWorkerPool.h \
+    $$PWD/src/Filtering/FlushDenormalsGuard.h \
+    $$PWD/src/Filtering/FirFilter.h \
+    $$PWD/src/Filtering/RealFft.h \
+    $$PWD/src/Filtering/Resampler.h \
+    $$PWD/src/Filtering/NotchFilter.h \
+    $$PWD/src/Filtering/FixedPointFilter.h \
+    $$PWD/src/Filtering/NotchCombFilter.hpp \
+    $$PWD/src/Recording/BdfHeader.h \
+    $$PWD/src/Recording/BdfReader.h \
+    $$PWD/src/Recording/BdfRepair.h \
+    $$PWD/src/Recording/BdfWriter.h \
+    $$PWD/src/Recording/DerivedWriter.h \
+    $$PWD/src/Recording/GcrConvert.h \
+    $$PWD/src/Recording/GcrFile.h \
+    $$PWD/src/Recording/MappedFile.h \
+    $$PWD/src/Recording/RiceCoder.h \
+    $$PWD/src/Recording/SegmentedWriter.h \
     $$PWD/src/Filtering/AbstractFilter.h
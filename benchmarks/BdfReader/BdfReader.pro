@@ -0,0 +1,11 @@
+include(../benchmarks.pri)
+
+TARGET = BdfReaderBenchmark
+
+SOURCES += \
+    main.cpp \
+    $$PWD/../../src/Recording/BdfHeader.cpp \
+    $$PWD/../../src/Recording/BdfReader.cpp \
+    $$PWD/../../src/Recording/MappedFile.cpp \
+    $$PWD/../../src/Filtering/dspfilter/SimdUtilities.cpp \
+    $$PWD/../../src/Filtering/dspfilter/SimdUtilitiesAvx.cpp
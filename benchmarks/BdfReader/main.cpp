@@ -0,0 +1,281 @@
+/**
+@file main.cpp
+
+@brief Замер чтения BDF файла: CBdfReader (отображение в память, векторная распаковка) против чтения записей через fseek/fread
+с распаковкой Unpack24BitValue, как в инструментах анализа до CBdfReader
+
+Использование: BdfReaderBenchmark [путь к файлу] [длительность записи в секундах] [количество случайных окон]
+Файл создается с заголовком устройства (22 сигнала, 1000 Гц) и удаляется после замера.
+
+Результат в формате CSV: method,operation,count,total_ms,us_per_operation,checksum
+(checksum - сумма прочитанных значений, должна совпадать у обоих способов)
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include "../../src/Recording/BdfHeader.h"
+#include "../../src/Recording/BdfReader.h"
+//----------------------------------------------------------------------------------
+using namespace GarantEEG;
+//----------------------------------------------------------------------------------
+//! Количество сигналов в заголовке устройства
+const int SIGNALS_COUNT = 22;
+
+//! Количество записей данных в секунду
+const int RECORDS_PER_SECOND = 10;
+
+//! Отсчетов основного канала в записи данных при частоте 1000 Гц
+const int CHANNEL_SAMPLES = 100;
+
+//! Длительность случайного окна в записях данных (1 секунда)
+const int WINDOW_RECORDS = RECORDS_PER_SECOND;
+//----------------------------------------------------------------------------------
+/**
+ * @brief WriteField Записать поле заголовка BDF
+ */
+static void WriteField(vector<char> &header, int offset, int size, const char *text)
+{
+    memcpy(&header[offset], text, std::min((int)strlen(text), size));
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief MakeHeader Заголовок с раскладкой сигналов устройства: 8 каналов, 3 канала акселерометра, 10 сопротивлений, аннотации
+ */
+static vector<char> MakeHeader()
+{
+    const int samples[SIGNALS_COUNT] = { CHANNEL_SAMPLES, CHANNEL_SAMPLES, CHANNEL_SAMPLES, CHANNEL_SAMPLES, CHANNEL_SAMPLES, CHANNEL_SAMPLES, CHANNEL_SAMPLES, CHANNEL_SAMPLES,
+                                         5, 5, 5, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 30 };
+
+    const int headerSize = BDF_MAIN_HEADER_SIZE + SIGNALS_COUNT * BDF_SIGNAL_HEADER_SIZE;
+    vector<char> header(headerSize, ' ');
+    char text[32];
+
+    sprintf(text, "%i", headerSize);
+    WriteField(header, 184, 8, text);
+    WriteField(header, 236, 8, "-1");
+    WriteField(header, 244, 8, "0.1");
+    sprintf(text, "%i", SIGNALS_COUNT);
+    WriteField(header, 252, 4, text);
+
+    const int signals = BDF_MAIN_HEADER_SIZE;
+
+    for (int i = 0; i < SIGNALS_COUNT; i++)
+    {
+        WriteField(header, signals + 104 * SIGNALS_COUNT + 8 * i, 8, "-187500");
+        WriteField(header, signals + 112 * SIGNALS_COUNT + 8 * i, 8, "187500");
+        WriteField(header, signals + 120 * SIGNALS_COUNT + 8 * i, 8, "-8388608");
+        WriteField(header, signals + 128 * SIGNALS_COUNT + 8 * i, 8, "8388607");
+        sprintf(text, "%i", samples[i]);
+        WriteField(header, signals + 216 * SIGNALS_COUNT + 8 * i, 8, text);
+    }
+
+    return header;
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief CreateRecordFile Создать файл с псевдослучайными записями данных
+ * @param path Путь к файлу
+ * @param recordsCount Количество записей данных
+ * @param header Заголовок созданного файла
+ * @return true если файл создан
+ */
+static bool CreateRecordFile(const char *path, long long recordsCount, CBdfHeader &header)
+{
+    vector<char> headerData = MakeHeader();
+
+    if (!header.Parse(&headerData[0], (int)headerData.size()))
+        return false;
+
+    FILE *file = fopen(path, "wb");
+
+    if (file == nullptr)
+        return false;
+
+    bool written = (fwrite(&headerData[0], headerData.size(), 1, file) == 1);
+    vector<unsigned char> record(header.RecordSize());
+    unsigned int value = 2166136261u;
+
+    for (long long i = 0; i < recordsCount && written; i++)
+    {
+        for (size_t j = 0; j < record.size(); j++)
+        {
+            value = value * 1664525u + 1013904223u;
+            record[j] = (unsigned char)(value >> 24);
+        }
+
+        written = (fwrite(&record[0], record.size(), 1, file) == 1);
+    }
+
+    fclose(file);
+
+    return written;
+}
+//----------------------------------------------------------------------------------
+static void PrintResult(const char *method, const char *operation, long long count, double milliseconds, double checksum)
+{
+    printf("%s,%s,%lld,%.2f,%.3f,%.6e\n", method, operation, count, milliseconds, milliseconds * 1000.0 / count, checksum);
+    fflush(stdout);
+}
+//----------------------------------------------------------------------------------
+static double ElapsedMilliseconds(const std::chrono::steady_clock::time_point &start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+//----------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    const char *path = (argc > 1 ? argv[1] : "BdfReaderBenchmark.bdf");
+    int seconds = (argc > 2 ? atoi(argv[2]) : 3600);
+    int windowsCount = (argc > 3 ? atoi(argv[3]) : 10000);
+
+    if (seconds < 2)
+        seconds = 2;
+
+    if (windowsCount < 1)
+        windowsCount = 1;
+
+    const long long recordsCount = (long long)seconds * RECORDS_PER_SECOND;
+    CBdfHeader header;
+
+    if (!CreateRecordFile(path, recordsCount, header))
+    {
+        fprintf(stderr, "can not create file %s\n", path);
+        return 1;
+    }
+
+    const BDF_SIGNAL_INFO &signal = header.Signal(0);
+    const double gain = (signal.PhysicalMaximum - signal.PhysicalMinimum) / (signal.DigitalMaximum - signal.DigitalMinimum);
+    const double offset = signal.PhysicalMinimum - signal.DigitalMinimum * gain;
+
+    //Одинаковые случайные окна для обоих способов
+    vector<long long> windows(windowsCount);
+    unsigned int value = 12345u;
+
+    for (long long &window : windows)
+    {
+        value = value * 1664525u + 1013904223u;
+        window = (long long)(value % (unsigned int)(recordsCount - WINDOW_RECORDS));
+    }
+
+    printf("method,operation,count,total_ms,us_per_operation,checksum\n");
+
+    //Чтение записей через fread
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        FILE *file = fopen(path, "rb");
+        CBdfHeader fileHeader;
+        bool valid = (file != nullptr && fileHeader.Read(file));
+
+        PrintResult("fread", "open", 1, ElapsedMilliseconds(start), 0.0);
+
+        if (!valid)
+            return 1;
+
+        vector<unsigned char> record(fileHeader.RecordSize());
+        vector<double> samples(WINDOW_RECORDS * CHANNEL_SAMPLES);
+        double checksum = 0.0;
+
+        start = std::chrono::steady_clock::now();
+
+        for (long long window : windows)
+        {
+            for (int r = 0; r < WINDOW_RECORDS; r++)
+            {
+                FileSeek64(file, fileHeader.HeaderSize() + (window + r) * fileHeader.RecordSize());
+
+                if (fread(&record[0], record.size(), 1, file) != 1)
+                    break;
+
+                const unsigned char *ptr = &record[signal.Offset];
+
+                for (int j = 0; j < CHANNEL_SAMPLES; j++, ptr += 3)
+                    samples[r * CHANNEL_SAMPLES + j] = Unpack24BitValue(ptr) * gain + offset;
+            }
+
+            checksum += samples[0] + samples[samples.size() - 1];
+        }
+
+        PrintResult("fread", "random_window_1s", windowsCount, ElapsedMilliseconds(start), checksum);
+
+        checksum = 0.0;
+        start = std::chrono::steady_clock::now();
+        FileSeek64(file, fileHeader.HeaderSize());
+
+        for (long long i = 0; i < recordsCount; i++)
+        {
+            if (fread(&record[0], record.size(), 1, file) != 1)
+                break;
+
+            const unsigned char *ptr = &record[signal.Offset];
+
+            for (int j = 0; j < CHANNEL_SAMPLES; j++, ptr += 3)
+                checksum += Unpack24BitValue(ptr) * gain + offset;
+        }
+
+        PrintResult("fread", "sequential_channel", recordsCount, ElapsedMilliseconds(start), checksum);
+
+        fclose(file);
+    }
+
+    //CBdfReader
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        CBdfReader reader;
+        bool valid = reader.Open(path);
+
+        PrintResult("reader", "open", 1, ElapsedMilliseconds(start), 0.0);
+
+        if (!valid)
+            return 1;
+
+        vector<double> samples(WINDOW_RECORDS * CHANNEL_SAMPLES);
+        double checksum = 0.0;
+
+        start = std::chrono::steady_clock::now();
+
+        for (long long window : windows)
+        {
+            reader.ReadSignal(0, window * CHANNEL_SAMPLES, (int)samples.size(), &samples[0]);
+            checksum += samples[0] + samples[samples.size() - 1];
+        }
+
+        PrintResult("reader", "random_window_1s", windowsCount, ElapsedMilliseconds(start), checksum);
+
+        vector<float> floatSamples(WINDOW_RECORDS * CHANNEL_SAMPLES);
+        checksum = 0.0;
+        start = std::chrono::steady_clock::now();
+
+        for (long long window : windows)
+        {
+            reader.ReadSignal(0, window * CHANNEL_SAMPLES, (int)floatSamples.size(), &floatSamples[0]);
+            checksum += floatSamples[0] + floatSamples[floatSamples.size() - 1];
+        }
+
+        PrintResult("reader_float", "random_window_1s", windowsCount, ElapsedMilliseconds(start), checksum);
+
+        checksum = 0.0;
+        start = std::chrono::steady_clock::now();
+
+        for (long long first = 0; first < reader.SamplesCount(0); first += (long long)samples.size())
+        {
+            int count = reader.ReadSignal(0, first, (int)samples.size(), &samples[0]);
+
+            for (int j = 0; j < count; j++)
+                checksum += samples[j];
+        }
+
+        PrintResult("reader", "sequential_channel", recordsCount, ElapsedMilliseconds(start), checksum);
+    }
+
+    remove(path);
+
+    return 0;
+}
+//----------------------------------------------------------------------------------
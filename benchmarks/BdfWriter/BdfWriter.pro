@@ -0,0 +1,11 @@
+include(../benchmarks.pri)
+
+TARGET = BdfWriterBenchmark
+
+SOURCES += \
+    main.cpp \
+    $$PWD/../../src/Recording/BdfHeader.cpp \
+    $$PWD/../../src/Recording/BdfWriter.cpp \
+    $$PWD/../../src/Recording/GcrFile.cpp \
+    $$PWD/../../src/Recording/MappedFile.cpp \
+    $$PWD/../../src/Recording/RiceCoder.cpp
@@ -0,0 +1,262 @@
+/**
+@file main.cpp
+
+@brief Замер времени передачи пакета на запись в потоке приема: синхронная запись буфера (fwrite в потоке приема), CBdfWriter с разным количеством и размером буферов и с отображением файла в память,
+а также стоимости политик сохранности (обновление заголовка и принудительная запись на диск с разными интервалами)
+
+Использование: BdfWriterBenchmark [путь к файлу] [длительность записи в секундах] [интервал между пакетами в микросекундах] [длительность замера политики сохранности в секундах]
+Интервал 0 - пакеты передаются без пауз (проверка пропускной способности диска, ожидания буферов неизбежны).
+Политики сохранности зависят от времени, поэтому их замеры всегда идут с темпом устройства (10 пакетов в секунду), по умолчанию 10 секунд на политику.
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include "../../src/Recording/BdfHeader.h"
+#include "../../src/Recording/BdfWriter.h"
+//----------------------------------------------------------------------------------
+using namespace GarantEEG;
+//----------------------------------------------------------------------------------
+//! Размер заголовка BDF устройства
+const int HEADER_SIZE = 5888;
+
+//! Размер записи данных при частоте 1000 Гц
+const int RECORD_SIZE = 2565;
+
+//! Количество пакетов устройства в секунду
+const int RECORDS_PER_SECOND = 10;
+
+//! Длительность данных в буфере синхронной записи (как в исходной реализации)
+const int SYNC_BUFFER_SECONDS = 30;
+//----------------------------------------------------------------------------------
+//! Результат замера
+struct WRITE_RESULT
+{
+	//! Времена передачи пакетов (в микросекундах)
+    vector<double> Times;
+
+	//! Общее время записи (в секундах)
+    double Seconds;
+
+	//! Статистика CBdfWriter
+    GARANT_EEG_RECORDING_STATISTICS Statistics;
+};
+//----------------------------------------------------------------------------------
+/**
+ * @brief MakeRecord Заполнить запись данных псевдослучайными отсчетами
+ * @param record Запись данных
+ * @param index Номер записи
+ */
+static void MakeRecord(vector<char> &record, int index)
+{
+    unsigned int value = 2166136261u ^ (unsigned int)index;
+
+    for (size_t i = 0; i < record.size(); i++)
+    {
+        value = value * 1664525u + 1013904223u;
+        record[i] = (char)(value >> 24);
+    }
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief WaitInterval Дождаться времени следующего пакета
+ * @param start Время начала записи
+ * @param index Номер пакета
+ * @param interval Интервал между пакетами в микросекундах
+ */
+static void WaitInterval(const std::chrono::steady_clock::time_point &start, int index, int interval)
+{
+    if (interval > 0)
+        std::this_thread::sleep_until(start + std::chrono::microseconds((long long)index * interval));
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief RunSync Записать файл синхронно (как ProcessData до CBdfWriter)
+ */
+static WRITE_RESULT RunSync(const char *path, int recordsCount, int interval)
+{
+    WRITE_RESULT result;
+    memset(&result.Statistics, 0, sizeof(result.Statistics));
+
+    FILE *file = fopen(path, "wb");
+
+    if (file == nullptr)
+        return result;
+
+    vector<char> header(HEADER_SIZE, ' ');
+    fwrite(&header[0], header.size(), 1, file);
+
+    const int bufferSize = RECORD_SIZE * RECORDS_PER_SECOND * SYNC_BUFFER_SECONDS;
+    vector<char> buffer(bufferSize);
+    vector<char> record(RECORD_SIZE);
+    int bufferDataSize = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < recordsCount; i++)
+    {
+        MakeRecord(record, i);
+        WaitInterval(start, i, interval);
+
+        auto packetStart = std::chrono::steady_clock::now();
+
+        if (bufferDataSize + RECORD_SIZE > bufferSize)
+        {
+            fwrite(&buffer[0], bufferDataSize, 1, file);
+            bufferDataSize = 0;
+        }
+
+        memcpy(&buffer[bufferDataSize], &record[0], RECORD_SIZE);
+        bufferDataSize += RECORD_SIZE;
+
+        result.Times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - packetStart).count());
+    }
+
+    fwrite(&buffer[0], bufferDataSize, 1, file);
+    fclose(file);
+
+    result.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return result;
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief RunAsync Записать файл через CBdfWriter
+ */
+static WRITE_RESULT RunAsync(const char *path, int recordsCount, int interval, const BDF_WRITER_SETTINGS &settings)
+{
+    WRITE_RESULT result;
+    memset(&result.Statistics, 0, sizeof(result.Statistics));
+
+    CBdfWriter writer;
+    vector<char> header(HEADER_SIZE, ' ');
+
+    if (!writer.Open(path, header, RECORD_SIZE, settings))
+        return result;
+
+    vector<char> record(RECORD_SIZE);
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < recordsCount; i++)
+    {
+        MakeRecord(record, i);
+        WaitInterval(start, i, interval);
+
+        auto packetStart = std::chrono::steady_clock::now();
+
+        writer.Write(&record[0]);
+
+        result.Times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - packetStart).count());
+    }
+
+    writer.Close();
+
+    result.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    writer.GetStatistics(result.Statistics);
+
+    return result;
+}
+//----------------------------------------------------------------------------------
+static void PrintResult(const char *mode, int buffersCount, int bufferSeconds, int flushInterval, const BDF_WRITER_SETTINGS &durability, WRITE_RESULT &result)
+{
+    if (result.Times.empty())
+    {
+        fprintf(stderr, "%s: can not create file\n", mode);
+        return;
+    }
+
+    double total = 0.0;
+
+    for (double time : result.Times)
+        total += time;
+
+    std::sort(result.Times.begin(), result.Times.end());
+
+    const GARANT_EEG_RECORDING_STATISTICS &statistics = result.Statistics;
+    double megabytes = (double)result.Times.size() * RECORD_SIZE / (1024.0 * 1024.0);
+
+    printf("%s,%i,%i,%i,%i,%i,%i,%i,%.2f,%.2f,%.2f,%i,%.2f,%.2f,%.2f,%i,%i,%i,%.2f,%.2f\n", mode, buffersCount, bufferSeconds, flushInterval,
+           durability.Durability, (durability.Durability != RD_NONE ? durability.CommitInterval : 0), (durability.Durability == RD_SYNC ? durability.SyncInterval : 0), (int)result.Times.size(),
+           total / result.Times.size(), result.Times[result.Times.size() * 99 / 100], result.Times.back(),
+           statistics.StallsCount, statistics.StallTime, statistics.MaxWriteTime, megabytes / result.Seconds, statistics.MaxQueueDepth,
+           statistics.CommitsCount, statistics.SyncsCount, statistics.SyncTime, statistics.MaxSyncTime);
+    fflush(stdout);
+}
+//----------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    const char *path = (argc > 1 ? argv[1] : "BdfWriterBenchmark.bdf");
+    int seconds = (argc > 2 ? atoi(argv[2]) : 600);
+    int interval = (argc > 3 ? atoi(argv[3]) : 0);
+    int durabilitySeconds = (argc > 4 ? atoi(argv[4]) : 10);
+
+    if (seconds < 1)
+        seconds = 1;
+
+    if (durabilitySeconds < 1)
+        durabilitySeconds = 1;
+
+    const int recordsCount = seconds * RECORDS_PER_SECOND;
+
+    printf("mode,buffers,buffer_seconds,flush_interval_ms,durability,commit_interval_ms,sync_interval_ms,packets,mean_us,p99_us,max_us,stalls,stall_ms,max_write_ms,mb_per_s,max_queue_depth,commits,syncs,sync_ms,max_sync_ms\n");
+
+    const BDF_WRITER_SETTINGS defaultSettings;
+
+    WRITE_RESULT result = RunSync(path, recordsCount, interval);
+    PrintResult("sync", 1, SYNC_BUFFER_SECONDS, 0, defaultSettings, result);
+
+    const int configurations[][2] = { { 2, 1 }, { 3, 1 }, { 3, 5 }, { 4, 5 }, { 8, 1 } };
+
+    for (const auto &configuration : configurations)
+    {
+        BDF_WRITER_SETTINGS settings;
+        settings.BuffersCount = configuration[0];
+        settings.BufferRecords = RECORDS_PER_SECOND * configuration[1];
+
+        result = RunAsync(path, recordsCount, interval, settings);
+        PrintResult("async", configuration[0], configuration[1], 0, settings, result);
+    }
+
+    const int flushIntervals[] = { 100, 1000, 10000 };
+
+    for (int flushInterval : flushIntervals)
+    {
+        BDF_WRITER_SETTINGS settings;
+        settings.Mode = RM_MAPPED;
+        settings.FlushInterval = flushInterval;
+
+        result = RunAsync(path, recordsCount, interval, settings);
+        PrintResult("mapped", 0, 0, flushInterval, settings, result);
+    }
+
+    //Политика сохранности, интервал обновления заголовка, интервал принудительной записи на диск
+    const int durabilities[][3] = { { RD_NONE, 0, 0 }, { RD_COMMIT, 1000, 0 }, { RD_COMMIT, 100, 0 }, { RD_SYNC, 1000, 1000 }, { RD_SYNC, 100, 1000 }, { RD_SYNC, 100, 100 } };
+    const int devicePacketInterval = 1000000 / RECORDS_PER_SECOND;
+
+    for (int mode = RM_BUFFERED; mode <= RM_MAPPED; mode++)
+    {
+        for (const auto &durability : durabilities)
+        {
+            BDF_WRITER_SETTINGS settings;
+            settings.Mode = mode;
+            settings.BufferRecords = RECORDS_PER_SECOND * 5;
+            settings.Durability = durability[0];
+            settings.CommitInterval = std::max(durability[1], 1);
+            settings.SyncInterval = std::max(durability[2], 1);
+
+            result = RunAsync(path, durabilitySeconds * RECORDS_PER_SECOND, devicePacketInterval, settings);
+            PrintResult((mode == RM_MAPPED ? "mapped" : "async"), (mode == RM_MAPPED ? 0 : settings.BuffersCount), (mode == RM_MAPPED ? 0 : 5), (mode == RM_MAPPED ? settings.FlushInterval : 0), settings, result);
+        }
+    }
+
+    remove(path);
+
+    return 0;
+}
+//----------------------------------------------------------------------------------
@@ -0,0 +1,7 @@
+include(../benchmarks.pri)
+
+TARGET = CascadeBlockBenchmark
+
+SOURCES += \
+    main.cpp \
+    $$DSPFILTER_SOURCES
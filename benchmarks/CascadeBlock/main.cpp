@@ -0,0 +1,164 @@
+/**
+@file main.cpp
+
+@brief Сравнение поотсчетной обработки каскада биквадов с поэтапной (звено за звеном по всему блоку) для порядков 2-16
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include "../../src/Filtering/dspfilter/Butterworth.h"
+//----------------------------------------------------------------------------------
+using std::vector;
+//----------------------------------------------------------------------------------
+//! Количество каналов
+const int CHANNELS_COUNT = 8;
+
+//! Частота дискретизации
+const int RATE = 500;
+
+//! Количество отсчетов в фрэйме
+const int RECORDS_COUNT = 50;
+
+//! Количество фрэймов в одном проходе замера
+const int FRAMES_PER_PASS = 40;
+//----------------------------------------------------------------------------------
+//! Способы обработки
+enum CASCADE_PROCESS_MODE
+{
+	//! Все звенья для каждого отсчета (Cascade::process)
+	CPM_SAMPLE_MAJOR = 0,
+	//! Звено за звеном по блоку для каждого канала (Cascade::processBlock)
+	CPM_STAGE_MAJOR,
+	//! Звено за звеном по блоку для пары каналов с чередованием рекурсий
+	CPM_STAGE_MAJOR_INTERLEAVED
+};
+//----------------------------------------------------------------------------------
+/**
+ * @brief Measure Замерить обработку каскада
+ * @param design Рассчитанный фильтр
+ * @param mode Способ обработки
+ * @param passesCount Количество проходов
+ * @param output Результат обработки последнего прохода
+ * @return Время на отсчет одного канала в наносекундах
+ */
+template<class DesignType>
+static double Measure(const DesignType &design, int mode, int passesCount, vector<float> &output)
+{
+    typedef typename DesignType::template State<Dsp::DirectFormII> ChannelState;
+
+    const int length = RECORDS_COUNT * FRAMES_PER_PASS;
+    std::unique_ptr<ChannelState[]> states(new ChannelState[CHANNELS_COUNT]);
+
+    vector<float> input((size_t)CHANNELS_COUNT * length);
+
+    for (int c = 0; c < CHANNELS_COUNT; c++)
+    {
+        for (int i = 0; i < length; i++)
+            input[(size_t)c * length + i] = (float)(50.0 * sin(0.013 * (c + 1) * i) + 10.0 * sin(0.63 * i) + 20.0);
+    }
+
+    output.resize(input.size());
+    double seconds = 0.0;
+
+    for (int pass = 0; pass < passesCount; pass++)
+    {
+        //Каждый проход - продолжение сигнала с теми же состояниями, входные данные копируются вне замера
+        memcpy(&output[0], &input[0], input.size() * sizeof(float));
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (int frame = 0; frame < FRAMES_PER_PASS; frame++)
+        {
+            float *samples = &output[frame * RECORDS_COUNT];
+
+            if (mode == CPM_SAMPLE_MAJOR)
+            {
+                for (int c = 0; c < CHANNELS_COUNT; c++)
+                    design.process(RECORDS_COUNT, samples + (size_t)c * length, states[c]);
+            }
+            else if (mode == CPM_STAGE_MAJOR)
+            {
+                for (int c = 0; c < CHANNELS_COUNT; c++)
+                    design.processBlock(RECORDS_COUNT, samples + (size_t)c * length, states[c]);
+            }
+            else
+            {
+                for (int c = 0; c < CHANNELS_COUNT; c += 2)
+                    design.processBlock(RECORDS_COUNT, samples + (size_t)c * length, states[c], samples + (size_t)(c + 1) * length, states[c + 1]);
+            }
+        }
+
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    return seconds * 1e9 / ((double)passesCount * length * CHANNELS_COUNT);
+}
+//----------------------------------------------------------------------------------
+template<int Order>
+static void Run(int passesCount)
+{
+    Dsp::Butterworth::BandPass<Order> design;
+    design.setup(Order, RATE, 23.0, 44.0);
+
+    const char *modeNames[] = { "sample_major", "stage_major", "stage_major_interleaved" };
+    vector<float> reference;
+    double referenceTime = 0.0;
+
+    for (int mode = CPM_SAMPLE_MAJOR; mode <= CPM_STAGE_MAJOR_INTERLEAVED; mode++)
+    {
+        vector<float> output;
+        double time = Measure(design, mode, passesCount, output);
+        double difference = 0.0;
+
+        if (mode == CPM_SAMPLE_MAJOR)
+        {
+            reference = output;
+            referenceTime = time;
+        }
+        else
+        {
+            for (size_t i = 0; i < output.size(); i++)
+                difference = std::max(difference, (double)fabs(output[i] - reference[i]));
+        }
+
+        printf("%i,%s,%.3f,%.2f,%g\n", Order, modeNames[mode], time, referenceTime / time, difference);
+        fflush(stdout);
+    }
+}
+//----------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    int passesCount = (argc > 1 ? atoi(argv[1]) : 200);
+
+    if (passesCount < 1)
+        passesCount = 1;
+
+    printf("order,mode,ns_per_sample,speedup,max_abs_difference\n");
+
+    Run<2>(passesCount);
+    Run<3>(passesCount);
+    Run<4>(passesCount);
+    Run<5>(passesCount);
+    Run<6>(passesCount);
+    Run<7>(passesCount);
+    Run<8>(passesCount);
+    Run<9>(passesCount);
+    Run<10>(passesCount);
+    Run<11>(passesCount);
+    Run<12>(passesCount);
+    Run<13>(passesCount);
+    Run<14>(passesCount);
+    Run<15>(passesCount);
+    Run<16>(passesCount);
+
+    return 0;
+}
+//----------------------------------------------------------------------------------
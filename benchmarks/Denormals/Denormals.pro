@@ -0,0 +1,8 @@
+include(../benchmarks.pri)
+
+TARGET = DenormalsBenchmark
+
+SOURCES += \
+    main.cpp \
+    $$PWD/../../src/Filtering/BaseFilter.cpp \
+    $$DSPFILTER_SOURCES
@@ -0,0 +1,161 @@
+/**
+@file main.cpp
+
+@brief Замер скорости БИХ фильтров на тишине и сигналах около нуля для разных форм звеньев и режимов борьбы с денормализованными числами
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "../../src/Filtering/ButterworthFilter.hpp"
+//----------------------------------------------------------------------------------
+using namespace GarantEEG;
+using std::vector;
+//----------------------------------------------------------------------------------
+//! Количество каналов фильтра
+const int FILTER_CHANNELS = 32;
+
+//! Порядок фильтра
+const int FILTER_ORDER = 4;
+
+//! Частота дискретизации
+const int RATE = 500;
+
+//! Количество отсчетов в фрэйме
+const int RECORDS_COUNT = 50;
+
+//! Режим без защиты от денормализованных чисел (только для сравнения, через API недоступен)
+const int NUMERICS_MODE_NONE = -1;
+//----------------------------------------------------------------------------------
+//! Тестовые сигналы
+enum BENCHMARK_SIGNAL
+{
+	//! Нули
+	BS_SILENCE = 0,
+	//! Единичный импульс, затем нули (состояние фильтра затухает до денормализованных чисел)
+	BS_DECAY,
+	//! Шум с амплитудой в диапазоне денормализованных float
+	BS_TINY
+};
+//----------------------------------------------------------------------------------
+//! Фильтр с доступом к отключению добавления константы без включения FTZ/DAZ
+template<class StateType>
+class CBenchmarkFilter : public CButterworthFilter<FILTER_ORDER, FILTER_CHANNELS, StateType>
+{
+public:
+    CBenchmarkFilter(const int *channelsList) : CButterworthFilter<FILTER_ORDER, FILTER_CHANNELS, StateType>(channelsList) {}
+
+    void DisableDenormalPrevention() { this->m_Filter.setDenormalPrevention(false); }
+};
+//----------------------------------------------------------------------------------
+/**
+ * @brief Measure Замерить время фильтрации
+ * @param mode Режим (NUMERICS_MODE_NONE или из GARANT_EEG_FILTER_NUMERICS_MODE)
+ * @param signal Тестовый сигнал
+ * @param framesCount Количество фрэймов
+ * @param worstFrameTime Максимальное время обработки фрэйма в микросекундах
+ * @return Среднее время на отсчет одного канала в наносекундах
+ */
+template<class StateType>
+static double Measure(int mode, int signal, int framesCount, double &worstFrameTime)
+{
+    int channelsList[FILTER_CHANNELS];
+
+    for (int i = 0; i < FILTER_CHANNELS; i++)
+        channelsList[i] = i + 1;
+
+    CBenchmarkFilter<StateType> filter(channelsList);
+    filter.Setup(RATE, 1, 45, 0);
+
+    if (mode == NUMERICS_MODE_NONE)
+        filter.DisableDenormalPrevention();
+    else
+        filter.SetNumericsMode(mode);
+
+    vector<float> samples(FILTER_CHANNELS * RECORDS_COUNT);
+    vector<float*> channels(FILTER_CHANNELS);
+
+    for (int i = 0; i < FILTER_CHANNELS; i++)
+        channels[i] = &samples[i * RECORDS_COUNT];
+
+    unsigned int seed = 1;
+    double totalTime = 0.0;
+    worstFrameTime = 0.0;
+
+    for (int frame = 0; frame < framesCount; frame++)
+    {
+        for (int i = 0; i < FILTER_CHANNELS; i++)
+        {
+            for (int j = 0; j < RECORDS_COUNT; j++)
+            {
+                float value = 0.0f;
+
+                if (signal == BS_DECAY)
+                    value = (frame == 0 && j == 0 ? 1.0f : 0.0f);
+                else if (signal == BS_TINY)
+                {
+                    seed = seed * 1664525u + 1013904223u;
+                    value = (float)(((int)(seed >> 8) - (1 << 23)) * 1e-45);
+                }
+
+                channels[i][j] = value;
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        filter.Process(RECORDS_COUNT, &channels[0]);
+
+        double time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        totalTime += time;
+        worstFrameTime = std::max(worstFrameTime, time);
+    }
+
+    return totalTime * 1000.0 / ((double)framesCount * RECORDS_COUNT * FILTER_CHANNELS);
+}
+//----------------------------------------------------------------------------------
+template<class StateType>
+static void Run(const char *formName, int framesCount)
+{
+    const int modes[] = { FNM_ANTI_DENORMAL, NUMERICS_MODE_NONE, FNM_FLUSH_TO_ZERO };
+    const char *modeNames[] = { "anti_denormal", "none", "flush_to_zero" };
+    const char *signalNames[] = { "silence", "decay", "tiny" };
+
+    for (int m = 0; m < 3; m++)
+    {
+        for (int signal = BS_SILENCE; signal <= BS_TINY; signal++)
+        {
+            double worstFrameTime = 0.0;
+            double time = Measure<StateType>(modes[m], signal, framesCount, worstFrameTime);
+
+            printf("%s,%s,%s,%.2f,%.2f\n", formName, modeNames[m], signalNames[signal], time, worstFrameTime);
+            fflush(stdout);
+        }
+    }
+}
+//----------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    //Длительность сигнала в секундах (затухание состояния до денормализованных double занимает около минуты)
+    int seconds = (argc > 1 ? atoi(argv[1]) : 300);
+
+    if (seconds < 1)
+        seconds = 1;
+
+    const int framesCount = seconds * RATE / RECORDS_COUNT;
+
+    printf("form,mode,signal,ns_per_sample,worst_frame_us\n");
+
+    Run<Dsp::DirectFormII>("direct_form_ii", framesCount);
+    Run<Dsp::DirectFormI>("direct_form_i", framesCount);
+    Run<Dsp::TransposedDirectFormII>("transposed_direct_form_ii", framesCount);
+
+    return 0;
+}
+//----------------------------------------------------------------------------------
@@ -0,0 +1,10 @@
+include(../benchmarks.pri)
+
+TARGET = DesignSetupBenchmark
+
+SOURCES += \
+    main.cpp \
+    $$PWD/../../src/Filtering/dspfilter/Bessel.cpp \
+    $$PWD/../../src/Filtering/dspfilter/Elliptic.cpp \
+    $$PWD/../../src/Filtering/dspfilter/Legendre.cpp \
+    $$DSPFILTER_SOURCES
@@ -0,0 +1,137 @@
+/**
+@file main.cpp
+
+@brief Замер перенастройки (setup) полосовых фильтров Bessel, Legendre и Elliptic с кэшем аналоговых прототипов и без него
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include "../../src/Filtering/dspfilter/Bessel.h"
+#include "../../src/Filtering/dspfilter/Elliptic.h"
+#include "../../src/Filtering/dspfilter/Legendre.h"
+#include "../../src/Filtering/dspfilter/PrototypeCache.h"
+//----------------------------------------------------------------------------------
+//! Частота дискретизации
+const int RATE = 500;
+//----------------------------------------------------------------------------------
+//! Семейства фильтров (параметры прототипа, не влияющие на частоты, фиксированы)
+struct BesselFamily
+{
+    static const char *Name() { return "bessel"; }
+    template<int Order> using Design = Dsp::Bessel::BandPass<Order>;
+    template<class DesignType> static void Setup(DesignType &design, int order, double center, double width) { design.setup(order, RATE, center, width); }
+};
+
+struct LegendreFamily
+{
+    static const char *Name() { return "legendre"; }
+    template<int Order> using Design = Dsp::Legendre::BandPass<Order>;
+    template<class DesignType> static void Setup(DesignType &design, int order, double center, double width) { design.setup(order, RATE, center, width); }
+};
+
+struct EllipticFamily
+{
+    static const char *Name() { return "elliptic"; }
+    template<int Order> using Design = Dsp::Elliptic::BandPass<Order>;
+    template<class DesignType> static void Setup(DesignType &design, int order, double center, double width) { design.setup(order, RATE, center, width, 1.0, 0.5); }
+};
+//----------------------------------------------------------------------------------
+/**
+ * @brief Measure Замерить перенастройку новыми экземплярами фильтра (как при создании фильтра или смене полосы)
+ * @param cached true - кэш прототипов заполнен, false - кэш очищается перед каждой перенастройкой
+ * @param setupsCount Количество перенастроек
+ * @param design Фильтр последней перенастройки
+ * @return Время одной перенастройки в микросекундах
+ */
+template<class Family, int Order>
+static double Measure(bool cached, int setupsCount, typename Family::template Design<Order> &design)
+{
+    typedef typename Family::template Design<Order> DesignType;
+
+    Dsp::PrototypeCache::clear();
+
+    if (cached)
+    {
+        DesignType warmup;
+        Family::Setup(warmup, Order, 20.0, 30.0);
+    }
+
+    double seconds = 0.0;
+
+    for (int i = 0; i < setupsCount; i++)
+    {
+        //Новый экземпляр: собственное запоминание прототипа в AnalogLowPass не срабатывает
+        std::unique_ptr<DesignType> fresh(new DesignType());
+
+        if (!cached)
+            Dsp::PrototypeCache::clear();
+
+        auto start = std::chrono::steady_clock::now();
+        Family::Setup(*fresh, Order, 10.0 + (i % 20), 20.0);
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (i == setupsCount - 1)
+            Family::Setup(design, Order, 10.0 + (i % 20), 20.0);
+    }
+
+    return seconds * 1e6 / setupsCount;
+}
+//----------------------------------------------------------------------------------
+template<class Family, int Order>
+static void Run(int setupsCount)
+{
+    typename Family::template Design<Order> uncachedDesign, cachedDesign;
+
+    Dsp::PrototypeCache::clear();
+    double uncachedTime = Measure<Family, Order>(false, setupsCount, uncachedDesign);
+
+    Dsp::PrototypeCache::clear();
+    double cachedTime = Measure<Family, Order>(true, setupsCount, cachedDesign);
+
+    //Коэффициенты должны совпадать точно
+    double difference = 0.0;
+
+    for (int s = 0; s < uncachedDesign.getNumStages(); s++)
+    {
+        const Dsp::Cascade::Stage &a = uncachedDesign[s];
+        const Dsp::Cascade::Stage &b = cachedDesign[s];
+
+        difference = std::max(difference, fabs(a.getB0() - b.getB0()) + fabs(a.getB1() - b.getB1()) + fabs(a.getB2() - b.getB2()) +
+                                          fabs(a.getA1() - b.getA1()) + fabs(a.getA2() - b.getA2()));
+    }
+
+    printf("%s,%i,%.2f,%.2f,%.2f,%g\n", Family::Name(), Order, uncachedTime, cachedTime, uncachedTime / cachedTime, difference);
+    fflush(stdout);
+}
+//----------------------------------------------------------------------------------
+template<class Family>
+static void RunFamily(int setupsCount)
+{
+    Run<Family, 2>(setupsCount);
+    Run<Family, 4>(setupsCount);
+    Run<Family, 8>(setupsCount);
+    Run<Family, 16>(setupsCount);
+}
+//----------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    int setupsCount = (argc > 1 ? atoi(argv[1]) : 2000);
+
+    if (setupsCount < 1)
+        setupsCount = 1;
+
+    printf("family,order,uncached_us,cached_us,speedup,max_coefficient_difference\n");
+
+    RunFamily<BesselFamily>(setupsCount);
+    RunFamily<LegendreFamily>(setupsCount);
+    RunFamily<EllipticFamily>(setupsCount);
+
+    return 0;
+}
+//----------------------------------------------------------------------------------
@@ -0,0 +1,16 @@
+include(../benchmarks.pri)
+
+TARGET = DspFiltersBenchmark
+
+SOURCES += \
+    main.cpp \
+    $$PWD/../../src/Filtering/BaseFilter.cpp \
+    $$PWD/../../src/Filtering/NotchFilter.cpp \
+    $$PWD/../../src/Filtering/FixedPointFilter.cpp \
+    $$PWD/../../src/Filtering/dspfilter/Bessel.cpp \
+    $$PWD/../../src/Filtering/dspfilter/ChebyshevI.cpp \
+    $$PWD/../../src/Filtering/dspfilter/ChebyshevII.cpp \
+    $$PWD/../../src/Filtering/dspfilter/Elliptic.cpp \
+    $$PWD/../../src/Filtering/dspfilter/Legendre.cpp \
+    $$PWD/../../src/Filtering/dspfilter/RBJ.cpp \
+    $$DSPFILTER_SOURCES
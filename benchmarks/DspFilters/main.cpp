@@ -0,0 +1,549 @@
+/**
+@file main.cpp
+
+@brief Набор замеров скорости фильтров библиотеки dspfilter и реализаций CBaseFilter (семейство x порядок x форма звеньев x каналы x тип отсчетов x размер блока)
+
+Использование: DspFiltersBenchmark [--min-time секунды] [--all-channels] [--family имя] [--layer dsp|filter] [--csv файл] [--json файл]
+Без --csv и --json результат выводится в stdout в формате CSV.
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../../src/Filtering/ButterworthFilter.hpp"
+#include "../../src/Filtering/NotchCombFilter.hpp"
+#include "../../src/Filtering/FixedPointFilter.h"
+#include "../../src/Filtering/dspfilter/Bessel.h"
+#include "../../src/Filtering/dspfilter/ChebyshevI.h"
+#include "../../src/Filtering/dspfilter/ChebyshevII.h"
+#include "../../src/Filtering/dspfilter/Elliptic.h"
+#include "../../src/Filtering/dspfilter/Legendre.h"
+//----------------------------------------------------------------------------------
+using namespace GarantEEG;
+using std::string;
+using std::vector;
+//----------------------------------------------------------------------------------
+//! Нижняя частота полосы пропускания
+const int BAND_LOW = 1;
+
+//! Верхняя частота полосы пропускания
+const int BAND_HIGHT = 45;
+
+//! Количество фрэймов в одном проходе замера (входные данные восстанавливаются между проходами)
+const int FRAMES_PER_PASS = 40;
+
+//! Количество пакетов устройства в секунду (размер блока = частота / 10)
+const int FRAMES_PER_SECOND = 10;
+
+//! Размеры блоков для частот устройства 250, 500 и 1000 Гц
+const int BLOCK_SIZES[] = { 25, 50, 100 };
+
+//! Количество каналов по умолчанию (--all-channels - все от 1 до 52)
+const int DEFAULT_CHANNELS[] = { 1, 2, 4, 8, 16, 32, 52 };
+
+//! Количество каналов для реализаций CBaseFilter (количество каналов - параметр шаблона)
+const int FILTER_CHANNELS[] = { 1, 8, 16, 32, 52 };
+
+//! Максимальное количество каналов устройства
+const int MAX_CHANNELS = 52;
+//----------------------------------------------------------------------------------
+//! Настройки запуска
+struct BENCHMARK_OPTIONS
+{
+	//! Минимальное время замера одной конфигурации (в секундах)
+    double MinSeconds = 0.02;
+
+	//! Замерять все количества каналов от 1 до MAX_CHANNELS
+    bool AllChannels = false;
+
+	//! Замерять только указанное семейство (пусто - все)
+    string Family;
+
+	//! Замерять только указанный уровень (пусто - все)
+    string Layer;
+
+	//! Путь к файлу CSV
+    string CsvPath;
+
+	//! Путь к файлу JSON
+    string JsonPath;
+};
+//----------------------------------------------------------------------------------
+//! Результат замера одной конфигурации
+struct BENCHMARK_RESULT
+{
+	//! Уровень ("dsp" - классы dspfilter, "filter" - реализации CBaseFilter)
+    string Layer;
+
+	//! Семейство фильтров
+    string Family;
+
+	//! Порядок фильтра
+    int Order;
+
+	//! Форма звеньев
+    string State;
+
+	//! Количество каналов
+    int Channels;
+
+	//! Тип отсчетов
+    string Sample;
+
+	//! Размер блока
+    int Block;
+
+	//! Количество отсчетов (по всем каналам) в секунду
+    double SamplesPerSecond;
+
+	//! Время на отсчет одного канала в наносекундах
+    double NsPerSample;
+};
+//----------------------------------------------------------------------------------
+static BENCHMARK_OPTIONS g_Options;
+static vector<BENCHMARK_RESULT> g_Results;
+//----------------------------------------------------------------------------------
+//! Семейства фильтров (полосовые фильтры одинаковой полосы)
+struct BUTTERWORTH_FAMILY
+{
+    static const char *Name() { return "butterworth"; }
+    template<int Order> struct Design { typedef Dsp::Butterworth::BandPass<Order> Type; };
+    template<class DesignType> static void Setup(DesignType &design, int order, double rate, double center, double width) { design.setup(order, rate, center, width); }
+};
+
+struct CHEBYSHEV_I_FAMILY
+{
+    static const char *Name() { return "chebyshev_i"; }
+    template<int Order> struct Design { typedef Dsp::ChebyshevI::BandPass<Order> Type; };
+    template<class DesignType> static void Setup(DesignType &design, int order, double rate, double center, double width) { design.setup(order, rate, center, width, 1.0); }
+};
+
+struct CHEBYSHEV_II_FAMILY
+{
+    static const char *Name() { return "chebyshev_ii"; }
+    template<int Order> struct Design { typedef Dsp::ChebyshevII::BandPass<Order> Type; };
+    template<class DesignType> static void Setup(DesignType &design, int order, double rate, double center, double width) { design.setup(order, rate, center, width, 40.0); }
+};
+
+struct ELLIPTIC_FAMILY
+{
+    static const char *Name() { return "elliptic"; }
+    template<int Order> struct Design { typedef Dsp::Elliptic::BandPass<Order> Type; };
+    template<class DesignType> static void Setup(DesignType &design, int order, double rate, double center, double width) { design.setup(order, rate, center, width, 1.0, 0.5); }
+};
+
+struct BESSEL_FAMILY
+{
+    static const char *Name() { return "bessel"; }
+    template<int Order> struct Design { typedef Dsp::Bessel::BandPass<Order> Type; };
+    template<class DesignType> static void Setup(DesignType &design, int order, double rate, double center, double width) { design.setup(order, rate, center, width); }
+};
+
+struct LEGENDRE_FAMILY
+{
+    static const char *Name() { return "legendre"; }
+    template<int Order> struct Design { typedef Dsp::Legendre::BandPass<Order> Type; };
+    template<class DesignType> static void Setup(DesignType &design, int order, double rate, double center, double width) { design.setup(order, rate, center, width); }
+};
+//----------------------------------------------------------------------------------
+static const char *StateName(Dsp::DirectFormII*) { return "direct_form_ii"; }
+static const char *StateName(Dsp::DirectFormI*) { return "direct_form_i"; }
+static const char *StateName(Dsp::TransposedDirectFormII*) { return "transposed_direct_form_ii"; }
+
+static const char *SampleName(float*) { return "float"; }
+static const char *SampleName(double*) { return "double"; }
+
+static const char *FilterStateName(int stateForm)
+{
+    switch (stateForm)
+    {
+        case FSF_DIRECT_FORM_I: return "direct_form_i";
+        case FSF_TRANSPOSED_DIRECT_FORM_II: return "transposed_direct_form_ii";
+        case FSF_DIRECT_FORM_I_FLOAT: return "direct_form_i_float";
+        case FSF_TRANSPOSED_DIRECT_FORM_II_FLOAT: return "transposed_direct_form_ii_float";
+        default:
+            break;
+    }
+
+    return "direct_form_ii";
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief Selected Проверить, выбран ли уровень и семейство для замера
+ * @param layer Уровень
+ * @param family Семейство
+ * @return true если выбран
+ */
+static bool Selected(const char *layer, const char *family)
+{
+    return ((g_Options.Layer.empty() || g_Options.Layer == layer) && (g_Options.Family.empty() || g_Options.Family == family));
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief ChannelsCounts Получить список количеств каналов для замера классов dspfilter
+ * @return Список
+ */
+static vector<int> ChannelsCounts()
+{
+    vector<int> result;
+
+    if (g_Options.AllChannels)
+    {
+        for (int i = 1; i <= MAX_CHANNELS; i++)
+            result.push_back(i);
+    }
+    else
+        result.assign(std::begin(DEFAULT_CHANNELS), std::end(DEFAULT_CHANNELS));
+
+    return result;
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief FillInput Заполнить входные данные (смесь синусоид с разной частотой в каждом канале)
+ * @param samples Данные (канал за каналом)
+ * @param channelsCount Количество каналов
+ * @param length Длина данных канала
+ * @param rate Частота дискретизации
+ */
+template<typename Sample>
+static void FillInput(vector<Sample> &samples, int channelsCount, int length, int rate)
+{
+    samples.resize((size_t)channelsCount * length);
+
+    for (int c = 0; c < channelsCount; c++)
+    {
+        for (int i = 0; i < length; i++)
+        {
+            double t = (double)i / rate;
+            samples[(size_t)c * length + i] = (Sample)(50.0 * sin(2.0 * 3.14159265358979 * (3.0 + c % 7) * t) + 10.0 * sin(2.0 * 3.14159265358979 * 50.0 * t) + 20.0);
+        }
+    }
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief AddResult Сохранить результат замера
+ * @param result Результат без рассчитанных скоростей
+ * @param seconds Время обработки
+ * @param samplesCount Количество обработанных отсчетов по всем каналам
+ */
+static void AddResult(BENCHMARK_RESULT result, double seconds, double samplesCount)
+{
+    result.SamplesPerSecond = samplesCount / seconds;
+    result.NsPerSample = seconds * 1e9 / samplesCount;
+
+    g_Results.push_back(result);
+
+    fprintf(stderr, "%s %s order %i %s %i ch %s block %i: %.2f ns/sample\n", result.Layer.c_str(), result.Family.c_str(), result.Order,
+            result.State.c_str(), result.Channels, result.Sample.c_str(), result.Block, result.NsPerSample);
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief MeasureDesign Замерить фильтрацию классом dspfilter (состояние каждого канала - отдельный объект, как в ChannelsState)
+ * @param design Рассчитанный фильтр
+ * @param channelsCount Количество каналов
+ * @param block Размер блока
+ * @param samplesCount Количество обработанных отсчетов по всем каналам
+ * @return Время обработки в секундах
+ */
+template<class StateType, typename Sample, class DesignType>
+static double MeasureDesign(const DesignType &design, int channelsCount, int block, double &samplesCount)
+{
+    typedef typename DesignType::template State<StateType> ChannelState;
+
+    const int length = block * FRAMES_PER_PASS;
+    std::unique_ptr<ChannelState[]> states(new ChannelState[channelsCount]);
+
+    vector<Sample> input;
+    FillInput(input, channelsCount, length, block * FRAMES_PER_SECOND);
+
+    vector<Sample> work(input.size());
+    double seconds = 0.0;
+    samplesCount = 0.0;
+
+    //Первый проход - прогрев
+    for (int pass = -1; pass == -1 || seconds < g_Options.MinSeconds; pass++)
+    {
+        memcpy(&work[0], &input[0], work.size() * sizeof(Sample));
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (int frame = 0; frame < FRAMES_PER_PASS; frame++)
+        {
+            for (int c = 0; c < channelsCount; c++)
+                design.process(block, &work[(size_t)c * length + frame * block], states[c]);
+        }
+
+        if (pass >= 0)
+        {
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            samplesCount += (double)length * channelsCount;
+        }
+    }
+
+    return seconds;
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief MeasureFilter Замерить фильтрацию реализацией CBaseFilter
+ * @param filter Фильтр
+ * @param block Размер блока
+ * @param samplesCount Количество обработанных отсчетов по всем каналам
+ * @return Время обработки в секундах
+ */
+static double MeasureFilter(CBaseFilter *filter, int block, double &samplesCount)
+{
+    const int channelsCount = filter->ChannelsCount();
+    const int length = block * FRAMES_PER_PASS;
+
+    vector<float> input;
+    FillInput(input, channelsCount, length, block * FRAMES_PER_SECOND);
+
+    vector<float> work(input.size());
+    vector<float*> channels(channelsCount);
+    double seconds = 0.0;
+    samplesCount = 0.0;
+
+    for (int pass = -1; pass == -1 || seconds < g_Options.MinSeconds; pass++)
+    {
+        memcpy(&work[0], &input[0], work.size() * sizeof(float));
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (int frame = 0; frame < FRAMES_PER_PASS; frame++)
+        {
+            for (int c = 0; c < channelsCount; c++)
+                channels[c] = &work[(size_t)c * length + frame * block];
+
+            filter->Process(block, &channels[0]);
+        }
+
+        if (pass >= 0)
+        {
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            samplesCount += (double)length * channelsCount;
+        }
+    }
+
+    return seconds;
+}
+//----------------------------------------------------------------------------------
+template<class Family, int Order, class StateType, typename Sample>
+static void RunDesign()
+{
+    for (int block : BLOCK_SIZES)
+    {
+        const double rate = block * FRAMES_PER_SECOND;
+
+        typename Family::template Design<Order>::Type design;
+        Family::Setup(design, Order, rate, (BAND_LOW + BAND_HIGHT) / 2.0, (double)(BAND_HIGHT - BAND_LOW));
+
+        for (int channelsCount : ChannelsCounts())
+        {
+            double samplesCount = 0.0;
+            double seconds = MeasureDesign<StateType, Sample>(design, channelsCount, block, samplesCount);
+
+            AddResult({ "dsp", Family::Name(), Order, StateName((StateType*)nullptr), channelsCount, SampleName((Sample*)nullptr), block, 0.0, 0.0 }, seconds, samplesCount);
+        }
+    }
+}
+//----------------------------------------------------------------------------------
+template<class Family, int Order>
+static void RunOrder()
+{
+    RunDesign<Family, Order, Dsp::DirectFormII, float>();
+    RunDesign<Family, Order, Dsp::DirectFormII, double>();
+    RunDesign<Family, Order, Dsp::DirectFormI, float>();
+    RunDesign<Family, Order, Dsp::DirectFormI, double>();
+    RunDesign<Family, Order, Dsp::TransposedDirectFormII, float>();
+    RunDesign<Family, Order, Dsp::TransposedDirectFormII, double>();
+}
+//----------------------------------------------------------------------------------
+template<class Family>
+static void RunFamily()
+{
+    if (!Selected("dsp", Family::Name()))
+        return;
+
+    RunOrder<Family, 1>();
+    RunOrder<Family, 2>();
+    RunOrder<Family, 3>();
+    RunOrder<Family, 4>();
+    RunOrder<Family, 5>();
+    RunOrder<Family, 6>();
+    RunOrder<Family, 7>();
+    RunOrder<Family, 8>();
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief RunFilter Замерить реализацию CBaseFilter на всех размерах блока
+ * @param family Название семейства
+ * @param filter Созданный фильтр (удаляется после замера)
+ */
+static void RunFilter(const char *family, CBaseFilter *filter)
+{
+    if (filter == nullptr)
+        return;
+
+    for (int block : BLOCK_SIZES)
+    {
+        filter->Setup(block * FRAMES_PER_SECOND, (filter->Type() == FT_NOTCH_COMB ? 50 : BAND_LOW), BAND_HIGHT, 0);
+
+        double samplesCount = 0.0;
+        double seconds = MeasureFilter(filter, block, samplesCount);
+
+        AddResult({ "filter", family, filter->Order(), FilterStateName(filter->StateForm()), filter->ChannelsCount(), "float", block, 0.0, 0.0 }, seconds, samplesCount);
+    }
+
+    delete filter;
+}
+//----------------------------------------------------------------------------------
+template<int MaxChannels>
+static void RunFilters()
+{
+    int channelsList[MaxChannels];
+
+    for (int i = 0; i < MaxChannels; i++)
+        channelsList[i] = i + 1;
+
+    if (Selected("filter", "butterworth"))
+    {
+        const int stateForms[] = { FSF_DIRECT_FORM_II, FSF_DIRECT_FORM_I, FSF_TRANSPOSED_DIRECT_FORM_II, FSF_DIRECT_FORM_I_FLOAT, FSF_TRANSPOSED_DIRECT_FORM_II_FLOAT };
+
+        for (int order = 1; order <= 8; order++)
+        {
+            for (int stateForm : stateForms)
+                RunFilter("butterworth", CButterworthFilter<1, MaxChannels>::Create(order, channelsList, stateForm));
+        }
+    }
+
+    if (Selected("filter", "butterworth_fixed"))
+    {
+        for (int order = 1; order <= FIXED_POINT_MAX_ORDER; order++)
+            RunFilter("butterworth_fixed", CFixedPointFilter::Create(order, MaxChannels, channelsList));
+    }
+
+    if (Selected("filter", "notch_comb"))
+    {
+        for (int harmonics = 1; harmonics <= 8; harmonics++)
+            RunFilter("notch_comb", CNotchCombFilter<MaxChannels>::Create(harmonics, channelsList));
+    }
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief WriteCsv Записать результаты в формате CSV
+ * @param file Файл
+ */
+static void WriteCsv(FILE *file)
+{
+    fprintf(file, "layer,family,order,state,channels,sample,block,samples_per_sec,ns_per_sample\n");
+
+    for (const BENCHMARK_RESULT &result : g_Results)
+    {
+        fprintf(file, "%s,%s,%i,%s,%i,%s,%i,%.0f,%.3f\n", result.Layer.c_str(), result.Family.c_str(), result.Order, result.State.c_str(),
+                result.Channels, result.Sample.c_str(), result.Block, result.SamplesPerSecond, result.NsPerSample);
+    }
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief WriteJson Записать результаты в формате JSON (массив объектов)
+ * @param file Файл
+ */
+static void WriteJson(FILE *file)
+{
+    fprintf(file, "[\n");
+
+    for (size_t i = 0; i < g_Results.size(); i++)
+    {
+        const BENCHMARK_RESULT &result = g_Results[i];
+
+        fprintf(file, "  {\"layer\": \"%s\", \"family\": \"%s\", \"order\": %i, \"state\": \"%s\", \"channels\": %i, \"sample\": \"%s\", \"block\": %i, "
+                      "\"samples_per_sec\": %.0f, \"ns_per_sample\": %.3f}%s\n", result.Layer.c_str(), result.Family.c_str(), result.Order,
+                result.State.c_str(), result.Channels, result.Sample.c_str(), result.Block, result.SamplesPerSecond, result.NsPerSample,
+                (i + 1 < g_Results.size() ? "," : ""));
+    }
+
+    fprintf(file, "]\n");
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief WriteFile Записать результаты в файл
+ * @param path Путь к файлу
+ * @param writer Функция записи
+ * @return true если файл записан
+ */
+static bool WriteFile(const string &path, void (*writer)(FILE*))
+{
+    FILE *file = fopen(path.c_str(), "w");
+
+    if (file == nullptr)
+    {
+        fprintf(stderr, "Can't open %s\n", path.c_str());
+        return false;
+    }
+
+    writer(file);
+    fclose(file);
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if (arg == "--min-time" && hasValue)
+            g_Options.MinSeconds = atof(argv[++i]);
+        else if (arg == "--all-channels")
+            g_Options.AllChannels = true;
+        else if (arg == "--family" && hasValue)
+            g_Options.Family = argv[++i];
+        else if (arg == "--layer" && hasValue)
+            g_Options.Layer = argv[++i];
+        else if (arg == "--csv" && hasValue)
+            g_Options.CsvPath = argv[++i];
+        else if (arg == "--json" && hasValue)
+            g_Options.JsonPath = argv[++i];
+        else
+        {
+            fprintf(stderr, "Usage: %s [--min-time seconds] [--all-channels] [--family name] [--layer dsp|filter] [--csv file] [--json file]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    RunFamily<BUTTERWORTH_FAMILY>();
+    RunFamily<CHEBYSHEV_I_FAMILY>();
+    RunFamily<CHEBYSHEV_II_FAMILY>();
+    RunFamily<ELLIPTIC_FAMILY>();
+    RunFamily<BESSEL_FAMILY>();
+    RunFamily<LEGENDRE_FAMILY>();
+
+    RunFilters<1>();
+    RunFilters<8>();
+    RunFilters<16>();
+    RunFilters<32>();
+    RunFilters<52>();
+
+    bool result = true;
+
+    if (!g_Options.CsvPath.empty())
+        result &= WriteFile(g_Options.CsvPath, WriteCsv);
+
+    if (!g_Options.JsonPath.empty())
+        result &= WriteFile(g_Options.JsonPath, WriteJson);
+
+    if (g_Options.CsvPath.empty() && g_Options.JsonPath.empty())
+        WriteCsv(stdout);
+
+    return (result ? 0 : 2);
+}
+//----------------------------------------------------------------------------------
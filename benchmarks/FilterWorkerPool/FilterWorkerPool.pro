@@ -0,0 +1,9 @@
+include(../benchmarks.pri)
+
+TARGET = FilterWorkerPoolBenchmark
+
+SOURCES += \
+    main.cpp \
+    $$PWD/../../src/Filtering/BaseFilter.cpp \
+    $$PWD/../../src/Filtering/FilterWorkerPool.cpp \
+    $$DSPFILTER_SOURCES
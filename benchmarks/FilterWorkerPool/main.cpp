@@ -0,0 +1,141 @@
+/**
+@file main.cpp
+
+@brief Замер ускорения параллельной фильтрации каналов пулом потоков в зависимости от количества каналов
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include "../../src/Filtering/ButterworthFilter.hpp"
+#include "../../src/Filtering/FilterWorkerPool.h"
+//----------------------------------------------------------------------------------
+using namespace GarantEEG;
+//----------------------------------------------------------------------------------
+//! Количество каналов в одном фильтре (несколько устройств агрегируются набором фильтров)
+const int FILTER_CHANNELS = 32;
+
+//! Порядок фильтра
+const int FILTER_ORDER = 4;
+
+//! Частота дискретизации
+const int RATE = 500;
+
+//! Количество отсчетов в фрэйме
+const int RECORDS_COUNT = 50;
+//----------------------------------------------------------------------------------
+/**
+ * @brief MeasureFrameTime Замерить среднее время фильтрации одного фрэйма
+ * @param channelsCount Общее количество каналов
+ * @param threadsCount Количество рабочих потоков пула (0 - последовательная обработка)
+ * @param framesCount Количество фрэймов
+ * @return Время в микросекундах
+ */
+static double MeasureFrameTime(int channelsCount, int threadsCount, int framesCount)
+{
+    int channelsList[FILTER_CHANNELS];
+
+    for (int i = 0; i < FILTER_CHANNELS; i++)
+        channelsList[i] = i + 1;
+
+    const int filtersCount = (channelsCount + FILTER_CHANNELS - 1) / FILTER_CHANNELS;
+    vector<CBaseFilter*> filters;
+
+    for (int i = 0; i < filtersCount; i++)
+    {
+        CBaseFilter *filter = new CButterworthFilter<FILTER_ORDER, FILTER_CHANNELS>(channelsList);
+        filter->Setup(RATE, 1, 45, 0);
+        filters.push_back(filter);
+    }
+
+    vector<float> samples(filtersCount * FILTER_CHANNELS * RECORDS_COUNT);
+    vector<float*> channels(filtersCount * FILTER_CHANNELS);
+
+    for (int i = 0; i < (int)channels.size(); i++)
+        channels[i] = &samples[i * RECORDS_COUNT];
+
+    CFilterWorkerPool pool;
+    pool.SetThreadsCount(threadsCount);
+
+    const int workersCount = threadsCount + 1;
+    vector<FILTER_TASK> tasks;
+
+    for (int f = 0; f < filtersCount; f++)
+    {
+        int chunksCount = 1;
+
+        if (workersCount > 1)
+            chunksCount = std::max(1, std::min(workersCount * 2, FILTER_CHANNELS / FILTER_TASK_MIN_CHANNELS));
+
+        for (int c = 0; c < chunksCount; c++)
+        {
+            int first = FILTER_CHANNELS * c / chunksCount;
+            int last = FILTER_CHANNELS * (c + 1) / chunksCount;
+
+            tasks.push_back({ filters[f], &channels[f * FILTER_CHANNELS], RECORDS_COUNT, first, last - first, nullptr });
+        }
+    }
+
+    long long sampleIndex = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int frame = 0; frame < framesCount; frame++)
+    {
+        for (int j = 0; j < RECORDS_COUNT; j++, sampleIndex++)
+        {
+            float value = (float)sin(sampleIndex * 0.05);
+
+            for (int i = 0; i < (int)channels.size(); i++)
+                channels[i][j] = value;
+        }
+
+        pool.Run(tasks);
+
+        for (CBaseFilter *filter : filters)
+            filter->FinishProcess(RECORDS_COUNT);
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    for (CBaseFilter *filter : filters)
+        delete filter;
+
+    return std::chrono::duration<double, std::micro>(elapsed).count() / framesCount;
+}
+//----------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    int framesCount = (argc > 1 ? atoi(argv[1]) : 2000);
+    int maxThreads = (argc > 2 ? atoi(argv[2]) : (int)thread::hardware_concurrency() - 1);
+
+    if (framesCount < 1)
+        framesCount = 1;
+
+    if (maxThreads < 0)
+        maxThreads = 0;
+
+    const int channelsCounts[] = { 32, 64, 128, 256, 512 };
+
+    printf("channels,threads,frame_us,speedup\n");
+
+    for (int channelsCount : channelsCounts)
+    {
+        double serialTime = MeasureFrameTime(channelsCount, 0, framesCount);
+        printf("%i,0,%.2f,1.00\n", channelsCount, serialTime);
+
+        for (int threadsCount = 1; threadsCount <= maxThreads; threadsCount++)
+        {
+            double time = MeasureFrameTime(channelsCount, threadsCount, framesCount);
+            printf("%i,%i,%.2f,%.2f\n", channelsCount, threadsCount, time, serialTime / time);
+        }
+
+        fflush(stdout);
+    }
+
+    return 0;
+}
+//----------------------------------------------------------------------------------
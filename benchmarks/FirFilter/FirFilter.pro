@@ -0,0 +1,10 @@
+include(../benchmarks.pri)
+
+TARGET = FirFilterBenchmark
+
+SOURCES += \
+    main.cpp \
+    $$PWD/../../src/Filtering/BaseFilter.cpp \
+    $$PWD/../../src/Filtering/FirFilter.cpp \
+    $$PWD/../../src/Filtering/RealFft.cpp \
+    $$PWD/../../src/Filtering/dspfilter/FrequencyResponse.cpp
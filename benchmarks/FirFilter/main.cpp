@@ -0,0 +1,79 @@
+/**
+@file main.cpp
+
+@brief Замер стоимости КИХ фильтра в зависимости от порядка (прямая свертка и свертка через БПФ)
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include "../../src/Filtering/FirFilter.h"
+//----------------------------------------------------------------------------------
+using namespace GarantEEG;
+//----------------------------------------------------------------------------------
+//! Количество каналов
+const int CHANNELS_COUNT = 8;
+
+//! Частота дискретизации
+const int RATE = 1000;
+
+//! Количество отсчетов в фрэйме
+const int RECORDS_COUNT = 100;
+//----------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    int seconds = (argc > 1 ? atoi(argv[1]) : 120);
+
+    if (seconds < 1)
+        seconds = 1;
+
+    const int framesCount = seconds * RATE / RECORDS_COUNT;
+    const int orders[] = { 16, 32, 64, 94, 96, 128, 256, 512, 1000, 2000, 4000, 8000, 16000 };
+
+    int channelsList[CHANNELS_COUNT];
+
+    for (int i = 0; i < CHANNELS_COUNT; i++)
+        channelsList[i] = i + 1;
+
+    vector<float> samples(CHANNELS_COUNT * RECORDS_COUNT);
+    float *channels[CHANNELS_COUNT];
+
+    for (int i = 0; i < CHANNELS_COUNT; i++)
+        channels[i] = &samples[i * RECORDS_COUNT];
+
+    printf("order,engine,delay,ns_per_sample,realtime_load_percent\n");
+
+    for (int order : orders)
+    {
+        CFirFilter filter(order, CHANNELS_COUNT, channelsList);
+        filter.Setup(RATE, 1, 40, 0);
+
+        long long sampleIndex = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        for (int frame = 0; frame < framesCount; frame++)
+        {
+            for (int j = 0; j < RECORDS_COUNT; j++, sampleIndex++)
+            {
+                float value = (float)sin(sampleIndex * 0.05);
+
+                for (int i = 0; i < CHANNELS_COUNT; i++)
+                    channels[i][j] = value;
+            }
+
+            filter.Process(RECORDS_COUNT, channels);
+        }
+
+        double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        double perSample = elapsed / ((double)framesCount * RECORDS_COUNT * CHANNELS_COUNT);
+
+        printf("%i,%s,%i,%.2f,%.4f\n", filter.Order(), filter.UseFft() ? "fft" : "direct", filter.Delay(), perSample, elapsed / (seconds * 1e9) * 100.0);
+        fflush(stdout);
+    }
+
+    return 0;
+}
+//----------------------------------------------------------------------------------
@@ -0,0 +1,9 @@
+include(../benchmarks.pri)
+
+TARGET = FixedPointFilterBenchmark
+
+SOURCES += \
+    main.cpp \
+    $$PWD/../../src/Filtering/BaseFilter.cpp \
+    $$PWD/../../src/Filtering/FixedPointFilter.cpp \
+    $$DSPFILTER_SOURCES
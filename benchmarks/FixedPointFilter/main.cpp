@@ -0,0 +1,124 @@
+/**
+@file main.cpp
+
+@brief Проверка точности целочисленного фильтра Butterworth относительно каскада двойной точности в полосах дельта, тета и альфа
+
+Использование: FixedPointFilterBenchmark
+Код возврата 1, если погрешность превышает FIXED_POINT_TOLERANCE или выход целочисленного фильтра близок к нулю.
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include "../../src/Filtering/FixedPointFilter.h"
+#include "../../src/Filtering/dspfilter/Butterworth.h"
+//----------------------------------------------------------------------------------
+using namespace GarantEEG;
+using std::vector;
+//----------------------------------------------------------------------------------
+//! Длительность сигнала (в секундах, первая половина - переходный процесс)
+const int SIGNAL_SECONDS = 20;
+
+//! Количество пакетов устройства в секунду (размер блока = частота / 10)
+const int FRAMES_PER_SECOND = 10;
+
+//! Постоянная составляющая входа в отсчетах АЦП
+const double SIGNAL_OFFSET = 20000.0;
+
+//! Амплитуда синуса в центре полосы в отсчетах АЦП
+const double SIGNAL_AMPLITUDE = 4000.0;
+
+//! Допустимая погрешность относительно пика выхода double
+const double FIXED_POINT_TOLERANCE = 1e-2;
+
+//! Минимальное отношение пика выхода целочисленного фильтра к пику выхода double (меньше - канал "молчит")
+const double MIN_PEAK_RATIO = 0.5;
+
+//! Частоты устройства
+const int RATES[] = { 250, 500, 1000 };
+
+//! Полосы пропускания (нижняя, верхняя)
+const int BANDS[][2] = { { 1, 4 }, { 4, 8 }, { 8, 13 } };
+//----------------------------------------------------------------------------------
+/**
+ * @brief Run Сравнить целочисленный фильтр с каскадом двойной точности на синусе в центре полосы
+ * @return true если погрешность в пределах FIXED_POINT_TOLERANCE и выход не близок к нулю
+ */
+static bool Run(int rate, int low, int hight, int order, int rounding)
+{
+    const int length = rate * SIGNAL_SECONDS;
+    const int blockSize = rate / FRAMES_PER_SECOND;
+    const double center = (low + hight) / 2.0;
+
+    vector<double> expected(length);
+
+    for (int i = 0; i < length; i++)
+        expected[i] = floor(SIGNAL_OFFSET + SIGNAL_AMPLITUDE * sin(2.0 * M_PI * center * i / rate) + 0.5);
+
+    vector<float> output(expected.begin(), expected.end());
+
+    Dsp::SimpleFilter<Dsp::Butterworth::BandPass<FIXED_POINT_MAX_ORDER>, 1, Dsp::DirectFormI> reference;
+    reference.setup(order, rate, center, (double)(hight - low));
+
+    const int channelsList[1] = { 0 };
+    CFixedPointFilter *filter = (CFixedPointFilter*)CFixedPointFilter::Create(order, 1, channelsList);
+    filter->Setup(rate, low, hight, 0);
+    filter->SetRounding(rounding);
+
+    for (int i = 0; i + blockSize <= length; i += blockSize)
+    {
+        double *referenceBlock = &expected[i];
+        reference.process(blockSize, &referenceBlock);
+
+        float *block = &output[i];
+        filter->ProcessChannels(blockSize, &block, 0, 1);
+        filter->FinishProcess(blockSize);
+    }
+
+    delete filter;
+
+    double error = 0.0;
+    double peak = 0.0;
+    double outputPeak = 0.0;
+
+    for (int i = length / 2; i < length; i++)
+    {
+        error = std::max(error, fabs(output[i] - expected[i]));
+        peak = std::max(peak, fabs(expected[i]));
+        outputPeak = std::max(outputPeak, (double)fabs(output[i]));
+    }
+
+    const double relativeError = (peak > 0.0 ? error / peak : error);
+    const double peakRatio = (peak > 0.0 ? outputPeak / peak : 0.0);
+    const bool passed = (relativeError <= FIXED_POINT_TOLERANCE && peakRatio >= MIN_PEAK_RATIO);
+
+    printf("%i,%i,%i,%i,%i,%g,%g,%s\n", rate, low, hight, order, rounding, relativeError, peakRatio, (passed ? "ok" : "FAIL"));
+    fflush(stdout);
+
+    if (!passed)
+        fprintf(stderr, "order %i at %i Hz, band %i-%i Hz, rounding %i: relative error %g, peak ratio %g\n", order, rate, low, hight, rounding, relativeError, peakRatio);
+
+    return passed;
+}
+//----------------------------------------------------------------------------------
+int main()
+{
+    printf("rate,low,hight,order,rounding,max_relative_error,peak_ratio,tolerance\n");
+
+    bool passed = true;
+
+    for (int rate : RATES)
+    {
+        for (const auto &band : BANDS)
+        {
+            for (int order = 4; order <= FIXED_POINT_MAX_ORDER; order++)
+                passed &= Run(rate, band[0], band[1], order, FPR_ERROR_FEEDBACK);
+        }
+    }
+
+    return (passed ? 0 : 1);
+}
+//----------------------------------------------------------------------------------
@@ -0,0 +1,7 @@
+include(../benchmarks.pri)
+
+TARGET = FloatStateBenchmark
+
+SOURCES += \
+    main.cpp \
+    $$DSPFILTER_SOURCES
@@ -0,0 +1,216 @@
+/**
+@file main.cpp
+
+@brief Сравнение состояний звеньев двойной и одинарной точности (DF-I, DF-II, TDF-II): погрешность относительно double и скорость для всех каналов устройства
+
+Использование: FloatStateBenchmark [количество проходов]
+Код возврата 1, если погрешность рекомендуемой конфигурации (DF-I или TDF-II, полоса от 1 Гц, порядок до 8) превышает FLOAT_TOLERANCE.
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "../../src/Filtering/dspfilter/Butterworth.h"
+//----------------------------------------------------------------------------------
+using std::vector;
+//----------------------------------------------------------------------------------
+//! Количество каналов
+const int CHANNELS_COUNT = 52;
+
+//! Длительность сигнала для оценки погрешности (в секундах, первая половина - переходный процесс)
+const int ACCURACY_SECONDS = 60;
+
+//! Количество пакетов устройства в секунду (размер блока = частота / 10)
+const int FRAMES_PER_SECOND = 10;
+
+//! Количество фрэймов в одном проходе замера скорости
+const int FRAMES_PER_PASS = 40;
+
+//! Допустимая погрешность одинарной точности относительно пика сигнала
+const double FLOAT_TOLERANCE = 1e-3;
+
+//! Частоты устройства
+const int RATES[] = { 250, 500, 1000 };
+
+//! Полосы пропускания (нижняя, верхняя)
+const double BANDS[][2] = { { 1.0, 45.0 }, { 0.5, 45.0 }, { 0.1, 30.0 } };
+//----------------------------------------------------------------------------------
+/**
+ * @brief MakeSignal Сформировать тестовый сигнал канала (постоянная составляющая, медленный дрейф, альфа и сетевая помеха)
+ * @param channel Индекс канала
+ * @param rate Частота дискретизации
+ * @param length Количество отсчетов
+ * @param signal Результат
+ */
+static void MakeSignal(int channel, double rate, int length, float *signal)
+{
+    for (int i = 0; i < length; i++)
+    {
+        double t = i / rate;
+        signal[i] = (float)(200.0 + 30.0 * sin(2.0 * M_PI * 0.3 * t) + 50.0 * sin(2.0 * M_PI * (3.0 + channel % 7) * t) +
+                            10.0 * sin(2.0 * M_PI * 10.0 * t) + 5.0 * sin(2.0 * M_PI * 50.0 * t));
+    }
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief Process Отфильтровать сигнал одного канала блоками размера пакета устройства
+ * @param filter Фильтр
+ * @param rate Частота дискретизации
+ * @param length Количество отсчетов
+ * @param signal Сигнал (результат записывается на его место)
+ */
+template<class FilterType>
+static void Process(FilterType &filter, int rate, int length, float *signal)
+{
+    const int blockSize = rate / FRAMES_PER_SECOND;
+
+    for (int i = 0; i + blockSize <= length; i += blockSize)
+    {
+        float *block = signal + i;
+        filter.process(blockSize, &block);
+    }
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief RelativeError Получить погрешность одинарной точности относительно двойной
+ * @param rate Частота дискретизации
+ * @param low Нижняя частота полосы
+ * @param hight Верхняя частота полосы
+ * @return Максимальное отклонение установившегося выхода, отнесенное к пику выхода double
+ */
+template<int Order, class DoubleState, class FloatState>
+static double RelativeError(int rate, double low, double hight)
+{
+    Dsp::SimpleFilter<Dsp::Butterworth::BandPass<Order>, 1, DoubleState> reference;
+    Dsp::SimpleFilter<Dsp::Butterworth::BandPass<Order>, 1, FloatState> filter;
+    reference.setup(Order, rate, (low + hight) / 2.0, hight - low);
+    filter.setup(Order, rate, (low + hight) / 2.0, hight - low);
+
+    const int length = rate * ACCURACY_SECONDS;
+    vector<float> expected(length);
+    MakeSignal(0, rate, length, &expected[0]);
+    vector<float> output(expected);
+
+    Process(reference, rate, length, &expected[0]);
+    Process(filter, rate, length, &output[0]);
+
+    double error = 0.0;
+    double peak = 0.0;
+
+    for (int i = length / 2; i < length; i++)
+    {
+        error = std::max(error, (double)fabs(output[i] - expected[i]));
+        peak = std::max(peak, (double)fabs(expected[i]));
+    }
+
+    return (peak > 0.0 ? error / peak : error);
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief Measure Замерить обработку всех каналов
+ * @param rate Частота дискретизации
+ * @param passesCount Количество проходов
+ * @return Время на отсчет одного канала в наносекундах
+ */
+template<int Order, class StateType>
+static double Measure(int rate, int passesCount)
+{
+    Dsp::SimpleFilter<Dsp::Butterworth::BandPass<Order>, CHANNELS_COUNT, StateType> filter;
+    filter.setup(Order, rate, 23.0, 44.0);
+
+    const int blockSize = rate / FRAMES_PER_SECOND;
+    const int length = blockSize * FRAMES_PER_PASS;
+    vector<float> input((size_t)CHANNELS_COUNT * length);
+
+    for (int c = 0; c < CHANNELS_COUNT; c++)
+        MakeSignal(c, rate, length, &input[(size_t)c * length]);
+
+    vector<float> output(input.size());
+    double seconds = 0.0;
+
+    for (int pass = 0; pass < passesCount; pass++)
+    {
+        memcpy(&output[0], &input[0], input.size() * sizeof(float));
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (int frame = 0; frame < FRAMES_PER_PASS; frame++)
+        {
+            float *channels[CHANNELS_COUNT];
+
+            for (int c = 0; c < CHANNELS_COUNT; c++)
+                channels[c] = &output[(size_t)c * length + frame * blockSize];
+
+            filter.process(blockSize, channels);
+        }
+
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    return seconds * 1e9 / ((double)passesCount * length * CHANNELS_COUNT);
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief RunForm Замерить одну форму звеньев в двух точностях
+ * @return true если погрешность рекомендуемой конфигурации в пределах FLOAT_TOLERANCE
+ */
+template<int Order, class DoubleState, class FloatState>
+static bool RunForm(const char *name, bool recommended, int rate, double low, double hight, int passesCount)
+{
+    double error = RelativeError<Order, DoubleState, FloatState>(rate, low, hight);
+    double doubleTime = Measure<Order, DoubleState>(rate, passesCount);
+    double floatTime = Measure<Order, FloatState>(rate, passesCount);
+
+    recommended = (recommended && low >= 1.0 && Order <= 8);
+    bool passed = (!recommended || error <= FLOAT_TOLERANCE);
+
+    printf("%i,%g,%g,%i,%s,%.3f,%.3f,%.2f,%g,%s\n", rate, low, hight, Order, name, doubleTime, floatTime,
+           doubleTime / floatTime, error, (recommended ? (passed ? "ok" : "FAIL") : "-"));
+    fflush(stdout);
+
+    if (!passed)
+        fprintf(stderr, "%s order %i at %i Hz, band %g-%g Hz: relative error %g exceeds %g\n", name, Order, rate, low, hight, error, FLOAT_TOLERANCE);
+
+    return passed;
+}
+//----------------------------------------------------------------------------------
+template<int Order>
+static bool Run(int rate, double low, double hight, int passesCount)
+{
+    bool passed = RunForm<Order, Dsp::DirectFormI, Dsp::DirectFormIFloat>("direct_form_i", true, rate, low, hight, passesCount);
+    passed &= RunForm<Order, Dsp::DirectFormII, Dsp::DirectFormIIFloat>("direct_form_ii", false, rate, low, hight, passesCount);
+    passed &= RunForm<Order, Dsp::TransposedDirectFormII, Dsp::TransposedDirectFormIIFloat>("transposed_direct_form_ii", true, rate, low, hight, passesCount);
+
+    return passed;
+}
+//----------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    int passesCount = (argc > 1 ? atoi(argv[1]) : 20);
+
+    if (passesCount < 1)
+        passesCount = 1;
+
+    printf("rate,low,hight,order,form,ns_per_sample_double,ns_per_sample_float,speedup,max_relative_error,tolerance\n");
+
+    bool passed = true;
+
+    for (int rate : RATES)
+    {
+        for (const auto &band : BANDS)
+        {
+            passed &= Run<2>(rate, band[0], band[1], passesCount);
+            passed &= Run<4>(rate, band[0], band[1], passesCount);
+            passed &= Run<8>(rate, band[0], band[1], passesCount);
+        }
+    }
+
+    return (passed ? 0 : 1);
+}
+//----------------------------------------------------------------------------------
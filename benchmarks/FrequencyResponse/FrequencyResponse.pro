@@ -0,0 +1,7 @@
+include(../benchmarks.pri)
+
+TARGET = FrequencyResponseBenchmark
+
+SOURCES += \
+    main.cpp \
+    $$DSPFILTER_SOURCES
@@ -0,0 +1,198 @@
+/**
+@file main.cpp
+
+@brief Сравнение поточечного расчета частотной характеристики (Cascade::response) с пакетным (Dsp::FrequencyResponse) для отображения фильтров
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "../../src/Filtering/dspfilter/Butterworth.h"
+#include "../../src/Filtering/dspfilter/FrequencyResponse.h"
+//----------------------------------------------------------------------------------
+using std::vector;
+//----------------------------------------------------------------------------------
+//! Частота дискретизации
+const int RATE = 500;
+
+//! Количество коэффициентов КИХ фильтра
+const int FIR_TAPS_COUNT = 257;
+//----------------------------------------------------------------------------------
+//! Способы расчета
+enum RESPONSE_MODE
+{
+	//! Cascade::response для каждой точки
+	RM_PER_POINT = 0,
+	//! Пакетный расчет с новой сеткой при каждом вызове (поворотные множители пересчитываются)
+	RM_BATCH,
+	//! Пакетный расчет на неизменной сетке (поворотные множители из предыдущего вызова)
+	RM_BATCH_CACHED
+};
+//----------------------------------------------------------------------------------
+/**
+ * @brief Grid Получить логарифмическую сетку частот
+ * @param count Количество точек
+ * @return Частоты в Гц
+ */
+static vector<double> Grid(int count)
+{
+    vector<double> frequencies(count);
+
+    for (int i = 0; i < count; i++)
+        frequencies[i] = 0.1 * pow(RATE / 2 / 0.1, count > 1 ? (double)i / (count - 1) : 0.0);
+
+    return frequencies;
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief Measure Замерить расчет характеристики цепочки из каскада и КИХ фильтра
+ * @param cascade Каскад биквадов
+ * @param taps Коэффициенты КИХ фильтра (пустой список - без КИХ фильтра)
+ * @param count Количество точек
+ * @param mode Способ расчета
+ * @param callsCount Количество вызовов
+ * @param magnitude Модуль характеристики последнего вызова
+ * @return Время одного вызова в микросекундах
+ */
+static double Measure(const Dsp::Cascade &cascade, const vector<double> &taps, int count, int mode, int callsCount, vector<double> &magnitude)
+{
+    const vector<double> frequencies = Grid(count);
+    Dsp::FrequencyResponse response;
+    magnitude.assign(count, 0.0);
+
+    response.setSampleRate(RATE);
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int call = 0; call < callsCount; call++)
+    {
+        if (mode == RM_PER_POINT)
+        {
+            for (int i = 0; i < count; i++)
+            {
+                const double normalized = frequencies[i] / RATE;
+                Dsp::complex_t value = cascade.response(normalized);
+
+                if (!taps.empty())
+                {
+                    Dsp::complex_t sum = 0.0;
+
+                    for (size_t k = 0; k < taps.size(); k++)
+                        sum += taps[k] * std::polar(1.0, -2 * Dsp::doublePi * normalized * k);
+
+                    value *= sum;
+                }
+
+                magnitude[i] = std::abs(value);
+            }
+        }
+        else
+        {
+            if (mode == RM_BATCH || !call)
+                response.setFrequencies(count, &frequencies[0]);
+
+            response.reset();
+            response.multiply(cascade);
+
+            if (!taps.empty())
+                response.multiplyTransversal((int)taps.size(), &taps[0]);
+
+            response.getMagnitude(&magnitude[0]);
+        }
+    }
+
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1e6 / callsCount;
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief Run Замерить все способы расчета для одной цепочки
+ * @param name Название цепочки
+ * @param cascade Каскад биквадов
+ * @param taps Коэффициенты КИХ фильтра
+ * @param callsCount Количество вызовов для 1000 точек
+ */
+static void Run(const char *name, const Dsp::Cascade &cascade, const vector<double> &taps, int callsCount)
+{
+    const char *modeNames[] = { "per_point", "batch", "batch_cached" };
+    const int counts[] = { 100, 1000, 10000 };
+
+    for (int count : counts)
+    {
+        const int calls = std::max(1, callsCount * 1000 / count);
+        vector<double> reference;
+        double referenceTime = 0.0;
+
+        for (int mode = RM_PER_POINT; mode <= RM_BATCH_CACHED; mode++)
+        {
+            vector<double> magnitude;
+            double time = Measure(cascade, taps, count, mode, calls, magnitude);
+            double difference = 0.0;
+
+            if (mode == RM_PER_POINT)
+            {
+                reference = magnitude;
+                referenceTime = time;
+            }
+            else
+            {
+                for (int i = 0; i < count; i++)
+                    difference = std::max(difference, fabs(magnitude[i] - reference[i]));
+            }
+
+            printf("%s,%i,%s,%.2f,%.2f,%g\n", name, count, modeNames[mode], time, referenceTime / time, difference);
+            fflush(stdout);
+        }
+    }
+}
+//----------------------------------------------------------------------------------
+template<int Order>
+static void RunButterworth(int callsCount)
+{
+    Dsp::Butterworth::BandPass<Order> design;
+    design.setup(Order, RATE, 23.0, 44.0);
+
+    char name[64];
+    sprintf(name, "butterworth_%i", Order);
+
+    Run(name, design, vector<double>(), callsCount);
+}
+//----------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    int callsCount = (argc > 1 ? atoi(argv[1]) : 200);
+
+    if (callsCount < 1)
+        callsCount = 1;
+
+    printf("chain,points,mode,us_per_call,speedup,max_abs_difference\n");
+
+    RunButterworth<2>(callsCount);
+    RunButterworth<4>(callsCount);
+    RunButterworth<8>(callsCount);
+    RunButterworth<16>(callsCount);
+
+    //Полосовой КИХ фильтр (окно Хэмминга) после БИХ фильтра 4-го порядка
+    Dsp::Butterworth::BandPass<4> design;
+    design.setup(4, RATE, 23.0, 44.0);
+
+    vector<double> taps(FIR_TAPS_COUNT);
+    const int middle = FIR_TAPS_COUNT / 2;
+
+    for (int i = 0; i < FIR_TAPS_COUNT; i++)
+    {
+        const double n = i - middle;
+        const double ideal = (n == 0.0 ? 2.0 * (45.0 - 1.0) / RATE : (sin(2 * Dsp::doublePi * 45.0 / RATE * n) - sin(2 * Dsp::doublePi * 1.0 / RATE * n)) / (Dsp::doublePi * n));
+
+        taps[i] = ideal * (0.54 - 0.46 * cos(2 * Dsp::doublePi * i / (FIR_TAPS_COUNT - 1)));
+    }
+
+    Run("butterworth_4_fir_257", design, taps, std::max(1, callsCount / 10));
+
+    return 0;
+}
+//----------------------------------------------------------------------------------
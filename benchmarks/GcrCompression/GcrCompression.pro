@@ -0,0 +1,14 @@
+include(../benchmarks.pri)
+
+TARGET = GcrCompressionBenchmark
+
+SOURCES += \
+    main.cpp \
+    $$PWD/../../src/Recording/BdfHeader.cpp \
+    $$PWD/../../src/Recording/BdfReader.cpp \
+    $$PWD/../../src/Recording/GcrConvert.cpp \
+    $$PWD/../../src/Recording/GcrFile.cpp \
+    $$PWD/../../src/Recording/MappedFile.cpp \
+    $$PWD/../../src/Recording/RiceCoder.cpp \
+    $$PWD/../../src/Filtering/dspfilter/SimdUtilities.cpp \
+    $$PWD/../../src/Filtering/dspfilter/SimdUtilitiesAvx.cpp
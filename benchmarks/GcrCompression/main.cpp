@@ -0,0 +1,332 @@
+/**
+@file main.cpp
+
+@brief Замер сжатия записей без потерь в формат GCR: степень сжатия, скорость сжатия и распаковки (МБ/с исходных данных BDF),
+запас по скорости относительно реального времени (для сжатия потоком записи) и чтение случайных окон по 1 секунде.
+После распаковки файл сравнивается с исходным побайтно (кроме количества записей в заголовке).
+
+Использование: GcrCompressionBenchmark [BDF файл или -] [длительность записи в секундах] [записей в блоке]
+Без файла создается запись с заголовком устройства (22 сигнала, 1000 Гц) и сигналами, похожими на ЭЭГ:
+альфа-ритм, сетевая наводка 50 Гц, дрейф и шум (единица младшего разряда - 0.022 мкВ). Без размера блока замеряются блоки 1, 10 и 100 записей.
+
+Результат в формате CSV: operation,chunk_records,records,input_mb,output_mb,ratio,total_ms,mb_per_s,realtime_x,verified
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include "../../src/Recording/BdfHeader.h"
+#include "../../src/Recording/GcrConvert.h"
+//----------------------------------------------------------------------------------
+using namespace GarantEEG;
+//----------------------------------------------------------------------------------
+//! Количество сигналов в заголовке устройства
+const int SIGNALS_COUNT = 22;
+
+//! Количество основных каналов
+const int CHANNELS_COUNT = 8;
+
+//! Количество записей данных в секунду
+const int RECORDS_PER_SECOND = 10;
+
+//! Отсчетов основного канала в записи данных при частоте 1000 Гц
+const int CHANNEL_SAMPLES = 100;
+
+//! Количество случайных окон по 1 секунде
+const int WINDOWS_COUNT = 2000;
+
+//! Отсчеты сигналов в записи данных: 8 каналов, 3 канала акселерометра, 10 сопротивлений, аннотации
+const int SIGNAL_SAMPLES[SIGNALS_COUNT] = { CHANNEL_SAMPLES, CHANNEL_SAMPLES, CHANNEL_SAMPLES, CHANNEL_SAMPLES, CHANNEL_SAMPLES, CHANNEL_SAMPLES, CHANNEL_SAMPLES, CHANNEL_SAMPLES,
+                                            5, 5, 5, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 30 };
+//----------------------------------------------------------------------------------
+/**
+ * @brief WriteField Записать поле заголовка BDF
+ */
+static void WriteField(vector<char> &header, int offset, int size, const char *text)
+{
+    memcpy(&header[offset], text, std::min((int)strlen(text), size));
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief MakeHeader Заголовок с раскладкой сигналов устройства
+ * @param recordsCount Количество записей данных
+ */
+static vector<char> MakeHeader(long long recordsCount)
+{
+    const int headerSize = BDF_MAIN_HEADER_SIZE + SIGNALS_COUNT * BDF_SIGNAL_HEADER_SIZE;
+    vector<char> header(headerSize, ' ');
+    char text[32];
+
+    sprintf(text, "%i", headerSize);
+    WriteField(header, 184, 8, text);
+    sprintf(text, "%lld", recordsCount);
+    WriteField(header, 236, 8, text);
+    WriteField(header, 244, 8, "0.1");
+    sprintf(text, "%i", SIGNALS_COUNT);
+    WriteField(header, 252, 4, text);
+
+    const int signals = BDF_MAIN_HEADER_SIZE;
+
+    for (int i = 0; i < SIGNALS_COUNT; i++)
+    {
+        WriteField(header, signals + 104 * SIGNALS_COUNT + 8 * i, 8, "-187500");
+        WriteField(header, signals + 112 * SIGNALS_COUNT + 8 * i, 8, "187500");
+        WriteField(header, signals + 120 * SIGNALS_COUNT + 8 * i, 8, "-8388608");
+        WriteField(header, signals + 128 * SIGNALS_COUNT + 8 * i, 8, "8388607");
+        sprintf(text, "%i", SIGNAL_SAMPLES[i]);
+        WriteField(header, signals + 216 * SIGNALS_COUNT + 8 * i, 8, text);
+    }
+
+    return header;
+}
+//----------------------------------------------------------------------------------
+//! Генератор псевдослучайных чисел для шума
+static unsigned int g_Random = 2166136261u;
+//----------------------------------------------------------------------------------
+/**
+ * @brief Noise Приближенно нормальный шум с единичной дисперсией
+ */
+static double Noise()
+{
+    double sum = 0.0;
+
+    for (int i = 0; i < 4; i++)
+    {
+        g_Random = g_Random * 1664525u + 1013904223u;
+        sum += (g_Random >> 8) / 16777216.0;
+    }
+
+    return (sum - 2.0) * 1.7320508;
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief CreateEegFile Создать BDF файл с сигналами, похожими на ЭЭГ
+ * @param path Путь к файлу
+ * @param recordsCount Количество записей данных
+ * @return true если файл создан
+ */
+static bool CreateEegFile(const char *path, long long recordsCount)
+{
+    vector<char> headerData = MakeHeader(recordsCount);
+    CBdfHeader header;
+
+    if (!header.Parse(&headerData[0], (int)headerData.size()))
+        return false;
+
+    FILE *file = fopen(path, "wb");
+
+    if (file == nullptr)
+        return false;
+
+    bool written = (fwrite(&headerData[0], headerData.size(), 1, file) == 1);
+    vector<unsigned char> record(header.RecordSize());
+    double drift[CHANNELS_COUNT] = { 0.0 };
+    const double pi = 3.14159265358979;
+
+    for (long long r = 0; r < recordsCount && written; r++)
+    {
+        std::fill(record.begin(), record.end(), 0);
+
+        for (int c = 0; c < CHANNELS_COUNT; c++)
+        {
+            unsigned char *ptr = &record[header.Signal(c).Offset];
+
+            for (int i = 0; i < CHANNEL_SAMPLES; i++, ptr += 3)
+            {
+                const double t = (r * CHANNEL_SAMPLES + i) / 1000.0;
+                drift[c] = drift[c] * 0.999 + Noise() * 20.0;
+
+                //Амплитуды в единицах младшего разряда: альфа-ритм ~20 мкВ, наводка ~4 мкВ, шум ~1 мкВ
+                double value = 900.0 * sin(2.0 * pi * 10.0 * t + c) * (0.6 + 0.4 * sin(2.0 * pi * 0.1 * t)) + 200.0 * sin(2.0 * pi * 50.0 * t) + drift[c] + Noise() * 40.0;
+                Pack24BitValue(ptr, (int)floor(value + 0.5));
+            }
+        }
+
+        for (int axis = 0; axis < 3; axis++)
+        {
+            unsigned char *ptr = &record[header.Signal(CHANNELS_COUNT + axis).Offset];
+
+            for (int i = 0; i < 5; i++, ptr += 3)
+                Pack24BitValue(ptr, (axis == 2 ? 16384 : 0) + (int)(Noise() * 30.0));
+        }
+
+        for (int i = 0; i < 10; i++)
+            Pack24BitValue(&record[header.Signal(CHANNELS_COUNT + 3 + i).Offset], 5000 + i * 100 + (int)(r / 600));
+
+        //Аннотация времени записи данных (TAL), остаток сигнала - нули
+        char annotation[32] = { 0 };
+        sprintf(annotation, "+%.1f%c%c", r / (double)RECORDS_PER_SECOND, 20, 20);
+        memcpy(&record[header.Signal(SIGNALS_COUNT - 1).Offset], annotation, strlen(annotation));
+
+        written = (fwrite(&record[0], record.size(), 1, file) == 1);
+    }
+
+    if (fclose(file) != 0)
+        written = false;
+
+    return written;
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief FileSize Получить размер файла (-1 если файл не открывается)
+ */
+static long long FileSize(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+
+    if (file == nullptr)
+        return -1;
+
+    long long size = FileSize64(file);
+    fclose(file);
+
+    return size;
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief CompareFiles Сравнить файлы побайтно, не учитывая поле количества записей в заголовке BDF
+ */
+static bool CompareFiles(const char *first, const char *second)
+{
+    FILE *a = fopen(first, "rb");
+    FILE *b = fopen(second, "rb");
+    bool equal = (a != nullptr && b != nullptr);
+
+    vector<char> bufferA(1 << 20);
+    vector<char> bufferB(1 << 20);
+    long long position = 0;
+
+    while (equal)
+    {
+        size_t sizeA = fread(&bufferA[0], 1, bufferA.size(), a);
+        size_t sizeB = fread(&bufferB[0], 1, bufferB.size(), b);
+
+        if (sizeA != sizeB)
+        {
+            equal = false;
+            break;
+        }
+
+        if (!sizeA)
+            break;
+
+        if (position == 0 && sizeA >= (size_t)BDF_MAIN_HEADER_SIZE)
+            memcpy(&bufferB[BDF_RECORDS_COUNT_OFFSET], &bufferA[BDF_RECORDS_COUNT_OFFSET], 8);
+
+        equal = (memcmp(&bufferA[0], &bufferB[0], sizeA) == 0);
+        position += (long long)sizeA;
+    }
+
+    if (a != nullptr)
+        fclose(a);
+
+    if (b != nullptr)
+        fclose(b);
+
+    return equal;
+}
+//----------------------------------------------------------------------------------
+static void PrintResult(const char *operation, int chunkRecords, long long records, double inputSize, double outputSize, double milliseconds, double seconds, bool verified)
+{
+    const double megabyte = 1024.0 * 1024.0;
+    const double rawSize = std::max(inputSize, outputSize);
+
+    printf("%s,%i,%lld,%.2f,%.2f,%.3f,%.2f,%.1f,%.0f,%i\n", operation, chunkRecords, records, inputSize / megabyte, outputSize / megabyte, (outputSize > 0.0 ? inputSize / outputSize : 0.0),
+           milliseconds, rawSize / megabyte / (milliseconds / 1000.0), seconds / (milliseconds / 1000.0), (verified ? 1 : 0));
+    fflush(stdout);
+}
+//----------------------------------------------------------------------------------
+static double ElapsedMilliseconds(const std::chrono::steady_clock::time_point &start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+//----------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    const bool generated = (argc < 2 || !strcmp(argv[1], "-"));
+    const string bdfPath = (generated ? "GcrCompressionBenchmark.bdf" : argv[1]);
+    const string gcrPath = "GcrCompressionBenchmark.gcr";
+    const string restoredPath = "GcrCompressionBenchmark.restored.bdf";
+    int seconds = (argc > 2 ? atoi(argv[2]) : 600);
+
+    if (seconds < 2)
+        seconds = 2;
+
+    vector<int> chunkSizes = { 1, GCR_DEFAULT_CHUNK_RECORDS, 100 };
+
+    if (argc > 3)
+        chunkSizes = { std::max(1, std::min(atoi(argv[3]), GCR_MAX_CHUNK_RECORDS)) };
+
+    if (generated && !CreateEegFile(bdfPath.c_str(), (long long)seconds * RECORDS_PER_SECOND))
+    {
+        fprintf(stderr, "can not create file %s\n", bdfPath.c_str());
+        return 1;
+    }
+
+    const double bdfSize = (double)FileSize(bdfPath.c_str());
+
+    printf("operation,chunk_records,records,input_mb,output_mb,ratio,total_ms,mb_per_s,realtime_x,verified\n");
+
+    for (int chunkRecords : chunkSizes)
+    {
+        auto start = std::chrono::steady_clock::now();
+        bool compressed = CompressBdfFile(bdfPath, gcrPath, chunkRecords);
+        double time = ElapsedMilliseconds(start);
+
+        CGcrReader reader;
+
+        if (!compressed || !reader.Open(gcrPath))
+        {
+            fprintf(stderr, "can not compress file %s\n", bdfPath.c_str());
+            return 1;
+        }
+
+        const long long recordsCount = reader.RecordsCount();
+        const double duration = recordsCount * reader.Header().RecordDuration();
+        const double gcrSize = (double)FileSize(gcrPath.c_str());
+
+        PrintResult("compress", chunkRecords, recordsCount, bdfSize, gcrSize, time, duration, true);
+
+        start = std::chrono::steady_clock::now();
+        bool decompressed = DecompressGcrFile(gcrPath, restoredPath);
+        time = ElapsedMilliseconds(start);
+
+        bool verified = (decompressed && CompareFiles(bdfPath.c_str(), restoredPath.c_str()));
+
+        PrintResult("decompress", chunkRecords, recordsCount, gcrSize, bdfSize, time, duration, verified);
+
+        //Случайные окна по 1 секунде: распаковываются только блоки окна
+        const int windowRecords = RECORDS_PER_SECOND;
+        vector<char> window((size_t)windowRecords * reader.Header().RecordSize());
+        unsigned int value = 12345u;
+        long long readRecords = 0;
+
+        start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < WINDOWS_COUNT && recordsCount > windowRecords; i++)
+        {
+            value = value * 1664525u + 1013904223u;
+            readRecords += reader.ReadRecords((long long)(value % (unsigned int)(recordsCount - windowRecords)), windowRecords, &window[0]);
+        }
+
+        time = ElapsedMilliseconds(start);
+
+        PrintResult("random_window_1s", chunkRecords, readRecords, gcrSize, (double)readRecords * reader.Header().RecordSize(), time, readRecords * reader.Header().RecordDuration(),
+                    (readRecords == (long long)WINDOWS_COUNT * windowRecords));
+
+        reader.Close();
+        remove(restoredPath.c_str());
+        remove(gcrPath.c_str());
+    }
+
+    if (generated)
+        remove(bdfPath.c_str());
+
+    return 0;
+}
+//----------------------------------------------------------------------------------
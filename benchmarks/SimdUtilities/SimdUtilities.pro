@@ -0,0 +1,7 @@
+include(../benchmarks.pri)
+
+TARGET = SimdUtilitiesBenchmark
+
+SOURCES += \
+    main.cpp \
+    $$DSPFILTER_SOURCES
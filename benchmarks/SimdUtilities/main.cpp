@@ -0,0 +1,184 @@
+/**
+@file main.cpp
+
+@brief Замер векторных реализаций Dsp::copy/add/multiply/convertInt24/deinterleave/interleave на всех доступных наборах инструкций
+
+Использование: SimdUtilitiesBenchmark [количество повторов]
+
+Результат в формате CSV: kernel,channels,samples,level,ns_per_call,speedup,identical
+(speedup - относительно скалярной реализации, identical - совпадение результата со скалярной реализацией)
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <functional>
+#include <vector>
+#include "../../src/Filtering/dspfilter/Utilities.h"
+//----------------------------------------------------------------------------------
+using std::vector;
+//----------------------------------------------------------------------------------
+//! Максимальное количество каналов
+const int MAX_CHANNELS = 32;
+
+//! Максимальное количество отсчетов на канал (фрэйм 1000 Гц)
+const int MAX_SAMPLES = 100;
+//----------------------------------------------------------------------------------
+//! Буферы замера: чередующиеся и раздельные данные обоих типов
+struct BENCHMARK_BUFFERS
+{
+    vector<float> InterleavedFloat;
+    vector<double> InterleavedDouble;
+    vector<float> PlanarFloat;
+    vector<double> PlanarDouble;
+    vector<unsigned char> Int24;
+    float *PlanarFloatChannels[MAX_CHANNELS];
+    double *PlanarDoubleChannels[MAX_CHANNELS];
+
+    BENCHMARK_BUFFERS()
+    : InterleavedFloat(MAX_CHANNELS * MAX_SAMPLES), InterleavedDouble(MAX_CHANNELS * MAX_SAMPLES),
+      PlanarFloat(MAX_CHANNELS * MAX_SAMPLES), PlanarDouble(MAX_CHANNELS * MAX_SAMPLES), Int24(MAX_CHANNELS * MAX_SAMPLES * 3)
+    {
+        for (int i = 0; i < MAX_CHANNELS * MAX_SAMPLES; i++)
+        {
+            InterleavedDouble[i] = 1e-6 * ((i * 7919) % 8388607 - 4194303);
+            InterleavedFloat[i] = (float)InterleavedDouble[i];
+            PlanarDouble[i] = InterleavedDouble[(i * 31) % (MAX_CHANNELS * MAX_SAMPLES)];
+            PlanarFloat[i] = (float)PlanarDouble[i];
+
+            //24-битные отсчеты во всем диапазоне, включая отрицательные
+            int value = (int)(((unsigned int)i * 2082697u) % 16777216u) - 8388608;
+            Int24[i * 3] = (unsigned char)(value & 0xFF);
+            Int24[i * 3 + 1] = (unsigned char)((value >> 8) & 0xFF);
+            Int24[i * 3 + 2] = (unsigned char)((value >> 16) & 0xFF);
+        }
+
+        for (int c = 0; c < MAX_CHANNELS; c++)
+        {
+            PlanarFloatChannels[c] = &PlanarFloat[c * MAX_SAMPLES];
+            PlanarDoubleChannels[c] = &PlanarDouble[c * MAX_SAMPLES];
+        }
+    }
+};
+//----------------------------------------------------------------------------------
+/**
+ * @brief Measure Замерить время одного вызова
+ * @param kernel Замеряемая операция
+ * @param repeats Количество повторов
+ * @return Время в наносекундах
+ */
+static double Measure(const std::function<void()> &kernel, int repeats)
+{
+    kernel();
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < repeats; i++)
+        kernel();
+
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1e9 / repeats;
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief Run Замерить операцию на всех наборах инструкций и сравнить результат со скалярным
+ * @param name Название операции
+ * @param channels Количество каналов
+ * @param samples Количество отсчетов на канал
+ * @param repeats Количество повторов
+ * @param kernel Операция (результат - в буфере output)
+ * @param output Буфер результата
+ * @param outputSize Размер результата в байтах
+ */
+static void Run(const char *name, int channels, int samples, int repeats, const std::function<void()> &kernel, const void *output, size_t outputSize)
+{
+    vector<char> reference(outputSize);
+    double referenceTime = 0.0;
+
+    for (int level = Dsp::Simd::levelScalar; level <= Dsp::Simd::getSupportedLevel(); level++)
+    {
+        Dsp::Simd::setLevel((Dsp::Simd::Level)level);
+
+        double time = Measure(kernel, repeats);
+        bool identical = true;
+
+        if (level == Dsp::Simd::levelScalar)
+        {
+            //Операции на месте (add, multiply) повторяются, поэтому эталон снимается отдельным прогоном с тем же количеством вызовов
+            memcpy(&reference[0], output, outputSize);
+            referenceTime = time;
+        }
+        else
+            identical = (memcmp(&reference[0], output, outputSize) == 0);
+
+        printf("%s,%i,%i,%s,%.1f,%.2f,%i\n", name, channels, samples, Dsp::Simd::getLevelName((Dsp::Simd::Level)level), time, referenceTime / time, identical ? 1 : 0);
+        fflush(stdout);
+    }
+}
+//----------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    int repeats = (argc > 1 ? atoi(argv[1]) : 200000);
+
+    if (repeats < 1)
+        repeats = 1;
+
+    const int channelsCounts[] = { 8, 16, 32 };
+    const int samplesCounts[] = { 25, 50, 100 };
+
+    BENCHMARK_BUFFERS source;
+    BENCHMARK_BUFFERS target;
+
+    printf("kernel,channels,samples,level,ns_per_call,speedup,identical\n");
+
+    for (int samples : samplesCounts)
+    {
+        const int length = MAX_CHANNELS * samples;
+
+        Run("copy_double_to_float", 1, length, repeats, [&]() { Dsp::copy(length, &target.PlanarFloat[0], &source.PlanarDouble[0]); },
+            &target.PlanarFloat[0], length * sizeof(float));
+
+        Run("copy_float_to_double", 1, length, repeats, [&]() { Dsp::copy(length, &target.PlanarDouble[0], &source.PlanarFloat[0]); },
+            &target.PlanarDouble[0], length * sizeof(double));
+
+        Run("convert_int24_to_float", 1, length, repeats, [&]() { Dsp::convertInt24(length, &target.PlanarFloat[0], &source.Int24[0], 0.0447f, 0.5f); },
+            &target.PlanarFloat[0], length * sizeof(float));
+
+        Run("convert_int24_to_double", 1, length, repeats, [&]() { Dsp::convertInt24(length, &target.PlanarDouble[0], &source.Int24[0], 0.000447 / 10.0 / 1000.0, 0.0); },
+            &target.PlanarDouble[0], length * sizeof(double));
+
+        //Операции на месте: перед каждым вызовом буфер восстанавливается, чтобы значения не уходили в бесконечность
+        Run("add_float", 1, length, repeats, [&]() {
+                memcpy(&target.PlanarFloat[0], &source.InterleavedFloat[0], length * sizeof(float));
+                Dsp::add(length, &target.PlanarFloat[0], &source.PlanarFloat[0]);
+            }, &target.PlanarFloat[0], length * sizeof(float));
+
+        Run("multiply_double", 1, length, repeats, [&]() {
+                memcpy(&target.PlanarDouble[0], &source.InterleavedDouble[0], length * sizeof(double));
+                Dsp::multiply(length, &target.PlanarDouble[0], 0.000447 / 10.0 / 1000.0);
+            }, &target.PlanarDouble[0], length * sizeof(double));
+
+        for (int channels : channelsCounts)
+        {
+            Run("deinterleave_double_to_float", channels, samples, repeats, [&]() { Dsp::deinterleave(channels, samples, target.PlanarFloatChannels, &source.InterleavedDouble[0]); },
+                &target.PlanarFloat[0], channels * MAX_SAMPLES * sizeof(float));
+
+            Run("deinterleave_double_to_double", channels, samples, repeats, [&]() { Dsp::deinterleave(channels, samples, target.PlanarDoubleChannels, &source.InterleavedDouble[0]); },
+                &target.PlanarDouble[0], channels * MAX_SAMPLES * sizeof(double));
+
+            Run("deinterleave_float_to_float", channels, samples, repeats, [&]() { Dsp::deinterleave(channels, samples, target.PlanarFloatChannels, &source.InterleavedFloat[0]); },
+                &target.PlanarFloat[0], channels * MAX_SAMPLES * sizeof(float));
+
+            Run("interleave_float_to_double", channels, samples, repeats, [&]() { Dsp::interleave(channels, (size_t)samples, &target.InterleavedDouble[0], source.PlanarFloatChannels); },
+                &target.InterleavedDouble[0], channels * samples * sizeof(double));
+
+            Run("interleave_double_to_double", channels, samples, repeats, [&]() { Dsp::interleave(channels, (size_t)samples, &target.InterleavedDouble[0], source.PlanarDoubleChannels); },
+                &target.InterleavedDouble[0], channels * samples * sizeof(double));
+        }
+    }
+
+    return 0;
+}
+//----------------------------------------------------------------------------------
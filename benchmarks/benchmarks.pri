@@ -0,0 +1,24 @@
+QT       -= core gui
+
+CONFIG   += console c++11
+CONFIG   -= app_bundle qt
+
+#Заголовки библиотеки подключаются как "../GarantEEG_API/include/...", поэтому каталог библиотеки должен называться GarantEEG_API
+INCLUDEPATH += $$PWD/..
+
+unix: DEFINES += __cdecl=
+unix: LIBS += -lpthread
+
+DSPFILTER_SOURCES = \
+    $$PWD/../src/Filtering/dspfilter/Biquad.cpp \
+    $$PWD/../src/Filtering/dspfilter/Butterworth.cpp \
+    $$PWD/../src/Filtering/dspfilter/Cascade.cpp \
+    $$PWD/../src/Filtering/dspfilter/Filter.cpp \
+    $$PWD/../src/Filtering/dspfilter/FrequencyResponse.cpp \
+    $$PWD/../src/Filtering/dspfilter/Param.cpp \
+    $$PWD/../src/Filtering/dspfilter/PoleFilter.cpp \
+    $$PWD/../src/Filtering/dspfilter/PrototypeCache.cpp \
+    $$PWD/../src/Filtering/dspfilter/RootFinder.cpp \
+    $$PWD/../src/Filtering/dspfilter/SimdUtilities.cpp \
+    $$PWD/../src/Filtering/dspfilter/SimdUtilitiesAvx.cpp \
+    $$PWD/../src/Filtering/dspfilter/State.cpp
@@ -0,0 +1,16 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    BdfReader \
+    BdfWriter \
+    CascadeBlock \
+    Denormals \
+    DesignSetup \
+    DspFilters \
+    FilterWorkerPool \
+    FixedPointFilter \
+    FirFilter \
+    FloatState \
+    FrequencyResponse \
+    GcrCompression \
+    SimdUtilities
@@ -74,6 +74,14 @@ public:
 	 */
     virtual bool IsPaused() const = 0;
 
+	/**
+	 * @brief SetReplayOptions Установить параметры воспроизведения записи (только для DT_REPLAY, можно менять во время воспроизведения)
+	 * @param speed Скорость воспроизведения (1.0 - реальное время, N - в N раз быстрее, 0 - максимальная скорость)
+	 * @param loop Воспроизводить файл по кругу (иначе в конце файла запись останавливается и сообщается DCS_CONNECTION_CLOSED)
+	 * @return true если параметры корректны и устройство поддерживает воспроизведение
+	 */
+    virtual bool SetReplayOptions(double speed, bool loop) = 0;
+
 	/**
 	 * @brief StartRecord Начать запись данных в файл
 	 * @param userName Имя респондента
@@ -82,6 +90,15 @@ public:
 	 */
     virtual bool StartRecord(const char *userName, const char *filePath = nullptr) = 0;
 
+	/**
+	 * @brief StartRecord Начать запись данных в файл с момента в прошлом (из истории, см. SetRecordingHistory)
+	 * @param userName Имя респондента
+	 * @param filePath Путь к BDF файлу, в который нужно записывать данные (nullptr - файл в папке SaveData)
+	 * @param preTriggerSeconds Сколько секунд истории записать перед текущим моментом (записывается доступная история, целыми секундами)
+	 * @return true если запись в файл началась успешно, false если запись не началась
+	 */
+    virtual bool StartRecord(const char *userName, const char *filePath, int preTriggerSeconds) = 0;
+
 	/**
 	 * @brief StopRecord Остановить запись данных в файл
 	 */
@@ -109,6 +126,74 @@ public:
 	 */
     virtual bool IsRecordPaused() const = 0;
 
+	/**
+	 * @brief SetRecordingBuffers Установить буферизацию записи данных в файл (применяется со следующего StartRecord)
+	 * @param buffersCount Количество буферов (от 2 до 8)
+	 * @param bufferSeconds Длительность данных в одном буфере в секундах (от 1 до 30, при записи с историей буферы увеличиваются, чтобы вместить ее)
+	 * @return true если параметры корректны
+	 */
+    virtual bool SetRecordingBuffers(int buffersCount, int bufferSeconds) = 0;
+
+	/**
+	 * @brief SetRecordingMode Установить способ записи данных в файл (применяется со следующего StartRecord)
+	 * @param mode Способ записи из GARANT_EEG_RECORDING_MODE
+	 * @param flushInterval Интервал асинхронного сброса данных на диск для RM_MAPPED в миллисекундах (от 100 до 60000)
+	 * @return true если параметры корректны
+	 */
+    virtual bool SetRecordingMode(int mode, int flushInterval) = 0;
+
+	/**
+	 * @brief SetRecordingDurability Установить политику сохранности записи при аварийном завершении (применяется со следующего StartRecord)
+	 * @param durability Политика из GARANT_EEG_RECORDING_DURABILITY
+	 * @param commitInterval Интервал передачи данных системе и обновления количества записей в заголовке в миллисекундах (от 100 до 60000)
+	 * @param syncInterval Интервал принудительной записи данных на диск для RD_SYNC в миллисекундах (от 100 до 600000, не чаще commitInterval)
+	 * @return true если параметры корректны
+	 */
+    virtual bool SetRecordingDurability(int durability, int commitInterval, int syncInterval) = 0;
+
+	/**
+	 * @brief SetRecordingDerivedSignals Установить производные сигналы, записываемые вместе с исходными данными в дополнительный файл
+	 * с той же длительностью записей данных, тем же способом и политикой сохранности (применяется со следующего StartRecord)
+	 * @param signals Флаги GARANT_EEG_RECORDING_DERIVED
+	 * @return true если флаги корректны
+	 */
+    virtual bool SetRecordingDerivedSignals(int signals) = 0;
+
+	/**
+	 * @brief SetRecordingHistory Установить длительность истории исходных данных в памяти, с которой может начинаться запись
+	 * (StartRecord с preTriggerSeconds). История накапливается все время трансляции и сбрасывается при ее перезапуске
+	 * @param seconds Длительность истории в секундах (0 - без истории, до 60)
+	 * @return true если длительность корректна
+	 */
+    virtual bool SetRecordingHistory(int seconds) = 0;
+
+	/**
+	 * @brief SetRecordingSegmentation Установить разбиение записи на сегменты (применяется со следующего StartRecord).
+	 * Сегменты - отдельные файлы с полным заголовком ("запись_0001.bdf", "запись_0002.bdf", ...), переход без потери записей данных,
+	 * границы сегментов кратны секунде. О закрытии каждого сегмента сообщается состоянием DRS_SEGMENT_CLOSED (из потока записи,
+	 * для последнего сегмента - из StopRecord перед DRS_RECORD_STOPPED). Дополнительный файл производных сигналов делится
+	 * на сегменты с теми же границами (сегмент, целиком приходящийся на историю до начала записи, для него не создается)
+	 * @param segmentSeconds Длительность сегмента в секундах (0 - без ограничения, до 86400)
+	 * @param segmentMegabytes Максимальный размер сегмента в мегабайтах (0 - без ограничения; для RM_COMPRESSED - размер несжатых данных)
+	 * @return true если параметры корректны
+	 */
+    virtual bool SetRecordingSegmentation(int segmentSeconds, int segmentMegabytes) = 0;
+
+	/**
+	 * @brief GetLastClosedSegment Получить путь к последнему закрытому сегменту записи (например, в коллбэке DRS_SEGMENT_CLOSED)
+	 * @param filePath Буфер для пути к файлу
+	 * @param size Размер буфера
+	 * @return true если сегмент был закрыт и путь помещается в буфер
+	 */
+    virtual bool GetLastClosedSegment(char *filePath, int size) = 0;
+
+	/**
+	 * @brief GetRecordingStatistics Получить статистику записи данных в файл (текущей или последней записи)
+	 * @param statistics Указатель на структуру статистики
+	 * @return true если статистика получена
+	 */
+    virtual bool GetRecordingStatistics(GARANT_EEG_RECORDING_STATISTICS *statistics) = 0;
+
 	/**
 	 * @brief SetAutoReconnection Установить состояние автопереподключения к устройству при разрыве соединения
 	 * @param enable Новое состояние
@@ -169,6 +254,20 @@ public:
 	 */
     virtual int GetRate() const = 0;
 
+	/**
+	 * @brief SetOutputRate Установить частоту дискретизации данных, передаваемых в коллбэк приема данных.
+	 * Понижение частоты выполняется до фильтрации, поэтому фильтры работают на выходной частоте и должны настраиваться на нее. Запись в файл ведется на частоте устройства.
+	 * @param rate Выходная частота (0 или частота не меньше частоты устройства - без понижения частоты)
+	 * @return true если частота установлена, false если частота некорректна
+	 */
+    virtual bool SetOutputRate(int rate) = 0;
+
+	/**
+	 * @brief GetOutputRate Получить частоту дискретизации данных, передаваемых в коллбэк приема данных
+	 * @return Частота дискретизации данных
+	 */
+    virtual int GetOutputRate() const = 0;
+
 	/**
 	 * @brief GetBatteryStatus Получить уровень заряда аккумулятора
 	 * @return Значение в процентах
@@ -213,6 +312,17 @@ public:
 	 */
     virtual const CAbstractFilter* AddFilter(int type, int order, int channelsCount, const int *channelsList) = 0;
 
+	/**
+	 * @brief AddFilter Добавить фильтр с указанием каналов и формы реализации звеньев БИХ фильтра
+	 * @param type Тип фильтра
+	 * @param order Порядок фильтра
+	 * @param channelsCount Количество каналов
+	 * @param channelsList Список каналов
+	 * @param stateForm Форма реализации звеньев из GARANT_EEG_FILTER_STATE_FORM (учитывается для FT_BUTTERWORTH)
+	 * @return Указатель на созданный фильтр или nullptr в случае, если не удалось создать фильтр с указанными параметрами
+	 */
+    virtual const CAbstractFilter* AddFilter(int type, int order, int channelsCount, const int *channelsList, int stateForm) = 0;
+
 	/**
 	 * @brief SetupFilter Установить настройки фильтра
 	 * @param filter Указатель на фильтр для установки настроек
@@ -223,6 +333,100 @@ public:
 	 */
     virtual bool SetupFilter(const CAbstractFilter *filter, int rate, int lowFrequency, int hightFrequency) = 0;
 
+	/**
+	 * @brief SetupFilter Установить настройки фильтра с плавным переходом от текущих настроек (без сброса состояния фильтра и переходного процесса)
+	 * @param filter Указатель на фильтр для установки настроек
+	 * @param rate Частота дискретизации данных
+	 * @param lowFrequency Нижняя частота среза
+	 * @param hightFrequency Верхняя частота среза
+	 * @param transitionSamples Количество отсчетов, за которое коэффициенты фильтра плавно перейдут к новым значениям (0 - мгновенное применение)
+	 * @return true если настройки применены, false если нет
+	 */
+    virtual bool SetupFilter(const CAbstractFilter *filter, int rate, int lowFrequency, int hightFrequency, int transitionSamples) = 0;
+
+	/**
+	 * @brief SetupNotchFilter Установить настройки гребенчатого режекторного фильтра сетевой наводки (FT_NOTCH_COMB)
+	 * @param filter Указатель на фильтр для установки настроек
+	 * @param rate Частота дискретизации данных
+	 * @param frequency Номинальная частота сети (50 или 60 Гц)
+	 * @param q Добротность каждой режекции (ширина режекции - частота гармоники / q)
+	 * @param adaptive Отслеживать реальную частоту сети по первому каналу фильтра и плавно перестраивать режекции
+	 * @param transitionSamples Количество отсчетов, за которое коэффициенты фильтра плавно перейдут к новым значениям (0 - мгновенное применение)
+	 * @return true если настройки применены, false если нет
+	 */
+    virtual bool SetupNotchFilter(const CAbstractFilter *filter, int rate, double frequency, double q, bool adaptive, int transitionSamples) = 0;
+
+	/**
+	 * @brief GetNotchFilterFrequency Получить текущую частоту режекции основной гармоники (при отслеживании - отслеженная частота сети)
+	 * @param filter Указатель на фильтр
+	 * @return Частота или -1, если фильтр не является гребенчатым режекторным фильтром
+	 */
+    virtual double GetNotchFilterFrequency(const CAbstractFilter *filter) = 0;
+
+	/**
+	 * @brief SetFixedPointFilterOptions Установить параметры целочисленного фильтра (FT_BUTTERWORTH_FIXED)
+	 * @param filter Указатель на фильтр
+	 * @param rounding Режим округления из GARANT_EEG_FIXED_POINT_ROUNDING
+	 * @param saturation true - насыщение при переполнении, false - циклический перенос
+	 * @return true если параметры применены, false если фильтр не найден, не является целочисленным или режим не поддерживается
+	 */
+    virtual bool SetFixedPointFilterOptions(const CAbstractFilter *filter, int rounding, bool saturation) = 0;
+
+	/**
+	 * @brief SetFilterNumericsMode Установить режим борьбы с денормализованными числами для БИХ фильтра
+	 * @param filter Указатель на фильтр
+	 * @param mode Режим из GARANT_EEG_FILTER_NUMERICS_MODE (FNM_FLUSH_TO_ZERO - FTZ/DAZ в потоке фильтрации без добавления константы к отсчетам)
+	 * @return true если режим применен, false если фильтр не найден или не поддерживает режим
+	 */
+    virtual bool SetFilterNumericsMode(const CAbstractFilter *filter, int mode) = 0;
+
+	/**
+	 * @brief GetFilterStateSize Получить размер буфера для сохранения состояния фильтра
+	 * @param filter Указатель на фильтр
+	 * @return Размер в байтах или 0, если фильтр не найден или не поддерживает сохранение состояния
+	 */
+    virtual int GetFilterStateSize(const CAbstractFilter *filter) = 0;
+
+	/**
+	 * @brief SaveFilterState Сохранить состояние фильтра (линии задержки звеньев всех каналов) для быстрого "теплого" перезапуска
+	 * @param filter Указатель на фильтр
+	 * @param buffer Буфер для записи
+	 * @param size Размер буфера (не меньше GetFilterStateSize)
+	 * @return true если состояние сохранено
+	 */
+    virtual bool SaveFilterState(const CAbstractFilter *filter, void *buffer, int size) = 0;
+
+	/**
+	 * @brief RestoreFilterState Восстановить сохраненное состояние фильтра (тип, порядок, форма звеньев, каналы и частоты фильтра должны совпадать с сохраненными)
+	 * @param filter Указатель на фильтр
+	 * @param buffer Сохраненное состояние
+	 * @param size Размер сохраненного состояния
+	 * @return true если состояние восстановлено
+	 */
+    virtual bool RestoreFilterState(const CAbstractFilter *filter, const void *buffer, int size) = 0;
+
+	/**
+	 * @brief SetFilterSteadyStateInit Включить инициализацию состояния фильтра по первому отсчету после подключения или возобновления трансляции (установившийся режим для постоянного сигнала, переходный процесс почти отсутствует)
+	 * @param filter Указатель на фильтр
+	 * @param enabled true - включить (восстановленное после перезапуска состояние имеет приоритет)
+	 * @return true если настройка применена, false если фильтр не найден или не поддерживает инициализацию
+	 */
+    virtual bool SetFilterSteadyStateInit(const CAbstractFilter *filter, bool enabled) = 0;
+
+	/**
+	 * @brief GetFiltersResponse Рассчитать частотную характеристику цепочки фильтров на сетке частот (для отображения)
+	 * @param filters Список фильтров цепочки (характеристики перемножаются)
+	 * @param filtersCount Количество фильтров
+	 * @param pointsCount Количество точек сетки
+	 * @param firstFrequency Первая частота сетки в Гц
+	 * @param lastFrequency Последняя частота сетки в Гц
+	 * @param logarithmic true - логарифмическая сетка (частоты больше 0), false - равномерная
+	 * @param magnitude Буфер для модуля характеристики (pointsCount значений) или nullptr
+	 * @param phase Буфер для фазы характеристики в радианах (pointsCount значений) или nullptr
+	 * @return true если характеристика рассчитана, false если фильтр не найден или не поддерживает расчет характеристики
+	 */
+    virtual bool GetFiltersResponse(const CAbstractFilter * const *filters, int filtersCount, int pointsCount, double firstFrequency, double lastFrequency, bool logarithmic, double *magnitude, double *phase) = 0;
+
 	/**
 	 * @brief RemoveFilter Удалить фильтр
 	 * @param filter Указатель на фильтр для удаления
@@ -234,6 +438,18 @@ public:
 	 */
     virtual void RemoveAllFilters() = 0;
 
+	/**
+	 * @brief SetFilterThreadsCount Установить количество рабочих потоков для параллельной фильтрации каналов (имеет смысл при большом количестве каналов)
+	 * @param count Количество потоков (0 - фильтрация в потоке приема данных)
+	 */
+    virtual void SetFilterThreadsCount(int count) = 0;
+
+	/**
+	 * @brief GetFilterThreadsCount Получить количество рабочих потоков для параллельной фильтрации каналов
+	 * @return Количество потоков
+	 */
+    virtual int GetFilterThreadsCount() const = 0;
+
 
 
 	/**
@@ -265,6 +481,46 @@ public:
 //! Функция создания устройства
 extern "C" __declspec(dllexport) IGarantEEG* __cdecl CreateDevice(GARANT_EEG_DEVICE_TYPE type);
 //----------------------------------------------------------------------------------
+/**
+ * @brief FilterRecordZeroPhase Функция фильтрации записанного BDF файла с нулевой фазой (прямой и обратный проход, семантика filtfilt)
+ * @param inputFilePath Путь к исходному BDF файлу
+ * @param outputFilePath Путь к результирующему BDF файлу
+ * @param type Тип фильтра
+ * @param order Порядок фильтра
+ * @param lowFrequency Нижняя частота среза (больше 0, фильтр полосовой)
+ * @param hightFrequency Верхняя частота среза (меньше половины частоты дискретизации)
+ * @param channelsCount Количество фильтруемых каналов
+ * @param channelsList Список фильтруемых каналов (нумерация сигналов BDF с 1), остальные сигналы копируются без изменений
+ * @param threadsCount Количество потоков обработки (0 - по количеству ядер)
+ * @return true если фильтрация прошла успешно
+ */
+extern "C" __declspec(dllexport) bool __cdecl FilterRecordZeroPhase(const char *inputFilePath, const char *outputFilePath, int type, int order, int lowFrequency, int hightFrequency, int channelsCount, const int *channelsList, int threadsCount);
+//----------------------------------------------------------------------------------
+/**
+ * @brief RepairRecord Функция восстановления BDF файла после аварийного завершения записи (файл исправляется на месте)
+ * @param filePath Путь к BDF файлу
+ * @param result Указатель на результат восстановления (может быть nullptr)
+ * @return true если файл корректен или восстановлен
+ */
+extern "C" __declspec(dllexport) bool __cdecl RepairRecord(const char *filePath, GARANT_EEG_RECORD_REPAIR_RESULT *result);
+//----------------------------------------------------------------------------------
+/**
+ * @brief CompressRecord Функция сжатия BDF файла без потерь в формат GCR (блоки с произвольным доступом, линейное предсказание и коды Райса)
+ * @param bdfFilePath Путь к BDF файлу
+ * @param gcrFilePath Путь к создаваемому GCR файлу
+ * @param chunkRecords Количество записей данных в блоке (от 1 до 600, 10 - одна секунда)
+ * @return true если файл сжат без ошибок
+ */
+extern "C" __declspec(dllexport) bool __cdecl CompressRecord(const char *bdfFilePath, const char *gcrFilePath, int chunkRecords);
+//----------------------------------------------------------------------------------
+/**
+ * @brief DecompressRecord Функция восстановления BDF файла из формата GCR (также записи, не закрытой после аварийного завершения)
+ * @param gcrFilePath Путь к GCR файлу
+ * @param bdfFilePath Путь к создаваемому BDF файлу
+ * @return true если все записи данных восстановлены без ошибок
+ */
+extern "C" __declspec(dllexport) bool __cdecl DecompressRecord(const char *gcrFilePath, const char *bdfFilePath);
+//----------------------------------------------------------------------------------
 } //namespace GarantEEG
 //----------------------------------------------------------------------------------
 #endif // GARANT_EEG_API_CPP_H
@@ -19,7 +19,9 @@ namespace GarantEEG
 enum GARANT_EEG_DEVICE_TYPE
 {
 	//! Базовый класс для работы с устройством GarantEEG
-	DT_GARANT = 0
+	DT_GARANT = 0,
+	//! Воспроизведение записанного BDF (GCR) файла через тот же конвейер обработки (в Start вместо хоста - путь к файлу)
+	DT_REPLAY
 };
 //----------------------------------------------------------------------------------
 //! Основные типы фильтров
@@ -28,7 +30,82 @@ enum GARANT_EEG_FILTER_TYPE
 	//! Неизвестный фильтр, не валидно
 	FT_UNKNOWN = 0,
 	//! Частотный фильтр Butterworth
-	FT_BUTTERWORTH
+	FT_BUTTERWORTH,
+	//! Полосовой КИХ фильтр с линейной фазой (порядок - количество коэффициентов - 1, до 16384)
+	FT_FIR,
+	//! Гребенчатый режекторный фильтр сетевой наводки (порядок - количество гармоник, до 10)
+	FT_NOTCH_COMB,
+	//! Полосовой фильтр Butterworth в фиксированной точке на исходных 24-битных отсчетах (порядок до 8, результат не зависит от платформы)
+	FT_BUTTERWORTH_FIXED
+};
+//----------------------------------------------------------------------------------
+//! Формы реализации звеньев БИХ фильтров (состояние каналов)
+enum GARANT_EEG_FILTER_STATE_FORM
+{
+	//! Прямая форма II (по умолчанию, минимальное состояние)
+	FSF_DIRECT_FORM_II = 0,
+	//! Прямая форма I (устойчива к переполнению промежуточных значений)
+	FSF_DIRECT_FORM_I,
+	//! Транспонированная прямая форма II (меньший шум округления)
+	FSF_TRANSPOSED_DIRECT_FORM_II,
+	//! Прямая форма I с состоянием одинарной точности (вдвое меньше обращений к памяти; погрешность относительно double до 1e-4 от пика при 250-500 Гц и до 5e-4 при 1000 Гц для полос от 1 Гц; для полос ниже 0.5 Гц не рекомендуется)
+	FSF_DIRECT_FORM_I_FLOAT,
+	//! Транспонированная прямая форма II с состоянием одинарной точности (погрешность примерно вдвое больше, чем у FSF_DIRECT_FORM_I_FLOAT)
+	FSF_TRANSPOSED_DIRECT_FORM_II_FLOAT
+};
+//----------------------------------------------------------------------------------
+//! Режимы борьбы с денормализованными числами в БИХ фильтрах
+enum GARANT_EEG_FILTER_NUMERICS_MODE
+{
+	//! Добавление знакопеременной малой константы к каждому отсчету (по умолчанию)
+	FNM_ANTI_DENORMAL = 0,
+	//! Аппаратный сброс денормализованных чисел в ноль (FTZ/DAZ) в потоке фильтрации, без добавления константы
+	FNM_FLUSH_TO_ZERO
+};
+//----------------------------------------------------------------------------------
+//! Режимы округления результатов звеньев целочисленного фильтра (FT_BUTTERWORTH_FIXED)
+enum GARANT_EEG_FIXED_POINT_ROUNDING
+{
+	//! Округление вниз с переносом остатка на следующий отсчет (по умолчанию, минимальный шум на низких частотах)
+	FPR_ERROR_FEEDBACK = 0,
+	//! Округление к ближайшему
+	FPR_NEAREST,
+	//! Округление вниз (отбрасывание дробной части)
+	FPR_TRUNCATE
+};
+//----------------------------------------------------------------------------------
+//! Способы записи данных в файл
+enum GARANT_EEG_RECORDING_MODE
+{
+	//! Буферы в памяти, запись в файл отдельным потоком (по умолчанию)
+	RM_BUFFERED = 0,
+	//! Отображение файла в память: записи данных копируются прямо в файл, место выделяется большими участками, сброс на диск асинхронный с заданным интервалом
+	RM_MAPPED,
+	//! Сжатие без потерь в формат GCR (линейное предсказание и коды Райса) потоком записи, буферы как при RM_BUFFERED
+	RM_COMPRESSED
+};
+//----------------------------------------------------------------------------------
+//! Политики сохранности записи при аварийном завершении (сбой программы, отключение питания)
+enum GARANT_EEG_RECORDING_DURABILITY
+{
+	//! Количество записей в заголовке исправляется только при остановке записи (по умолчанию)
+	RD_NONE = 0,
+	//! Данные периодически передаются системе и количество записей в заголовке обновляется на месте
+	RD_COMMIT,
+	//! Данные периодически передаются системе, с заданным интервалом принудительно записываются на диск (fdatasync / FlushFileBuffers), после чего обновляется количество записей в заголовке
+	RD_SYNC
+};
+//----------------------------------------------------------------------------------
+//! Производные сигналы, записываемые в дополнительный файл рядом с записью ("запись.derived.bdf"), флаги
+enum GARANT_EEG_RECORDING_DERIVED
+{
+	//! Дополнительный файл не создается (по умолчанию)
+	RDS_NONE = 0,
+	//! Основные каналы после понижения частоты и фильтров, как в коллбэке приема данных (выходная частота должна быть кратна 10 Гц).
+	//! Если выходная частота изменена во время записи, до ее возврата каналы повторяют последнее записанное значение
+	RDS_FILTERED = 1,
+	//! Основные каналы относительно среднего по всем основным каналам (усредненный референт), частота устройства
+	RDS_AVERAGE_REFERENCE = 2
 };
 //----------------------------------------------------------------------------------
 //! Состояния подключения к устройству
@@ -66,7 +143,11 @@ enum GARANT_EEG_DEVICE_RECORDING_STATE
 	//! Запись данных в файл возобновлена
 	DRS_RECORD_RESUMED,
 	//! Запись данных в файл остановлена
-	DRS_RECORD_STOPPED
+	DRS_RECORD_STOPPED,
+	//! Сегмент записи закрыт и готов к обработке (путь - GetLastClosedSegment)
+	DRS_SEGMENT_CLOSED,
+	//! Сегмент записи закрыт с ошибками записи (путь - GetLastClosedSegment)
+	DRS_SEGMENT_WRITE_ERROR
 };
 //----------------------------------------------------------------------------------
 ////////////////////////////////////////////////////////////////////////////////////
@@ -111,7 +192,7 @@ struct GARANT_EEG_DATA
 	//! Метка времени текущего пакета
 	double Time;
 
-	//! Количество наборов данных по каналам
+	//! Количество наборов данных по каналам (при понижении частоты выходных данных может меняться от фрэйма к фрэйму)
 	int DataRecordsCount;
 
 	//! Сырые данные по каналам (реальное количество - DataRecordsCount)
@@ -130,6 +211,68 @@ struct GARANT_EEG_DATA
 	char Annitations[30];
 };
 //----------------------------------------------------------------------------------
+//! Статистика записи данных в файл (поток приема передает заполненные буферы потоку записи)
+struct GARANT_EEG_RECORDING_STATISTICS
+{
+	//! Количество переданных на запись записей данных
+	long long RecordsCount;
+
+	//! Количество записанных в файл байт данных (RM_COMPRESSED - сжатых)
+	long long BytesWritten;
+
+	//! Количество записанных буферов (RM_MAPPED - количество сбросов на диск)
+	int BuffersWritten;
+
+	//! Максимальное количество заполненных буферов в очереди записи
+	int MaxQueueDepth;
+
+	//! Количество ожиданий потоком приема свободного буфера (RM_MAPPED - следующего участка файла)
+	int StallsCount;
+
+	//! Суммарное время ожидания свободного буфера (в миллисекундах)
+	double StallTime;
+
+	//! Максимальное время одного ожидания свободного буфера (в миллисекундах)
+	double MaxStallTime;
+
+	//! Суммарное время записи буферов в файл (RM_MAPPED - сбросов и выделения участков, в миллисекундах)
+	double WriteTime;
+
+	//! Максимальное время записи одного буфера (RM_MAPPED - одного сброса или выделения участка, в миллисекундах)
+	double MaxWriteTime;
+
+	//! Количество ошибок записи в файл
+	int WriteErrors;
+
+	//! Количество обновлений количества записей в заголовке (RD_COMMIT, RD_SYNC)
+	int CommitsCount;
+
+	//! Количество принудительных записей на диск (RD_SYNC)
+	int SyncsCount;
+
+	//! Суммарное время принудительной записи на диск (в миллисекундах)
+	double SyncTime;
+
+	//! Максимальное время одной принудительной записи на диск (в миллисекундах)
+	double MaxSyncTime;
+};
+//----------------------------------------------------------------------------------
+//! Результат восстановления BDF файла
+struct GARANT_EEG_RECORD_REPAIR_RESULT
+{
+	//! Количество записей данных, указанное в заголовке до восстановления (-1 если не указано)
+	long long HeaderRecordsCount;
+
+	//! Количество целых записей данных после восстановления
+	long long RecordsCount;
+
+	//! Размер файла до восстановления
+	long long OriginalSize;
+
+	//! Размер файла после восстановления
+	long long RepairedSize;
+};
+//----------------------------------------------------------------------------------
 ////////////////////////////////////////////////////////////////////////////////////
 //! Объявление типов коллбэков
 ////////////////////////////////////////////////////////////////////////////////////
@@ -10,13 +10,22 @@
 #include <windows.h>
 #include "../../../components/rapidjson/document.h"
 #include "Filtering/ButterworthFilter.hpp"
+#include "Filtering/FirFilter.h"
+#include "Filtering/NotchCombFilter.hpp"
+#include "Filtering/FixedPointFilter.h"
+#include "Filtering/dspfilter/Utilities.h"
 #include <QDebug>
+#include <algorithm>
+#include <math.h>
 //----------------------------------------------------------------------------------
 namespace GarantEEG
 {
 //----------------------------------------------------------------------------------
+//! Физическое значение одного отсчета АЦП основных каналов (в вольтах)
+static const double EEG8_CHANNEL_SCALE = 0.000447 / 10.0 / 1000.0;
+//----------------------------------------------------------------------------------
 CEeg8::CEeg8()
-: m_HeaderSize(5888), m_DataSize(1365)
+: m_HeaderSize(5888), m_DataSize(1365), m_Resampler(8), m_ResampleSamples(8 * 100), m_NativeSamples(8 * 100), m_PlanarSamples(8 * 100), m_DerivedSamples(8 * 100)
 {
     m_ChannelNames.push_back("Po7");
     m_ChannelNames.push_back("O1");
@@ -71,7 +80,6 @@ bool CEeg8::Start(bool waitForConnection, int rate, const char *host, int port)
             break;
     }
 
-    WRITE_FILE_BUFFER_SIZE = m_DataSize * 10 * 30; //10 - count of records per second, 30 seconds record
     m_Host = host;
     m_Port = port;
     m_NTPMessage = "";
@@ -121,9 +129,32 @@ string fixEdfString(string str, const uint &maxLength)
     return str;
 }
 //----------------------------------------------------------------------------------
+/**
+ * @brief DerivedFilePath Получить путь к дополнительному файлу производных сигналов ("запись.derived.bdf" для "запись.bdf")
+ * @param filePath Путь к файлу записи
+ * @return Путь к дополнительному файлу
+ */
+static string DerivedFilePath(const string &filePath)
+{
+    size_t dot = filePath.find_last_of('.');
+    size_t slash = filePath.find_last_of("/\\");
+
+    if (dot == string::npos || (slash != string::npos && dot < slash))
+        return filePath + ".derived";
+
+    return filePath.substr(0, dot) + ".derived" + filePath.substr(dot);
+}
+//----------------------------------------------------------------------------------
 bool CEeg8::StartRecord(const char *userName, const char *filePath)
 {
-    if (!m_Started || m_Recording || m_TranslationPaused || m_File != nullptr)
+    return StartRecord(userName, filePath, 0);
+}
+//----------------------------------------------------------------------------------
+bool CEeg8::StartRecord(const char *userName, const char *filePath, int preTriggerSeconds)
+{
+    std::lock_guard<std::recursive_mutex> stateLock(m_RecordStateMutex);
+
+    if (preTriggerSeconds < 0 || !m_Started || m_Recording || m_TranslationPaused || m_BdfWriter.IsOpened() || m_DerivedWriter.IsOpened())
         return false;
     else if (!m_HeaderData.size())
     {
@@ -148,43 +179,123 @@ bool CEeg8::StartRecord(const char *userName, const char *filePath)
         SYSTEMTIME st;
         GetLocalTime(&st);
 
-        sprintf(buff, "/EegRecord_%i.%i.%i___%i.%i.%i.bdf", st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond);
+        sprintf(buff, "/EegRecord_%i.%i.%i___%i.%i.%i.%s", st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond, (m_RecordMode == RM_COMPRESSED ? "gcr" : "bdf"));
 
         m_RecordFileName = directory + buff;
     }
 
-    if (m_FileWriteBuffer != nullptr)
+    qDebug() << "start recording in" << m_RecordFileName.c_str();
+
+    vector<char> header = m_HeaderData;
+
+    string name = fixEdfString(userName, 80);
+    memcpy(&header[8], &name[0], 80);
+
+    for (int i = 0; i < (int)m_ChannelNames.size(); i++)
     {
-        delete[] m_FileWriteBuffer;
-        m_FileWriteBuffer = nullptr;
+        string electrodeName = fixEdfString(m_ChannelNames[i], 16);
+        memcpy(&header[256 + (16 * i)], &electrodeName[0], 16);
     }
 
-    qDebug() << "start recording in" << m_RecordFileName.c_str();
+    BDF_WRITER_SETTINGS settings;
+    settings.Mode = m_RecordMode;
+    settings.BuffersCount = m_RecordBuffersCount;
+    settings.BufferRecords = 10 * m_RecordBufferSeconds; //10 - количество записей данных в секунду
+    settings.FlushInterval = m_RecordFlushInterval;
+    settings.Durability = m_RecordDurability;
+    settings.CommitInterval = m_RecordCommitInterval;
+    settings.SyncInterval = m_RecordSyncInterval;
+
+    //Производные сигналы: длительность записи данных та же (0.1 с), поэтому записи обоих файлов совпадают по времени
+    vector<BDF_SIGNAL_TEMPLATE> derivedSignals;
+    int derivedFlags = RDS_NONE;
+    const int outputRate = GetOutputRate();
+    char prefiltering[80] = { 0 };
+
+    if ((m_RecordDerivedSignals & RDS_FILTERED) && (outputRate % 10) != 0)
+        qDebug() << "filtered channels are not recorded, output rate is not a multiple of 10 Hz:" << outputRate;
+    else if (m_RecordDerivedSignals & RDS_FILTERED)
+    {
+        sprintf(prefiltering, "filtered, %i Hz", outputRate);
+        derivedFlags |= RDS_FILTERED;
 
-    m_File = fopen(m_RecordFileName.c_str(), "wb");
+        for (int i = 0; i < 8; i++)
+            derivedSignals.push_back({ i, "F " + m_ChannelNames[i], prefiltering, outputRate / 10 });
+    }
 
-    if (m_File != nullptr)
+    if (m_RecordDerivedSignals & RDS_AVERAGE_REFERENCE)
     {
-        vector<char> header = m_HeaderData;
+        derivedFlags |= RDS_AVERAGE_REFERENCE;
 
-        string name = fixEdfString(userName, 80);
-        memcpy(&header[8], &name[0], 80);
+        for (int i = 0; i < 8; i++)
+            derivedSignals.push_back({ i, "AR " + m_ChannelNames[i], "average reference", m_Rate / 10 });
+    }
 
-        for (int i = 0; i < (int)m_ChannelNames.size(); i++)
-        {
-            string electrodeName = fixEdfString(m_ChannelNames[i], 16);
-            memcpy(&header[256 + (16 * i)], &electrodeName[0], 16);
-        }
+    string derivedFileName = DerivedFilePath(m_RecordFileName);
 
-        fwrite(&header[0], header.size(), 1, m_File);
+    //Границы сегментов кратны секунде (10 записей данных), чтобы время начала в заголовках сегментов было точным
+    long long segmentRecords = (long long)m_RecordSegmentSeconds * 10;
 
-        m_FileWriteBuffer = new char[WRITE_FILE_BUFFER_SIZE];
+    if (m_RecordSegmentMegabytes > 0)
+    {
+        long long sizeRecords = ((long long)m_RecordSegmentMegabytes * 1024 * 1024 - (long long)header.size()) / m_DataSize / 10 * 10;
+        sizeRecords = std::max(10LL, sizeRecords);
 
-        m_CurrentWriteBufferDataSize = 0;
-        m_WrittenDataCount = 0;
-        m_Recording = true;
-        m_RecordPaused = false;
+        segmentRecords = (segmentRecords > 0 ? std::min(segmentRecords, sizeRecords) : sizeRecords);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_SegmentMutex);
+        m_LastClosedSegment.clear();
+    }
 
+    bool derivedFailed = false;
+
+    {
+        std::lock_guard<std::mutex> lock(m_RecordMutex);
+
+        //История берется целыми секундами: производные сигналы начинаются с текущего момента, их время начала сдвигается на целое число секунд
+        int historyFrames = std::min(m_HistoryCount, preTriggerSeconds * 10);
+        historyFrames -= historyFrames % 10;
+
+        vector<char> derivedHeader = header;
+        ShiftBdfStartTime(derivedHeader, historyFrames / 10);
+
+        //Буферы записи вмещают всю историю с запасом в один буфер: иначе сброс истории ждал бы диска под этой блокировкой, останавливая прием
+        BDF_WRITER_SETTINGS recordSettings = settings;
+        const int spareBuffers = std::max(BDF_WRITER_MIN_BUFFERS_COUNT, std::min(settings.BuffersCount, BDF_WRITER_MAX_BUFFERS_COUNT)) - 1;
+        recordSettings.BufferRecords = std::max(settings.BufferRecords, (historyFrames + spareBuffers - 1) / spareBuffers);
+
+        if (m_BdfWriter.Open(m_RecordFileName, header, m_DataSize, recordSettings, segmentRecords, &CEeg8::OnSegmentClosed, this))
+        {
+            m_DerivedRecordOffset = historyFrames;
+
+            if (derivedSignals.empty() || m_DerivedWriter.Open(derivedFileName, derivedHeader, derivedSignals, settings, segmentRecords))
+            {
+                //Фрэймы истории копируются из кольцевого буфера прямо в буферы записи, как и принимаемые фрэймы
+                for (int i = m_HistoryCount - historyFrames; i < m_HistoryCount; i++)
+                    WriteRecordFrame(&m_History[(size_t)((m_HistoryFirst + i) % m_HistoryCapacity) * m_DataSize]);
+
+                m_Recording = true;
+                m_RecordPaused = false;
+                m_DerivedSignals = derivedFlags;
+                m_DerivedFilteredRate = outputRate;
+                std::fill(m_DerivedFilteredLast, m_DerivedFilteredLast + 8, 0.0);
+            }
+            else
+                derivedFailed = true;
+        }
+    }
+
+    //Закрытие вызывает коллбэк сегмента, поэтому выполняется без блокировки записи
+    if (derivedFailed)
+    {
+        qDebug() << "can not create" << derivedFileName.c_str();
+        m_BdfWriter.Close();
+    }
+
+    if (m_Recording)
+    {
         if (m_Callback_OnRecordingStateChanged != nullptr)
             m_Callback_OnRecordingStateChanged(m_CallbackUserData_OnRecordingStateChanged, DRS_NO_ERROR);
     }
@@ -199,34 +310,25 @@ bool CEeg8::StartRecord(const char *userName, const char *filePath)
 //----------------------------------------------------------------------------------
 void CEeg8::StopRecord()
 {
-    if (!m_Started || !m_Recording || m_TranslationPaused || m_File == nullptr)
+    std::lock_guard<std::recursive_mutex> stateLock(m_RecordStateMutex);
+
+    if (!m_Started || !m_Recording || m_TranslationPaused || !m_BdfWriter.IsOpened())
         return;
 
-    if (m_CurrentWriteBufferDataSize > 0 && m_FileWriteBuffer != nullptr)
     {
-        fwrite(&m_FileWriteBuffer[0], m_CurrentWriteBufferDataSize, 1, m_File);
-    }
+        //После сброса флага поток приема больше не обращается к m_BdfWriter, дозапись идет без блокировки приема
+        std::lock_guard<std::mutex> lock(m_RecordMutex);
 
-    if (m_WrittenDataCount > 0)
-    {
-        string recordsCountText = fixEdfString(std::to_string(m_WrittenDataCount), 8);
-        fseek(m_File, 236, SEEK_SET);
-        fwrite(&recordsCountText[0], recordsCountText.length(), 1, m_File);
+        m_Recording = false;
+        m_RecordPaused = false;
+        m_DerivedSignals = RDS_NONE;
     }
 
-    if (m_FileWriteBuffer != nullptr)
-    {
-        delete[] m_FileWriteBuffer;
-        m_FileWriteBuffer = nullptr;
-    }
+    if (!m_BdfWriter.Close())
+        qDebug() << "errors while writing" << m_RecordFileName.c_str();
 
-    fflush(m_File);
-    fclose(m_File);
-    m_CurrentWriteBufferDataSize = 0;
-    m_WrittenDataCount = 0;
-    m_File = nullptr;
-    m_Recording = false;
-    m_RecordPaused = false;
+    if (m_DerivedWriter.IsOpened() && !m_DerivedWriter.Close())
+        qDebug() << "errors while writing" << DerivedFilePath(m_RecordFileName).c_str();
 
     if (m_Callback_OnRecordingStateChanged != nullptr)
         m_Callback_OnRecordingStateChanged(m_CallbackUserData_OnRecordingStateChanged, DRS_RECORD_STOPPED);
@@ -234,9 +336,20 @@ void CEeg8::StopRecord()
 //----------------------------------------------------------------------------------
 void CEeg8::PauseRecord()
 {
+    std::lock_guard<std::recursive_mutex> stateLock(m_RecordStateMutex);
+
     if (m_Started && m_Recording)
     {
-        m_RecordPaused = true;
+        {
+            //Во время паузы новые записи не поступают, накопленные данные передаются на запись сразу
+            std::lock_guard<std::mutex> lock(m_RecordMutex);
+
+            m_RecordPaused = true;
+            m_BdfWriter.Commit();
+
+            if (m_DerivedWriter.IsOpened())
+                m_DerivedWriter.Commit();
+        }
 
         if (m_Callback_OnRecordingStateChanged != nullptr)
             m_Callback_OnRecordingStateChanged(m_CallbackUserData_OnRecordingStateChanged, DRS_RECORD_PAUSED);
@@ -245,6 +358,8 @@ void CEeg8::PauseRecord()
 //----------------------------------------------------------------------------------
 void CEeg8::ResumeRecord()
 {
+    std::lock_guard<std::recursive_mutex> stateLock(m_RecordStateMutex);
+
     if (m_Started && m_Recording)
     {
         m_RecordPaused = false;
@@ -254,10 +369,119 @@ void CEeg8::ResumeRecord()
     }
 }
 //----------------------------------------------------------------------------------
+bool CEeg8::SetRecordingBuffers(int buffersCount, int bufferSeconds)
+{
+    if (buffersCount < BDF_WRITER_MIN_BUFFERS_COUNT || buffersCount > BDF_WRITER_MAX_BUFFERS_COUNT || bufferSeconds < 1 || bufferSeconds > 30)
+        return false;
+
+    m_RecordBuffersCount = buffersCount;
+    m_RecordBufferSeconds = bufferSeconds;
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+bool CEeg8::SetRecordingMode(int mode, int flushInterval)
+{
+    if (mode < RM_BUFFERED || mode > RM_COMPRESSED || flushInterval < 100 || flushInterval > 60000)
+        return false;
+
+    m_RecordMode = mode;
+    m_RecordFlushInterval = flushInterval;
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+bool CEeg8::SetRecordingDurability(int durability, int commitInterval, int syncInterval)
+{
+    if (durability < RD_NONE || durability > RD_SYNC || commitInterval < 100 || commitInterval > 60000 || syncInterval < 100 || syncInterval > 600000)
+        return false;
+
+    m_RecordDurability = durability;
+    m_RecordCommitInterval = commitInterval;
+    m_RecordSyncInterval = syncInterval;
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+bool CEeg8::SetRecordingDerivedSignals(int signals)
+{
+    if (signals < RDS_NONE || signals > (RDS_FILTERED | RDS_AVERAGE_REFERENCE))
+        return false;
+
+    m_RecordDerivedSignals = signals;
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+bool CEeg8::SetRecordingHistory(int seconds)
+{
+    if (seconds < 0 || seconds > 60)
+        return false;
+
+    m_HistorySeconds = seconds;
+    ResetHistory();
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+bool CEeg8::SetRecordingSegmentation(int segmentSeconds, int segmentMegabytes)
+{
+    if (segmentSeconds < 0 || segmentSeconds > 86400 || segmentMegabytes < 0 || segmentMegabytes > 1024 * 1024)
+        return false;
+
+    m_RecordSegmentSeconds = segmentSeconds;
+    m_RecordSegmentMegabytes = segmentMegabytes;
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+bool CEeg8::GetLastClosedSegment(char *filePath, int size)
+{
+    std::lock_guard<std::mutex> lock(m_SegmentMutex);
+
+    if (filePath == nullptr || m_LastClosedSegment.empty() || (int)m_LastClosedSegment.length() >= size)
+        return false;
+
+    memcpy(filePath, m_LastClosedSegment.c_str(), m_LastClosedSegment.length() + 1);
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+void CEeg8::OnSegmentClosed(void *userData, const string &filePath, bool success)
+{
+    CEeg8 *eeg = (CEeg8*)userData;
+
+    if (!success)
+        qDebug() << "errors while writing" << filePath.c_str();
+
+    {
+        std::lock_guard<std::mutex> lock(eeg->m_SegmentMutex);
+        eeg->m_LastClosedSegment = filePath;
+    }
+
+    if (eeg->m_Callback_OnRecordingStateChanged != nullptr)
+        eeg->m_Callback_OnRecordingStateChanged(eeg->m_CallbackUserData_OnRecordingStateChanged, (success ? DRS_SEGMENT_CLOSED : DRS_SEGMENT_WRITE_ERROR));
+}
+//----------------------------------------------------------------------------------
+bool CEeg8::GetRecordingStatistics(GARANT_EEG_RECORDING_STATISTICS *statistics)
+{
+    if (statistics == nullptr)
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_RecordMutex);
+
+    m_BdfWriter.GetStatistics(*statistics);
+
+    return true;
+}
+//----------------------------------------------------------------------------------
 void CEeg8::StartDataTranslation()
 {
     if (m_Started && !m_Recording && m_TranslationPaused)
     {
+        RestartFilters();
+        ResetHistory();
+
         SendPacket("start -protect eeg.rate " + std::to_string(m_Rate) + "\r\n");
 
         m_TranslationPaused = false;
@@ -333,88 +557,245 @@ const CAbstractFilter* CEeg8::AddFilter(int type, int order)
 }
 //----------------------------------------------------------------------------------
 const CAbstractFilter* CEeg8::AddFilter(int type, int order, int channelsCount, const int *channelsList)
+{
+    return AddFilter(type, order, channelsCount, channelsList, FSF_DIRECT_FORM_II);
+}
+//----------------------------------------------------------------------------------
+const CAbstractFilter* CEeg8::AddFilter(int type, int order, int channelsCount, const int *channelsList, int stateForm)
 {
     CBaseFilter *filter = nullptr;
 
-    //for (int i = 1; i <= 52; i++) qDebug("case %i: filter = CButterworthFilter<1, %i>::Create(order, channelsList); break;", i, i);
+    //for (int i = 1; i <= 52; i++) qDebug("case %i: filter = CButterworthFilter<1, %i>::Create(order, channelsList, stateForm); break;", i, i);
 
     if (type == FT_BUTTERWORTH)
     {
         switch (channelsCount)
         {
-            case 1: filter = CButterworthFilter<1, 1>::Create(order, channelsList); break;
-            case 2: filter = CButterworthFilter<1, 2>::Create(order, channelsList); break;
-            case 3: filter = CButterworthFilter<1, 3>::Create(order, channelsList); break;
-            case 4: filter = CButterworthFilter<1, 4>::Create(order, channelsList); break;
-            case 5: filter = CButterworthFilter<1, 5>::Create(order, channelsList); break;
-            case 6: filter = CButterworthFilter<1, 6>::Create(order, channelsList); break;
-            case 7: filter = CButterworthFilter<1, 7>::Create(order, channelsList); break;
-            case 8: filter = CButterworthFilter<1, 8>::Create(order, channelsList); break;
-            case 9: filter = CButterworthFilter<1, 9>::Create(order, channelsList); break;
-            case 10: filter = CButterworthFilter<1, 10>::Create(order, channelsList); break;
-            case 11: filter = CButterworthFilter<1, 11>::Create(order, channelsList); break;
-            case 12: filter = CButterworthFilter<1, 12>::Create(order, channelsList); break;
-            case 13: filter = CButterworthFilter<1, 13>::Create(order, channelsList); break;
-            case 14: filter = CButterworthFilter<1, 14>::Create(order, channelsList); break;
-            case 15: filter = CButterworthFilter<1, 15>::Create(order, channelsList); break;
-            case 16: filter = CButterworthFilter<1, 16>::Create(order, channelsList); break;
-            case 17: filter = CButterworthFilter<1, 17>::Create(order, channelsList); break;
-            case 18: filter = CButterworthFilter<1, 18>::Create(order, channelsList); break;
-            case 19: filter = CButterworthFilter<1, 19>::Create(order, channelsList); break;
-            case 20: filter = CButterworthFilter<1, 20>::Create(order, channelsList); break;
-            case 21: filter = CButterworthFilter<1, 21>::Create(order, channelsList); break;
-            case 22: filter = CButterworthFilter<1, 22>::Create(order, channelsList); break;
-            case 23: filter = CButterworthFilter<1, 23>::Create(order, channelsList); break;
-            case 24: filter = CButterworthFilter<1, 24>::Create(order, channelsList); break;
-            case 25: filter = CButterworthFilter<1, 25>::Create(order, channelsList); break;
-            case 26: filter = CButterworthFilter<1, 26>::Create(order, channelsList); break;
-            case 27: filter = CButterworthFilter<1, 27>::Create(order, channelsList); break;
-            case 28: filter = CButterworthFilter<1, 28>::Create(order, channelsList); break;
-            case 29: filter = CButterworthFilter<1, 29>::Create(order, channelsList); break;
-            case 30: filter = CButterworthFilter<1, 30>::Create(order, channelsList); break;
-            case 31: filter = CButterworthFilter<1, 31>::Create(order, channelsList); break;
-            case 32: filter = CButterworthFilter<1, 32>::Create(order, channelsList); break;
-            case 33: filter = CButterworthFilter<1, 33>::Create(order, channelsList); break;
-            case 34: filter = CButterworthFilter<1, 34>::Create(order, channelsList); break;
-            case 35: filter = CButterworthFilter<1, 35>::Create(order, channelsList); break;
-            case 36: filter = CButterworthFilter<1, 36>::Create(order, channelsList); break;
-            case 37: filter = CButterworthFilter<1, 37>::Create(order, channelsList); break;
-            case 38: filter = CButterworthFilter<1, 38>::Create(order, channelsList); break;
-            case 39: filter = CButterworthFilter<1, 39>::Create(order, channelsList); break;
-            case 40: filter = CButterworthFilter<1, 40>::Create(order, channelsList); break;
-            case 41: filter = CButterworthFilter<1, 41>::Create(order, channelsList); break;
-            case 42: filter = CButterworthFilter<1, 42>::Create(order, channelsList); break;
-            case 43: filter = CButterworthFilter<1, 43>::Create(order, channelsList); break;
-            case 44: filter = CButterworthFilter<1, 44>::Create(order, channelsList); break;
-            case 45: filter = CButterworthFilter<1, 45>::Create(order, channelsList); break;
-            case 46: filter = CButterworthFilter<1, 46>::Create(order, channelsList); break;
-            case 47: filter = CButterworthFilter<1, 47>::Create(order, channelsList); break;
-            case 48: filter = CButterworthFilter<1, 48>::Create(order, channelsList); break;
-            case 49: filter = CButterworthFilter<1, 49>::Create(order, channelsList); break;
-            case 50: filter = CButterworthFilter<1, 50>::Create(order, channelsList); break;
-            case 51: filter = CButterworthFilter<1, 51>::Create(order, channelsList); break;
-            case 52: filter = CButterworthFilter<1, 52>::Create(order, channelsList); break;
+            case 1: filter = CButterworthFilter<1, 1>::Create(order, channelsList, stateForm); break;
+            case 2: filter = CButterworthFilter<1, 2>::Create(order, channelsList, stateForm); break;
+            case 3: filter = CButterworthFilter<1, 3>::Create(order, channelsList, stateForm); break;
+            case 4: filter = CButterworthFilter<1, 4>::Create(order, channelsList, stateForm); break;
+            case 5: filter = CButterworthFilter<1, 5>::Create(order, channelsList, stateForm); break;
+            case 6: filter = CButterworthFilter<1, 6>::Create(order, channelsList, stateForm); break;
+            case 7: filter = CButterworthFilter<1, 7>::Create(order, channelsList, stateForm); break;
+            case 8: filter = CButterworthFilter<1, 8>::Create(order, channelsList, stateForm); break;
+            case 9: filter = CButterworthFilter<1, 9>::Create(order, channelsList, stateForm); break;
+            case 10: filter = CButterworthFilter<1, 10>::Create(order, channelsList, stateForm); break;
+            case 11: filter = CButterworthFilter<1, 11>::Create(order, channelsList, stateForm); break;
+            case 12: filter = CButterworthFilter<1, 12>::Create(order, channelsList, stateForm); break;
+            case 13: filter = CButterworthFilter<1, 13>::Create(order, channelsList, stateForm); break;
+            case 14: filter = CButterworthFilter<1, 14>::Create(order, channelsList, stateForm); break;
+            case 15: filter = CButterworthFilter<1, 15>::Create(order, channelsList, stateForm); break;
+            case 16: filter = CButterworthFilter<1, 16>::Create(order, channelsList, stateForm); break;
+            case 17: filter = CButterworthFilter<1, 17>::Create(order, channelsList, stateForm); break;
+            case 18: filter = CButterworthFilter<1, 18>::Create(order, channelsList, stateForm); break;
+            case 19: filter = CButterworthFilter<1, 19>::Create(order, channelsList, stateForm); break;
+            case 20: filter = CButterworthFilter<1, 20>::Create(order, channelsList, stateForm); break;
+            case 21: filter = CButterworthFilter<1, 21>::Create(order, channelsList, stateForm); break;
+            case 22: filter = CButterworthFilter<1, 22>::Create(order, channelsList, stateForm); break;
+            case 23: filter = CButterworthFilter<1, 23>::Create(order, channelsList, stateForm); break;
+            case 24: filter = CButterworthFilter<1, 24>::Create(order, channelsList, stateForm); break;
+            case 25: filter = CButterworthFilter<1, 25>::Create(order, channelsList, stateForm); break;
+            case 26: filter = CButterworthFilter<1, 26>::Create(order, channelsList, stateForm); break;
+            case 27: filter = CButterworthFilter<1, 27>::Create(order, channelsList, stateForm); break;
+            case 28: filter = CButterworthFilter<1, 28>::Create(order, channelsList, stateForm); break;
+            case 29: filter = CButterworthFilter<1, 29>::Create(order, channelsList, stateForm); break;
+            case 30: filter = CButterworthFilter<1, 30>::Create(order, channelsList, stateForm); break;
+            case 31: filter = CButterworthFilter<1, 31>::Create(order, channelsList, stateForm); break;
+            case 32: filter = CButterworthFilter<1, 32>::Create(order, channelsList, stateForm); break;
+            case 33: filter = CButterworthFilter<1, 33>::Create(order, channelsList, stateForm); break;
+            case 34: filter = CButterworthFilter<1, 34>::Create(order, channelsList, stateForm); break;
+            case 35: filter = CButterworthFilter<1, 35>::Create(order, channelsList, stateForm); break;
+            case 36: filter = CButterworthFilter<1, 36>::Create(order, channelsList, stateForm); break;
+            case 37: filter = CButterworthFilter<1, 37>::Create(order, channelsList, stateForm); break;
+            case 38: filter = CButterworthFilter<1, 38>::Create(order, channelsList, stateForm); break;
+            case 39: filter = CButterworthFilter<1, 39>::Create(order, channelsList, stateForm); break;
+            case 40: filter = CButterworthFilter<1, 40>::Create(order, channelsList, stateForm); break;
+            case 41: filter = CButterworthFilter<1, 41>::Create(order, channelsList, stateForm); break;
+            case 42: filter = CButterworthFilter<1, 42>::Create(order, channelsList, stateForm); break;
+            case 43: filter = CButterworthFilter<1, 43>::Create(order, channelsList, stateForm); break;
+            case 44: filter = CButterworthFilter<1, 44>::Create(order, channelsList, stateForm); break;
+            case 45: filter = CButterworthFilter<1, 45>::Create(order, channelsList, stateForm); break;
+            case 46: filter = CButterworthFilter<1, 46>::Create(order, channelsList, stateForm); break;
+            case 47: filter = CButterworthFilter<1, 47>::Create(order, channelsList, stateForm); break;
+            case 48: filter = CButterworthFilter<1, 48>::Create(order, channelsList, stateForm); break;
+            case 49: filter = CButterworthFilter<1, 49>::Create(order, channelsList, stateForm); break;
+            case 50: filter = CButterworthFilter<1, 50>::Create(order, channelsList, stateForm); break;
+            case 51: filter = CButterworthFilter<1, 51>::Create(order, channelsList, stateForm); break;
+            case 52: filter = CButterworthFilter<1, 52>::Create(order, channelsList, stateForm); break;
+            default:
+                break;
+        }
+    }
+    else if (type == FT_FIR)
+        filter = CFirFilter::Create(order, channelsCount, channelsList);
+    else if (type == FT_BUTTERWORTH_FIXED)
+    {
+        filter = CFixedPointFilter::Create(order, channelsCount, channelsList);
+
+        if (filter != nullptr)
+            ((CFixedPointFilter*)filter)->SetOutputScale(EEG8_CHANNEL_SCALE);
+    }
+    else if (type == FT_NOTCH_COMB)
+    {
+        switch (channelsCount)
+        {
+            case 1: filter = CNotchCombFilter<1>::Create(order, channelsList); break;
+            case 2: filter = CNotchCombFilter<2>::Create(order, channelsList); break;
+            case 3: filter = CNotchCombFilter<3>::Create(order, channelsList); break;
+            case 4: filter = CNotchCombFilter<4>::Create(order, channelsList); break;
+            case 5: filter = CNotchCombFilter<5>::Create(order, channelsList); break;
+            case 6: filter = CNotchCombFilter<6>::Create(order, channelsList); break;
+            case 7: filter = CNotchCombFilter<7>::Create(order, channelsList); break;
+            case 8: filter = CNotchCombFilter<8>::Create(order, channelsList); break;
+            case 9: filter = CNotchCombFilter<9>::Create(order, channelsList); break;
+            case 10: filter = CNotchCombFilter<10>::Create(order, channelsList); break;
+            case 11: filter = CNotchCombFilter<11>::Create(order, channelsList); break;
+            case 12: filter = CNotchCombFilter<12>::Create(order, channelsList); break;
+            case 13: filter = CNotchCombFilter<13>::Create(order, channelsList); break;
+            case 14: filter = CNotchCombFilter<14>::Create(order, channelsList); break;
+            case 15: filter = CNotchCombFilter<15>::Create(order, channelsList); break;
+            case 16: filter = CNotchCombFilter<16>::Create(order, channelsList); break;
+            case 17: filter = CNotchCombFilter<17>::Create(order, channelsList); break;
+            case 18: filter = CNotchCombFilter<18>::Create(order, channelsList); break;
+            case 19: filter = CNotchCombFilter<19>::Create(order, channelsList); break;
+            case 20: filter = CNotchCombFilter<20>::Create(order, channelsList); break;
+            case 21: filter = CNotchCombFilter<21>::Create(order, channelsList); break;
+            case 22: filter = CNotchCombFilter<22>::Create(order, channelsList); break;
+            case 23: filter = CNotchCombFilter<23>::Create(order, channelsList); break;
+            case 24: filter = CNotchCombFilter<24>::Create(order, channelsList); break;
+            case 25: filter = CNotchCombFilter<25>::Create(order, channelsList); break;
+            case 26: filter = CNotchCombFilter<26>::Create(order, channelsList); break;
+            case 27: filter = CNotchCombFilter<27>::Create(order, channelsList); break;
+            case 28: filter = CNotchCombFilter<28>::Create(order, channelsList); break;
+            case 29: filter = CNotchCombFilter<29>::Create(order, channelsList); break;
+            case 30: filter = CNotchCombFilter<30>::Create(order, channelsList); break;
+            case 31: filter = CNotchCombFilter<31>::Create(order, channelsList); break;
+            case 32: filter = CNotchCombFilter<32>::Create(order, channelsList); break;
+            case 33: filter = CNotchCombFilter<33>::Create(order, channelsList); break;
+            case 34: filter = CNotchCombFilter<34>::Create(order, channelsList); break;
+            case 35: filter = CNotchCombFilter<35>::Create(order, channelsList); break;
+            case 36: filter = CNotchCombFilter<36>::Create(order, channelsList); break;
+            case 37: filter = CNotchCombFilter<37>::Create(order, channelsList); break;
+            case 38: filter = CNotchCombFilter<38>::Create(order, channelsList); break;
+            case 39: filter = CNotchCombFilter<39>::Create(order, channelsList); break;
+            case 40: filter = CNotchCombFilter<40>::Create(order, channelsList); break;
+            case 41: filter = CNotchCombFilter<41>::Create(order, channelsList); break;
+            case 42: filter = CNotchCombFilter<42>::Create(order, channelsList); break;
+            case 43: filter = CNotchCombFilter<43>::Create(order, channelsList); break;
+            case 44: filter = CNotchCombFilter<44>::Create(order, channelsList); break;
+            case 45: filter = CNotchCombFilter<45>::Create(order, channelsList); break;
+            case 46: filter = CNotchCombFilter<46>::Create(order, channelsList); break;
+            case 47: filter = CNotchCombFilter<47>::Create(order, channelsList); break;
+            case 48: filter = CNotchCombFilter<48>::Create(order, channelsList); break;
+            case 49: filter = CNotchCombFilter<49>::Create(order, channelsList); break;
+            case 50: filter = CNotchCombFilter<50>::Create(order, channelsList); break;
+            case 51: filter = CNotchCombFilter<51>::Create(order, channelsList); break;
+            case 52: filter = CNotchCombFilter<52>::Create(order, channelsList); break;
             default:
                 break;
         }
     }
 
     if (filter != nullptr)
+    {
+        std::lock_guard<std::mutex> lock(m_FiltersMutex);
         m_Filters.push_back(filter);
+    }
 
     return filter;
 }
 //----------------------------------------------------------------------------------
 bool CEeg8::SetupFilter(const CAbstractFilter *filter, int rate, int lowFrequency, int hightFrequency)
+{
+    return SetupFilter(filter, rate, lowFrequency, hightFrequency, 0);
+}
+//----------------------------------------------------------------------------------
+bool CEeg8::SetupFilter(const CAbstractFilter *filter, int rate, int lowFrequency, int hightFrequency, int transitionSamples)
+{
+    if (filter == nullptr)
+        return false;
+
+    if (transitionSamples < 0)
+        transitionSamples = 0;
+
+    std::lock_guard<std::mutex> lock(m_FiltersMutex);
+
+    for (std::vector<CBaseFilter*>::iterator i = m_Filters.begin(); i != m_Filters.end(); ++i)
+    {
+        if (filter == *i)
+        {
+            (*i)->Setup(rate, lowFrequency, hightFrequency, transitionSamples);
+            return true;
+        }
+    }
+
+    return false;
+}
+//----------------------------------------------------------------------------------
+bool CEeg8::SetupNotchFilter(const CAbstractFilter *filter, int rate, double frequency, double q, bool adaptive, int transitionSamples)
+{
+    if (filter == nullptr || frequency <= 0.0)
+        return false;
+
+    if (transitionSamples < 0)
+        transitionSamples = 0;
+
+    std::lock_guard<std::mutex> lock(m_FiltersMutex);
+
+    //Тип проверяется только у фильтра из списка: указатель удаленного фильтра разыменовывать нельзя
+    for (std::vector<CBaseFilter*>::iterator i = m_Filters.begin(); i != m_Filters.end(); ++i)
+    {
+        if (filter == *i)
+        {
+            if ((*i)->Type() != FT_NOTCH_COMB)
+                return false;
+
+            ((CNotchFilter*)(*i))->SetupNotch(rate, frequency, q, adaptive, transitionSamples);
+            return true;
+        }
+    }
+
+    return false;
+}
+//----------------------------------------------------------------------------------
+double CEeg8::GetNotchFilterFrequency(const CAbstractFilter *filter)
+{
+    if (filter == nullptr)
+        return -1.0;
+
+    std::lock_guard<std::mutex> lock(m_FiltersMutex);
+
+    for (std::vector<CBaseFilter*>::iterator i = m_Filters.begin(); i != m_Filters.end(); ++i)
+    {
+        if (filter == *i)
+            return ((*i)->Type() == FT_NOTCH_COMB ? ((CNotchFilter*)(*i))->Frequency() : -1.0);
+    }
+
+    return -1.0;
+}
+//----------------------------------------------------------------------------------
+bool CEeg8::SetFixedPointFilterOptions(const CAbstractFilter *filter, int rounding, bool saturation)
 {
     if (filter == nullptr)
         return false;
 
+    std::lock_guard<std::mutex> lock(m_FiltersMutex);
+
     for (std::vector<CBaseFilter*>::iterator i = m_Filters.begin(); i != m_Filters.end(); ++i)
     {
         if (filter == *i)
         {
-            (*i)->Setup(rate, lowFrequency, hightFrequency);
+            if ((*i)->Type() != FT_BUTTERWORTH_FIXED)
+                return false;
+
+            CFixedPointFilter *fixedFilter = (CFixedPointFilter*)*i;
+
+            if (!fixedFilter->SetRounding(rounding))
+                return false;
+
+            fixedFilter->SetSaturation(saturation);
+
             return true;
         }
     }
@@ -422,8 +803,144 @@ bool CEeg8::SetupFilter(const CAbstractFilter *filter, int rate, int lowFrequenc
     return false;
 }
 //----------------------------------------------------------------------------------
+bool CEeg8::SetFilterNumericsMode(const CAbstractFilter *filter, int mode)
+{
+    if (filter == nullptr)
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_FiltersMutex);
+
+    for (std::vector<CBaseFilter*>::iterator i = m_Filters.begin(); i != m_Filters.end(); ++i)
+    {
+        if (filter == *i)
+            return (*i)->SetNumericsMode(mode);
+    }
+
+    return false;
+}
+//----------------------------------------------------------------------------------
+int CEeg8::GetFilterStateSize(const CAbstractFilter *filter)
+{
+    if (filter == nullptr)
+        return 0;
+
+    std::lock_guard<std::mutex> lock(m_FiltersMutex);
+
+    for (std::vector<CBaseFilter*>::iterator i = m_Filters.begin(); i != m_Filters.end(); ++i)
+    {
+        if (filter == *i)
+            return (*i)->StateSize();
+    }
+
+    return 0;
+}
+//----------------------------------------------------------------------------------
+bool CEeg8::SaveFilterState(const CAbstractFilter *filter, void *buffer, int size)
+{
+    if (filter == nullptr)
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_FiltersMutex);
+
+    for (std::vector<CBaseFilter*>::iterator i = m_Filters.begin(); i != m_Filters.end(); ++i)
+    {
+        if (filter == *i)
+            return (*i)->SaveState(buffer, size);
+    }
+
+    return false;
+}
+//----------------------------------------------------------------------------------
+bool CEeg8::RestoreFilterState(const CAbstractFilter *filter, const void *buffer, int size)
+{
+    if (filter == nullptr)
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_FiltersMutex);
+
+    for (std::vector<CBaseFilter*>::iterator i = m_Filters.begin(); i != m_Filters.end(); ++i)
+    {
+        if (filter == *i)
+            return (*i)->RestoreState(buffer, size);
+    }
+
+    return false;
+}
+//----------------------------------------------------------------------------------
+bool CEeg8::SetFilterSteadyStateInit(const CAbstractFilter *filter, bool enabled)
+{
+    if (filter == nullptr)
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_FiltersMutex);
+
+    for (std::vector<CBaseFilter*>::iterator i = m_Filters.begin(); i != m_Filters.end(); ++i)
+    {
+        if (filter == *i)
+        {
+            (*i)->SetSteadyStateInit(enabled);
+            return ((*i)->SteadyStateInit() == enabled);
+        }
+    }
+
+    return false;
+}
+//----------------------------------------------------------------------------------
+bool CEeg8::GetFiltersResponse(const CAbstractFilter * const *filters, int filtersCount, int pointsCount, double firstFrequency, double lastFrequency, bool logarithmic, double *magnitude, double *phase)
+{
+    if (filters == nullptr || filtersCount < 0 || pointsCount < 1 || (logarithmic && (firstFrequency <= 0.0 || lastFrequency <= 0.0)))
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_FiltersMutex);
+
+    //Сетка пересчитывается только при изменении параметров, поворотные множители - при изменении частоты дискретизации
+    if (logarithmic)
+        m_FrequencyResponse.setLogarithmic(pointsCount, firstFrequency, lastFrequency);
+    else
+        m_FrequencyResponse.setLinear(pointsCount, firstFrequency, lastFrequency);
+
+    m_FrequencyResponse.reset();
+
+    for (int f = 0; f < filtersCount; f++)
+    {
+        std::vector<CBaseFilter*>::iterator i = std::find(m_Filters.begin(), m_Filters.end(), filters[f]);
+
+        if (i == m_Filters.end() || !(*i)->Response(m_FrequencyResponse))
+            return false;
+    }
+
+    if (magnitude != nullptr)
+        m_FrequencyResponse.getMagnitude(magnitude);
+
+    if (phase != nullptr)
+        m_FrequencyResponse.getPhase(phase);
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+void CEeg8::ResetHistory()
+{
+    std::lock_guard<std::mutex> lock(m_RecordMutex);
+
+    //Выделяется один раз при изменении длительности или размера фрэйма, поток приема только копирует фрэймы
+    m_HistoryCapacity = m_HistorySeconds * 10;
+    m_History.resize((size_t)m_HistoryCapacity * m_DataSize);
+    m_HistoryFirst = 0;
+    m_HistoryCount = 0;
+}
+//----------------------------------------------------------------------------------
+void CEeg8::RestartFilters()
+{
+    std::lock_guard<std::mutex> lock(m_FiltersMutex);
+
+    for (CBaseFilter *filter : m_Filters)
+        filter->Restart();
+}
+//----------------------------------------------------------------------------------
 void CEeg8::RemoveFilter(const CAbstractFilter *filter)
 {
+    std::lock_guard<std::mutex> lock(m_FiltersMutex);
+
     for (std::vector<CBaseFilter*>::iterator i = m_Filters.begin(); i != m_Filters.end(); ++i)
     {
         if (filter == *i)
@@ -437,6 +954,8 @@ void CEeg8::RemoveFilter(const CAbstractFilter *filter)
 //----------------------------------------------------------------------------------
 void CEeg8::RemoveAllFilters()
 {
+    std::lock_guard<std::mutex> lock(m_FiltersMutex);
+
     for (CBaseFilter *filter : m_Filters)
     {
         if (filter != nullptr)
@@ -446,6 +965,29 @@ void CEeg8::RemoveAllFilters()
     m_Filters.clear();
 }
 //----------------------------------------------------------------------------------
+bool CEeg8::SetOutputRate(int rate)
+{
+    if (rate < 0 || rate > 1000)
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_FiltersMutex);
+
+    if (rate != m_OutputRate)
+        m_Resampler.Reset();
+
+    m_OutputRate = rate;
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+void CEeg8::SetFilterThreadsCount(int count)
+{
+    std::lock_guard<std::mutex> lock(m_FiltersMutex);
+
+    m_FilterWorkerPool.SetThreadsCount(count);
+    m_FilterThreadsCount = m_FilterWorkerPool.ThreadsCount();
+}
+//----------------------------------------------------------------------------------
 void CEeg8::SetCallback_OnStartStateChanged(void *userData, EEG_ON_START_STATE_CHANGED *callback)
 {
     m_CallbackUserData_OnStartStateChanged = userData;
@@ -561,6 +1103,10 @@ void CEeg8::SocketThreadFunction(int depth)
 
     m_ConnectionStage = CS_CONNECTED;
 
+    //Фильтры перезапускаются до коллбэка, чтобы состояние, восстановленное в нем, не было перезаписано
+    RestartFilters();
+    ResetHistory();
+
     if (m_Callback_OnStartStateChanged != nullptr)
         m_Callback_OnStartStateChanged(m_CallbackUserData_OnStartStateChanged, DCS_NO_ERROR);
 
@@ -871,31 +1417,54 @@ void CEeg8::ProcessData(unsigned char *buf, const int &size)
         return (double)intValue;
     };
 
-    if (m_Recording && !m_RecordPaused && m_File != nullptr)
+    //Отсчеты одного основного канала (распаковываются векторно, как при чтении BDF файла)
+    double channelSamples[100];
+
+    //Производные сигналы пишутся только для фрэймов, записанных в исходный файл
+    int derivedSignals = RDS_NONE;
+
+    if ((m_Recording && !m_RecordPaused) || m_HistoryCapacity > 0)
     {
-        if (m_CurrentWriteBufferDataSize + size > WRITE_FILE_BUFFER_SIZE)
+        //Запись в файл идет в потоке CBdfWriter, здесь данные только копируются в буфер
+        std::lock_guard<std::mutex> lock(m_RecordMutex);
+
+        if (m_Recording && !m_RecordPaused)
         {
-            fwrite(&m_FileWriteBuffer[0], m_CurrentWriteBufferDataSize, 1, m_File);
-            m_CurrentWriteBufferDataSize = 0;
+            WriteRecordFrame(&buf[0]);
+            derivedSignals = m_DerivedSignals;
         }
 
-        memcpy(&m_FileWriteBuffer[m_CurrentWriteBufferDataSize], &buf[0], size);
-        m_CurrentWriteBufferDataSize += size;
+        //История для начала записи с момента в прошлом (самый старый фрэйм перезаписывается)
+        if (m_HistoryCapacity > 0 && size == m_DataSize)
+        {
+            int index = (m_HistoryFirst + m_HistoryCount) % m_HistoryCapacity;
+
+            if (m_HistoryCount < m_HistoryCapacity)
+                m_HistoryCount++;
+            else
+                m_HistoryFirst = (m_HistoryFirst + 1) % m_HistoryCapacity;
 
-        m_WrittenDataCount++;
+            memcpy(&m_History[(size_t)index * m_DataSize], buf, m_DataSize);
+        }
     }
 
+    const int deviceSamplesCount = frameData.DataRecordsCount;
+
     for (int i = 0; i < 22; i++)
     {
         if (i < 8) //main channels
         {
-            unsigned char *ptr = buf + (i * frameData.DataRecordsCount * 3);
+            Dsp::convertInt24(frameData.DataRecordsCount, channelSamples, buf + (i * frameData.DataRecordsCount * 3));
 
-            for (int j = 0; j < frameData.DataRecordsCount; j++, ptr += 3)
+            for (int j = 0; j < frameData.DataRecordsCount; j++)
             {
                 //frameData.ChannelsData[j].Value[i] = (int)(unpack24BitValue(ptr) * 0.000447) / 10.0; // из кода matlab
 
-                frameData.RawChannelsData[j].Value[i] = frameData.FilteredChannelsData[j].Value[i] = (unpack24BitValue(ptr) * 0.000447) / 10.0 / 1000.0; // /1000.0 для перевода в микровольты (из милливольт)
+                double intValue = channelSamples[j];
+
+                m_NativeSamples[i * 100 + j] = (int)intValue;
+
+                frameData.RawChannelsData[j].Value[i] = frameData.FilteredChannelsData[j].Value[i] = (intValue * 0.000447) / 10.0 / 1000.0; // /1000.0 для перевода в микровольты (из милливольт)
             }
         }
         else if (i < 11) //accelerometr
@@ -927,6 +1496,23 @@ void CEeg8::ProcessData(unsigned char *buf, const int &size)
         }
     }
 
+    //Усредненный референт считается по исходным отсчетам до понижения частоты (m_NativeSamples затем перезаписываются)
+    if (derivedSignals & RDS_AVERAGE_REFERENCE)
+    {
+        for (int j = 0; j < deviceSamplesCount; j++)
+        {
+            double average = 0.0;
+
+            for (int i = 0; i < 8; i++)
+                average += m_NativeSamples[i * 100 + j];
+
+            average /= 8.0;
+
+            for (int i = 0; i < 8; i++)
+                m_DerivedSamples[i * 100 + j] = m_NativeSamples[i * 100 + j] - average;
+        }
+    }
+
     rapidjson::Document doc;
     doc.Parse((char*)(buf + (size - 90)));
 
@@ -953,12 +1539,52 @@ void CEeg8::ProcessData(unsigned char *buf, const int &size)
         }
     }
 
-    if (m_Callback_OnReceivedData != nullptr)
+    if (m_Callback_OnReceivedData != nullptr || (derivedSignals & RDS_FILTERED))
     {
+        std::unique_lock<std::mutex> filtersLock(m_FiltersMutex);
+
+        //Понижение частоты выполняется до фильтров, чтобы фильтры обрабатывали меньше отсчетов
+        if (m_OutputRate > 0 && m_OutputRate < m_Rate)
+        {
+            if (m_Resampler.InputRate() != m_Rate || m_Resampler.OutputRate() != m_OutputRate)
+                m_Resampler.Setup(m_Rate, m_OutputRate);
+
+            double *channels[8];
+
+            for (int i = 0; i < 8; i++)
+            {
+                channels[i] = &m_ResampleSamples[i * 100];
+
+                for (int j = 0; j < frameData.DataRecordsCount; j++)
+                    channels[i][j] = frameData.RawChannelsData[j].Value[i];
+            }
+
+            frameData.DataRecordsCount = m_Resampler.Process(frameData.DataRecordsCount, channels);
+
+            for (int i = 0; i < 8; i++)
+            {
+                for (int j = 0; j < frameData.DataRecordsCount; j++)
+                {
+                    frameData.RawChannelsData[j].Value[i] = frameData.FilteredChannelsData[j].Value[i] = channels[i][j];
+
+                    //Целочисленные фильтры получают отсчеты после понижения частоты, приведенные обратно к шагу АЦП
+                    m_NativeSamples[i * 100 + j] = (int)lrint(channels[i][j] / EEG8_CHANNEL_SCALE);
+                }
+            }
+        }
+
         if (!m_Filters.empty())
         {
-            for (CBaseFilter *filter : m_Filters)
+            const int recordsCount = frameData.DataRecordsCount;
+            const int filtersCount = (int)m_Filters.size();
+            int totalChannels = 0;
+
+            m_FilterEnabled.assign(filtersCount, 0);
+
+            for (int f = 0; f < filtersCount; f++)
             {
+                CBaseFilter *filter = m_Filters[f];
+
                 if (filter == nullptr)
                     continue;
 
@@ -969,86 +1595,190 @@ void CEeg8::ProcessData(unsigned char *buf, const int &size)
                     continue;
 
                 bool error = false;
-                float *channels[8];
-                //QVector< QVector<float> > channels;
-                //QVector<float*> channelsPtr;
 
                 for (int i = 0; i < channelsCount; i++)
                 {
-                    channels[i] = new float[frameData.DataRecordsCount];
-                    //channels.push_back(QVector<float>());
+                    if ((uint)(channelsList[i] - 1) >= 8)
+                    {
+                        error = true;
+                        break;
+                    }
                 }
 
-                double multiply = 1.0;
+                if (error)
+                    continue;
 
-                /*double multiply = 1.0;
+                m_FilterEnabled[f] = 1;
+                totalChannels += channelsCount;
+            }
 
-                int index = ui->comboBoxVoltage->currentIndex();
-                if(0 == index)
-                {
-                    multiply = 1000000.0;
-                }
-                else if(1 == index)
-                {
-                    multiply = 1000.0;
-                }*/
+            //Буферы переиспользуются между фрэймами и растут только при увеличении количества каналов
+            if ((int)m_FilterSamples.size() < totalChannels * recordsCount)
+                m_FilterSamples.resize(totalChannels * recordsCount);
+
+            if ((int)m_FilterChannels.size() < totalChannels)
+                m_FilterChannels.resize(totalChannels);
+
+            m_FilterTasks.clear();
+
+            //Данные фрэйма раскладываются по каналам один раз (векторная транспозиция 8 каналов), каналы фильтров копируются уже непрерывными блоками
+            double *planarChannels[8];
+
+            for (int i = 0; i < 8; i++)
+                planarChannels[i] = &m_PlanarSamples[i * 100];
+
+            Dsp::deinterleave(8, recordsCount, planarChannels, &frameData.RawChannelsData[0].Value[0]);
+
+            const int workersCount = m_FilterWorkerPool.ThreadsCount() + 1;
+            int channelOffset = 0;
+
+            for (int f = 0; f < filtersCount; f++)
+            {
+                if (!m_FilterEnabled[f])
+                    continue;
+
+                CBaseFilter *filter = m_Filters[f];
+                int channelsCount = filter->ChannelsCount();
+                const int *channelsList = filter->ChannelsList();
+                float **channels = &m_FilterChannels[channelOffset];
+
+                double multiply = 1.0;
+                const bool nativeInput = filter->NativeInput();
 
                 for (int i = 0; i < channelsCount; i++)
                 {
-                    uint channelIndex = channelsList[i] - 1;
+                    int channelIndex = channelsList[i] - 1;
+                    float *channel = &m_FilterSamples[(channelOffset + i) * recordsCount];
 
-                    if (channelIndex >= 8)
-                    {
-                        error = true;
-                        break;
-                    }
+                    channels[i] = channel;
 
-                    //QVector<float> &channel = channels[i];
-                    //channel.reserve(frameData.DataRecordsCount);
+                    Dsp::copy(recordsCount, channel, planarChannels[channelIndex]);
 
-                    for (int j = 0; j < frameData.DataRecordsCount; j++)
+                    for (int j = 0; j < recordsCount; j++)
                     {
-                        float value = (float)frameData.RawChannelsData[j].Value[channelIndex];
+                        float value = channel[j];
 
                         if (abs(value * 1000000) >= 374000)
                             value = 0.0f;
+                        else if (nativeInput)
+                            value = (float)m_NativeSamples[channelIndex * 100 + j];
                         else
                             value *= multiply;
 
-                        channels[i][j] = value;
-                        //channel.push_back(value);
+                        channel[j] = value;
                     }
-
-                    //channelsPtr.push_back(&channels[i][0]);
                 }
 
-                if (error)
-                    continue;
+                //Каналы фильтра делятся на части с запасом относительно количества потоков, чтобы освободившиеся потоки могли забирать работу у занятых
+                int chunksCount = 1;
 
-                //filter->Process(frameData.DataRecordsCount, &channelsPtr[0]);
-                filter->Process(frameData.DataRecordsCount, channels);
+                if (workersCount > 1)
+                    chunksCount = std::max(1, std::min(workersCount * 2, channelsCount / FILTER_TASK_MIN_CHANNELS));
 
-                for (int i = 0; i < channelsCount; i++)
+                for (int c = 0; c < chunksCount; c++)
                 {
-                    int channelIndex = channelsList[i] - 1;
-                    //QVector<float> &channel = channels[i];
+                    int first = channelsCount * c / chunksCount;
+                    int last = channelsCount * (c + 1) / chunksCount;
 
-                    for (int j = 0; j < frameData.DataRecordsCount; j++)
-                    {
-                        //frameData.ChannelsData[j].Value[channelIndex] = (double)channel[j];
-                        frameData.FilteredChannelsData[j].Value[channelIndex] = (double)channels[i][j];
-                    }
+                    m_FilterTasks.push_back({ filter, channels, recordsCount, first, last - first, nullptr });
                 }
 
+                channelOffset += channelsCount;
+            }
+
+            m_FilterWorkerPool.Run(m_FilterTasks);
+
+            channelOffset = 0;
+
+            for (int f = 0; f < filtersCount; f++)
+            {
+                if (!m_FilterEnabled[f])
+                    continue;
+
+                CBaseFilter *filter = m_Filters[f];
+                int channelsCount = filter->ChannelsCount();
+                const int *channelsList = filter->ChannelsList();
+                float **channels = &m_FilterChannels[channelOffset];
+
+                filter->FinishProcess(recordsCount);
+
+                //Результат собирается в раскладке по каналам, каналы без фильтров сохраняют исходные значения
                 for (int i = 0; i < channelsCount; i++)
-                {
-                     delete[] channels[i];
-                }
+                    Dsp::copy(recordsCount, planarChannels[channelsList[i] - 1], channels[i]);
+
+                channelOffset += channelsCount;
             }
+
+            Dsp::interleave(8, (size_t)recordsCount, &frameData.FilteredChannelsData[0].Value[0], planarChannels);
         }
 
+        filtersLock.unlock();
+    }
+
+    if (derivedSignals != RDS_NONE)
+        WriteDerivedSignals(frameData, derivedSignals, deviceSamplesCount);
+
+    if (m_Callback_OnReceivedData != nullptr)
         m_Callback_OnReceivedData(m_CallbackUserData_OnReceivedData, &frameData);
+}
+//----------------------------------------------------------------------------------
+void CEeg8::WriteRecordFrame(const unsigned char *frame)
+{
+    const int segmentIndex = m_BdfWriter.SegmentIndex();
+
+    m_BdfWriter.Write(frame);
+
+    //Решение о смене сегмента принимается по исходной записи и применяется к дополнительному файлу,
+    //чтобы сегменты обоих файлов начинались с одной и той же секунды
+    if (m_BdfWriter.SegmentIndex() != segmentIndex && m_DerivedWriter.IsOpened())
+        m_DerivedWriter.AddSegmentBoundary(m_BdfWriter.RecordsCount() - 1 - m_DerivedRecordOffset);
+}
+//----------------------------------------------------------------------------------
+void CEeg8::WriteDerivedSignals(const GARANT_EEG_DATA &frameData, int derivedSignals, int deviceSamplesCount)
+{
+    std::lock_guard<std::mutex> lock(m_RecordMutex);
+
+    if (!m_Recording || !m_DerivedWriter.IsOpened())
+        return;
+
+    int signal = 0;
+
+    if (m_DerivedSignals & RDS_FILTERED)
+    {
+        if ((derivedSignals & RDS_FILTERED) && GetOutputRate() == m_DerivedFilteredRate && frameData.DataRecordsCount > 0)
+        {
+            const int stride = sizeof(GARANT_EEG_CHANNELS_DATA) / sizeof(double);
+
+            for (int i = 0; i < 8; i++)
+            {
+                m_DerivedWriter.Append(signal + i, &frameData.FilteredChannelsData[0].Value[i], frameData.DataRecordsCount, stride, EEG8_CHANNEL_SCALE);
+                m_DerivedFilteredLast[i] = frameData.FilteredChannelsData[frameData.DataRecordsCount - 1].Value[i];
+            }
+        }
+        else
+        {
+            //После смены выходной частоты во время записи частота в заголовке уже не совпадает: отфильтрованные каналы
+            //продолжаются последним записанным значением, иначе записи данных перестанут собираться для всех производных сигналов
+            const int count = m_DerivedFilteredRate / 10;
+            double samples[100];
+
+            for (int i = 0; i < 8; i++)
+            {
+                std::fill(samples, samples + count, m_DerivedFilteredLast[i]);
+                m_DerivedWriter.Append(signal + i, samples, count, 1, EEG8_CHANNEL_SCALE);
+            }
+        }
+
+        signal += 8;
+    }
+
+    if (derivedSignals & RDS_AVERAGE_REFERENCE)
+    {
+        for (int i = 0; i < 8; i++)
+            m_DerivedWriter.Append(signal + i, &m_DerivedSamples[i * 100], deviceSamplesCount, 1, 1.0);
     }
+
+    m_DerivedWriter.Write();
 }
 //----------------------------------------------------------------------------------
 } //namespace GarantEEG
@@ -22,8 +22,14 @@ using std::thread;
 //----------------------------------------------------------------------------------
 #include <winsock.h>
 #include <mutex>
+#include <atomic>
 //----------------------------------------------------------------------------------
 #include "Filtering/BaseFilter.h"
+#include "Filtering/FilterWorkerPool.h"
+#include "Filtering/Resampler.h"
+#include "Filtering/dspfilter/FrequencyResponse.h"
+#include "Recording/SegmentedWriter.h"
+#include "Recording/DerivedWriter.h"
 //----------------------------------------------------------------------------------
 namespace GarantEEG
 {
@@ -122,14 +128,85 @@ protected:
 	//! Мьютекс для доступа
     std::mutex m_Mutex;
 
-	//! Файл записи данных
-    FILE *m_File = nullptr;
+	//! Мьютекс для доступа к списку фильтров, ресэмплеру и их настройкам
+    std::mutex m_FiltersMutex;
 
-	//! Текущий размер буфера записи
-    int m_CurrentWriteBufferDataSize = 0;
+	//! Мьютекс для доступа к записи данных в файл (поток приема и вызовы пользователя)
+    std::mutex m_RecordMutex;
 
-	//! Количество записанных фрэймов
-    int m_WrittenDataCount = 0;
+	//! Мьютекс смены состояния записи: начало, остановка и пауза записи из разных потоков (вызовы пользователя,
+	//! конец воспроизведения) выполняются по очереди и проверяют состояние заново. Рекурсивный, так как коллбэки
+	//! состояния записи могут снова начать или остановить запись
+    std::recursive_mutex m_RecordStateMutex;
+
+	//! Асинхронная запись BDF файла (сегментами, если задано SetRecordingSegmentation)
+    CSegmentedWriter m_BdfWriter;
+
+	//! Мьютекс для доступа к пути последнего закрытого сегмента
+    std::mutex m_SegmentMutex;
+
+	//! Путь к последнему закрытому сегменту записи
+    string m_LastClosedSegment = "";
+
+	//! Длительность сегмента записи в секундах (0 - без ограничения)
+    int m_RecordSegmentSeconds = 0;
+
+	//! Максимальный размер сегмента записи в мегабайтах (0 - без ограничения)
+    int m_RecordSegmentMegabytes = 0;
+
+	//! Длительность истории исходных данных в секундах (0 - без истории)
+    int m_HistorySeconds = 0;
+
+	//! История исходных данных: кольцевой буфер фрэймов по m_DataSize байт (доступ под m_RecordMutex)
+    vector<unsigned char> m_History;
+
+	//! Емкость истории во фрэймах
+    int m_HistoryCapacity = 0;
+
+	//! Индекс самого старого фрэйма в истории
+    int m_HistoryFirst = 0;
+
+	//! Количество фрэймов в истории
+    int m_HistoryCount = 0;
+
+	//! Количество буферов записи данных в файл
+    int m_RecordBuffersCount = BDF_WRITER_DEFAULT_BUFFERS_COUNT;
+
+	//! Длительность данных в одном буфере записи (в секундах)
+    int m_RecordBufferSeconds = 5;
+
+	//! Способ записи данных в файл из GARANT_EEG_RECORDING_MODE
+    int m_RecordMode = RM_BUFFERED;
+
+	//! Интервал асинхронного сброса данных на диск для RM_MAPPED (в миллисекундах)
+    int m_RecordFlushInterval = 1000;
+
+	//! Политика сохранности записи из GARANT_EEG_RECORDING_DURABILITY
+    int m_RecordDurability = RD_NONE;
+
+	//! Интервал обновления количества записей в заголовке (в миллисекундах)
+    int m_RecordCommitInterval = 1000;
+
+	//! Интервал принудительной записи данных на диск для RD_SYNC (в миллисекундах)
+    int m_RecordSyncInterval = 10000;
+
+	//! Производные сигналы для следующих записей (флаги GARANT_EEG_RECORDING_DERIVED)
+    int m_RecordDerivedSignals = RDS_NONE;
+
+	//! Производные сигналы текущей записи (RDS_NONE если дополнительный файл не создан)
+    int m_DerivedSignals = RDS_NONE;
+
+	//! Частота отфильтрованных каналов текущей записи (выходная частота при начале записи)
+    int m_DerivedFilteredRate = 0;
+
+	//! Последние записанные значения отфильтрованных каналов (повторяются, если выходная частота изменена во время записи)
+    double m_DerivedFilteredLast[8] = { 0.0 };
+
+	//! Асинхронная запись производных сигналов
+    CDerivedWriter m_DerivedWriter;
+
+	//! Количество фрэймов истории в начале текущей записи (дополнительный файл начинается после них)
+    long long m_DerivedRecordOffset = 0;
 
 	//! Размер для защищенного режима
     const int PROTECTED_MODE_EXTRA_SIZE = 12;
@@ -137,9 +214,6 @@ protected:
 	//! Размер сообщения синхронизации времени
     const int NTP_MESSAGE_SIZE = 40;
 
-	//! Размер буфера записи данных в файл
-    int WRITE_FILE_BUFFER_SIZE = 0;
-
 	//! Размер заголовка
     int m_HeaderSize = 0;
 
@@ -167,15 +241,51 @@ protected:
 	//! Буфер приема
     vector<char> m_RecvBuffer;
 
-	//! Буфер записи данных в файл
-    char *m_FileWriteBuffer = nullptr;
-
 	//! Буфер отправки
     string m_SendBuffer;
 
 	//! Применяемые фильтры
     std::vector<CBaseFilter*> m_Filters;
 
+	//! Выходная частота данных (0 - частота устройства)
+    int m_OutputRate = 0;
+
+	//! Ресэмплер для понижения частоты выходных данных (работает до фильтров)
+    CResampler m_Resampler;
+
+	//! Буфер данных каналов для ресэмплера
+    vector<double> m_ResampleSamples;
+
+	//! Исходные целые отсчеты АЦП основных каналов текущего фрэйма (для целочисленных фильтров)
+    vector<int> m_NativeSamples;
+
+	//! Данные основных каналов текущего фрэйма в раскладке по каналам (вход и выход фильтров)
+    vector<double> m_PlanarSamples;
+
+	//! Отсчеты основных каналов с усредненным референтом текущего фрэйма (в шаге АЦП)
+    vector<double> m_DerivedSamples;
+
+	//! Частотная характеристика для GetFiltersResponse (сетка и поворотные множители сохраняются между вызовами)
+    Dsp::FrequencyResponse m_FrequencyResponse;
+
+	//! Пул потоков для параллельной фильтрации каналов
+    CFilterWorkerPool m_FilterWorkerPool;
+
+	//! Количество потоков пула фильтрации для GetFilterThreadsCount (пул меняется под m_FiltersMutex, значение читается без блокировки)
+    std::atomic<int> m_FilterThreadsCount{ 0 };
+
+	//! Буфер данных каналов для фильтрации (по каналам всех фильтров подряд)
+    vector<float> m_FilterSamples;
+
+	//! Указатели на данные каналов в буфере фильтрации
+    vector<float*> m_FilterChannels;
+
+	//! Задачи фильтрации текущего фрэйма
+    vector<FILTER_TASK> m_FilterTasks;
+
+	//! Флаги применимости фильтров к текущему фрэйму
+    vector<char> m_FilterEnabled;
+
 	//! Данные пользователя для коллбэка состояния подключения к устройству
     void *m_CallbackUserData_OnStartStateChanged = nullptr;
 
@@ -252,6 +362,38 @@ protected:
      */
     void ProcessData(unsigned char *buf, const int &size);
 
+	/**
+	 * @brief WriteRecordFrame Передать фрэйм на запись в файл (вызывается под m_RecordMutex)
+	 * @param frame Указатель на фрэйм размером m_DataSize
+	 */
+    void WriteRecordFrame(const unsigned char *frame);
+
+	/**
+	 * @brief WriteDerivedSignals Добавить производные сигналы фрэйма в дополнительный файл записи
+	 * @param frameData Данные фрэйма (отфильтрованные каналы после понижения частоты и фильтров)
+	 * @param derivedSignals Флаги GARANT_EEG_RECORDING_DERIVED, действовавшие при записи исходного фрэйма
+	 * @param deviceSamplesCount Количество отсчетов фрэйма на частоте устройства (для m_DerivedSamples)
+	 */
+    void WriteDerivedSignals(const GARANT_EEG_DATA &frameData, int derivedSignals, int deviceSamplesCount);
+
+	/**
+	 * @brief OnSegmentClosed Коллбэк закрытия сегмента записи (поток обслуживания сегментов или StopRecord)
+	 * @param userData Указатель на CEeg8
+	 * @param filePath Путь к файлу сегмента
+	 * @param success true если все данные сегмента записаны без ошибок
+	 */
+    static void OnSegmentClosed(void *userData, const string &filePath, bool success);
+
+	/**
+	 * @brief RestartFilters Сообщить фильтрам о перезапуске потока данных (после подключения или возобновления трансляции)
+	 */
+    void RestartFilters();
+
+	/**
+	 * @brief ResetHistory Очистить историю исходных данных и выделить ее под текущий размер фрэйма (после подключения или возобновления трансляции)
+	 */
+    void ResetHistory();
+
 public:
 	/**
 	 * @brief CEeg8 Конструктор
@@ -319,6 +461,14 @@ public:
 	 */
     virtual bool IsPaused() const override { return m_TranslationPaused; }
 
+	/**
+	 * @brief SetReplayOptions Установить параметры воспроизведения записи (только для DT_REPLAY, можно менять во время воспроизведения)
+	 * @param speed Скорость воспроизведения (1.0 - реальное время, N - в N раз быстрее, 0 - максимальная скорость)
+	 * @param loop Воспроизводить файл по кругу (иначе в конце файла запись останавливается и сообщается DCS_CONNECTION_CLOSED)
+	 * @return true если параметры корректны и устройство поддерживает воспроизведение
+	 */
+    virtual bool SetReplayOptions(double speed, bool loop) override { (void)speed; (void)loop; return false; }
+
 	/**
 	 * @brief StartRecord Начать запись данных в файл
 	 * @param userName Имя респондента
@@ -327,6 +477,15 @@ public:
 	 */
     virtual bool StartRecord(const char *userName, const char *filePath = nullptr) override;
 
+	/**
+	 * @brief StartRecord Начать запись данных в файл с момента в прошлом (из истории, см. SetRecordingHistory)
+	 * @param userName Имя респондента
+	 * @param filePath Путь к BDF файлу, в который нужно записывать данные (nullptr - файл в папке SaveData)
+	 * @param preTriggerSeconds Сколько секунд истории записать перед текущим моментом (записывается доступная история, целыми секундами)
+	 * @return true если запись в файл началась успешно, false если запись не началась
+	 */
+    virtual bool StartRecord(const char *userName, const char *filePath, int preTriggerSeconds) override;
+
 	/**
 	 * @brief StopRecord Остановить запись данных в файл
 	 */
@@ -354,6 +513,74 @@ public:
 	 */
     virtual bool IsRecordPaused() const override { return m_RecordPaused; }
 
+	/**
+	 * @brief SetRecordingBuffers Установить буферизацию записи данных в файл (применяется со следующего StartRecord)
+	 * @param buffersCount Количество буферов (от 2 до 8)
+	 * @param bufferSeconds Длительность данных в одном буфере в секундах (от 1 до 30, при записи с историей буферы увеличиваются, чтобы вместить ее)
+	 * @return true если параметры корректны
+	 */
+    virtual bool SetRecordingBuffers(int buffersCount, int bufferSeconds) override;
+
+	/**
+	 * @brief SetRecordingMode Установить способ записи данных в файл (применяется со следующего StartRecord)
+	 * @param mode Способ записи из GARANT_EEG_RECORDING_MODE
+	 * @param flushInterval Интервал асинхронного сброса данных на диск для RM_MAPPED в миллисекундах (от 100 до 60000)
+	 * @return true если параметры корректны
+	 */
+    virtual bool SetRecordingMode(int mode, int flushInterval) override;
+
+	/**
+	 * @brief SetRecordingDurability Установить политику сохранности записи при аварийном завершении (применяется со следующего StartRecord)
+	 * @param durability Политика из GARANT_EEG_RECORDING_DURABILITY
+	 * @param commitInterval Интервал передачи данных системе и обновления количества записей в заголовке в миллисекундах (от 100 до 60000)
+	 * @param syncInterval Интервал принудительной записи данных на диск для RD_SYNC в миллисекундах (от 100 до 600000, не чаще commitInterval)
+	 * @return true если параметры корректны
+	 */
+    virtual bool SetRecordingDurability(int durability, int commitInterval, int syncInterval) override;
+
+	/**
+	 * @brief SetRecordingDerivedSignals Установить производные сигналы, записываемые вместе с исходными данными в дополнительный файл
+	 * с той же длительностью записей данных, тем же способом и политикой сохранности (применяется со следующего StartRecord)
+	 * @param signals Флаги GARANT_EEG_RECORDING_DERIVED
+	 * @return true если флаги корректны
+	 */
+    virtual bool SetRecordingDerivedSignals(int signals) override;
+
+	/**
+	 * @brief SetRecordingHistory Установить длительность истории исходных данных в памяти, с которой может начинаться запись
+	 * (StartRecord с preTriggerSeconds). История накапливается все время трансляции и сбрасывается при ее перезапуске
+	 * @param seconds Длительность истории в секундах (0 - без истории, до 60)
+	 * @return true если длительность корректна
+	 */
+    virtual bool SetRecordingHistory(int seconds) override;
+
+	/**
+	 * @brief SetRecordingSegmentation Установить разбиение записи на сегменты (применяется со следующего StartRecord).
+	 * Сегменты - отдельные файлы с полным заголовком ("запись_0001.bdf", "запись_0002.bdf", ...), переход без потери записей данных,
+	 * границы сегментов кратны секунде. О закрытии каждого сегмента сообщается состоянием DRS_SEGMENT_CLOSED (из потока записи,
+	 * для последнего сегмента - из StopRecord перед DRS_RECORD_STOPPED). Дополнительный файл производных сигналов делится
+	 * на сегменты с теми же границами (сегмент, целиком приходящийся на историю до начала записи, для него не создается)
+	 * @param segmentSeconds Длительность сегмента в секундах (0 - без ограничения, до 86400)
+	 * @param segmentMegabytes Максимальный размер сегмента в мегабайтах (0 - без ограничения; для RM_COMPRESSED - размер несжатых данных)
+	 * @return true если параметры корректны
+	 */
+    virtual bool SetRecordingSegmentation(int segmentSeconds, int segmentMegabytes) override;
+
+	/**
+	 * @brief GetLastClosedSegment Получить путь к последнему закрытому сегменту записи (например, в коллбэке DRS_SEGMENT_CLOSED)
+	 * @param filePath Буфер для пути к файлу
+	 * @param size Размер буфера
+	 * @return true если сегмент был закрыт и путь помещается в буфер
+	 */
+    virtual bool GetLastClosedSegment(char *filePath, int size) override;
+
+	/**
+	 * @brief GetRecordingStatistics Получить статистику записи данных в файл (текущей или последней записи)
+	 * @param statistics Указатель на структуру статистики
+	 * @return true если статистика получена
+	 */
+    virtual bool GetRecordingStatistics(GARANT_EEG_RECORDING_STATISTICS *statistics) override;
+
 	/**
 	 * @brief SetAutoReconnection Установить состояние автопереподключения к устройству при разрыве соединения
 	 * @param enable Новое состояние
@@ -414,6 +641,19 @@ public:
 	 */
     virtual int GetRate() const override { return m_Rate; }
 
+	/**
+	 * @brief SetOutputRate Установить частоту дискретизации данных, передаваемых в коллбэк приема данных (фильтры работают на выходной частоте)
+	 * @param rate Выходная частота (0 или частота не меньше частоты устройства - без понижения частоты)
+	 * @return true если частота установлена, false если частота некорректна
+	 */
+    virtual bool SetOutputRate(int rate) override;
+
+	/**
+	 * @brief GetOutputRate Получить частоту дискретизации данных, передаваемых в коллбэк приема данных
+	 * @return Частота дискретизации данных
+	 */
+    virtual int GetOutputRate() const override { return ((m_OutputRate > 0 && m_OutputRate < m_Rate) ? m_OutputRate : m_Rate); }
+
 	/**
 	 * @brief GetBatteryStatus Получить уровень заряда аккумулятора
 	 * @return Значение в процентах
@@ -458,6 +698,17 @@ public:
 	 */
     virtual const CAbstractFilter* AddFilter(int type, int order, int channelsCount, const int *channelsList) override;
 
+	/**
+	 * @brief AddFilter Добавить фильтр с указанием каналов и формы реализации звеньев БИХ фильтра
+	 * @param type Тип фильтра
+	 * @param order Порядок фильтра
+	 * @param channelsCount Количество каналов
+	 * @param channelsList Список каналов
+	 * @param stateForm Форма реализации звеньев из GARANT_EEG_FILTER_STATE_FORM (учитывается для FT_BUTTERWORTH)
+	 * @return Указатель на созданный фильтр или nullptr в случае, если не удалось создать фильтр с указанными параметрами
+	 */
+    virtual const CAbstractFilter* AddFilter(int type, int order, int channelsCount, const int *channelsList, int stateForm) override;
+
 	/**
 	 * @brief SetupFilter Установить настройки фильтра
 	 * @param filter Указатель на фильтр для установки настроек
@@ -468,6 +719,100 @@ public:
 	 */
     virtual bool SetupFilter(const CAbstractFilter *filter, int rate, int lowFrequency, int hightFrequency) override;
 
+	/**
+	 * @brief SetupFilter Установить настройки фильтра с плавным переходом от текущих настроек (без сброса состояния фильтра и переходного процесса)
+	 * @param filter Указатель на фильтр для установки настроек
+	 * @param rate Частота дискретизации данных
+	 * @param lowFrequency Нижняя частота среза
+	 * @param hightFrequency Верхняя частота среза
+	 * @param transitionSamples Количество отсчетов, за которое коэффициенты фильтра плавно перейдут к новым значениям (0 - мгновенное применение)
+	 * @return true если настройки применены, false если нет
+	 */
+    virtual bool SetupFilter(const CAbstractFilter *filter, int rate, int lowFrequency, int hightFrequency, int transitionSamples) override;
+
+	/**
+	 * @brief SetupNotchFilter Установить настройки гребенчатого режекторного фильтра сетевой наводки (FT_NOTCH_COMB)
+	 * @param filter Указатель на фильтр для установки настроек
+	 * @param rate Частота дискретизации данных
+	 * @param frequency Номинальная частота сети (50 или 60 Гц)
+	 * @param q Добротность каждой режекции (ширина режекции - частота гармоники / q)
+	 * @param adaptive Отслеживать реальную частоту сети по первому каналу фильтра и плавно перестраивать режекции
+	 * @param transitionSamples Количество отсчетов, за которое коэффициенты фильтра плавно перейдут к новым значениям (0 - мгновенное применение)
+	 * @return true если настройки применены, false если нет
+	 */
+    virtual bool SetupNotchFilter(const CAbstractFilter *filter, int rate, double frequency, double q, bool adaptive, int transitionSamples) override;
+
+	/**
+	 * @brief GetNotchFilterFrequency Получить текущую частоту режекции основной гармоники (при отслеживании - отслеженная частота сети)
+	 * @param filter Указатель на фильтр
+	 * @return Частота или -1, если фильтр не является гребенчатым режекторным фильтром
+	 */
+    virtual double GetNotchFilterFrequency(const CAbstractFilter *filter) override;
+
+	/**
+	 * @brief SetFixedPointFilterOptions Установить параметры целочисленного фильтра (FT_BUTTERWORTH_FIXED)
+	 * @param filter Указатель на фильтр
+	 * @param rounding Режим округления из GARANT_EEG_FIXED_POINT_ROUNDING
+	 * @param saturation true - насыщение при переполнении, false - циклический перенос
+	 * @return true если параметры применены, false если фильтр не найден, не является целочисленным или режим не поддерживается
+	 */
+    virtual bool SetFixedPointFilterOptions(const CAbstractFilter *filter, int rounding, bool saturation) override;
+
+	/**
+	 * @brief SetFilterNumericsMode Установить режим борьбы с денормализованными числами для БИХ фильтра
+	 * @param filter Указатель на фильтр
+	 * @param mode Режим из GARANT_EEG_FILTER_NUMERICS_MODE (FNM_FLUSH_TO_ZERO - FTZ/DAZ в потоке фильтрации без добавления константы к отсчетам)
+	 * @return true если режим применен, false если фильтр не найден или не поддерживает режим
+	 */
+    virtual bool SetFilterNumericsMode(const CAbstractFilter *filter, int mode) override;
+
+	/**
+	 * @brief GetFilterStateSize Получить размер буфера для сохранения состояния фильтра
+	 * @param filter Указатель на фильтр
+	 * @return Размер в байтах или 0, если фильтр не найден или не поддерживает сохранение состояния
+	 */
+    virtual int GetFilterStateSize(const CAbstractFilter *filter) override;
+
+	/**
+	 * @brief SaveFilterState Сохранить состояние фильтра (линии задержки звеньев всех каналов) для быстрого "теплого" перезапуска
+	 * @param filter Указатель на фильтр
+	 * @param buffer Буфер для записи
+	 * @param size Размер буфера (не меньше GetFilterStateSize)
+	 * @return true если состояние сохранено
+	 */
+    virtual bool SaveFilterState(const CAbstractFilter *filter, void *buffer, int size) override;
+
+	/**
+	 * @brief RestoreFilterState Восстановить сохраненное состояние фильтра (тип, порядок, форма звеньев, каналы и частоты фильтра должны совпадать с сохраненными)
+	 * @param filter Указатель на фильтр
+	 * @param buffer Сохраненное состояние
+	 * @param size Размер сохраненного состояния
+	 * @return true если состояние восстановлено
+	 */
+    virtual bool RestoreFilterState(const CAbstractFilter *filter, const void *buffer, int size) override;
+
+	/**
+	 * @brief SetFilterSteadyStateInit Включить инициализацию состояния фильтра по первому отсчету после подключения или возобновления трансляции (установившийся режим для постоянного сигнала, переходный процесс почти отсутствует)
+	 * @param filter Указатель на фильтр
+	 * @param enabled true - включить (восстановленное после перезапуска состояние имеет приоритет)
+	 * @return true если настройка применена, false если фильтр не найден или не поддерживает инициализацию
+	 */
+    virtual bool SetFilterSteadyStateInit(const CAbstractFilter *filter, bool enabled) override;
+
+	/**
+	 * @brief GetFiltersResponse Рассчитать частотную характеристику цепочки фильтров на сетке частот (для отображения)
+	 * @param filters Список фильтров цепочки (характеристики перемножаются)
+	 * @param filtersCount Количество фильтров
+	 * @param pointsCount Количество точек сетки
+	 * @param firstFrequency Первая частота сетки в Гц
+	 * @param lastFrequency Последняя частота сетки в Гц
+	 * @param logarithmic true - логарифмическая сетка (частоты больше 0), false - равномерная
+	 * @param magnitude Буфер для модуля характеристики (pointsCount значений) или nullptr
+	 * @param phase Буфер для фазы характеристики в радианах (pointsCount значений) или nullptr
+	 * @return true если характеристика рассчитана, false если фильтр не найден или не поддерживает расчет характеристики
+	 */
+    virtual bool GetFiltersResponse(const CAbstractFilter * const *filters, int filtersCount, int pointsCount, double firstFrequency, double lastFrequency, bool logarithmic, double *magnitude, double *phase) override;
+
 	/**
 	 * @brief RemoveFilter Удалить фильтр
 	 * @param filter Указатель на фильтр для удаления
@@ -479,6 +824,18 @@ public:
 	 */
     virtual void RemoveAllFilters() override;
 
+	/**
+	 * @brief SetFilterThreadsCount Установить количество рабочих потоков для параллельной фильтрации каналов
+	 * @param count Количество потоков (0 - фильтрация в потоке приема данных)
+	 */
+    virtual void SetFilterThreadsCount(int count) override;
+
+	/**
+	 * @brief GetFilterThreadsCount Получить количество рабочих потоков для параллельной фильтрации каналов
+	 * @return Количество потоков
+	 */
+    virtual int GetFilterThreadsCount() const override { return m_FilterThreadsCount; }
+
 
 
 	/**
@@ -0,0 +1,237 @@
+/**
+@file EegReplay.cpp
+
+@brief Класс для воспроизведения записанного BDF (GCR) файла как устройства EEG8
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include "src/EegReplay.h"
+#include <windows.h>
+#include <QDebug>
+#include <chrono>
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+CEegReplay::CEegReplay()
+: CEeg8()
+{
+    //Сокет не создается, команды устройству (SendPacket) игнорируются
+    m_Socket = INVALID_SOCKET;
+}
+//----------------------------------------------------------------------------------
+CEegReplay::~CEegReplay()
+{
+    Stop();
+
+    if (m_Thread.joinable())
+        m_Thread.join();
+}
+//----------------------------------------------------------------------------------
+bool CEegReplay::Start(bool waitForConnection, int rate, const char *host, int port)
+{
+    (void)rate;
+    (void)port;
+
+    if (m_Started || m_ConnectionStage == CS_CONNECTED)
+        return true;
+    else if (m_ConnectionStage == CS_CONNECTING)
+        return false;
+
+    m_ConnectionStage = CS_NONE;
+    m_Started = false;
+    m_Recording = false;
+    m_RecordPaused = false;
+    m_TranslationPaused = false;
+
+    m_Host = (host != nullptr ? host : "");
+
+    if (m_Thread.joinable())
+        m_Thread.join();
+
+    m_ConnectionStage = CS_CONNECTING;
+    m_Thread = thread([](CEegReplay *eeg){ qDebug() << "replay thread start"; eeg->ReplayThreadFunction(); qDebug() << "replay thread end"; }, this);
+
+    while (waitForConnection && m_ConnectionStage == CS_CONNECTING)
+        Sleep(1);
+
+    //При максимальной скорости короткий файл может быть воспроизведен до конца раньше этой проверки
+    if (waitForConnection)
+        return (m_ConnectionStage != CS_CONNECTION_ERROR);
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+bool CEegReplay::SetReplayOptions(double speed, bool loop)
+{
+    if (speed < 0.0 || speed > 1000.0)
+        return false;
+
+    m_ReplaySpeed = speed;
+    m_ReplayLoop = loop;
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+bool CEegReplay::OpenReplayFile()
+{
+    m_BdfReader.Close();
+    m_GcrReader.Close();
+
+    vector<char> header;
+    int recordSize = 0;
+
+    if (m_GcrReader.Open(m_Host))
+    {
+        header = m_GcrReader.HeaderData();
+        recordSize = m_GcrReader.Header().RecordSize();
+    }
+    else if (m_BdfReader.Open(m_Host))
+    {
+        FILE *file = fopen(m_Host.c_str(), "rb");
+
+        if (file == nullptr)
+            return false;
+
+        header.resize(m_BdfReader.Header().HeaderSize());
+        bool headerRead = (fread(&header[0], header.size(), 1, file) == 1);
+        fclose(file);
+
+        if (!headerRead)
+            return false;
+
+        recordSize = m_BdfReader.Header().RecordSize();
+    }
+    else
+        return false;
+
+    //Файл должен быть записан этим устройством: 22 сигнала и размер фрэйма одной из частот
+    if ((int)header.size() != m_HeaderSize)
+        return false;
+
+    if (recordSize == 765)
+        m_Rate = 250;
+    else if (recordSize == 1365)
+        m_Rate = 500;
+    else if (recordSize == 2565)
+        m_Rate = 1000;
+    else
+        return false;
+
+    m_DataSize = recordSize;
+    m_HeaderData = header;
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+void CEegReplay::ReplayThreadFunction()
+{
+    if (!OpenReplayFile())
+    {
+        qDebug() << "can not replay" << m_Host.c_str();
+
+        m_ConnectionStage = CS_CONNECTION_ERROR;
+
+        if (m_Callback_OnStartStateChanged != nullptr)
+            m_Callback_OnStartStateChanged(m_CallbackUserData_OnStartStateChanged, DCS_HOST_NOT_FOUND);
+
+        return;
+    }
+
+    const bool compressed = m_GcrReader.IsOpened();
+    const long long recordsCount = (compressed ? m_GcrReader.RecordsCount() : m_BdfReader.RecordsCount());
+
+    m_ConnectionStage = CS_CONNECTED;
+
+    //Фильтры перезапускаются до коллбэка, чтобы состояние, восстановленное в нем, не было перезаписано
+    RestartFilters();
+    ResetHistory();
+
+    if (m_Callback_OnStartStateChanged != nullptr)
+        m_Callback_OnStartStateChanged(m_CallbackUserData_OnStartStateChanged, DCS_NO_ERROR);
+
+    m_Started = true;
+
+    //Фрэйм копируется из файла, так как ProcessData работает с изменяемым буфером приема
+    vector<unsigned char> frame(m_DataSize);
+    long long index = 0;
+
+    //Темп считается от начала отрезка без пауз: фрэйм N отрезка передается через N * 100 мс / скорость
+    auto paceStart = std::chrono::steady_clock::now();
+    long long paceFrames = 0;
+    double paceSpeed = m_ReplaySpeed;
+
+    while (m_Started)
+    {
+        if (m_TranslationPaused)
+        {
+            Sleep(10);
+            paceFrames = 0;
+            continue;
+        }
+
+        if (index >= recordsCount)
+        {
+            if (!m_ReplayLoop || recordsCount < 1)
+                break;
+
+            //Начало файла не продолжает его конец, фильтры и история начинают заново
+            index = 0;
+            RestartFilters();
+            ResetHistory();
+        }
+
+        const int read = (compressed ? m_GcrReader.ReadRecords(index, 1, (char*)&frame[0]) : m_BdfReader.ReadRecords(index, 1, (char*)&frame[0]));
+
+        if (read != 1)
+            break;
+
+        index++;
+
+        ProcessData(&frame[0], m_DataSize);
+
+        const double speed = m_ReplaySpeed;
+
+        if (speed <= 0.0)
+            continue;
+
+        auto now = std::chrono::steady_clock::now();
+
+        //После паузы, смены скорости или отставания больше секунды (медленная обработка) темп отсчитывается заново
+        if (paceFrames == 0 || speed != paceSpeed || now - paceStart > std::chrono::duration<double>(paceFrames * 0.1 / speed + 1.0))
+        {
+            paceStart = now;
+            paceFrames = 0;
+            paceSpeed = speed;
+        }
+
+        paceFrames++;
+
+        std::this_thread::sleep_until(paceStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(paceFrames * 0.1 / speed)));
+    }
+
+    //Конец файла: запись закрывается, как при остановке, и сообщается о разрыве подключения.
+    //Остановка записи и сброс m_Started выполняются под m_RecordStateMutex, чтобы StartRecord пользователя
+    //не начал запись между ними, а StopRecord пользователя не закрывал файл одновременно с этим потоком
+    {
+        std::lock_guard<std::recursive_mutex> stateLock(m_RecordStateMutex);
+
+        if (m_Started)
+            StopRecord();
+
+        m_Started = false;
+    }
+
+    m_BdfReader.Close();
+    m_GcrReader.Close();
+
+    m_ConnectionStage = CS_NONE;
+    m_TranslationPaused = false;
+
+    if (m_Callback_OnStartStateChanged != nullptr)
+        m_Callback_OnStartStateChanged(m_CallbackUserData_OnStartStateChanged, DCS_CONNECTION_CLOSED);
+}
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
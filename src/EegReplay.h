@@ -0,0 +1,88 @@
+/**
+@file EegReplay.h
+
+@brief Класс для воспроизведения записанного BDF (GCR) файла как устройства EEG8
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#ifndef EEGREPLAY_H
+#define EEGREPLAY_H
+//----------------------------------------------------------------------------------
+#include "EEG8.h"
+#include "Recording/BdfReader.h"
+#include "Recording/GcrFile.h"
+#include <atomic>
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+//! Класс для воспроизведения записи. Записи данных файла - исходные фрэймы устройства, поэтому они передаются в ProcessData
+//! и проходят тот же путь, что и принятые по сети: распаковка, история, запись в файл, понижение частоты, фильтры, коллбэк.
+//! Start открывает файл (host - путь к файлу, частота берется из файла), конец файла обрабатывается как разрыв подключения.
+class CEegReplay : public CEeg8
+{
+protected:
+	//! Скорость воспроизведения (1.0 - реальное время, 0 - максимальная; меняется из потока пользователя во время воспроизведения)
+    std::atomic<double> m_ReplaySpeed{ 1.0 };
+
+	//! Воспроизводить файл по кругу (меняется из потока пользователя во время воспроизведения)
+    std::atomic<bool> m_ReplayLoop{ false };
+
+	//! Воспроизводимый BDF файл
+    CBdfReader m_BdfReader;
+
+	//! Воспроизводимый GCR файл
+    CGcrReader m_GcrReader;
+
+	/**
+	 * @brief OpenReplayFile Открыть файл воспроизведения и взять из него заголовок, частоту и размер фрэйма
+	 * @return true если файл открыт и записан этим устройством
+	 */
+    bool OpenReplayFile();
+
+	/**
+	 * @brief ReplayThreadFunction Функция потока воспроизведения
+	 */
+    void ReplayThreadFunction();
+
+public:
+	/**
+	 * @brief CEegReplay Конструктор
+	 */
+    CEegReplay();
+
+	/**
+	 * @brief ~CEegReplay Деструктор
+	 */
+    virtual ~CEegReplay();
+
+	/**
+	 * @brief GetType Получение типа устройства
+	 * @return Тип устройства
+	 */
+    virtual GARANT_EEG_DEVICE_TYPE GetType() const override { return DT_REPLAY; }
+
+	/**
+	 * @brief Start Начать воспроизведение файла
+	 * @param waitForConnection Ожидать ли открытия файла или открыть его в асинхронном режиме
+	 * @param rate Не используется (частота берется из файла)
+	 * @param host Путь к BDF или GCR файлу
+	 * @param port Не используется
+	 * @return true если файл открыт (или открытие началось, для асинхронного режима)
+	 */
+    virtual bool Start(bool waitForConnection = true, int rate = 500, const char *host = "", int port = 0) override;
+
+	/**
+	 * @brief SetReplayOptions Установить параметры воспроизведения (можно менять во время воспроизведения)
+	 * @param speed Скорость воспроизведения (1.0 - реальное время, N - в N раз быстрее, 0 - максимальная скорость)
+	 * @param loop Воспроизводить файл по кругу
+	 * @return true если параметры корректны
+	 */
+    virtual bool SetReplayOptions(double speed, bool loop) override;
+};
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
+#endif // EEGREPLAY_H
+//----------------------------------------------------------------------------------
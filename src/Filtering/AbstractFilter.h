@@ -64,6 +64,24 @@ public:
 	 * @return Частота
 	 */
     virtual int HightFrequency() const = 0;
+
+	/**
+	 * @brief Delay Получить постоянную задержку выходного сигнала фильтра
+	 * @return Задержка в отсчетах или -1, если фильтр имеет нелинейную фазу и постоянной задержки нет
+	 */
+    virtual int Delay() const { return -1; }
+
+	/**
+	 * @brief StateForm Получить форму реализации звеньев фильтра
+	 * @return Форма из GARANT_EEG_FILTER_STATE_FORM или -1, если фильтр не является БИХ фильтром
+	 */
+    virtual int StateForm() const { return -1; }
+
+	/**
+	 * @brief NumericsMode Получить режим борьбы с денормализованными числами
+	 * @return Режим из GARANT_EEG_FILTER_NUMERICS_MODE
+	 */
+    virtual int NumericsMode() const { return FNM_ANTI_DENORMAL; }
 };
 //----------------------------------------------------------------------------------
 } //namespace GarantEEG
@@ -0,0 +1,119 @@
+/**
+@file BaseFilter.cpp
+
+@brief Базовый класс для работы с фильтрами
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include "BaseFilter.h"
+#include <string.h>
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+/**
+ * @brief StateChecksum Подсчитать контрольную сумму FNV-1a
+ * @param hash Начальное значение
+ * @param data Данные
+ * @param size Размер данных
+ * @return Контрольная сумма
+ */
+static unsigned int StateChecksum(unsigned int hash, const void *data, int size)
+{
+    const unsigned char *bytes = (const unsigned char*)data;
+
+    for (int i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+//----------------------------------------------------------------------------------
+void CBaseFilter::FillStateHeader(FILTER_STATE_HEADER &header) const
+{
+    memset(&header, 0, sizeof(header));
+
+    header.Magic = FILTER_STATE_MAGIC;
+    header.Version = FILTER_STATE_VERSION;
+    header.Type = Type();
+    header.Order = Order();
+    header.StateForm = StateForm();
+    header.ChannelsCount = ChannelsCount();
+    header.Rate = Rate();
+    header.LowFrequency = LowFrequency();
+    header.HightFrequency = HightFrequency();
+    header.DataSize = StateDataSize();
+}
+//----------------------------------------------------------------------------------
+int CBaseFilter::StateSize() const
+{
+    const int dataSize = StateDataSize();
+
+    if (dataSize < 1)
+        return 0;
+
+    return (int)sizeof(FILTER_STATE_HEADER) + ChannelsCount() * (int)sizeof(int) + dataSize;
+}
+//----------------------------------------------------------------------------------
+bool CBaseFilter::SaveState(void *buffer, int size) const
+{
+    const int stateSize = StateSize();
+
+    if (buffer == nullptr || stateSize < 1 || size < stateSize)
+        return false;
+
+    FILTER_STATE_HEADER header;
+    FillStateHeader(header);
+
+    const int channelsSize = header.ChannelsCount * (int)sizeof(int);
+    unsigned char *channels = (unsigned char*)buffer + sizeof(FILTER_STATE_HEADER);
+    unsigned char *data = channels + channelsSize;
+
+    memcpy(channels, ChannelsList(), channelsSize);
+    SaveStateData(data);
+
+    header.Checksum = StateChecksum(2166136261u, channels, channelsSize + header.DataSize);
+    memcpy(buffer, &header, sizeof(header));
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+bool CBaseFilter::RestoreState(const void *buffer, int size)
+{
+    const int stateSize = StateSize();
+
+    if (buffer == nullptr || stateSize < 1 || size != stateSize)
+        return false;
+
+    FILTER_STATE_HEADER saved;
+    memcpy(&saved, buffer, sizeof(saved));
+
+    FILTER_STATE_HEADER header;
+    FillStateHeader(header);
+
+    //Состояние применимо только к фильтру с теми же коэффициентами и той же раскладкой данных
+    if (saved.Magic != header.Magic || saved.Version != header.Version || saved.Type != header.Type ||
+            saved.Order != header.Order || saved.StateForm != header.StateForm || saved.ChannelsCount != header.ChannelsCount ||
+            saved.Rate != header.Rate || saved.LowFrequency != header.LowFrequency || saved.HightFrequency != header.HightFrequency ||
+            saved.DataSize != header.DataSize)
+        return false;
+
+    const int channelsSize = header.ChannelsCount * (int)sizeof(int);
+    const unsigned char *channels = (const unsigned char*)buffer + sizeof(FILTER_STATE_HEADER);
+
+    if (memcmp(channels, ChannelsList(), channelsSize) || saved.Checksum != StateChecksum(2166136261u, channels, channelsSize + header.DataSize))
+        return false;
+
+    RestoreStateData(channels + channelsSize);
+
+    //Восстановленное состояние не должно быть перезаписано инициализацией по первому отсчету
+    m_SteadyStatePending = false;
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
@@ -11,12 +11,91 @@
 //----------------------------------------------------------------------------------
 #include "AbstractFilter.h"
 //----------------------------------------------------------------------------------
+namespace Dsp
+{
+class FrequencyResponse;
+}
+//----------------------------------------------------------------------------------
 namespace GarantEEG
 {
 //----------------------------------------------------------------------------------
+//! Сигнатура сохраненного состояния фильтра ("GFST")
+const unsigned int FILTER_STATE_MAGIC = 0x54534647;
+
+//! Версия формата сохраненного состояния фильтра
+const unsigned int FILTER_STATE_VERSION = 1;
+//----------------------------------------------------------------------------------
+//! Заголовок сохраненного состояния фильтра (за ним следуют список каналов и данные состояния)
+struct FILTER_STATE_HEADER
+{
+	//! Сигнатура FILTER_STATE_MAGIC
+    unsigned int Magic;
+
+	//! Версия формата
+    unsigned int Version;
+
+	//! Тип фильтра
+    int Type;
+
+	//! Порядок фильтра
+    int Order;
+
+	//! Форма реализации звеньев
+    int StateForm;
+
+	//! Количество каналов
+    int ChannelsCount;
+
+	//! Рабочая частота
+    int Rate;
+
+	//! Нижняя планка среза
+    int LowFrequency;
+
+	//! Верхняя планка среза
+    int HightFrequency;
+
+	//! Размер данных состояния
+    int DataSize;
+
+	//! Контрольная сумма списка каналов и данных состояния (FNV-1a)
+    unsigned int Checksum;
+};
+//----------------------------------------------------------------------------------
 //! Базовый класс для работы с фильтрами
 class CBaseFilter : public CAbstractFilter
 {
+protected:
+	//! Флаг инициализации состояния по первому отсчету после перезапуска потока данных
+    bool m_SteadyStateInit = false;
+
+	//! Флаг ожидания инициализации состояния по первому отсчету следующего блока
+    bool m_SteadyStatePending = false;
+
+	/**
+	 * @brief StateDataSize Получить размер данных состояния каналов
+	 * @return Размер в байтах (0 - фильтр не поддерживает сохранение состояния)
+	 */
+    virtual int StateDataSize() const { return 0; }
+
+	/**
+	 * @brief SaveStateData Записать данные состояния каналов
+	 * @param data Указатель на буфер размером StateDataSize()
+	 */
+    virtual void SaveStateData(void *data) const { (void)data; }
+
+	/**
+	 * @brief RestoreStateData Загрузить данные состояния каналов
+	 * @param data Указатель на данные размером StateDataSize()
+	 */
+    virtual void RestoreStateData(const void *data) { (void)data; }
+
+	/**
+	 * @brief FillStateHeader Заполнить заголовок состояния по текущим настройкам фильтра
+	 * @param header Заголовок
+	 */
+    virtual void FillStateHeader(FILTER_STATE_HEADER &header) const;
+
 public:
 	/**
 	 * @brief ~CBaseFilter Деструктор
@@ -28,15 +107,94 @@ public:
 	 * @param rate Рабочая частота
 	 * @param lowFrequency Нижняя планка среза
 	 * @param hightFrequency Верхняя планка среза
+	 * @param transitionSamples Количество отсчетов плавного перехода к новым настройкам (0 - мгновенное применение)
 	 */
-    virtual void Setup(int rate, int lowFrequency, int hightFrequency) = 0;
+    virtual void Setup(int rate, int lowFrequency, int hightFrequency, int transitionSamples) = 0;
 
 	/**
 	 * @brief Process Функция фильтрации данных
 	 * @param count Количетво данных
 	 * @param samples Указатель на список данных по каналам
 	 */
-    virtual void Process(int count, float **samples) = 0;
+    virtual void Process(int count, float **samples)
+    {
+        ProcessChannels(count, samples, 0, ChannelsCount());
+        FinishProcess(count);
+    }
+
+	/**
+	 * @brief ProcessChannels Функция фильтрации части каналов (непересекающиеся диапазоны каналов могут обрабатываться параллельно)
+	 * @param count Количетво данных
+	 * @param samples Указатель на список данных по всем каналам фильтра
+	 * @param firstChannel Индекс первого обрабатываемого канала
+	 * @param channelsCount Количество обрабатываемых каналов
+	 */
+    virtual void ProcessChannels(int count, float **samples, int firstChannel, int channelsCount) = 0;
+
+	/**
+	 * @brief FinishProcess Функция завершения обработки блока данных (вызывается один раз после обработки всех каналов)
+	 * @param count Количетво данных
+	 */
+    virtual void FinishProcess(int count) = 0;
+
+	/**
+	 * @brief SetNumericsMode Установить режим борьбы с денормализованными числами
+	 * @param mode Режим из GARANT_EEG_FILTER_NUMERICS_MODE
+	 * @return true если режим поддерживается фильтром
+	 */
+    virtual bool SetNumericsMode(int mode) { return (mode == FNM_ANTI_DENORMAL); }
+
+	/**
+	 * @brief NativeInput Проверить, принимает ли фильтр исходные целые отсчеты АЦП вместо физических значений
+	 * @return true если фильтру передаются целые отсчеты
+	 */
+    virtual bool NativeInput() const { return false; }
+
+	/**
+	 * @brief Response Домножить частотную характеристику на характеристику фильтра (сетка частот задается в Гц, частота дискретизации устанавливается фильтром)
+	 * @param response Частотная характеристика цепочки фильтров
+	 * @return true если фильтр поддерживает расчет характеристики
+	 */
+    virtual bool Response(Dsp::FrequencyResponse &response) const { (void)response; return false; }
+
+	/**
+	 * @brief StateSize Получить размер буфера для сохранения состояния фильтра
+	 * @return Размер в байтах (0 - фильтр не поддерживает сохранение состояния)
+	 */
+    int StateSize() const;
+
+	/**
+	 * @brief SaveState Сохранить состояние каналов фильтра (линии задержки звеньев) вместе с заголовком для проверки при восстановлении
+	 * @param buffer Буфер для записи
+	 * @param size Размер буфера (не меньше StateSize())
+	 * @return true если состояние сохранено
+	 */
+    bool SaveState(void *buffer, int size) const;
+
+	/**
+	 * @brief RestoreState Восстановить состояние каналов фильтра (тип, порядок, форма звеньев, каналы и настройки частот должны совпадать)
+	 * @param buffer Сохраненное состояние
+	 * @param size Размер сохраненного состояния
+	 * @return true если состояние восстановлено
+	 */
+    bool RestoreState(const void *buffer, int size);
+
+	/**
+	 * @brief SetSteadyStateInit Включить инициализацию состояния по первому отсчету после перезапуска потока данных (установившийся режим для постоянного сигнала, без переходного процесса)
+	 * @param enabled true - включить
+	 */
+    void SetSteadyStateInit(bool enabled) { m_SteadyStateInit = (enabled && StateDataSize() > 0); }
+
+	/**
+	 * @brief SteadyStateInit Проверить, включена ли инициализация состояния по первому отсчету
+	 * @return true если включена
+	 */
+    bool SteadyStateInit() const { return m_SteadyStateInit; }
+
+	/**
+	 * @brief Restart Сообщить фильтру о перезапуске потока данных (при включенной инициализации состояние будет установлено по первому отсчету следующего блока)
+	 */
+    void Restart() { m_SteadyStatePending = m_SteadyStateInit; }
 };
 //----------------------------------------------------------------------------------
 } //namespace GarantEEG
@@ -11,17 +11,23 @@
 //----------------------------------------------------------------------------------
 #include "BaseFilter.h"
 #include "dspfilter/Butterworth.h"
+#include "dspfilter/SmoothedFilter.h"
+#include "dspfilter/FrequencyResponse.h"
+#include "FlushDenormalsGuard.h"
 //----------------------------------------------------------------------------------
 namespace GarantEEG
 {
 //----------------------------------------------------------------------------------
 //! Реализация фильтра Butterworth
-template<int MaxOrder, int MaxChannels = 8>
+template<int MaxOrder, int MaxChannels = 8, class StateType = Dsp::DirectFormII>
 class CButterworthFilter : public CBaseFilter
 {
 protected:
-	//! Фильтр
-    Dsp::SimpleFilter<Dsp::Butterworth::BandPass<MaxOrder>, MaxChannels> m_Filter;
+	//! Фильтр (с плавной перестройкой коэффициентов при смене настроек)
+    Dsp::SmoothedFilter<Dsp::Butterworth::BandPass<MaxOrder>, MaxChannels, StateType> m_Filter;
+
+	//! Режим борьбы с денормализованными числами
+    int m_NumericsMode = FNM_ANTI_DENORMAL;
 
 	//! Рабочая частота
     int m_Rate = 500;
@@ -35,6 +41,28 @@ protected:
 	//! Список каналов, для которых применяется фильтр
     int m_ChannelsList[MaxChannels];
 
+	/**
+	 * @brief StateDataSize Получить размер данных состояния каналов
+	 * @return Размер в байтах
+	 */
+    virtual int StateDataSize() const override { return m_Filter.getStateSize(); }
+
+	/**
+	 * @brief SaveStateData Записать данные состояния каналов
+	 * @param data Указатель на буфер размером StateDataSize()
+	 */
+    virtual void SaveStateData(void *data) const override { m_Filter.saveState(data); }
+
+	/**
+	 * @brief RestoreStateData Загрузить данные состояния каналов
+	 * @param data Указатель на данные размером StateDataSize()
+	 */
+    virtual void RestoreStateData(const void *data) override
+    {
+        m_Filter.restoreState(data);
+        m_Filter.setDenormalPrevention(m_NumericsMode == FNM_ANTI_DENORMAL);
+    }
+
 public:
 	/**
 	 * @brief CButterworthFilter Конструктор
@@ -52,27 +80,51 @@ public:
 	 * @param rate Рабочая частота
 	 * @param lowFrequency Нижняя планка среза
 	 * @param hightFrequency Верхняя планка среза
+	 * @param transitionSamples Количество отсчетов плавного перехода к новым настройкам (0 - мгновенное применение)
 	 */
-    virtual void Setup(int rate, int lowFrequency, int hightFrequency) override
+    virtual void Setup(int rate, int lowFrequency, int hightFrequency, int transitionSamples) override
     {
+        //При смене частоты дискретизации плавный переход не имеет смысла
+        m_Filter.setTransitionSamples(rate == m_Rate ? transitionSamples : 0);
+
         m_Rate = rate;
         m_LowFrequency = lowFrequency;
         m_HightFrequency = hightFrequency;
 
-        double centerFrequency = ((m_LowFrequency + (m_HightFrequency - m_LowFrequency)) / 2.0);
-        double widthFrequency = ((m_HightFrequency - m_LowFrequency) / 2.0);
+        double centerFrequency = ((m_LowFrequency + m_HightFrequency) / 2.0);
+        double widthFrequency = (double)(m_HightFrequency - m_LowFrequency);
 
         m_Filter.setup(MaxOrder, rate, centerFrequency, widthFrequency);
     }
 
 	/**
-	 * @brief Process Функция фильтрации данных
+	 * @brief ProcessChannels Функция фильтрации части каналов (непересекающиеся диапазоны каналов могут обрабатываться параллельно)
+	 * @param count Количетво данных
+	 * @param samples Указатель на список данных по всем каналам фильтра
+	 * @param firstChannel Индекс первого обрабатываемого канала
+	 * @param channelsCount Количество обрабатываемых каналов
+	 */
+    virtual void ProcessChannels(int count, float **samples, int firstChannel, int channelsCount) override
+    {
+        //Режим FTZ/DAZ устанавливается в том потоке, который выполняет фильтрацию
+        CFlushDenormalsGuard guard(m_NumericsMode == FNM_FLUSH_TO_ZERO);
+
+        if (m_SteadyStatePending && count > 0)
+            m_Filter.setSteadyState(samples, firstChannel, channelsCount);
+
+        m_Filter.processChannels(count, samples, firstChannel, channelsCount);
+    }
+
+	/**
+	 * @brief FinishProcess Функция завершения обработки блока данных (вызывается один раз после обработки всех каналов)
 	 * @param count Количетво данных
-	 * @param samples Указатель на список данных по каналам
 	 */
-    virtual void Process(int count, float **samples) override
+    virtual void FinishProcess(int count) override
     {
-        m_Filter.process(count, samples);
+        if (count > 0)
+            m_SteadyStatePending = false;
+
+        m_Filter.advance(count);
     }
 
 	/**
@@ -87,6 +139,47 @@ public:
 	 */
     virtual int Order() const override { return MaxOrder; }
 
+	/**
+	 * @brief StateForm Получить форму реализации звеньев фильтра
+	 * @return Форма из GARANT_EEG_FILTER_STATE_FORM
+	 */
+    virtual int StateForm() const override { return StateFormOf((StateType*)nullptr); }
+
+	/**
+	 * @brief NumericsMode Получить режим борьбы с денормализованными числами
+	 * @return Режим из GARANT_EEG_FILTER_NUMERICS_MODE
+	 */
+    virtual int NumericsMode() const override { return m_NumericsMode; }
+
+	/**
+	 * @brief SetNumericsMode Установить режим борьбы с денормализованными числами
+	 * @param mode Режим из GARANT_EEG_FILTER_NUMERICS_MODE
+	 * @return true если режим поддерживается фильтром
+	 */
+    virtual bool SetNumericsMode(int mode) override
+    {
+        if (mode != FNM_ANTI_DENORMAL && mode != FNM_FLUSH_TO_ZERO)
+            return false;
+
+        m_NumericsMode = mode;
+        m_Filter.setDenormalPrevention(mode == FNM_ANTI_DENORMAL);
+
+        return true;
+    }
+
+	/**
+	 * @brief Response Домножить частотную характеристику на характеристику фильтра (коэффициенты последней перенастройки)
+	 * @param response Частотная характеристика цепочки фильтров
+	 * @return true
+	 */
+    virtual bool Response(Dsp::FrequencyResponse &response) const override
+    {
+        response.setSampleRate((double)m_Rate);
+        response.multiply(m_Filter);
+
+        return true;
+    }
+
 	/**
 	 * @brief ChannelsCount Получить количество каналов, для которых работает фильтр
 	 * @return Количество каналов
@@ -121,28 +214,59 @@ public:
 	 * @brief Create Функция создания фильтра
 	 * @param order Порядок фильтра
 	 * @param channelsList Список каналов
+	 * @param stateForm Форма реализации звеньев из GARANT_EEG_FILTER_STATE_FORM
+	 * @return Указатель на созданный фильтр или nullptr если фильтр не был создан
+	 */
+    static CBaseFilter *Create(int order, const int *channelsList, int stateForm = FSF_DIRECT_FORM_II)
+    {
+        switch (stateForm)
+        {
+            case FSF_DIRECT_FORM_II: return CreateForm<Dsp::DirectFormII>(order, channelsList);
+            case FSF_DIRECT_FORM_I: return CreateForm<Dsp::DirectFormI>(order, channelsList);
+            case FSF_TRANSPOSED_DIRECT_FORM_II: return CreateForm<Dsp::TransposedDirectFormII>(order, channelsList);
+            case FSF_DIRECT_FORM_I_FLOAT: return CreateForm<Dsp::DirectFormIFloat>(order, channelsList);
+            case FSF_TRANSPOSED_DIRECT_FORM_II_FLOAT: return CreateForm<Dsp::TransposedDirectFormIIFloat>(order, channelsList);
+            default:
+                break;
+        }
+
+        return nullptr;
+    }
+
+private:
+	/**
+	 * @brief CreateForm Функция создания фильтра с заданной формой звеньев
+	 * @param order Порядок фильтра
+	 * @param channelsList Список каналов
 	 * @return Указатель на созданный фильтр или nullptr если фильтр не был создан
 	 */
-    static CBaseFilter *Create(int order, const int *channelsList)
+    template<class FormType>
+    static CBaseFilter *CreateForm(int order, const int *channelsList)
     {
-        //for (int i = 1; i <= 8; i++) qDebug("case %i: return new CButterworthFilter<%i, MaxChannels>(channelsList);", i, i);
+        //for (int i = 1; i <= 8; i++) qDebug("case %i: return new CButterworthFilter<%i, MaxChannels, FormType>(channelsList);", i, i);
 
         switch (order)
         {
-            case 1: return new CButterworthFilter<1, MaxChannels>(channelsList);
-            case 2: return new CButterworthFilter<2, MaxChannels>(channelsList);
-            case 3: return new CButterworthFilter<3, MaxChannels>(channelsList);
-            case 4: return new CButterworthFilter<4, MaxChannels>(channelsList);
-            case 5: return new CButterworthFilter<5, MaxChannels>(channelsList);
-            case 6: return new CButterworthFilter<6, MaxChannels>(channelsList);
-            case 7: return new CButterworthFilter<7, MaxChannels>(channelsList);
-            case 8: return new CButterworthFilter<8, MaxChannels>(channelsList);
+            case 1: return new CButterworthFilter<1, MaxChannels, FormType>(channelsList);
+            case 2: return new CButterworthFilter<2, MaxChannels, FormType>(channelsList);
+            case 3: return new CButterworthFilter<3, MaxChannels, FormType>(channelsList);
+            case 4: return new CButterworthFilter<4, MaxChannels, FormType>(channelsList);
+            case 5: return new CButterworthFilter<5, MaxChannels, FormType>(channelsList);
+            case 6: return new CButterworthFilter<6, MaxChannels, FormType>(channelsList);
+            case 7: return new CButterworthFilter<7, MaxChannels, FormType>(channelsList);
+            case 8: return new CButterworthFilter<8, MaxChannels, FormType>(channelsList);
             default:
                 break;
         }
 
         return nullptr;
     }
+
+    static int StateFormOf(Dsp::DirectFormII*) { return FSF_DIRECT_FORM_II; }
+    static int StateFormOf(Dsp::DirectFormI*) { return FSF_DIRECT_FORM_I; }
+    static int StateFormOf(Dsp::TransposedDirectFormII*) { return FSF_TRANSPOSED_DIRECT_FORM_II; }
+    static int StateFormOf(Dsp::DirectFormIFloat*) { return FSF_DIRECT_FORM_I_FLOAT; }
+    static int StateFormOf(Dsp::TransposedDirectFormIIFloat*) { return FSF_TRANSPOSED_DIRECT_FORM_II_FLOAT; }
 };
 //----------------------------------------------------------------------------------
 } //namespace GarantEEG
@@ -0,0 +1,201 @@
+/**
+@file FilterWorkerPool.cpp
+
+@brief Пул рабочих потоков для параллельной фильтрации каналов
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include "FilterWorkerPool.h"
+#include <algorithm>
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+/**
+ * @brief ExecuteTask Выполнить одну задачу
+ * @param task Задача
+ */
+static void ExecuteTask(const FILTER_TASK &task)
+{
+    if (task.Function != nullptr)
+        (*task.Function)(task.FirstChannel);
+    else
+        task.Filter->ProcessChannels(task.Count, task.Samples, task.FirstChannel, task.ChannelsCount);
+}
+//----------------------------------------------------------------------------------
+CFilterWorkerPool::CFilterWorkerPool()
+: m_PendingTasks(0)
+{
+    m_Queues.push_back(std::unique_ptr<WORKER_QUEUE>(new WORKER_QUEUE()));
+}
+//----------------------------------------------------------------------------------
+CFilterWorkerPool::~CFilterWorkerPool()
+{
+    StopThreads();
+}
+//----------------------------------------------------------------------------------
+void CFilterWorkerPool::StopThreads()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+
+    m_StartCondition.notify_all();
+
+    for (thread &worker : m_Threads)
+        worker.join();
+
+    m_Threads.clear();
+    m_Queues.resize(1);
+    m_Stop = false;
+}
+//----------------------------------------------------------------------------------
+void CFilterWorkerPool::SetThreadsCount(int count)
+{
+    if (count < 0)
+        count = 0;
+
+    if (count == (int)m_Threads.size())
+        return;
+
+    StopThreads();
+
+    for (int i = 0; i < count; i++)
+        m_Queues.push_back(std::unique_ptr<WORKER_QUEUE>(new WORKER_QUEUE()));
+
+    for (int i = 0; i < count; i++)
+        m_Threads.push_back(thread(&CFilterWorkerPool::WorkerLoop, this, i + 1));
+}
+//----------------------------------------------------------------------------------
+bool CFilterWorkerPool::PopTask(int index, FILTER_TASK &task)
+{
+    //Свои задачи берутся с конца очереди, чужие - с начала, чтобы владелец и перехватчик реже конкурировали
+    {
+        WORKER_QUEUE &queue = *m_Queues[index];
+        std::lock_guard<std::mutex> lock(queue.Mutex);
+
+        if (!queue.Tasks.empty())
+        {
+            task = queue.Tasks.back();
+            queue.Tasks.pop_back();
+            return true;
+        }
+    }
+
+    const int queuesCount = (int)m_Queues.size();
+
+    for (int i = 1; i < queuesCount; i++)
+    {
+        WORKER_QUEUE &queue = *m_Queues[(index + i) % queuesCount];
+        std::lock_guard<std::mutex> lock(queue.Mutex);
+
+        if (!queue.Tasks.empty())
+        {
+            task = queue.Tasks.front();
+            queue.Tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+//----------------------------------------------------------------------------------
+void CFilterWorkerPool::Execute(int index)
+{
+    FILTER_TASK task;
+
+    while (PopTask(index, task))
+    {
+        ExecuteTask(task);
+
+        if (m_PendingTasks.fetch_sub(1) == 1)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_DoneCondition.notify_all();
+        }
+    }
+}
+//----------------------------------------------------------------------------------
+void CFilterWorkerPool::WorkerLoop(int index)
+{
+    unsigned int generation = 0;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_StartCondition.wait(lock, [this, generation]() { return m_Stop || m_Generation != generation; });
+
+            if (m_Stop)
+                return;
+
+            generation = m_Generation;
+        }
+
+        Execute(index);
+    }
+}
+//----------------------------------------------------------------------------------
+void CFilterWorkerPool::Run(const vector<FILTER_TASK> &tasks, const std::function<void()> &mainThreadWork)
+{
+    if (tasks.empty())
+    {
+        if (mainThreadWork)
+            mainThreadWork();
+
+        return;
+    }
+
+    if (m_Threads.empty())
+    {
+        if (mainThreadWork)
+            mainThreadWork();
+
+        for (const FILTER_TASK &task : tasks)
+            ExecuteTask(task);
+
+        return;
+    }
+
+    const int queuesCount = (int)m_Queues.size();
+    const int tasksCount = (int)tasks.size();
+
+    m_PendingTasks = tasksCount;
+
+    for (int i = 0; i < tasksCount; i++)
+    {
+        WORKER_QUEUE &queue = *m_Queues[i % queuesCount];
+        std::lock_guard<std::mutex> lock(queue.Mutex);
+        queue.Tasks.push_back(tasks[i]);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Generation++;
+    }
+
+    m_StartCondition.notify_all();
+
+    if (mainThreadWork)
+        mainThreadWork();
+
+    Execute(0);
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_DoneCondition.wait(lock, [this]() { return m_PendingTasks.load() == 0; });
+}
+//----------------------------------------------------------------------------------
+void CFilterWorkerPool::Run(int tasksCount, const std::function<void(int)> &task, const std::function<void()> &mainThreadWork)
+{
+    vector<FILTER_TASK> tasks(std::max(tasksCount, 0));
+
+    for (int i = 0; i < (int)tasks.size(); i++)
+        tasks[i] = { nullptr, nullptr, 0, i, 1, &task };
+
+    Run(tasks, mainThreadWork);
+}
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
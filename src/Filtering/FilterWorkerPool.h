@@ -0,0 +1,158 @@
+/**
+@file FilterWorkerPool.h
+
+@brief Пул рабочих потоков для параллельной фильтрации каналов
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#ifndef FILTERWORKERPOOL_H
+#define FILTERWORKERPOOL_H
+//----------------------------------------------------------------------------------
+#include <vector>
+using std::vector;
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+using std::thread;
+#include <functional>
+//----------------------------------------------------------------------------------
+#include "BaseFilter.h"
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+//! Минимальное количество каналов в одной задаче фильтрации
+const int FILTER_TASK_MIN_CHANNELS = 4;
+//----------------------------------------------------------------------------------
+//! Задача фильтрации диапазона каналов
+struct FILTER_TASK
+{
+	//! Фильтр
+    CBaseFilter *Filter;
+
+	//! Указатель на список данных по всем каналам фильтра
+    float **Samples;
+
+	//! Количество данных
+    int Count;
+
+	//! Индекс первого обрабатываемого канала
+    int FirstChannel;
+
+	//! Количество обрабатываемых каналов
+    int ChannelsCount;
+
+	//! Функция задачи вместо фильтра (вызывается с FirstChannel в качестве индекса задачи, nullptr - фильтрация каналов)
+    const std::function<void(int)> *Function;
+};
+//----------------------------------------------------------------------------------
+//! Пул постоянных рабочих потоков фильтрации с очередью задач на каждый поток и перехватом задач у других потоков
+class CFilterWorkerPool
+{
+private:
+	//! Очередь задач одного потока
+    struct WORKER_QUEUE
+    {
+		//! Мьютекс доступа к очереди
+        std::mutex Mutex;
+
+		//! Задачи
+        std::deque<FILTER_TASK> Tasks;
+    };
+
+	//! Рабочие потоки
+    vector<thread> m_Threads;
+
+	//! Очереди задач (нулевая очередь принадлежит вызывающему потоку)
+    vector<std::unique_ptr<WORKER_QUEUE>> m_Queues;
+
+	//! Мьютекс для ожидания задач и их завершения
+    std::mutex m_Mutex;
+
+	//! Условие появления новых задач
+    std::condition_variable m_StartCondition;
+
+	//! Условие завершения всех задач
+    std::condition_variable m_DoneCondition;
+
+	//! Номер текущего запуска задач
+    unsigned int m_Generation = 0;
+
+	//! Флаг остановки потоков
+    bool m_Stop = false;
+
+	//! Количество невыполненных задач
+    std::atomic<int> m_PendingTasks;
+
+	/**
+	 * @brief PopTask Получить задачу из своей очереди или перехватить из чужой
+	 * @param index Индекс очереди потока
+	 * @param task Ссылка на задачу
+	 * @return true если задача получена
+	 */
+    bool PopTask(int index, FILTER_TASK &task);
+
+	/**
+	 * @brief Execute Выполнять задачи, пока они есть в очередях
+	 * @param index Индекс очереди потока
+	 */
+    void Execute(int index);
+
+	/**
+	 * @brief WorkerLoop Функция рабочего потока
+	 * @param index Индекс очереди потока
+	 */
+    void WorkerLoop(int index);
+
+	/**
+	 * @brief StopThreads Остановить рабочие потоки
+	 */
+    void StopThreads();
+
+public:
+	/**
+	 * @brief CFilterWorkerPool Конструктор
+	 */
+    CFilterWorkerPool();
+
+	/**
+	 * @brief ~CFilterWorkerPool Деструктор
+	 */
+    ~CFilterWorkerPool();
+
+	/**
+	 * @brief SetThreadsCount Установить количество рабочих потоков (вызывающий поток участвует в обработке дополнительно к ним)
+	 * @param count Количество потоков (0 - без рабочих потоков, обработка в вызывающем потоке)
+	 */
+    void SetThreadsCount(int count);
+
+	/**
+	 * @brief ThreadsCount Получить количество рабочих потоков
+	 * @return Количество потоков
+	 */
+    int ThreadsCount() const { return (int)m_Threads.size(); }
+
+	/**
+	 * @brief Run Выполнить задачи и дождаться их завершения
+	 * @param tasks Список задач
+	 * @param mainThreadWork Работа вызывающего потока, после которой он присоединяется к выполнению задач (nullptr - нет)
+	 */
+    void Run(const vector<FILTER_TASK> &tasks, const std::function<void()> &mainThreadWork = nullptr);
+
+	/**
+	 * @brief Run Выполнить задачи-функции и дождаться их завершения
+	 * @param tasksCount Количество задач
+	 * @param task Функция обработки задачи (получает индекс задачи)
+	 * @param mainThreadWork Работа вызывающего потока, после которой он присоединяется к выполнению задач (nullptr - нет)
+	 */
+    void Run(int tasksCount, const std::function<void(int)> &task, const std::function<void()> &mainThreadWork = nullptr);
+};
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
+#endif // FILTERWORKERPOOL_H
+//----------------------------------------------------------------------------------
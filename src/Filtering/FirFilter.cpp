@@ -0,0 +1,227 @@
+/**
+@file FirFilter.cpp
+
+@brief Класс для работы с КИХ фильтром с линейной фазой
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include "FirFilter.h"
+#include "dspfilter/FrequencyResponse.h"
+#include <algorithm>
+#include <string.h>
+#include <math.h>
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+CFirFilter::CFirFilter(int order, int channelsCount, const int *channelsList)
+: m_ChannelsList(channelsList, channelsList + channelsCount)
+{
+    //Нечетное количество коэффициентов дает целую групповую задержку
+    m_Order = order + (order & 1);
+    m_TapsCount = m_Order + 1;
+    m_UseFft = (m_TapsCount > FIR_DIRECT_MAX_TAPS);
+
+    m_Channels.resize(channelsCount);
+
+    if (m_UseFft)
+    {
+        m_Fft.Init(CRealFft::NextSize(2 * m_TapsCount));
+        m_BlockLength = m_Fft.Size() - m_TapsCount + 1;
+        m_TapsSpectrum.resize(m_Fft.Size() / 2 + 1);
+
+        for (CHANNEL_STATE &channel : m_Channels)
+        {
+            channel.Input.resize(m_Fft.Size(), 0.0);
+            channel.Output.resize(m_Fft.Size(), 0.0);
+            channel.Spectrum.resize(m_TapsSpectrum.size());
+            channel.Position = m_TapsCount - 1;
+        }
+    }
+    else
+    {
+        for (CHANNEL_STATE &channel : m_Channels)
+            channel.Input.resize(2 * m_TapsCount, 0.0);
+    }
+
+    Design();
+}
+//----------------------------------------------------------------------------------
+void CFirFilter::Design()
+{
+    const double pi = 3.1415926535897932384626433832795028841971;
+    const int middle = m_Order / 2;
+
+    double low = (double)m_LowFrequency / m_Rate;
+    double hight = (double)m_HightFrequency / m_Rate;
+
+    bool lowPass = (low <= 0.0);
+    bool hightPass = (hight >= 0.5);
+
+    //Идеальный фильтр нижних частот с частотой среза frequency (в долях частоты дискретизации)
+    auto sinc = [pi](double frequency, int n) -> double
+    {
+        if (!n)
+            return 2.0 * frequency;
+
+        return sin(2.0 * pi * frequency * n) / (pi * n);
+    };
+
+    m_Taps.assign(m_TapsCount, 0.0);
+
+    if (m_Rate <= 0 || low >= hight || (lowPass && hightPass))
+    {
+        //Некорректные или пустые настройки - фильтр пропускает сигнал с той же задержкой
+        m_Taps[middle] = 1.0;
+    }
+    else
+    {
+        double referenceFrequency = (lowPass ? 0.0 : (hightPass ? 0.5 : (low + hight) / 2.0));
+        double gain = 0.0;
+
+        for (int i = 0; i < m_TapsCount; i++)
+        {
+            int n = i - middle;
+            double value = 0.0;
+
+            if (lowPass)
+                value = sinc(hight, n);
+            else if (hightPass)
+                value = (n ? 0.0 : 1.0) - sinc(low, n);
+            else
+                value = sinc(hight, n) - sinc(low, n);
+
+            value *= 0.54 - 0.46 * cos(2.0 * pi * i / m_Order);
+
+            m_Taps[i] = value;
+            gain += value * cos(2.0 * pi * referenceFrequency * n);
+        }
+
+        if (fabs(gain) > 1e-12)
+        {
+            for (double &value : m_Taps)
+                value /= gain;
+        }
+    }
+
+    if (m_UseFft)
+    {
+        vector<double> padded(m_Fft.Size(), 0.0);
+        memcpy(&padded[0], &m_Taps[0], m_TapsCount * sizeof(double));
+
+        m_Fft.Forward(&padded[0], &m_TapsSpectrum[0]);
+    }
+}
+//----------------------------------------------------------------------------------
+void CFirFilter::Setup(int rate, int lowFrequency, int hightFrequency, int transitionSamples)
+{
+    (void)transitionSamples;
+
+    m_Rate = rate;
+    m_LowFrequency = lowFrequency;
+    m_HightFrequency = hightFrequency;
+
+    Design();
+}
+//----------------------------------------------------------------------------------
+void CFirFilter::ProcessDirect(CHANNEL_STATE &channel, int count, float *samples) const
+{
+    const int tapsCount = m_TapsCount;
+    const int middle = m_Order / 2;
+    const double *taps = &m_Taps[0];
+    double *input = &channel.Input[0];
+    int position = channel.Position;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (++position == tapsCount)
+            position = 0;
+
+        //Отсчет пишется в обе половины буфера, чтобы окно последних tapsCount отсчетов всегда было непрерывным
+        input[position] = input[position + tapsCount] = samples[i];
+
+        const double *window = input + position + 1;
+        double result = taps[middle] * window[middle];
+
+        //Симметрия коэффициентов вдвое сокращает количество умножений
+        for (int k = 0; k < middle; k++)
+            result += taps[k] * (window[k] + window[tapsCount - 1 - k]);
+
+        samples[i] = (float)result;
+    }
+
+    channel.Position = position;
+}
+//----------------------------------------------------------------------------------
+void CFirFilter::ProcessFft(CHANNEL_STATE &channel, int count, float *samples) const
+{
+    const int fftSize = m_Fft.Size();
+    const int overlap = m_TapsCount - 1;
+    const int spectrumSize = (int)m_TapsSpectrum.size();
+
+    int done = 0;
+
+    while (done < count)
+    {
+        int length = std::min(count - done, fftSize - channel.Position);
+        double *input = &channel.Input[channel.Position];
+        const double *output = &channel.Output[channel.Position];
+
+        //Выход берется из предыдущего посчитанного блока с тем же смещением
+        for (int i = 0; i < length; i++)
+        {
+            input[i] = samples[done + i];
+            samples[done + i] = (float)output[i];
+        }
+
+        channel.Position += length;
+        done += length;
+
+        if (channel.Position == fftSize)
+        {
+            CRealFft::COMPLEX *spectrum = &channel.Spectrum[0];
+
+            m_Fft.Forward(&channel.Input[0], spectrum);
+
+            for (int k = 0; k < spectrumSize; k++)
+                spectrum[k] *= m_TapsSpectrum[k];
+
+            //Первые overlap отсчетов результата искажены циклической сверткой и не используются
+            m_Fft.Inverse(spectrum, &channel.Output[0]);
+
+            memmove(&channel.Input[0], &channel.Input[m_BlockLength], overlap * sizeof(double));
+            channel.Position = overlap;
+        }
+    }
+}
+//----------------------------------------------------------------------------------
+void CFirFilter::ProcessChannels(int count, float **samples, int firstChannel, int channelsCount)
+{
+    for (int i = firstChannel; i < firstChannel + channelsCount; i++)
+    {
+        if (m_UseFft)
+            ProcessFft(m_Channels[i], count, samples[i]);
+        else
+            ProcessDirect(m_Channels[i], count, samples[i]);
+    }
+}
+//----------------------------------------------------------------------------------
+CBaseFilter *CFirFilter::Create(int order, int channelsCount, const int *channelsList)
+{
+    if (order < 2 || order > FIR_MAX_ORDER || channelsCount < 1 || channelsList == nullptr)
+        return nullptr;
+
+    return new CFirFilter(order, channelsCount, channelsList);
+}
+//----------------------------------------------------------------------------------
+bool CFirFilter::Response(Dsp::FrequencyResponse &response) const
+{
+    response.setSampleRate((double)m_Rate);
+    response.multiplyTransversal(m_TapsCount, &m_Taps[0]);
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
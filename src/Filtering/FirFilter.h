@@ -0,0 +1,220 @@
+/**
+@file FirFilter.h
+
+@brief Класс для работы с КИХ фильтром с линейной фазой
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#ifndef FIRFILTER_H
+#define FIRFILTER_H
+//----------------------------------------------------------------------------------
+#include "BaseFilter.h"
+#include "RealFft.h"
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+//! Максимальный порядок КИХ фильтра
+const int FIR_MAX_ORDER = 16384;
+
+//! Максимальное количество коэффициентов, при котором используется прямая свертка (для более длинных ядер используется БПФ)
+const int FIR_DIRECT_MAX_TAPS = 96;
+//----------------------------------------------------------------------------------
+//! Полосовой КИХ фильтр с линейной фазой (окно Хэмминга). Короткие ядра считаются прямой симметричной сверткой,
+//! длинные - блочной сверткой через БПФ методом перекрытия с накоплением (overlap-save) с дополнительной задержкой на длину блока
+class CFirFilter : public CBaseFilter
+{
+protected:
+	//! Состояние канала
+    struct CHANNEL_STATE
+    {
+		//! Входные данные (для прямой свертки - кольцевой буфер двойной длины, для БПФ - текущий блок)
+        vector<double> Input;
+
+		//! Выход последнего посчитанного блока (только для БПФ)
+        vector<double> Output;
+
+		//! Спектр текущего блока (только для БПФ)
+        vector<CRealFft::COMPLEX> Spectrum;
+
+		//! Текущая позиция во входном буфере
+        int Position = 0;
+    };
+
+	//! Порядок фильтра
+    int m_Order = 0;
+
+	//! Количество коэффициентов
+    int m_TapsCount = 0;
+
+	//! Рабочая частота
+    int m_Rate = 500;
+
+	//! Нижняя планка среза
+    int m_LowFrequency = 1;
+
+	//! Верхняя планка среза
+    int m_HightFrequency = 20;
+
+	//! Список каналов, для которых применяется фильтр
+    vector<int> m_ChannelsList;
+
+	//! Коэффициенты фильтра
+    vector<double> m_Taps;
+
+	//! Флаг использования БПФ
+    bool m_UseFft = false;
+
+	//! Преобразование Фурье размера блока свертки
+    CRealFft m_Fft;
+
+	//! Количество новых отсчетов в одном блоке свертки
+    int m_BlockLength = 0;
+
+	//! Спектр коэффициентов фильтра
+    vector<CRealFft::COMPLEX> m_TapsSpectrum;
+
+	//! Состояния каналов
+    vector<CHANNEL_STATE> m_Channels;
+
+	/**
+	 * @brief Design Рассчитать коэффициенты фильтра по текущим настройкам
+	 */
+    void Design();
+
+	/**
+	 * @brief ProcessDirect Фильтрация канала прямой сверткой
+	 * @param channel Состояние канала
+	 * @param count Количетво данных
+	 * @param samples Данные канала
+	 */
+    void ProcessDirect(CHANNEL_STATE &channel, int count, float *samples) const;
+
+	/**
+	 * @brief ProcessFft Фильтрация канала блочной сверткой через БПФ
+	 * @param channel Состояние канала
+	 * @param count Количетво данных
+	 * @param samples Данные канала
+	 */
+    void ProcessFft(CHANNEL_STATE &channel, int count, float *samples) const;
+
+public:
+	/**
+	 * @brief CFirFilter Конструктор
+	 * @param order Порядок фильтра (количество коэффициентов - 1, округляется вверх до четного)
+	 * @param channelsCount Количество каналов
+	 * @param channelsList Указатель на список каналов
+	 */
+    CFirFilter(int order, int channelsCount, const int *channelsList);
+
+	/**
+	 * @brief ~CFirFilter Деструктор
+	 */
+    virtual ~CFirFilter() {}
+
+	/**
+	 * @brief Setup Функция установки настроек фильтра
+	 * @param rate Рабочая частота
+	 * @param lowFrequency Нижняя планка среза (0 - фильтр нижних частот)
+	 * @param hightFrequency Верхняя планка среза
+	 * @param transitionSamples Не используется, коэффициенты применяются сразу (состояние каналов сохраняется)
+	 */
+    virtual void Setup(int rate, int lowFrequency, int hightFrequency, int transitionSamples) override;
+
+	/**
+	 * @brief ProcessChannels Функция фильтрации части каналов (непересекающиеся диапазоны каналов могут обрабатываться параллельно)
+	 * @param count Количетво данных
+	 * @param samples Указатель на список данных по всем каналам фильтра
+	 * @param firstChannel Индекс первого обрабатываемого канала
+	 * @param channelsCount Количество обрабатываемых каналов
+	 */
+    virtual void ProcessChannels(int count, float **samples, int firstChannel, int channelsCount) override;
+
+	/**
+	 * @brief FinishProcess Функция завершения обработки блока данных (состояние КИХ фильтра полностью поканальное)
+	 * @param count Количетво данных
+	 */
+    virtual void FinishProcess(int count) override { (void)count; }
+
+	/**
+	 * @brief Type Получить тип фильтра
+	 * @return Тип фильтра
+	 */
+    virtual int Type() const override { return FT_FIR; }
+
+	/**
+	 * @brief Order Получить порядок фильтра
+	 * @return Порядок фильтра
+	 */
+    virtual int Order() const override { return m_Order; }
+
+	/**
+	 * @brief ChannelsCount Получить количество каналов, для которых работает фильтр
+	 * @return Количество каналов
+	 */
+    virtual int ChannelsCount() const override { return (int)m_ChannelsList.size(); }
+
+	/**
+	 * @brief ChannelsList Получить указатель на список каналов, для которых работает фильтр
+	 * @return Указатель на список каналов
+	 */
+    virtual const int *ChannelsList() const override { return &m_ChannelsList[0]; }
+
+	/**
+	 * @brief Rate Получить рабочую частоту фильтра
+	 * @return Частота
+	 */
+    virtual int Rate() const override { return m_Rate; }
+
+	/**
+	 * @brief LowFrequency Получить нижнюю планку среза
+	 * @return Частота
+	 */
+    virtual int LowFrequency() const override { return m_LowFrequency; }
+
+	/**
+	 * @brief HightFrequency Получить верхнюю планку среза
+	 * @return Частота
+	 */
+    virtual int HightFrequency() const override { return m_HightFrequency; }
+
+	/**
+	 * @brief Delay Получить задержку выходного сигнала
+	 * @return Задержка в отсчетах (групповая задержка + задержка блочной свертки)
+	 */
+    virtual int Delay() const override { return m_Order / 2 + (m_UseFft ? m_BlockLength : 0); }
+
+	/**
+	 * @brief UseFft Проверить, используется ли блочная свертка через БПФ
+	 * @return true если используется БПФ, false если прямая свертка
+	 */
+    bool UseFft() const { return m_UseFft; }
+
+	/**
+	 * @brief Taps Получить коэффициенты фильтра
+	 * @return Коэффициенты (Order() + 1 значений)
+	 */
+    const vector<double> &Taps() const { return m_Taps; }
+
+	/**
+	 * @brief Response Домножить частотную характеристику на характеристику фильтра (без задержки блочной обработки через БПФ)
+	 * @param response Частотная характеристика цепочки фильтров
+	 * @return true
+	 */
+    virtual bool Response(Dsp::FrequencyResponse &response) const override;
+
+	/**
+	 * @brief Create Функция создания фильтра
+	 * @param order Порядок фильтра
+	 * @param channelsCount Количество каналов
+	 * @param channelsList Список каналов
+	 * @return Указатель на созданный фильтр или nullptr если фильтр не был создан
+	 */
+    static CBaseFilter *Create(int order, int channelsCount, const int *channelsList);
+};
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
+#endif // FIRFILTER_H
+//----------------------------------------------------------------------------------
@@ -0,0 +1,379 @@
+/**
+@file FixedPointFilter.cpp
+
+@brief Класс для работы с целочисленным фильтром Butterworth (фиксированная точка, исходные 24-битные отсчеты)
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include "FixedPointFilter.h"
+#include "dspfilter/Butterworth.h"
+#include "dspfilter/FrequencyResponse.h"
+#include <algorithm>
+#include <complex>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+//! Количество отсчетов, обрабатываемых звено за звеном за один проход
+static const int FIXED_POINT_CHUNK = 128;
+//----------------------------------------------------------------------------------
+/**
+ * @brief QuantizeCoefficient Перевести коэффициент в формат Q2.29 с насыщением
+ * @param value Коэффициент
+ * @return Целое значение
+ */
+static int QuantizeCoefficient(double value)
+{
+    double scaled = floor(value * (double)(1LL << FIXED_POINT_COEFFICIENT_BITS) + 0.5);
+
+    return (int)std::max((double)INT_MIN, std::min((double)INT_MAX, scaled));
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief StageResponse Получить комплексную частотную характеристику звена
+ * @param coefficients Коэффициенты звена (b0, b1, b2, a1, a2, a0 = 1)
+ * @param omega Нормированная круговая частота (радиан на отсчет)
+ * @return Значение характеристики
+ */
+static std::complex<double> StageResponse(const double *coefficients, double omega)
+{
+    const std::complex<double> z1 = std::polar(1.0, -omega);
+    const std::complex<double> z2 = z1 * z1;
+
+    return (coefficients[0] + coefficients[1] * z1 + coefficients[2] * z2) / (1.0 + coefficients[3] * z1 + coefficients[4] * z2);
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief StagePeakGain Получить максимум АЧХ звена на сетке частот от 0 до половины частоты дискретизации
+ * @param coefficients Коэффициенты звена (b0, b1, b2, a1, a2, a0 = 1)
+ * @return Максимум модуля характеристики
+ */
+static double StagePeakGain(const double *coefficients)
+{
+    const double pi = 3.1415926535897932384626433832795028841971;
+    double peak = 0.0;
+
+    for (int i = 0; i <= FIXED_POINT_PEAK_POINTS; i++)
+        peak = std::max(peak, std::abs(StageResponse(coefficients, pi * i / FIXED_POINT_PEAK_POINTS)));
+
+    return peak;
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief ProcessStage Обработать порцию отсчетов одним звеном (прямая форма I)
+ * @param coefficients Коэффициенты звена (b0, b1, b2, a1, a2)
+ * @param stateValues Состояние звена (x1, x2, y1, y2 и их остатки округления)
+ * @param samples Отсчеты (результат записывается на место входа)
+ * @param remainders Остатки округления отсчетов в единицах 2^-29 (только для FPR_ERROR_FEEDBACK, результат записывается на место входа)
+ * @param count Количество отсчетов
+ */
+template<int Rounding, bool Saturation>
+static void ProcessStage(const int *coefficients, int *stateValues, int *samples, int *remainders, int count)
+{
+    const long long b0 = coefficients[0];
+    const long long b1 = coefficients[1];
+    const long long b2 = coefficients[2];
+    const long long a1 = coefficients[3];
+    const long long a2 = coefficients[4];
+
+    long long x1 = stateValues[0];
+    long long x2 = stateValues[1];
+    long long y1 = stateValues[2];
+    long long y2 = stateValues[3];
+    long long xr1 = stateValues[4];
+    long long xr2 = stateValues[5];
+    long long yr1 = stateValues[6];
+    long long yr2 = stateValues[7];
+
+    for (int i = 0; i < count; i++)
+    {
+        const long long x = samples[i];
+        long long accumulator = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+        long long xr = 0;
+
+        if (Rounding == FPR_ERROR_FEEDBACK)
+        {
+            //Остатки округления входа и прошлых результатов проходят через звено так, как если бы отсчеты хранились точно:
+            //шум округления не усиливается полюсами этого и последующих звеньев (существенно для полюсов вблизи z = 1).
+            //Коэффициенты меньше 4 по модулю, остатки меньше 2^29 - сумма помещается в 64 бита.
+            xr = remainders[i];
+            accumulator += ((b0 * xr + b1 * xr1 + b2 * xr2 - a1 * yr1 - a2 * yr2 + (1LL << (FIXED_POINT_COEFFICIENT_BITS - 1))) >> FIXED_POINT_COEFFICIENT_BITS);
+        }
+        else if (Rounding == FPR_NEAREST)
+            accumulator += (1LL << (FIXED_POINT_COEFFICIENT_BITS - 1));
+
+        //Сдвиг отрицательных значений арифметический (округление вниз) на всех поддерживаемых компиляторах
+        long long y = (accumulator >> FIXED_POINT_COEFFICIENT_BITS);
+        long long yr = 0;
+
+        if (Rounding == FPR_ERROR_FEEDBACK)
+            yr = accumulator - y * (1LL << FIXED_POINT_COEFFICIENT_BITS);
+
+        if (Saturation)
+        {
+            if (y < INT_MIN || y > INT_MAX)
+            {
+                y = (y < INT_MIN ? INT_MIN : INT_MAX);
+                yr = 0;
+            }
+        }
+        else
+            y = (int)(unsigned int)(unsigned long long)y;
+
+        x2 = x1;
+        x1 = x;
+        xr2 = xr1;
+        xr1 = xr;
+        y2 = y1;
+        y1 = y;
+        yr2 = yr1;
+        yr1 = yr;
+
+        samples[i] = (int)y;
+
+        if (Rounding == FPR_ERROR_FEEDBACK)
+            remainders[i] = (int)yr;
+    }
+
+    stateValues[0] = (int)x1;
+    stateValues[1] = (int)x2;
+    stateValues[2] = (int)y1;
+    stateValues[3] = (int)y2;
+    stateValues[4] = (int)xr1;
+    stateValues[5] = (int)xr2;
+    stateValues[6] = (int)yr1;
+    stateValues[7] = (int)yr2;
+}
+//----------------------------------------------------------------------------------
+CFixedPointFilter::CFixedPointFilter(int order, int channelsCount, const int *channelsList)
+: m_Order(order), m_ChannelsList(channelsList, channelsList + channelsCount)
+{
+    //Полосовой фильтр порядка N состоит из N звеньев второго порядка
+    m_Stages.resize(order);
+
+    m_States.resize(channelsCount * order);
+    memset(&m_States[0], 0, m_States.size() * sizeof(FIXED_BIQUAD_STATE));
+
+    Design();
+}
+//----------------------------------------------------------------------------------
+CBaseFilter *CFixedPointFilter::Create(int order, int channelsCount, const int *channelsList)
+{
+    if (order < 1 || order > FIXED_POINT_MAX_ORDER || channelsCount < 1 || channelsList == nullptr)
+        return nullptr;
+
+    return new CFixedPointFilter(order, channelsCount, channelsList);
+}
+//----------------------------------------------------------------------------------
+void CFixedPointFilter::Design()
+{
+    Dsp::Butterworth::BandPass<FIXED_POINT_MAX_ORDER> design;
+
+    double centerFrequency = ((m_LowFrequency + m_HightFrequency) / 2.0);
+    double widthFrequency = (double)(m_HightFrequency - m_LowFrequency);
+
+    design.setup(m_Order, m_Rate, centerFrequency, widthFrequency);
+
+    //Расчет помещает все усиление полосы в числитель первого звена: для узких низкочастотных полос оно меньше шага Q2.29,
+    //а остальные звенья усиливают в тысячи раз. Числитель каждого звена нормируется на единичный пик АЧХ (звенья не
+    //усиливают сигнал и не переполняются), а отношение усиления расчета к усилению квантованных звеньев в центре полосы
+    //применяется на выходе вместе с физическим масштабом
+    const double one = (double)(1LL << FIXED_POINT_COEFFICIENT_BITS);
+    const double pi = 3.1415926535897932384626433832795028841971;
+    const double centerOmega = 2.0 * pi * centerFrequency / m_Rate;
+
+    std::complex<double> designResponse = 1.0;
+    std::complex<double> quantizedResponse = 1.0;
+
+    for (int i = 0; i < (int)m_Stages.size(); i++)
+    {
+        FIXED_BIQUAD &stage = m_Stages[i];
+
+        if (i >= design.getNumStages())
+        {
+            stage = { 1 << FIXED_POINT_COEFFICIENT_BITS, 0, 0, 0, 0 };
+            continue;
+        }
+
+        const Dsp::Cascade::Stage &biquad = design[i];
+        const double a0 = biquad.getA0();
+
+        double coefficients[5] = { biquad.getB0() / a0, biquad.getB1() / a0, biquad.getB2() / a0, biquad.getA1() / a0, biquad.getA2() / a0 };
+
+        designResponse *= StageResponse(coefficients, centerOmega);
+
+        const double peak = StagePeakGain(coefficients);
+
+        if (peak > 0.0)
+        {
+            for (int j = 0; j < 3; j++)
+                coefficients[j] /= peak;
+        }
+
+        stage.B0 = QuantizeCoefficient(coefficients[0]);
+        stage.B1 = QuantizeCoefficient(coefficients[1]);
+        stage.B2 = QuantizeCoefficient(coefficients[2]);
+        stage.A1 = QuantizeCoefficient(coefficients[3]);
+        stage.A2 = QuantizeCoefficient(coefficients[4]);
+
+        const double quantized[5] = { stage.B0 / one, stage.B1 / one, stage.B2 / one, stage.A1 / one, stage.A2 / one };
+
+        quantizedResponse *= StageResponse(quantized, centerOmega);
+    }
+
+    m_StagesGain = (std::abs(quantizedResponse) > 0.0 ? std::abs(designResponse) / std::abs(quantizedResponse) : 1.0);
+}
+//----------------------------------------------------------------------------------
+void CFixedPointFilter::Setup(int rate, int lowFrequency, int hightFrequency, int transitionSamples)
+{
+    (void)transitionSamples;
+
+    m_Rate = rate;
+    m_LowFrequency = lowFrequency;
+    m_HightFrequency = hightFrequency;
+
+    Design();
+}
+//----------------------------------------------------------------------------------
+bool CFixedPointFilter::SetRounding(int rounding)
+{
+    if (rounding != FPR_ERROR_FEEDBACK && rounding != FPR_NEAREST && rounding != FPR_TRUNCATE)
+        return false;
+
+    m_Rounding = rounding;
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+void CFixedPointFilter::SetSteadyState(int channel, int input)
+{
+    const double one = (double)(1LL << FIXED_POINT_COEFFICIENT_BITS);
+    const int stagesCount = (int)m_Stages.size();
+    double value = input;
+
+    for (int i = 0; i < stagesCount; i++)
+    {
+        const FIXED_BIQUAD &stage = m_Stages[i];
+        FIXED_BIQUAD_STATE &state = m_States[channel * stagesCount + i];
+
+        const double denominator = 1.0 + (stage.A1 + (double)stage.A2) / one;
+        const double gain = (fabs(denominator) < 1e-30 ? 0.0 : ((double)stage.B0 + stage.B1 + stage.B2) / one / denominator);
+
+        const int x = (int)std::max((double)INT_MIN, std::min((double)INT_MAX, floor(value + 0.5)));
+
+        value *= gain;
+
+        const int y = (int)std::max((double)INT_MIN, std::min((double)INT_MAX, floor(value + 0.5)));
+
+        state.X1 = state.X2 = x;
+        state.Y1 = state.Y2 = y;
+        state.XRemainder1 = state.XRemainder2 = 0;
+        state.YRemainder1 = state.YRemainder2 = 0;
+    }
+}
+//----------------------------------------------------------------------------------
+void CFixedPointFilter::ProcessChannels(int count, float **samples, int firstChannel, int channelsCount)
+{
+    typedef void (*PROCESS_STAGE_FUNCTION)(const int*, int*, int*, int*, int);
+
+    PROCESS_STAGE_FUNCTION processStage = nullptr;
+
+    switch (m_Rounding)
+    {
+        case FPR_NEAREST:
+            processStage = (m_Saturation ? ProcessStage<FPR_NEAREST, true> : ProcessStage<FPR_NEAREST, false>);
+            break;
+        case FPR_TRUNCATE:
+            processStage = (m_Saturation ? ProcessStage<FPR_TRUNCATE, true> : ProcessStage<FPR_TRUNCATE, false>);
+            break;
+        default:
+            processStage = (m_Saturation ? ProcessStage<FPR_ERROR_FEEDBACK, true> : ProcessStage<FPR_ERROR_FEEDBACK, false>);
+            break;
+    }
+
+    const int stagesCount = (int)m_Stages.size();
+    const double outputScale = m_OutputScale * m_StagesGain / (1 << FIXED_POINT_INPUT_SHIFT);
+
+    int buffer[FIXED_POINT_CHUNK];
+    int remainders[FIXED_POINT_CHUNK];
+
+    for (int c = firstChannel; c < firstChannel + channelsCount; c++)
+    {
+        float *channel = samples[c];
+
+        for (int offset = 0; offset < count; offset += FIXED_POINT_CHUNK)
+        {
+            const int chunk = std::min(FIXED_POINT_CHUNK, count - offset);
+
+            //Вход - целые отсчеты АЦП, точно представимые во float
+            for (int i = 0; i < chunk; i++)
+            {
+                int value = (int)floor(channel[offset + i] + 0.5f);
+                value = std::max(-FIXED_POINT_INPUT_LIMIT, std::min(FIXED_POINT_INPUT_LIMIT, value));
+
+                buffer[i] = value * (1 << FIXED_POINT_INPUT_SHIFT);
+                remainders[i] = 0;
+            }
+
+            if (m_SteadyStatePending && !offset)
+                SetSteadyState(c, buffer[0]);
+
+            //Звено за звеном по всей порции, состояние звена на время прохода хранится в локальных переменных
+            for (int s = 0; s < stagesCount; s++)
+            {
+                const FIXED_BIQUAD &stage = m_Stages[s];
+                FIXED_BIQUAD_STATE &state = m_States[c * stagesCount + s];
+
+                const int coefficients[5] = { stage.B0, stage.B1, stage.B2, stage.A1, stage.A2 };
+
+                processStage(coefficients, &state.X1, buffer, remainders, chunk);
+            }
+
+            //Физический масштаб применяется один раз на выходе
+            for (int i = 0; i < chunk; i++)
+                channel[offset + i] = (float)(buffer[i] * outputScale);
+        }
+    }
+}
+//----------------------------------------------------------------------------------
+bool CFixedPointFilter::Response(Dsp::FrequencyResponse &response) const
+{
+    const double one = (double)(1LL << FIXED_POINT_COEFFICIENT_BITS);
+    vector<double> coefficients;
+    coefficients.reserve(m_Stages.size() * 5);
+
+    //Усиление, вынесенное на выход, учитывается в числителе первого звена
+    for (size_t i = 0; i < m_Stages.size(); i++)
+    {
+        const FIXED_BIQUAD &stage = m_Stages[i];
+        const double gain = (i ? 1.0 : m_StagesGain);
+
+        coefficients.push_back(stage.B0 / one * gain);
+        coefficients.push_back(stage.B1 / one * gain);
+        coefficients.push_back(stage.B2 / one * gain);
+        coefficients.push_back(stage.A1 / one);
+        coefficients.push_back(stage.A2 / one);
+    }
+
+    response.setSampleRate((double)m_Rate);
+    response.multiply((int)m_Stages.size(), &coefficients[0]);
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+void CFixedPointFilter::SaveStateData(void *data) const
+{
+    memcpy(data, &m_States[0], m_States.size() * sizeof(FIXED_BIQUAD_STATE));
+}
+//----------------------------------------------------------------------------------
+void CFixedPointFilter::RestoreStateData(const void *data)
+{
+    memcpy(&m_States[0], data, m_States.size() * sizeof(FIXED_BIQUAD_STATE));
+}
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
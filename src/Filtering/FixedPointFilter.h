@@ -0,0 +1,288 @@
+/**
+@file FixedPointFilter.h
+
+@brief Класс для работы с целочисленным фильтром Butterworth (фиксированная точка, исходные 24-битные отсчеты)
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#ifndef FIXEDPOINTFILTER_H
+#define FIXEDPOINTFILTER_H
+//----------------------------------------------------------------------------------
+#include "BaseFilter.h"
+#include <vector>
+using std::vector;
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+//! Максимальный порядок целочисленного фильтра
+const int FIXED_POINT_MAX_ORDER = 8;
+
+//! Количество дробных бит коэффициентов (формат Q2.29: коэффициенты до 4 по модулю, сумма произведений помещается в 64 бита)
+const int FIXED_POINT_COEFFICIENT_BITS = 29;
+
+//! Количество дополнительных дробных бит отсчетов внутри фильтра (24 бита данных + 4 бита точности, 3 бита запаса по усилению)
+const int FIXED_POINT_INPUT_SHIFT = 4;
+
+//! Максимальное значение входного 24-битного отсчета по модулю
+const int FIXED_POINT_INPUT_LIMIT = 8388607;
+
+//! Количество точек сетки частот для поиска пика АЧХ звена при нормировке коэффициентов
+const int FIXED_POINT_PEAK_POINTS = 8192;
+//----------------------------------------------------------------------------------
+//! Полосовой фильтр Butterworth на звеньях прямой формы I в фиксированной точке (32-битные отсчеты, 64-битный аккумулятор).
+//! Вход - исходные целые отсчеты АЦП, физический масштаб применяется один раз на выходе. Результат не зависит от платформы.
+class CFixedPointFilter : public CBaseFilter
+{
+protected:
+	//! Коэффициенты звена в формате Q2.29 (a0 = 1)
+    struct FIXED_BIQUAD
+    {
+        int B0;
+        int B1;
+        int B2;
+        int A1;
+        int A2;
+    };
+
+	//! Состояние звена одного канала (поля идут подряд и обрабатываются как массив int[8])
+    struct FIXED_BIQUAD_STATE
+    {
+		//! x[n-1]
+        int X1;
+
+		//! x[n-2]
+        int X2;
+
+		//! y[n-1]
+        int Y1;
+
+		//! y[n-2]
+        int Y2;
+
+		//! Остаток округления x[n-1] в единицах 2^-29 (для FPR_ERROR_FEEDBACK)
+        int XRemainder1;
+
+		//! Остаток округления x[n-2]
+        int XRemainder2;
+
+		//! Остаток округления y[n-1]
+        int YRemainder1;
+
+		//! Остаток округления y[n-2]
+        int YRemainder2;
+    };
+
+	//! Порядок фильтра
+    int m_Order = 0;
+
+	//! Рабочая частота
+    int m_Rate = 500;
+
+	//! Нижняя планка среза
+    int m_LowFrequency = 1;
+
+	//! Верхняя планка среза
+    int m_HightFrequency = 20;
+
+	//! Список каналов, для которых применяется фильтр
+    vector<int> m_ChannelsList;
+
+	//! Звенья фильтра
+    vector<FIXED_BIQUAD> m_Stages;
+
+	//! Состояния звеньев (канал за каналом)
+    vector<FIXED_BIQUAD_STATE> m_States;
+
+	//! Режим округления
+    int m_Rounding = FPR_ERROR_FEEDBACK;
+
+	//! Флаг насыщения при переполнении (иначе - циклический перенос)
+    bool m_Saturation = true;
+
+	//! Физический масштаб одного отсчета АЦП
+    double m_OutputScale = 1.0;
+
+	//! Усиление, вынесенное из звеньев на выход: числители звеньев нормированы на единичный пик АЧХ, чтобы малое
+	//! общее усиление узкой низкочастотной полосы не округлялось до нуля в коэффициентах первого звена
+    double m_StagesGain = 1.0;
+
+	/**
+	 * @brief Design Рассчитать и квантовать коэффициенты по текущим настройкам (с нормировкой звеньев и расчетом m_StagesGain)
+	 */
+    void Design();
+
+	/**
+	 * @brief SetSteadyState Установить состояние канала в установившийся режим для постоянного входа
+	 * @param channel Индекс канала
+	 * @param input Вход (с учетом FIXED_POINT_INPUT_SHIFT)
+	 */
+    void SetSteadyState(int channel, int input);
+
+	/**
+	 * @brief StateDataSize Получить размер данных состояния каналов
+	 * @return Размер в байтах
+	 */
+    virtual int StateDataSize() const override { return (int)(m_States.size() * sizeof(FIXED_BIQUAD_STATE)); }
+
+	/**
+	 * @brief SaveStateData Записать данные состояния каналов
+	 * @param data Указатель на буфер размером StateDataSize()
+	 */
+    virtual void SaveStateData(void *data) const override;
+
+	/**
+	 * @brief RestoreStateData Загрузить данные состояния каналов
+	 * @param data Указатель на данные размером StateDataSize()
+	 */
+    virtual void RestoreStateData(const void *data) override;
+
+public:
+	/**
+	 * @brief CFixedPointFilter Конструктор
+	 * @param order Порядок фильтра
+	 * @param channelsCount Количество каналов
+	 * @param channelsList Указатель на список каналов
+	 */
+    CFixedPointFilter(int order, int channelsCount, const int *channelsList);
+
+	/**
+	 * @brief ~CFixedPointFilter Деструктор
+	 */
+    virtual ~CFixedPointFilter() {}
+
+	/**
+	 * @brief Setup Функция установки настроек фильтра
+	 * @param rate Рабочая частота
+	 * @param lowFrequency Нижняя планка среза
+	 * @param hightFrequency Верхняя планка среза
+	 * @param transitionSamples Не используется, коэффициенты применяются сразу (состояние каналов сохраняется)
+	 */
+    virtual void Setup(int rate, int lowFrequency, int hightFrequency, int transitionSamples) override;
+
+	/**
+	 * @brief ProcessChannels Функция фильтрации части каналов (вход - целые отсчеты АЦП, выход - в физических единицах)
+	 * @param count Количетво данных
+	 * @param samples Указатель на список данных по всем каналам фильтра
+	 * @param firstChannel Индекс первого обрабатываемого канала
+	 * @param channelsCount Количество обрабатываемых каналов
+	 */
+    virtual void ProcessChannels(int count, float **samples, int firstChannel, int channelsCount) override;
+
+	/**
+	 * @brief FinishProcess Функция завершения обработки блока данных (состояние фильтра полностью поканальное)
+	 * @param count Количетво данных
+	 */
+    virtual void FinishProcess(int count) override
+    {
+        if (count > 0)
+            m_SteadyStatePending = false;
+    }
+
+	/**
+	 * @brief NativeInput Проверить, принимает ли фильтр исходные целые отсчеты АЦП вместо физических значений
+	 * @return true
+	 */
+    virtual bool NativeInput() const override { return true; }
+
+	/**
+	 * @brief SetOutputScale Установить физический масштаб одного отсчета АЦП (применяется к выходу фильтра)
+	 * @param scale Масштаб
+	 */
+    void SetOutputScale(double scale) { m_OutputScale = scale; }
+
+	/**
+	 * @brief SetRounding Установить режим округления результатов звеньев
+	 * @param rounding Режим из GARANT_EEG_FIXED_POINT_ROUNDING
+	 * @return true если режим поддерживается
+	 */
+    bool SetRounding(int rounding);
+
+	/**
+	 * @brief Rounding Получить режим округления
+	 * @return Режим из GARANT_EEG_FIXED_POINT_ROUNDING
+	 */
+    int Rounding() const { return m_Rounding; }
+
+	/**
+	 * @brief SetSaturation Установить поведение при переполнении
+	 * @param saturation true - насыщение, false - циклический перенос
+	 */
+    void SetSaturation(bool saturation) { m_Saturation = saturation; }
+
+	/**
+	 * @brief Saturation Проверить, включено ли насыщение при переполнении
+	 * @return true если включено
+	 */
+    bool Saturation() const { return m_Saturation; }
+
+	/**
+	 * @brief Response Домножить частотную характеристику на характеристику фильтра (по квантованным коэффициентам)
+	 * @param response Частотная характеристика цепочки фильтров
+	 * @return true
+	 */
+    virtual bool Response(Dsp::FrequencyResponse &response) const override;
+
+	/**
+	 * @brief Type Получить тип фильтра
+	 * @return Тип фильтра
+	 */
+    virtual int Type() const override { return FT_BUTTERWORTH_FIXED; }
+
+	/**
+	 * @brief Order Получить порядок фильтра
+	 * @return Порядок фильтра
+	 */
+    virtual int Order() const override { return m_Order; }
+
+	/**
+	 * @brief StateForm Получить форму реализации звеньев фильтра
+	 * @return FSF_DIRECT_FORM_I
+	 */
+    virtual int StateForm() const override { return FSF_DIRECT_FORM_I; }
+
+	/**
+	 * @brief ChannelsCount Получить количество каналов, для которых работает фильтр
+	 * @return Количество каналов
+	 */
+    virtual int ChannelsCount() const override { return (int)m_ChannelsList.size(); }
+
+	/**
+	 * @brief ChannelsList Получить указатель на список каналов, для которых работает фильтр
+	 * @return Указатель на список каналов
+	 */
+    virtual const int *ChannelsList() const override { return &m_ChannelsList[0]; }
+
+	/**
+	 * @brief Rate Получить рабочую частоту фильтра
+	 * @return Частота
+	 */
+    virtual int Rate() const override { return m_Rate; }
+
+	/**
+	 * @brief LowFrequency Получить нижнюю планку среза
+	 * @return Частота
+	 */
+    virtual int LowFrequency() const override { return m_LowFrequency; }
+
+	/**
+	 * @brief HightFrequency Получить верхнюю планку среза
+	 * @return Частота
+	 */
+    virtual int HightFrequency() const override { return m_HightFrequency; }
+
+	/**
+	 * @brief Create Функция создания фильтра
+	 * @param order Порядок фильтра
+	 * @param channelsCount Количество каналов
+	 * @param channelsList Список каналов
+	 * @return Указатель на созданный фильтр или nullptr если фильтр не был создан
+	 */
+    static CBaseFilter *Create(int order, int channelsCount, const int *channelsList);
+};
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
+#endif // FIXEDPOINTFILTER_H
+//----------------------------------------------------------------------------------
@@ -0,0 +1,95 @@
+/**
+@file FlushDenormalsGuard.h
+
+@brief Класс для временного включения аппаратного сброса денормализованных чисел в текущем потоке
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#ifndef FLUSHDENORMALSGUARD_H
+#define FLUSHDENORMALSGUARD_H
+//----------------------------------------------------------------------------------
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <xmmintrin.h>
+#define GARANT_EEG_FLUSH_DENORMALS_SSE
+#elif defined(__aarch64__)
+#define GARANT_EEG_FLUSH_DENORMALS_AARCH64
+#endif
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+//! Включает FTZ/DAZ на время жизни объекта и восстанавливает прежний режим при разрушении (на неизвестных платформах ничего не делает)
+class CFlushDenormalsGuard
+{
+private:
+#if defined(GARANT_EEG_FLUSH_DENORMALS_SSE)
+	//! Биты FTZ (0x8000) и DAZ (0x0040) регистра MXCSR
+    static const unsigned int FLUSH_BITS = 0x8040;
+
+	//! Прежнее значение MXCSR
+    unsigned int m_Saved = 0;
+#elif defined(GARANT_EEG_FLUSH_DENORMALS_AARCH64)
+	//! Бит FZ регистра FPCR
+    static const unsigned long long FLUSH_BITS = (1ULL << 24);
+
+	//! Прежнее значение FPCR
+    unsigned long long m_Saved = 0;
+#endif
+
+	//! Флаг изменения режима
+    bool m_Enabled = false;
+
+public:
+	/**
+	 * @brief CFlushDenormalsGuard Конструктор
+	 * @param enabled Включать ли сброс денормализованных чисел (false - объект ничего не делает)
+	 */
+    explicit CFlushDenormalsGuard(bool enabled)
+    {
+        if (!enabled)
+            return;
+
+#if defined(GARANT_EEG_FLUSH_DENORMALS_SSE)
+        m_Saved = _mm_getcsr();
+
+        if ((m_Saved & FLUSH_BITS) != FLUSH_BITS)
+        {
+            _mm_setcsr(m_Saved | FLUSH_BITS);
+            m_Enabled = true;
+        }
+#elif defined(GARANT_EEG_FLUSH_DENORMALS_AARCH64)
+        __asm__ __volatile__("mrs %0, fpcr" : "=r"(m_Saved));
+
+        if ((m_Saved & FLUSH_BITS) != FLUSH_BITS)
+        {
+            unsigned long long value = m_Saved | FLUSH_BITS;
+            __asm__ __volatile__("msr fpcr, %0" : : "r"(value));
+            m_Enabled = true;
+        }
+#endif
+    }
+
+	/**
+	 * @brief ~CFlushDenormalsGuard Деструктор
+	 */
+    ~CFlushDenormalsGuard()
+    {
+        if (!m_Enabled)
+            return;
+
+#if defined(GARANT_EEG_FLUSH_DENORMALS_SSE)
+        _mm_setcsr(m_Saved);
+#elif defined(GARANT_EEG_FLUSH_DENORMALS_AARCH64)
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(m_Saved));
+#endif
+    }
+
+    CFlushDenormalsGuard(const CFlushDenormalsGuard&) = delete;
+    CFlushDenormalsGuard &operator=(const CFlushDenormalsGuard&) = delete;
+};
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
+#endif // FLUSHDENORMALSGUARD_H
+//----------------------------------------------------------------------------------
@@ -0,0 +1,181 @@
+/**
+@file NotchCombFilter.hpp
+
+@brief Класс для подавления сетевой наводки и ее гармоник одним каскадом режекторных звеньев
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#ifndef NOTCHCOMBFILTER_H
+#define NOTCHCOMBFILTER_H
+//----------------------------------------------------------------------------------
+#include "NotchFilter.h"
+#include "dspfilter/RBJ.h"
+#include "dspfilter/SmoothedFilter.h"
+#include "dspfilter/FrequencyResponse.h"
+#include "FlushDenormalsGuard.h"
+#include <string.h>
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+//! Реализация гребенчатого режекторного фильтра (все гармоники выполняются одним каскадом на канал)
+template<int MaxChannels = 8>
+class CNotchCombFilter : public CNotchFilter
+{
+protected:
+	//! Фильтр (с плавной перестройкой коэффициентов при смене частоты)
+    Dsp::SmoothedFilter<Dsp::RBJ::NotchComb<NOTCH_COMB_MAX_HARMONICS>, MaxChannels> m_Filter;
+
+	//! Список каналов, для которых применяется фильтр
+    int m_ChannelsList[MaxChannels];
+
+	/**
+	 * @brief Redesign Пересчитать коэффициенты фильтра по текущим настройкам
+	 * @param transitionSamples Количество отсчетов плавного перехода к новым настройкам
+	 */
+    virtual void Redesign(int transitionSamples) override
+    {
+        m_Filter.setTransitionSamples(transitionSamples);
+        m_Filter.setup((double)m_Rate, m_Frequency, m_Harmonics, m_Q);
+    }
+
+	/**
+	 * @brief StateDataSize Получить размер данных состояния каналов
+	 * @return Размер в байтах
+	 */
+    virtual int StateDataSize() const override { return m_Filter.getStateSize(); }
+
+	/**
+	 * @brief SaveStateData Записать данные состояния каналов
+	 * @param data Указатель на буфер размером StateDataSize()
+	 */
+    virtual void SaveStateData(void *data) const override { m_Filter.saveState(data); }
+
+	/**
+	 * @brief RestoreStateData Загрузить данные состояния каналов
+	 * @param data Указатель на данные размером StateDataSize()
+	 */
+    virtual void RestoreStateData(const void *data) override
+    {
+        m_Filter.restoreState(data);
+        m_Filter.setDenormalPrevention(m_NumericsMode == FNM_ANTI_DENORMAL);
+    }
+
+public:
+	/**
+	 * @brief CNotchCombFilter Конструктор
+	 * @param harmonics Количество гармоник
+	 * @param channelsList Указатель на список каналов
+	 */
+    CNotchCombFilter(int harmonics, const int *channelsList)
+    : CNotchFilter(harmonics)
+    {
+        memcpy(&m_ChannelsList[0], &channelsList[0], sizeof(m_ChannelsList));
+        Redesign(0);
+    }
+
+	/**
+	 * @brief ~CNotchCombFilter Деструктор
+	 */
+    virtual ~CNotchCombFilter() {}
+
+	/**
+	 * @brief ProcessChannels Функция фильтрации части каналов (непересекающиеся диапазоны каналов могут обрабатываться параллельно)
+	 * @param count Количетво данных
+	 * @param samples Указатель на список данных по всем каналам фильтра
+	 * @param firstChannel Индекс первого обрабатываемого канала
+	 * @param channelsCount Количество обрабатываемых каналов
+	 */
+    virtual void ProcessChannels(int count, float **samples, int firstChannel, int channelsCount) override
+    {
+        CFlushDenormalsGuard guard(m_NumericsMode == FNM_FLUSH_TO_ZERO);
+
+        //Частота сети отслеживается по первому каналу фильтра до режекции
+        if (m_Adaptive && firstChannel == 0 && channelsCount > 0)
+            TrackMains(count, samples[0]);
+
+        if (m_SteadyStatePending && count > 0)
+            m_Filter.setSteadyState(samples, firstChannel, channelsCount);
+
+        m_Filter.processChannels(count, samples, firstChannel, channelsCount);
+    }
+
+	/**
+	 * @brief FinishProcess Функция завершения обработки блока данных (вызывается один раз после обработки всех каналов)
+	 * @param count Количетво данных
+	 */
+    virtual void FinishProcess(int count) override
+    {
+        if (count > 0)
+            m_SteadyStatePending = false;
+
+        m_Filter.advance(count);
+
+        if (UpdateTracking(count) && !m_Filter.isInTransition())
+        {
+            m_Frequency = m_TrackedFrequency;
+            Redesign((int)(NOTCH_RETUNE_SECONDS * m_Rate));
+        }
+    }
+
+	/**
+	 * @brief SetNumericsMode Установить режим борьбы с денормализованными числами
+	 * @param mode Режим из GARANT_EEG_FILTER_NUMERICS_MODE
+	 * @return true если режим поддерживается фильтром
+	 */
+    virtual bool SetNumericsMode(int mode) override
+    {
+        if (mode != FNM_ANTI_DENORMAL && mode != FNM_FLUSH_TO_ZERO)
+            return false;
+
+        m_NumericsMode = mode;
+        m_Filter.setDenormalPrevention(mode == FNM_ANTI_DENORMAL);
+
+        return true;
+    }
+
+	/**
+	 * @brief Response Домножить частотную характеристику на характеристику фильтра (коэффициенты последней перенастройки)
+	 * @param response Частотная характеристика цепочки фильтров
+	 * @return true
+	 */
+    virtual bool Response(Dsp::FrequencyResponse &response) const override
+    {
+        response.setSampleRate((double)m_Rate);
+        response.multiply(m_Filter);
+
+        return true;
+    }
+
+	/**
+	 * @brief ChannelsCount Получить количество каналов, для которых работает фильтр
+	 * @return Количество каналов
+	 */
+    virtual int ChannelsCount() const override { return MaxChannels; }
+
+	/**
+	 * @brief ChannelsList Получить указатель на список каналов, для которых работает фильтр
+	 * @return Указатель на список каналов
+	 */
+    virtual const int *ChannelsList() const override { return &m_ChannelsList[0]; }
+
+	/**
+	 * @brief Create Функция создания фильтра
+	 * @param harmonics Количество гармоник
+	 * @param channelsList Список каналов
+	 * @return Указатель на созданный фильтр или nullptr если фильтр не был создан
+	 */
+    static CBaseFilter *Create(int harmonics, const int *channelsList)
+    {
+        if (harmonics < 1 || harmonics > NOTCH_COMB_MAX_HARMONICS)
+            return nullptr;
+
+        return new CNotchCombFilter<MaxChannels>(harmonics, channelsList);
+    }
+};
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
+#endif // NOTCHCOMBFILTER_H
+//----------------------------------------------------------------------------------
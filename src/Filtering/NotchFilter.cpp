@@ -0,0 +1,128 @@
+/**
+@file NotchFilter.cpp
+
+@brief Базовый класс для режекторных фильтров сетевой наводки (основная частота и гармоники)
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include "NotchFilter.h"
+#include <algorithm>
+#include <math.h>
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+static const double NOTCH_PI = 3.1415926535897932384626433832795028841971;
+//----------------------------------------------------------------------------------
+void CNotchFilter::SetupNotch(int rate, double frequency, double q, bool adaptive, int transitionSamples)
+{
+    //При смене частоты дискретизации плавный переход не имеет смысла
+    if (rate != m_Rate)
+        transitionSamples = 0;
+
+    m_Rate = rate;
+    m_NominalFrequency = frequency;
+    m_Frequency = frequency;
+    m_Q = (q > 0.0 ? q : 30.0);
+    m_Adaptive = adaptive;
+
+    ResetTracking();
+    Redesign(transitionSamples);
+}
+//----------------------------------------------------------------------------------
+void CNotchFilter::Setup(int rate, int lowFrequency, int hightFrequency, int transitionSamples)
+{
+    (void)hightFrequency;
+
+    SetupNotch(rate, (lowFrequency > 0 ? (double)lowFrequency : m_NominalFrequency), m_Q, m_Adaptive, transitionSamples);
+}
+//----------------------------------------------------------------------------------
+int CNotchFilter::HightFrequency() const
+{
+    int harmonics = m_Harmonics;
+
+    while (harmonics > 1 && m_Frequency * harmonics >= m_Rate / 2.0)
+        harmonics--;
+
+    return (int)(m_Frequency * harmonics + 0.5);
+}
+//----------------------------------------------------------------------------------
+void CNotchFilter::ResetTracking()
+{
+    m_TrackedFrequency = m_Frequency;
+    m_Oscillator = 1.0;
+    m_Demodulated = 0.0;
+    m_Power = 0.0;
+    m_PreviousPhase = 0.0;
+    m_PreviousPhaseValid = false;
+}
+//----------------------------------------------------------------------------------
+void CNotchFilter::TrackMains(int count, const float *samples)
+{
+    if (m_Rate <= 0)
+        return;
+
+    const double alpha = 1.0 - exp(-2.0 * NOTCH_PI * NOTCH_TRACKING_BANDWIDTH / m_Rate);
+    const std::complex<double> rotation = std::polar(1.0, -2.0 * NOTCH_PI * m_TrackedFrequency / m_Rate);
+
+    std::complex<double> oscillator = m_Oscillator;
+    std::complex<double> demodulated = m_Demodulated;
+    double power = m_Power;
+
+    for (int i = 0; i < count; i++)
+    {
+        const double value = samples[i];
+
+        demodulated += alpha * (value * oscillator - demodulated);
+        power += alpha * (value * value - power);
+        oscillator *= rotation;
+    }
+
+    //Нормировка накопленной ошибки округления генератора
+    m_Oscillator = oscillator / std::abs(oscillator);
+    m_Demodulated = demodulated;
+    m_Power = power;
+}
+//----------------------------------------------------------------------------------
+bool CNotchFilter::UpdateTracking(int count)
+{
+    if (!m_Adaptive || count < 1 || m_Rate <= 0)
+        return false;
+
+    //Амплитуда синусоиды равна удвоенному модулю результата демодуляции
+    const double mainsPower = 2.0 * std::norm(m_Demodulated);
+
+    if (mainsPower < NOTCH_TRACKING_MIN_POWER_RATIO * m_Power || mainsPower <= 0.0)
+    {
+        m_PreviousPhaseValid = false;
+        return false;
+    }
+
+    const double phase = std::arg(m_Demodulated);
+
+    if (m_PreviousPhaseValid)
+    {
+        double drift = phase - m_PreviousPhase;
+
+        while (drift > NOTCH_PI)
+            drift -= 2.0 * NOTCH_PI;
+
+        while (drift < -NOTCH_PI)
+            drift += 2.0 * NOTCH_PI;
+
+        //Фаза результата демодуляции меняется со скоростью 2 * pi * (реальная частота - отслеживаемая частота)
+        const double error = drift * m_Rate / (2.0 * NOTCH_PI * count);
+
+        m_TrackedFrequency += NOTCH_TRACKING_GAIN * error;
+        m_TrackedFrequency = std::max(m_NominalFrequency - NOTCH_TRACKING_RANGE, std::min(m_NominalFrequency + NOTCH_TRACKING_RANGE, m_TrackedFrequency));
+    }
+
+    m_PreviousPhase = phase;
+    m_PreviousPhaseValid = true;
+
+    return (fabs(m_TrackedFrequency - m_Frequency) >= NOTCH_RETUNE_THRESHOLD);
+}
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
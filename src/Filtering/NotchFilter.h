@@ -0,0 +1,212 @@
+/**
+@file NotchFilter.h
+
+@brief Базовый класс для режекторных фильтров сетевой наводки (основная частота и гармоники)
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#ifndef NOTCHFILTER_H
+#define NOTCHFILTER_H
+//----------------------------------------------------------------------------------
+#include "BaseFilter.h"
+#include <complex>
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+//! Максимальное количество гармоник (режекций) в фильтре
+const int NOTCH_COMB_MAX_HARMONICS = 10;
+
+//! Максимальное отклонение отслеживаемой частоты сети от номинальной (Гц)
+const double NOTCH_TRACKING_RANGE = 1.5;
+
+//! Полоса фильтра демодулятора отслеживания частоты сети (Гц)
+const double NOTCH_TRACKING_BANDWIDTH = 1.0;
+
+//! Коэффициент усиления петли отслеживания частоты сети
+const double NOTCH_TRACKING_GAIN = 0.5;
+
+//! Минимальная доля мощности сетевой наводки в сигнале для отслеживания частоты
+const double NOTCH_TRACKING_MIN_POWER_RATIO = 0.05;
+
+//! Отклонение отслеживаемой частоты от текущей частоты режекции, при котором фильтр перестраивается (Гц)
+const double NOTCH_RETUNE_THRESHOLD = 0.05;
+
+//! Длительность плавной перестройки фильтра на отслеженную частоту (в секундах)
+const double NOTCH_RETUNE_SECONDS = 0.5;
+//----------------------------------------------------------------------------------
+//! Базовый класс для режекторных фильтров сетевой наводки с опциональным отслеживанием реальной частоты сети
+class CNotchFilter : public CBaseFilter
+{
+protected:
+	//! Рабочая частота
+    int m_Rate = 500;
+
+	//! Количество гармоник
+    int m_Harmonics = 1;
+
+	//! Номинальная частота сети
+    double m_NominalFrequency = 50.0;
+
+	//! Текущая частота режекции основной гармоники
+    double m_Frequency = 50.0;
+
+	//! Добротность режекций
+    double m_Q = 30.0;
+
+	//! Флаг отслеживания реальной частоты сети
+    bool m_Adaptive = false;
+
+	//! Режим борьбы с денормализованными числами
+    int m_NumericsMode = FNM_ANTI_DENORMAL;
+
+	//! Отслеживаемая частота сети
+    double m_TrackedFrequency = 50.0;
+
+	//! Фаза опорного генератора демодулятора
+    std::complex<double> m_Oscillator = 1.0;
+
+	//! Отфильтрованный результат демодуляции
+    std::complex<double> m_Demodulated = 0.0;
+
+	//! Отфильтрованная мощность сигнала
+    double m_Power = 0.0;
+
+	//! Фаза результата демодуляции на предыдущем блоке
+    double m_PreviousPhase = 0.0;
+
+	//! Флаг валидности фазы предыдущего блока
+    bool m_PreviousPhaseValid = false;
+
+	/**
+	 * @brief ResetTracking Сбросить состояние отслеживания частоты сети
+	 */
+    void ResetTracking();
+
+	/**
+	 * @brief TrackMains Демодулировать сигнал на отслеживаемой частоте (вызывается для одного канала до фильтрации)
+	 * @param count Количетво данных
+	 * @param samples Данные канала
+	 */
+    void TrackMains(int count, const float *samples);
+
+	/**
+	 * @brief UpdateTracking Обновить оценку частоты сети по дрейфу фазы демодулятора за блок
+	 * @param count Количетво данных в блоке
+	 * @return true если отслеженная частота отошла от частоты режекции и фильтр нужно перестроить
+	 */
+    bool UpdateTracking(int count);
+
+	/**
+	 * @brief Redesign Пересчитать коэффициенты фильтра по текущим настройкам
+	 * @param transitionSamples Количество отсчетов плавного перехода к новым настройкам
+	 */
+    virtual void Redesign(int transitionSamples) = 0;
+
+	/**
+	 * @brief FillStateHeader Заполнить заголовок состояния (частота старшей гармоники зависит от отслеженной частоты сети и не проверяется)
+	 * @param header Заголовок
+	 */
+    virtual void FillStateHeader(FILTER_STATE_HEADER &header) const override
+    {
+        CBaseFilter::FillStateHeader(header);
+        header.HightFrequency = 0;
+    }
+
+public:
+	/**
+	 * @brief CNotchFilter Конструктор
+	 * @param harmonics Количество гармоник
+	 */
+    CNotchFilter(int harmonics) : m_Harmonics(harmonics) {}
+
+	/**
+	 * @brief ~CNotchFilter Деструктор
+	 */
+    virtual ~CNotchFilter() {}
+
+	/**
+	 * @brief SetupNotch Функция установки настроек режекторного фильтра
+	 * @param rate Рабочая частота
+	 * @param frequency Номинальная частота сети (основная гармоника)
+	 * @param q Добротность каждой режекции
+	 * @param adaptive Отслеживать реальную частоту сети по первому каналу фильтра
+	 * @param transitionSamples Количество отсчетов плавного перехода к новым настройкам (0 - мгновенное применение)
+	 */
+    void SetupNotch(int rate, double frequency, double q, bool adaptive, int transitionSamples);
+
+	/**
+	 * @brief Setup Функция установки настроек фильтра
+	 * @param rate Рабочая частота
+	 * @param lowFrequency Номинальная частота сети (0 - оставить текущую)
+	 * @param hightFrequency Не используется
+	 * @param transitionSamples Количество отсчетов плавного перехода к новым настройкам (0 - мгновенное применение)
+	 */
+    virtual void Setup(int rate, int lowFrequency, int hightFrequency, int transitionSamples) override;
+
+	/**
+	 * @brief Frequency Получить текущую частоту режекции основной гармоники (при отслеживании - отслеженная частота сети)
+	 * @return Частота
+	 */
+    double Frequency() const { return m_Frequency; }
+
+	/**
+	 * @brief Q Получить добротность режекций
+	 * @return Добротность
+	 */
+    double Q() const { return m_Q; }
+
+	/**
+	 * @brief Adaptive Проверить, включено ли отслеживание частоты сети
+	 * @return true если включено
+	 */
+    bool Adaptive() const { return m_Adaptive; }
+
+	/**
+	 * @brief Type Получить тип фильтра
+	 * @return Тип фильтра
+	 */
+    virtual int Type() const override { return FT_NOTCH_COMB; }
+
+	/**
+	 * @brief Order Получить порядок фильтра
+	 * @return Количество гармоник
+	 */
+    virtual int Order() const override { return m_Harmonics; }
+
+	/**
+	 * @brief StateForm Получить форму реализации звеньев фильтра
+	 * @return Форма из GARANT_EEG_FILTER_STATE_FORM
+	 */
+    virtual int StateForm() const override { return FSF_DIRECT_FORM_II; }
+
+	/**
+	 * @brief NumericsMode Получить режим борьбы с денормализованными числами
+	 * @return Режим из GARANT_EEG_FILTER_NUMERICS_MODE
+	 */
+    virtual int NumericsMode() const override { return m_NumericsMode; }
+
+	/**
+	 * @brief Rate Получить рабочую частоту фильтра
+	 * @return Частота
+	 */
+    virtual int Rate() const override { return m_Rate; }
+
+	/**
+	 * @brief LowFrequency Получить номинальную частоту сети
+	 * @return Частота
+	 */
+    virtual int LowFrequency() const override { return (int)(m_NominalFrequency + 0.5); }
+
+	/**
+	 * @brief HightFrequency Получить частоту старшей подавляемой гармоники
+	 * @return Частота
+	 */
+    virtual int HightFrequency() const override;
+};
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
+#endif // NOTCHFILTER_H
+//----------------------------------------------------------------------------------
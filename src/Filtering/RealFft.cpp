@@ -0,0 +1,161 @@
+/**
+@file RealFft.cpp
+
+@brief Быстрое преобразование Фурье для вещественных данных
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include "RealFft.h"
+#include <math.h>
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+int CRealFft::NextSize(int size)
+{
+    int result = 4;
+
+    while (result < size)
+        result <<= 1;
+
+    return result;
+}
+//----------------------------------------------------------------------------------
+bool CRealFft::Init(int size)
+{
+    if (size < 4 || (size & (size - 1)) != 0)
+        return false;
+
+    if (size == m_Size)
+        return true;
+
+    const double pi = 3.1415926535897932384626433832795028841971;
+    const int half = size / 2;
+
+    m_Size = size;
+    m_Twiddles.resize(half / 2 > 0 ? half / 2 : 1);
+    m_SplitTwiddles.resize(half + 1);
+    m_BitReverse.resize(half);
+
+    for (int i = 0; i < (int)m_Twiddles.size(); i++)
+        m_Twiddles[i] = std::polar(1.0, -2.0 * pi * i / half);
+
+    for (int i = 0; i <= half; i++)
+        m_SplitTwiddles[i] = std::polar(1.0, -2.0 * pi * i / size);
+
+    int bits = 0;
+
+    while ((1 << bits) < half)
+        bits++;
+
+    for (int i = 0; i < half; i++)
+    {
+        int reversed = 0;
+
+        for (int b = 0; b < bits; b++)
+        {
+            if (i & (1 << b))
+                reversed |= 1 << (bits - 1 - b);
+        }
+
+        m_BitReverse[i] = reversed;
+    }
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+void CRealFft::Transform(COMPLEX *data) const
+{
+    const int count = m_Size / 2;
+
+    for (int i = 0; i < count; i++)
+    {
+        int j = m_BitReverse[i];
+
+        if (i < j)
+            std::swap(data[i], data[j]);
+    }
+
+    for (int length = 2; length <= count; length <<= 1)
+    {
+        const int halfLength = length / 2;
+        const int step = count / length;
+
+        for (int start = 0; start < count; start += length)
+        {
+            COMPLEX *a = data + start;
+            COMPLEX *b = a + halfLength;
+
+            for (int k = 0, t = 0; k < halfLength; k++, t += step)
+            {
+                COMPLEX product = b[k] * m_Twiddles[t];
+                b[k] = a[k] - product;
+                a[k] += product;
+            }
+        }
+    }
+}
+//----------------------------------------------------------------------------------
+void CRealFft::Forward(const double *input, COMPLEX *output) const
+{
+    const int half = m_Size / 2;
+
+    //Четные отсчеты в действительную часть, нечетные - в мнимую, преобразование выполняется в выходном буфере
+    for (int i = 0; i < half; i++)
+        output[i] = COMPLEX(input[2 * i], input[2 * i + 1]);
+
+    Transform(output);
+
+    //Разделение спектров выполняется парами k и half - k, чтобы не требовался дополнительный буфер
+    for (int k = 1; k <= half / 2; k++)
+    {
+        COMPLEX a = output[k];
+        COMPLEX b = output[half - k];
+
+        COMPLEX even = (a + std::conj(b)) * 0.5;
+        COMPLEX odd = (a - std::conj(b)) * COMPLEX(0.0, -0.5);
+        COMPLEX evenPair = (b + std::conj(a)) * 0.5;
+        COMPLEX oddPair = (b - std::conj(a)) * COMPLEX(0.0, -0.5);
+
+        output[k] = even + m_SplitTwiddles[k] * odd;
+        output[half - k] = evenPair + m_SplitTwiddles[half - k] * oddPair;
+    }
+
+    COMPLEX z0 = output[0];
+
+    output[0] = COMPLEX(z0.real() + z0.imag(), 0.0);
+    output[half] = COMPLEX(z0.real() - z0.imag(), 0.0);
+}
+//----------------------------------------------------------------------------------
+void CRealFft::Inverse(const COMPLEX *input, double *output) const
+{
+    const int half = m_Size / 2;
+
+    //Выходной буфер используется как комплексный рабочий буфер половинного размера
+    COMPLEX *buffer = reinterpret_cast<COMPLEX*>(output);
+
+    //Сборка спектра комплексной последовательности (четные + i * нечетные), сопряженного для обратного преобразования через прямое
+    for (int k = 0; k < half; k++)
+    {
+        COMPLEX a = input[k];
+        COMPLEX b = std::conj(input[half - k]);
+        COMPLEX even = (a + b) * 0.5;
+        COMPLEX odd = (a - b) * 0.5 * std::conj(m_SplitTwiddles[k]);
+
+        buffer[k] = std::conj(even + COMPLEX(0.0, 1.0) * odd);
+    }
+
+    Transform(buffer);
+
+    const double scale = 1.0 / half;
+
+    for (int i = 0; i < m_Size; i += 2)
+    {
+        output[i] *= scale;
+        output[i + 1] *= -scale;
+    }
+}
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
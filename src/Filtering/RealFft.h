@@ -0,0 +1,96 @@
+/**
+@file RealFft.h
+
+@brief Быстрое преобразование Фурье для вещественных данных
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#ifndef REALFFT_H
+#define REALFFT_H
+//----------------------------------------------------------------------------------
+#include <vector>
+using std::vector;
+#include <complex>
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+//! Быстрое преобразование Фурье по основанию 2 для вещественных данных (через комплексное преобразование половинного размера).
+//! После инициализации не имеет изменяемого состояния, поэтому один объект может использоваться из нескольких потоков
+class CRealFft
+{
+public:
+	//! Тип комплексного числа
+    typedef std::complex<double> COMPLEX;
+
+private:
+	//! Размер преобразования
+    int m_Size = 0;
+
+	//! Поворачивающие множители комплексного преобразования половинного размера
+    vector<COMPLEX> m_Twiddles;
+
+	//! Поворачивающие множители для разделения спектров четных и нечетных отсчетов
+    vector<COMPLEX> m_SplitTwiddles;
+
+	//! Таблица бит-реверсивной перестановки
+    vector<int> m_BitReverse;
+
+	/**
+	 * @brief Transform Прямое комплексное преобразование половинного размера на месте
+	 * @param data Данные (Size() / 2 комплексных значений)
+	 */
+    void Transform(COMPLEX *data) const;
+
+public:
+	/**
+	 * @brief CRealFft Конструктор
+	 */
+    CRealFft() {}
+
+	/**
+	 * @brief CRealFft Конструктор
+	 * @param size Размер преобразования (степень двойки, не меньше 4)
+	 */
+    CRealFft(int size) { Init(size); }
+
+	/**
+	 * @brief Init Инициализировать таблицы для указанного размера
+	 * @param size Размер преобразования (степень двойки, не меньше 4)
+	 * @return true если размер допустим
+	 */
+    bool Init(int size);
+
+	/**
+	 * @brief Size Получить размер преобразования
+	 * @return Размер
+	 */
+    int Size() const { return m_Size; }
+
+	/**
+	 * @brief Forward Прямое преобразование
+	 * @param input Вещественные данные (Size() отсчетов)
+	 * @param output Спектр (Size() / 2 + 1 комплексных значений)
+	 */
+    void Forward(const double *input, COMPLEX *output) const;
+
+	/**
+	 * @brief Inverse Обратное преобразование (с нормировкой на размер)
+	 * @param input Спектр (Size() / 2 + 1 комплексных значений)
+	 * @param output Вещественные данные (Size() отсчетов, не должны пересекаться с input)
+	 */
+    void Inverse(const COMPLEX *input, double *output) const;
+
+	/**
+	 * @brief NextSize Получить ближайший допустимый размер преобразования
+	 * @param size Минимальный размер
+	 * @return Степень двойки не меньше size
+	 */
+    static int NextSize(int size);
+};
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
+#endif // REALFFT_H
+//----------------------------------------------------------------------------------
@@ -0,0 +1,185 @@
+/**
+@file Resampler.cpp
+
+@brief Класс для понижения частоты дискретизации данных (полифазный ресэмплер с подавлением наложения спектров)
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include "Resampler.h"
+#include <algorithm>
+#include <math.h>
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+/**
+ * @brief BesselI0 Модифицированная функция Бесселя первого рода нулевого порядка (для окна Кайзера)
+ * @param x Аргумент
+ * @return Значение функции
+ */
+static double BesselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = x / 2.0;
+
+    for (int k = 1; k < 64; k++)
+    {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+
+        if (term < sum * 1e-17)
+            break;
+    }
+
+    return sum;
+}
+//----------------------------------------------------------------------------------
+CResampler::CResampler(int channelsCount)
+: m_ChannelsCount(channelsCount), m_History(channelsCount)
+{
+}
+//----------------------------------------------------------------------------------
+bool CResampler::Setup(int inputRate, int outputRate)
+{
+    if (inputRate < 1 || outputRate < 1 || outputRate > inputRate)
+        return false;
+
+    int a = inputRate;
+    int b = outputRate;
+
+    while (b)
+    {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+
+    m_InputRate = inputRate;
+    m_OutputRate = outputRate;
+    m_Up = outputRate / a;
+    m_Down = inputRate / a;
+
+    //Фильтр рассчитывается на частоте inputRate * up, срез - ниже половины выходной частоты
+    const double pi = 3.1415926535897932384626433832795028841971;
+    const int factor = std::max(m_Up, m_Down);
+    const double cutoff = RESAMPLER_CUTOFF * 0.5 / factor;
+
+    m_TapsPerPhase = (2 * RESAMPLER_ZERO_CROSSINGS * factor + 1 + m_Up - 1) / m_Up;
+
+    const int length = m_TapsPerPhase * m_Up;
+    const double center = (length - 1) / 2.0;
+    const double windowScale = 1.0 / BesselI0(RESAMPLER_KAISER_BETA);
+
+    vector<double> taps(length);
+
+    for (int i = 0; i < length; i++)
+    {
+        double n = i - center;
+        double value = (fabs(n) < 1e-9 ? 2.0 * cutoff : sin(2.0 * pi * cutoff * n) / (pi * n));
+        double position = n / (center + 1.0);
+
+        value *= BesselI0(RESAMPLER_KAISER_BETA * sqrt(std::max(0.0, 1.0 - position * position))) * windowScale;
+
+        taps[i] = value;
+    }
+
+    //Каждая фаза нормируется отдельно и дает единичное усиление на постоянном сигнале:
+    //при общей нормировке прототипа суммы фаз немного различаются, и постоянный сигнал получал бы пульсацию с периодом up
+    m_Coefficients.resize(length);
+
+    for (int phase = 0; phase < m_Up; phase++)
+    {
+        double sum = 0.0;
+
+        for (int k = 0; k < m_TapsPerPhase; k++)
+            sum += taps[phase + k * m_Up];
+
+        for (int k = 0; k < m_TapsPerPhase; k++)
+            m_Coefficients[phase * m_TapsPerPhase + k] = taps[phase + k * m_Up] / sum;
+    }
+
+    Reset();
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+void CResampler::Reset()
+{
+    for (vector<double> &history : m_History)
+        history.assign(std::max(m_TapsPerPhase - 1, 0), 0.0);
+
+    m_NextInput = std::max(m_TapsPerPhase - 1, 0);
+    m_Phase = 0;
+}
+//----------------------------------------------------------------------------------
+double CResampler::Delay() const
+{
+    if (m_Down < 1)
+        return 0.0;
+
+    return (m_TapsPerPhase * m_Up - 1) / 2.0 / m_Down;
+}
+//----------------------------------------------------------------------------------
+int CResampler::Process(int count, double **samples)
+{
+    if (m_TapsPerPhase < 1 || count < 1)
+        return 0;
+
+    const int tapsPerPhase = m_TapsPerPhase;
+    int outputCount = 0;
+    int nextInput = m_NextInput;
+    int phase = m_Phase;
+
+    for (int c = 0; c < m_ChannelsCount; c++)
+    {
+        vector<double> &history = m_History[c];
+        double *channel = samples[c];
+
+        history.insert(history.end(), channel, channel + count);
+
+        const int historySize = (int)history.size();
+        const double *input = &history[0];
+
+        nextInput = m_NextInput;
+        phase = m_Phase;
+        outputCount = 0;
+
+        //Выход записывается на место входа: входные данные уже скопированы в историю, а выходных отсчетов не больше входных
+        while (nextInput < historySize)
+        {
+            const double *coefficients = &m_Coefficients[phase * tapsPerPhase];
+            const double *x = input + nextInput;
+            double result = 0.0;
+
+            for (int k = 0; k < tapsPerPhase; k++)
+                result += coefficients[k] * x[-k];
+
+            channel[outputCount++] = result;
+
+            phase += m_Down;
+            nextInput += phase / m_Up;
+            phase %= m_Up;
+        }
+    }
+
+    //Из истории удаляются отсчеты, которые больше не попадут в окно фильтра
+    int consumed = std::min(nextInput - (tapsPerPhase - 1), (int)m_History[0].size());
+
+    if (consumed > 0)
+    {
+        for (vector<double> &history : m_History)
+            history.erase(history.begin(), history.begin() + consumed);
+
+        nextInput -= consumed;
+    }
+
+    m_NextInput = nextInput;
+    m_Phase = phase;
+
+    return outputCount;
+}
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
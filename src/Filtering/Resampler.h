@@ -0,0 +1,123 @@
+/**
+@file Resampler.h
+
+@brief Класс для понижения частоты дискретизации данных (полифазный ресэмплер с подавлением наложения спектров)
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+//----------------------------------------------------------------------------------
+#include <vector>
+using std::vector;
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+//! Количество переходов через ноль импульсной характеристики фильтра ресэмплера с каждой стороны
+const int RESAMPLER_ZERO_CROSSINGS = 16;
+
+//! Частота среза фильтра ресэмплера относительно половины выходной частоты
+const double RESAMPLER_CUTOFF = 0.9;
+
+//! Параметр окна Кайзера (около 80 дБ подавления)
+const double RESAMPLER_KAISER_BETA = 8.0;
+//----------------------------------------------------------------------------------
+//! Полифазный ресэмплер с рациональным коэффициентом (up / down) для потоковой обработки
+class CResampler
+{
+protected:
+	//! Количество каналов
+    int m_ChannelsCount = 0;
+
+	//! Входная частота
+    int m_InputRate = 0;
+
+	//! Выходная частота
+    int m_OutputRate = 0;
+
+	//! Коэффициент интерполяции
+    int m_Up = 1;
+
+	//! Коэффициент децимации
+    int m_Down = 1;
+
+	//! Количество коэффициентов в одной фазе
+    int m_TapsPerPhase = 0;
+
+	//! Коэффициенты фильтра, сгруппированные по фазам (фаза p: h[p], h[p + up], h[p + 2 * up] ...)
+    vector<double> m_Coefficients;
+
+	//! Последние входные отсчеты по каналам
+    vector< vector<double> > m_History;
+
+	//! Индекс входного отсчета в истории, соответствующего следующему выходному отсчету
+    int m_NextInput = 0;
+
+	//! Фаза следующего выходного отсчета
+    int m_Phase = 0;
+
+public:
+	/**
+	 * @brief CResampler Конструктор
+	 * @param channelsCount Количество каналов
+	 */
+    CResampler(int channelsCount);
+
+	/**
+	 * @brief ~CResampler Деструктор
+	 */
+    virtual ~CResampler() {}
+
+	/**
+	 * @brief Setup Установить частоты и рассчитать фильтр (состояние сбрасывается)
+	 * @param inputRate Входная частота
+	 * @param outputRate Выходная частота (не больше входной)
+	 * @return true если настройки применены
+	 */
+    bool Setup(int inputRate, int outputRate);
+
+	/**
+	 * @brief Reset Сбросить состояние каналов
+	 */
+    void Reset();
+
+	/**
+	 * @brief InputRate Получить входную частоту
+	 * @return Частота
+	 */
+    int InputRate() const { return m_InputRate; }
+
+	/**
+	 * @brief OutputRate Получить выходную частоту
+	 * @return Частота
+	 */
+    int OutputRate() const { return m_OutputRate; }
+
+	/**
+	 * @brief Delay Получить задержку выходного сигнала
+	 * @return Задержка в выходных отсчетах
+	 */
+    double Delay() const;
+
+	/**
+	 * @brief MaxOutputCount Получить максимальное количество выходных отсчетов для порции данных
+	 * @param count Количество входных отсчетов
+	 * @return Количество выходных отсчетов
+	 */
+    int MaxOutputCount(int count) const { return (int)(((long long)count * m_Up + m_Down - 1) / m_Down); }
+
+	/**
+	 * @brief Process Обработать порцию данных
+	 * @param count Количество входных отсчетов
+	 * @param samples Указатель на список данных по каналам (результат записывается на место входных данных)
+	 * @return Количество выходных отсчетов (может меняться от порции к порции при дробном коэффициенте)
+	 */
+    int Process(int count, double **samples);
+};
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
+#endif // RESAMPLER_H
+//----------------------------------------------------------------------------------
@@ -0,0 +1,378 @@
+/**
+@file ZeroPhaseFilter.cpp
+
+@brief Класс для фильтрации записанных данных с нулевой фазой (прямой и обратный проход)
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include "ZeroPhaseFilter.h"
+#include "FilterWorkerPool.h"
+#include "../Recording/BdfHeader.h"
+#include "dspfilter/Utilities.h"
+#include <algorithm>
+#include <thread>
+#include <string.h>
+#include <math.h>
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+//! Данные обработки одного канала файла
+struct ZERO_PHASE_CHANNEL
+{
+	//! Описание сигнала
+    BDF_SIGNAL_INFO Signal;
+
+	//! Смещение данных канала в блоке промежуточных данных (в отсчетах на одну запись)
+    int BlockOffset;
+
+	//! Длина отражаемого края
+    int PadLength;
+
+	//! Последние PadLength + 1 исходных отсчетов канала
+    vector<double> Tail;
+
+	//! Состояние фильтра
+    CZeroPhaseFilter::CHANNEL_STATE State;
+};
+//----------------------------------------------------------------------------------
+CZeroPhaseFilter::CZeroPhaseFilter(const Dsp::Cascade &design)
+{
+    m_Design.assign(design);
+}
+//----------------------------------------------------------------------------------
+int CZeroPhaseFilter::PadLength(long long samplesCount) const
+{
+    long long length = m_PadLength;
+
+    if (length < 0)
+        length = 3 * (2 * m_Design.getNumStages() + 1);
+
+    if (length > samplesCount - 1)
+        length = samplesCount - 1;
+
+    return (int)std::max(length, 0LL);
+}
+//----------------------------------------------------------------------------------
+int CZeroPhaseFilter::WorkersCount(int tasksCount) const
+{
+    int count = m_ThreadsCount;
+
+    if (count < 1)
+        count = (int)std::thread::hardware_concurrency();
+
+    return std::max(1, std::min(count, tasksCount));
+}
+//----------------------------------------------------------------------------------
+void CZeroPhaseFilter::Process(int count, double *samples) const
+{
+    if (count < 1 || samples == nullptr)
+        return;
+
+    const int padLength = PadLength(count);
+    vector<double> extension(padLength);
+    CHANNEL_STATE state;
+
+    //прямой проход: нечетное отражение начала, сигнал, нечетное отражение конца
+    const double first = samples[0];
+    const double last = samples[count - 1];
+
+    for (int i = 0; i < padLength; i++)
+        extension[i] = 2.0 * last - samples[count - 2 - i];
+
+    state.setSteadyState(padLength ? 2.0 * first - samples[padLength] : first, m_Design);
+
+    for (int i = padLength; i > 0; i--)
+        state.process(2.0 * first - samples[i], m_Design);
+
+    for (int i = 0; i < count; i++)
+        samples[i] = state.process(samples[i], m_Design);
+
+    for (int i = 0; i < padLength; i++)
+        extension[i] = state.process(extension[i], m_Design);
+
+    //обратный проход
+    state.setSteadyState(padLength ? extension[padLength - 1] : samples[count - 1], m_Design);
+
+    for (int i = padLength - 1; i >= 0; i--)
+        state.process(extension[i], m_Design);
+
+    for (int i = count - 1; i >= 0; i--)
+        samples[i] = state.process(samples[i], m_Design);
+}
+//----------------------------------------------------------------------------------
+bool CZeroPhaseFilter::ProcessFile(const char *inputFilePath, const char *outputFilePath, int channelsCount, const int *channelsList) const
+{
+    if (inputFilePath == nullptr || outputFilePath == nullptr || channelsCount < 1 || channelsList == nullptr || !strcmp(inputFilePath, outputFilePath))
+        return false;
+
+    FILE *input = fopen(inputFilePath, "rb");
+
+    if (input == nullptr)
+        return false;
+
+    CBdfHeader header;
+
+    if (!header.Read(input))
+    {
+        fclose(input);
+        return false;
+    }
+
+    long long recordsCount = header.RecordsCountBySize(FileSize64(input));
+
+    if (header.RecordsCount() >= 0 && header.RecordsCount() < recordsCount)
+        recordsCount = header.RecordsCount();
+
+    const int recordSize = header.RecordSize();
+
+    //каналы для фильтрации
+    vector<ZERO_PHASE_CHANNEL> channels(channelsCount);
+    int samplesPerRecord = 0;
+    int minSamplesPerRecord = 0;
+    int maxPadLength = 0;
+
+    for (int i = 0; i < channelsCount; i++)
+    {
+        int signalIndex = channelsList[i] - 1;
+
+        if (signalIndex < 0 || signalIndex >= header.SignalsCount() || header.Signal(signalIndex).SamplesPerRecord < 1)
+        {
+            fclose(input);
+            return false;
+        }
+
+        ZERO_PHASE_CHANNEL &channel = channels[i];
+        channel.Signal = header.Signal(signalIndex);
+        channel.BlockOffset = samplesPerRecord;
+        channel.PadLength = PadLength(recordsCount * channel.Signal.SamplesPerRecord);
+        channel.Tail.reserve(channel.PadLength + 1);
+
+        samplesPerRecord += channel.Signal.SamplesPerRecord;
+        maxPadLength = std::max(maxPadLength, channel.PadLength);
+
+        if (!i || channel.Signal.SamplesPerRecord < minSamplesPerRecord)
+            minSamplesPerRecord = channel.Signal.SamplesPerRecord;
+    }
+
+    if (recordsCount < 1)
+    {
+        fclose(input);
+        return false;
+    }
+
+    //размер блока в записях: ограничен по памяти, но достаточен для отражения начала сигнала
+    long long blockRecords = m_BlockSize / (recordSize + samplesPerRecord * (long long)sizeof(double));
+    blockRecords = std::max(blockRecords, (long long)((maxPadLength + minSamplesPerRecord) / minSamplesPerRecord));
+    blockRecords = std::max(1LL, std::min(blockRecords, recordsCount));
+
+    const long long blocksCount = (recordsCount + blockRecords - 1) / blockRecords;
+
+    vector<char> headerData(header.HeaderSize());
+    FileSeek64(input, 0);
+
+    if (fread(&headerData[0], headerData.size(), 1, input) != 1)
+    {
+        fclose(input);
+        return false;
+    }
+
+    string recordsCountText = std::to_string(recordsCount);
+    recordsCountText.resize(8, ' ');
+    memcpy(&headerData[BDF_RECORDS_COUNT_OFFSET], &recordsCountText[0], 8);
+
+    string tempFilePath = string(outputFilePath) + ".tmp";
+    FILE *output = fopen(outputFilePath, "wb");
+    FILE *temp = fopen(tempFilePath.c_str(), "w+b");
+
+    if (output == nullptr || temp == nullptr)
+    {
+        if (output != nullptr)
+            fclose(output);
+
+        if (temp != nullptr)
+        {
+            fclose(temp);
+            remove(tempFilePath.c_str());
+        }
+
+        fclose(input);
+        return false;
+    }
+
+    bool result = (fwrite(&headerData[0], headerData.size(), 1, output) == 1);
+
+    //Рабочие потоки создаются один раз на файл; вызывающий поток читает следующий блок и затем присоединяется к обработке каналов
+    CFilterWorkerPool pool;
+    pool.SetThreadsCount(WorkersCount(channelsCount));
+    const size_t rawBlockSize = (size_t)(blockRecords * recordSize);
+    const size_t samplesBlockSize = (size_t)(blockRecords * samplesPerRecord);
+
+    vector<unsigned char> rawBlocks[2] = { vector<unsigned char>(rawBlockSize), vector<unsigned char>(rawBlockSize) };
+    vector<double> samplesBlocks[2] = { vector<double>(samplesBlockSize), vector<double>(samplesBlockSize) };
+
+    auto blockRecordsCount = [&](long long block) -> int
+    {
+        return (int)std::min(blockRecords, recordsCount - block * blockRecords);
+    };
+
+    auto readRawBlock = [&](long long block, vector<unsigned char> &buffer) -> bool
+    {
+        return FileSeek64(input, header.HeaderSize() + block * blockRecords * recordSize) &&
+                fread(&buffer[0], (size_t)blockRecordsCount(block) * recordSize, 1, input) == 1;
+    };
+
+    auto readSamplesBlock = [&](long long block, vector<double> &buffer) -> bool
+    {
+        return FileSeek64(temp, block * blockRecords * samplesPerRecord * (long long)sizeof(double)) &&
+                fread(&buffer[0], (size_t)blockRecordsCount(block) * samplesPerRecord * sizeof(double), 1, temp) == 1;
+    };
+
+    //прямой проход: исходные данные -> промежуточный файл
+    if (result)
+        result = readRawBlock(0, rawBlocks[0]);
+
+    for (long long block = 0; block < blocksCount && result; block++)
+    {
+        const vector<unsigned char> &raw = rawBlocks[block & 1];
+        vector<double> &samples = samplesBlocks[block & 1];
+        const int records = blockRecordsCount(block);
+
+        pool.Run(channelsCount, [&](int index)
+        {
+            ZERO_PHASE_CHANNEL &channel = channels[index];
+            const int sps = channel.Signal.SamplesPerRecord;
+            const int count = records * sps;
+            double *x = &samples[(size_t)records * channel.BlockOffset];
+
+            for (int r = 0; r < records; r++)
+                Dsp::convertInt24(sps, x + r * sps, &raw[(size_t)r * recordSize + channel.Signal.Offset]);
+
+            if (!block)
+            {
+                const int padLength = channel.PadLength;
+                const double first = x[0];
+
+                channel.State.setSteadyState(padLength ? 2.0 * first - x[padLength] : first, m_Design);
+
+                for (int i = padLength; i > 0; i--)
+                    channel.State.process(2.0 * first - x[i], m_Design);
+            }
+
+            vector<double> &tail = channel.Tail;
+            const int tailSize = channel.PadLength + 1;
+            const int appendCount = std::min(count, tailSize);
+
+            if ((int)tail.size() + appendCount > tailSize)
+                tail.erase(tail.begin(), tail.begin() + ((int)tail.size() + appendCount - tailSize));
+
+            tail.insert(tail.end(), x + count - appendCount, x + count);
+
+            for (int i = 0; i < count; i++)
+                x[i] = channel.State.process(x[i], m_Design);
+        },
+        [&]()
+        {
+            if (block + 1 < blocksCount && !readRawBlock(block + 1, rawBlocks[(block + 1) & 1]))
+                result = false;
+        });
+
+        if (result)
+            result = (fwrite(&samples[0], (size_t)records * samplesPerRecord * sizeof(double), 1, temp) == 1);
+    }
+
+    fflush(temp);
+
+    //нечетное отражение конца сигнала и подготовка к обратному проходу
+    for (ZERO_PHASE_CHANNEL &channel : channels)
+    {
+        const vector<double> &tail = channel.Tail;
+        const int padLength = channel.PadLength;
+        const double last = tail.back();
+        vector<double> extension(padLength);
+
+        for (int i = 0; i < padLength; i++)
+            extension[i] = channel.State.process(2.0 * last - tail[tail.size() - 2 - i], m_Design);
+
+        channel.State.setSteadyState(padLength ? extension[padLength - 1] : last, m_Design);
+
+        for (int i = padLength - 1; i >= 0; i--)
+            channel.State.process(extension[i], m_Design);
+    }
+
+    //обратный проход: промежуточный файл -> результирующий файл (блоки в обратном порядке)
+    if (result)
+        result = readSamplesBlock(blocksCount - 1, samplesBlocks[0]) && readRawBlock(blocksCount - 1, rawBlocks[0]);
+
+    for (long long block = blocksCount - 1, step = 0; block >= 0 && result; block--, step++)
+    {
+        vector<unsigned char> &raw = rawBlocks[step & 1];
+        vector<double> &samples = samplesBlocks[step & 1];
+        const int records = blockRecordsCount(block);
+
+        pool.Run(channelsCount, [&](int index)
+        {
+            ZERO_PHASE_CHANNEL &channel = channels[index];
+            const int sps = channel.Signal.SamplesPerRecord;
+            const int count = records * sps;
+            double *y = &samples[(size_t)records * channel.BlockOffset];
+
+            int minValue = channel.Signal.DigitalMinimum;
+            int maxValue = channel.Signal.DigitalMaximum;
+
+            if (minValue >= maxValue)
+            {
+                minValue = -8388608;
+                maxValue = 8388607;
+            }
+
+            for (int i = count - 1; i >= 0; i--)
+                y[i] = channel.State.process(y[i], m_Design);
+
+            for (int r = 0; r < records; r++)
+            {
+                unsigned char *ptr = &raw[(size_t)r * recordSize + channel.Signal.Offset];
+
+                for (int j = 0; j < sps; j++, ptr += 3)
+                {
+                    double value = floor(y[r * sps + j] + 0.5);
+
+                    if (value < minValue)
+                        value = minValue;
+                    else if (value > maxValue)
+                        value = maxValue;
+
+                    Pack24BitValue(ptr, (int)value);
+                }
+            }
+        },
+        [&]()
+        {
+            if (block > 0 && !(readSamplesBlock(block - 1, samplesBlocks[(step + 1) & 1]) && readRawBlock(block - 1, rawBlocks[(step + 1) & 1])))
+                result = false;
+        });
+
+        if (result)
+        {
+            result = FileSeek64(output, header.HeaderSize() + block * blockRecords * recordSize) &&
+                    fwrite(&raw[0], (size_t)records * recordSize, 1, output) == 1;
+        }
+    }
+
+    fclose(temp);
+    remove(tempFilePath.c_str());
+
+    fclose(input);
+
+    if (fclose(output) != 0)
+        result = false;
+
+    if (!result)
+        remove(outputFilePath);
+
+    return result;
+}
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
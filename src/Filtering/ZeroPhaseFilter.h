@@ -0,0 +1,104 @@
+/**
+@file ZeroPhaseFilter.h
+
+@brief Класс для фильтрации записанных данных с нулевой фазой (прямой и обратный проход)
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#ifndef ZEROPHASEFILTER_H
+#define ZEROPHASEFILTER_H
+//----------------------------------------------------------------------------------
+#include <vector>
+using std::vector;
+//----------------------------------------------------------------------------------
+#include "dspfilter/Cascade.h"
+#include "dspfilter/State.h"
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+//! Класс для фильтрации с нулевой фазой (семантика filtfilt: отражение краев и начальные условия установившегося режима)
+class CZeroPhaseFilter
+{
+public:
+	//! Максимальное количество звеньев второго порядка
+    static const int MAX_STAGES = 32;
+
+	//! Тип состояния фильтра для одного канала
+    typedef Dsp::CascadeStages<MAX_STAGES>::State<Dsp::DirectFormII> CHANNEL_STATE;
+
+protected:
+	//! Коэффициенты фильтра
+    Dsp::CascadeCopy<MAX_STAGES> m_Design;
+
+	//! Количество рабочих потоков (0 - по количеству ядер)
+    int m_ThreadsCount = 0;
+
+	//! Размер обрабатываемого за раз блока данных в байтах
+    int m_BlockSize = 16 * 1024 * 1024;
+
+	//! Длина отражаемого края (-1 - 3 * (2 * количество звеньев + 1), как в filtfilt)
+    int m_PadLength = -1;
+
+	/**
+	 * @brief PadLength Получить длину отражаемого края для сигнала
+	 * @param samplesCount Количество отсчетов сигнала
+	 * @return Длина края
+	 */
+    int PadLength(long long samplesCount) const;
+
+	/**
+	 * @brief WorkersCount Получить количество рабочих потоков
+	 * @param tasksCount Количество задач
+	 * @return Количество потоков
+	 */
+    int WorkersCount(int tasksCount) const;
+
+public:
+	/**
+	 * @brief CZeroPhaseFilter Конструктор
+	 * @param design Фильтр, коэффициенты которого будут использоваться
+	 */
+    CZeroPhaseFilter(const Dsp::Cascade &design);
+
+	/**
+	 * @brief SetThreadsCount Установить количество рабочих потоков
+	 * @param count Количество потоков (0 - по количеству ядер)
+	 */
+    void SetThreadsCount(int count) { m_ThreadsCount = (count < 0 ? 0 : count); }
+
+	/**
+	 * @brief SetBlockSize Установить размер блока данных, обрабатываемого за раз (ограничивает потребление памяти)
+	 * @param size Размер в байтах
+	 */
+    void SetBlockSize(int size) { m_BlockSize = (size < 65536 ? 65536 : size); }
+
+	/**
+	 * @brief SetPadLength Установить длину отражаемого края
+	 * @param length Длина в отсчетах (-1 - по умолчанию)
+	 */
+    void SetPadLength(int length) { m_PadLength = length; }
+
+	/**
+	 * @brief Process Отфильтровать сигнал в памяти
+	 * @param count Количество отсчетов
+	 * @param samples Отсчеты сигнала (результат записывается на место исходных данных)
+	 */
+    void Process(int count, double *samples) const;
+
+	/**
+	 * @brief ProcessFile Отфильтровать BDF файл поблочно (с ограниченным потреблением памяти), каналы обрабатываются параллельно
+	 * @param inputFilePath Путь к исходному BDF файлу
+	 * @param outputFilePath Путь к результирующему BDF файлу
+	 * @param channelsCount Количество фильтруемых каналов
+	 * @param channelsList Список фильтруемых каналов (нумерация сигналов BDF с 1), остальные сигналы копируются без изменений
+	 * @return true если фильтрация прошла успешно
+	 */
+    bool ProcessFile(const char *inputFilePath, const char *outputFilePath, int channelsCount, const int *channelsList) const;
+};
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
+#endif // ZEROPHASEFILTER_H
+//----------------------------------------------------------------------------------
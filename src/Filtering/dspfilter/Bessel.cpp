@@ -35,6 +35,7 @@ THE SOFTWARE.
 
 #include "Common.h"
 #include "Bessel.h"
+#include "PrototypeCache.h"
 #include "RootFinder.h"
 
 namespace Dsp {
@@ -76,6 +77,10 @@ void AnalogLowPass::design (int numPoles,
   {
     m_numPoles = numPoles;
 
+    const PrototypeCache::Key key (PrototypeCache::besselLowPass, numPoles);
+    if (PrototypeCache::lookup (key, *this))
+      return;
+
     reset ();
 
     RootFinderBase& solver (w->roots);
@@ -92,6 +97,8 @@ void AnalogLowPass::design (int numPoles,
 
     if (numPoles & 1)
       add (solver.root()[pairs].real(), infinity());
+
+    PrototypeCache::store (key, *this);
   }
 }
 
@@ -113,6 +120,10 @@ void AnalogLowShelf::design (int numPoles,
     m_numPoles = numPoles;
     m_gainDb = gainDb;
 
+    const PrototypeCache::Key key (PrototypeCache::besselLowShelf, numPoles, gainDb);
+    if (PrototypeCache::lookup (key, *this))
+      return;
+
     reset ();
 
     const double G = pow (10., gainDb / 20) - 1;
@@ -139,6 +150,8 @@ void AnalogLowShelf::design (int numPoles,
 
     if (numPoles & 1)
       add (poles.root()[pairs].real(), zeros.root()[pairs].real());
+
+    PrototypeCache::store (key, *this);
   }
 }
 
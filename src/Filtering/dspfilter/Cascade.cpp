@@ -114,5 +114,78 @@ void Cascade::setLayout (const LayoutBase& proto)
               std::abs (response (proto.getNormalW() / (2 * doublePi))));
 }
 
+void Cascade::copyStages (const Cascade& other)
+{
+  assert (other.m_numStages <= m_maxStages);
+  m_numStages = other.m_numStages;
+
+  for (int i = 0; i < m_numStages; ++i)
+    m_stageArray[i] = other.m_stageArray[i];
+}
+
+void Cascade::setNumStages (int numStages)
+{
+  assert (numStages >= 0 && numStages <= m_maxStages);
+  m_numStages = numStages;
+}
+
+void Cascade::setStage (int index, const BiquadBase& section)
+{
+  assert (index >= 0 && index < m_maxStages);
+  static_cast<BiquadBase&> (m_stageArray[index]) = section;
+}
+
+void Cascade::setIdentityStage (int index)
+{
+  assert (index >= 0 && index < m_maxStages);
+  Stage& stage = m_stageArray[index];
+  stage.m_a0 = 1;
+  stage.m_a1 = 0;
+  stage.m_a2 = 0;
+  stage.m_b0 = 1;
+  stage.m_b1 = 0;
+  stage.m_b2 = 0;
+}
+
+bool Cascade::beginTransition (const Cascade& target,
+                               int numSteps,
+                               Stage* increments)
+{
+  if (numSteps <= 0 || m_numStages != target.m_numStages)
+    return false;
+
+  const double t = 1. / numSteps;
+
+  for (int i = 0; i < m_numStages; ++i)
+  {
+    const Stage& from = m_stageArray[i];
+    const Stage& to = target.m_stageArray[i];
+    Stage& inc = increments[i];
+
+    inc.m_a0 = (to.m_a0 - from.m_a0) * t;
+    inc.m_a1 = (to.m_a1 - from.m_a1) * t;
+    inc.m_a2 = (to.m_a2 - from.m_a2) * t;
+    inc.m_b0 = (to.m_b0 - from.m_b0) * t;
+    inc.m_b1 = (to.m_b1 - from.m_b1) * t;
+    inc.m_b2 = (to.m_b2 - from.m_b2) * t;
+  }
+
+  return true;
+}
+
+void Cascade::stepTransition (const Stage* increments)
+{
+  Stage* stage = m_stageArray;
+  for (int i = m_numStages; --i >= 0; ++stage, ++increments)
+  {
+    stage->m_a0 += increments->m_a0;
+    stage->m_a1 += increments->m_a1;
+    stage->m_a2 += increments->m_a2;
+    stage->m_b0 += increments->m_b0;
+    stage->m_b1 += increments->m_b1;
+    stage->m_b2 += increments->m_b2;
+  }
+}
+
 }
 
@@ -57,6 +57,8 @@ public:
   class StateBase : private DenormalPrevention
   {
   public:
+    typedef typename StateType::value_type value_type;
+
     template <typename Sample>
     inline Sample process (const Sample in, const Cascade& c)
     {
@@ -73,7 +75,196 @@ public:
       return static_cast<Sample> (out);
     }
 
+    // Puts every stage into the steady state for a constant input,
+    // so processing can start without a settling transient.
+    double setSteadyState (const double in, const Cascade& c)
+    {
+      double out = in;
+      StateType* state = m_stateArray;
+      Biquad const* stage = c.m_stageArray;
+      for (int i = c.m_numStages; --i >= 0;)
+        out = (state++)->setSteadyState (out, *stage++);
+      return out;
+    }
+
+    void setDenormalPrevention (bool enabled)
+    {
+      DenormalPrevention::setDenormalPrevention (enabled);
+    }
+
+    // Stage-major processing: each stage runs over a whole chunk of
+    // the block before the next one starts, with its delay line held
+    // in locals. The chunk stays in L1 and the results are identical
+    // to process(). On its own a single recursion is latency bound,
+    // so this is mostly useful as the reference for the paired form.
+    template <typename Sample>
+    void processBlock (int numSamples, Sample* dest, const Cascade& c)
+    {
+      value_type buffer [blockChunk];
+
+      while (numSamples > 0)
+      {
+        const int n = std::min (numSamples, int (blockChunk));
+
+        for (int i = 0; i < n; ++i)
+          buffer[i] = dest[i];
+
+        double vsa = advanceVsa (n);
+
+        for (int k = 0; k < c.m_numStages; ++k)
+        {
+          const Biquad& stage = c.m_stageArray[k];
+          StateType state = m_stateArray[k];
+
+          for (int i = 0; i < n; ++i)
+          {
+            buffer[i] = state.process1 (buffer[i], stage, vsa);
+            vsa = -vsa;
+          }
+
+          m_stateArray[k] = state;
+          vsa = 0;
+        }
+
+        for (int i = 0; i < n; ++i)
+          dest[i] = static_cast<Sample> (buffer[i]);
+
+        dest += n;
+        numSamples -= n;
+      }
+    }
+
+    // Same as processBlock() for two independent channels at once.
+    // Their recursions are interleaved in one loop so the latency
+    // of one chain is hidden behind the other; this is faster than
+    // process() from order 2 up (see benchmarks/CascadeBlock).
+    template <typename Sample>
+    void processBlock (int numSamples,
+                       Sample* dest,
+                       StateBase& other,
+                       Sample* otherDest,
+                       const Cascade& c)
+    {
+      value_type buffer [blockChunk];
+      value_type otherBuffer [blockChunk];
+
+      while (numSamples > 0)
+      {
+        const int n = std::min (numSamples, int (blockChunk));
+
+        for (int i = 0; i < n; ++i)
+        {
+          buffer[i] = dest[i];
+          otherBuffer[i] = otherDest[i];
+        }
+
+        double vsa = advanceVsa (n);
+        double otherVsa = other.advanceVsa (n);
+
+        for (int k = 0; k < c.m_numStages; ++k)
+        {
+          const Biquad& stage = c.m_stageArray[k];
+          StateType state = m_stateArray[k];
+          StateType otherState = other.m_stateArray[k];
+
+          for (int i = 0; i < n; ++i)
+          {
+            buffer[i] = state.process1 (buffer[i], stage, vsa);
+            otherBuffer[i] = otherState.process1 (otherBuffer[i], stage, otherVsa);
+            vsa = -vsa;
+            otherVsa = -otherVsa;
+          }
+
+          m_stateArray[k] = state;
+          other.m_stateArray[k] = otherState;
+          vsa = 0;
+          otherVsa = 0;
+        }
+
+        for (int i = 0; i < n; ++i)
+        {
+          dest[i] = static_cast<Sample> (buffer[i]);
+          otherDest[i] = static_cast<Sample> (otherBuffer[i]);
+        }
+
+        dest += n;
+        otherDest += n;
+        numSamples -= n;
+      }
+    }
+
+    // Same as processBlock() for Lanes channels at once. The chunk is
+    // kept sample-major with the channels side by side, and each state
+    // form runs a stage over all lanes of a sample with its delay
+    // elements in per-lane arrays (StateType::processLanes()), so the
+    // lanes map onto vector registers: 8 float states per AVX register,
+    // 4 per SSE register. Results are those of processBlock() per lane.
+    template <int Lanes, typename Sample>
+    static void processBlockLanes (int numSamples,
+                                   Sample* const* dest,
+                                   StateBase* const* states,
+                                   const Cascade& c)
+    {
+      value_type buffer [blockChunk][Lanes];
+      int done = 0;
+
+      while (done < numSamples)
+      {
+        const int n = std::min (numSamples - done, int (blockChunk));
+        value_type vsa [Lanes];
+
+        for (int l = 0; l < Lanes; ++l)
+        {
+          const Sample* src = dest[l] + done;
+          for (int i = 0; i < n; ++i)
+            buffer[i][l] = static_cast<value_type> (src[i]);
+          vsa[l] = static_cast<value_type> (states[l]->advanceVsa (n));
+        }
+
+        for (int k = 0; k < c.m_numStages; ++k)
+        {
+          StateType state [Lanes];
+
+          for (int l = 0; l < Lanes; ++l)
+            state[l] = states[l]->m_stateArray[k];
+
+          StateType::template processLanes <Lanes> (
+            n, buffer, state, c.m_stageArray[k], vsa);
+
+          for (int l = 0; l < Lanes; ++l)
+          {
+            states[l]->m_stateArray[k] = state[l];
+            vsa[l] = 0;
+          }
+        }
+
+        for (int l = 0; l < Lanes; ++l)
+        {
+          Sample* out = dest[l] + done;
+          for (int i = 0; i < n; ++i)
+            out[i] = static_cast<Sample> (buffer[i][l]);
+        }
+
+        done += n;
+      }
+    }
+
   protected:
+    enum
+    {
+      blockChunk = 128
+    };
+
+    // Returns the constant process() would inject into the first
+    // sample of the next n, and moves on as if n were processed.
+    double advanceVsa (int n)
+    {
+      const double vsa = ac ();
+      if ((n - 1) & 1)
+        ac ();
+      return vsa;
+    }
+
     StateBase (StateType* stateArray)
       : m_stateArray (stateArray)
     {
@@ -104,7 +295,12 @@ public:
     return m_numStages;
   }
 
-  const Stage& operator[] (int index)
+  int getMaxStages () const
+  {
+    return m_maxStages;
+  }
+
+  const Stage& operator[] (int index) const
   {
     assert (index >= 0 && index <= m_numStages);
     return m_stageArray[index];
@@ -126,6 +322,35 @@ public:
     }
   }
 
+  // Process a block stage by stage, see StateBase::processBlock()
+  template <class StateType, typename Sample>
+  void processBlock (int numSamples, Sample* dest, StateType& state) const
+  {
+    state.processBlock (numSamples, dest, *this);
+  }
+
+  // Process a block of two channels with interleaved recursions
+  template <class StateType, typename Sample>
+  void processBlock (int numSamples,
+                     Sample* dest,
+                     StateType& state,
+                     Sample* otherDest,
+                     StateType& otherState) const
+  {
+    state.processBlock (numSamples, dest, otherState, otherDest, *this);
+  }
+
+  // Process a block of Lanes channels side by side, see
+  // StateBase::processBlockLanes()
+  template <int Lanes, class StateType, typename Sample>
+  void processBlockLanes (int numSamples,
+                          Sample* const* dest,
+                          StateBase <StateType>* const* states) const
+  {
+    StateBase <StateType>::template processBlockLanes <Lanes> (
+      numSamples, dest, states, *this);
+  }
+
 protected:
   Cascade ();
 
@@ -134,6 +359,27 @@ protected:
   void applyScale (double scale);
   void setLayout (const LayoutBase& proto);
 
+  // Copy the stage coefficients of another cascade into our own storage.
+  void copyStages (const Cascade& other);
+
+  // Prepare a linear move of every stage's coefficients from their current
+  // values to the ones of 'target' over numSteps calls to stepTransition().
+  // The stability region of a second order section is convex in (a1, a2),
+  // so interpolating between two stable designs of the same layout in SOS
+  // space never produces an unstable section. Returns false if the layouts
+  // differ and no transition is possible.
+  bool beginTransition (const Cascade& target, int numSteps, Stage* increments);
+
+  void stepTransition (const Stage* increments);
+
+  // Build the cascade directly from independently designed sections,
+  // for responses which do not come from an analog prototype.
+  void setNumStages (int numStages);
+
+  void setStage (int index, const BiquadBase& section);
+
+  void setIdentityStage (int index);
+
 private:
   int m_numStages;
   int m_maxStages;
@@ -147,6 +393,11 @@ template <int MaxStages>
 class CascadeStages
 {
 public:
+  enum
+  {
+    MaxStageCount = MaxStages
+  };
+
   template <class StateType>
   class State : public Cascade::StateBase <StateType>
   {
@@ -164,6 +415,24 @@ public:
         state->reset();
     }
 
+    // The delay lines of all stages as plain data, for saving and
+    // restoring a running filter. The stage array pointer is not
+    // part of it, so the data can go into a different instance.
+    static int getStateSize ()
+    {
+      return MaxStages * sizeof (StateType);
+    }
+
+    void saveState (void* data) const
+    {
+      memcpy (data, m_states, getStateSize ());
+    }
+
+    void restoreState (const void* data)
+    {
+      memcpy (m_states, data, getStateSize ());
+    }
+
   private:
     StateType m_states[MaxStages];
   };
@@ -178,6 +447,68 @@ private:
   Cascade::Stage m_stages[MaxStages];
 };
 
+//------------------------------------------------------------------------------
+
+// Free standing copy of the coefficients of another cascade. Unlike the
+// filters themselves it does not depend on any prototype storage.
+template <int MaxStages>
+class CascadeCopy : public Cascade
+{
+public:
+  enum
+  {
+    MaxStageCount = MaxStages
+  };
+
+  CascadeCopy ()
+  {
+    setCascadeStorage (Cascade::Storage (MaxStages, m_stages));
+  }
+
+  void assign (const Cascade& other)
+  {
+    copyStages (other);
+  }
+
+private:
+  Cascade::Stage m_stages[MaxStages];
+};
+
+//------------------------------------------------------------------------------
+
+// Set of coefficients which moves linearly between two designs of the
+// same layout. Only the endpoints are designed, so each step of the
+// transition costs one add per coefficient.
+template <int MaxStages>
+class CascadeTransition : public CascadeCopy <MaxStages>
+{
+public:
+  using CascadeCopy <MaxStages>::assign;
+
+  // Copy the current point of another transition together with its
+  // increments, so the copy can be stepped independently.
+  void assign (const CascadeTransition& other)
+  {
+    this->copyStages (other);
+
+    for (int i = 0; i < MaxStages; ++i)
+      m_increments[i] = other.m_increments[i];
+  }
+
+  bool begin (const Cascade& target, int numSteps)
+  {
+    return this->beginTransition (target, numSteps, m_increments);
+  }
+
+  void step ()
+  {
+    this->stepTransition (m_increments);
+  }
+
+private:
+  Cascade::Stage m_increments[MaxStages];
+};
+
 }
 
 #endif
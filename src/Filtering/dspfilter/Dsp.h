@@ -45,7 +45,9 @@ THE SOFTWARE.
 #include "Biquad.h"
 #include "Cascade.h"
 #include "Filter.h"
+#include "FrequencyResponse.h"
 #include "PoleFilter.h"
+#include "PrototypeCache.h"
 #include "SmoothedFilter.h"
 #include "State.h"
 #include "Utilities.h"
@@ -35,6 +35,7 @@ THE SOFTWARE.
 
 #include "Common.h"
 #include "Elliptic.h"
+#include "PrototypeCache.h"
 
 namespace Dsp {
 
@@ -84,6 +85,10 @@ void AnalogLowPass::design (int numPoles,
     m_rippleDb = rippleDb;
     m_rolloff = rolloff;
 
+    const PrototypeCache::Key key (PrototypeCache::ellipticLowPass, numPoles, rippleDb, rolloff);
+    if (PrototypeCache::lookup (key, *this))
+      return;
+
     reset ();
 
     // calculate
@@ -165,6 +170,8 @@ void AnalogLowPass::design (int numPoles,
     }
 
     setNormal (0, (numPoles&1) ? 1. : pow (10., -rippleDb / 20.0));
+
+    PrototypeCache::store (key, *this);
   }
 }
 
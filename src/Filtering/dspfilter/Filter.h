@@ -253,15 +253,99 @@ public:
     m_state.reset();
   }
 
+  void setDenormalPrevention (bool enabled)
+  {
+    for (int i = 0; i < Channels; ++i)
+      m_state[i].setDenormalPrevention (enabled);
+  }
+
+  // Size of the delay lines of all channels, see saveState().
+  int getStateSize () const
+  {
+    return Channels * channel_state_t::getStateSize ();
+  }
+
+  void saveState (void* data) const
+  {
+    for (int i = 0; i < Channels; ++i)
+      m_state[i].saveState (static_cast<char*>(data) +
+                            i * channel_state_t::getStateSize ());
+  }
+
+  void restoreState (const void* data)
+  {
+    for (int i = 0; i < Channels; ++i)
+      m_state[i].restoreState (static_cast<const char*>(data) +
+                               i * channel_state_t::getStateSize ());
+  }
+
+  // Puts a range of channels into the steady state for their first
+  // sample, so a restarted stream does not begin with a transient.
+  template <typename Sample>
+  void setSteadyState (Sample* const* arrayOfChannels,
+                       int firstChannel,
+                       int numChannels)
+  {
+    for (int i = firstChannel; i < firstChannel + numChannels; ++i)
+      m_state[i].setSteadyState (arrayOfChannels[i][0], *this);
+  }
+
   template <typename Sample>
   void process (int numSamples, Sample* const* arrayOfChannels)
   {
-    m_state.process (numSamples, arrayOfChannels, *((FilterClass*)this));
+    processChannelsBlock (numSamples, arrayOfChannels, 0, 0, Channels);
   }
 
 protected:
-  ChannelsState <Channels,
-                 typename FilterClass::template State <StateType> > m_state;
+  typedef typename FilterClass::template State <StateType> channel_state_t;
+
+  enum
+  {
+    // Channels processed side by side, see
+    // Cascade::StateBase::processBlockLanes()
+    lanes = 8
+  };
+
+  // Processing of a range of channels starting at the given sample
+  // offset. Channels go stage-major in groups of 'lanes' processed side
+  // by side, then in pairs to interleave their recursions, see
+  // Cascade::StateBase::processBlock(); an odd one left over is faster
+  // sample-major.
+  template <typename Sample>
+  void processChannelsBlock (int numSamples,
+                             Sample* const* arrayOfChannels,
+                             int offset,
+                             int firstChannel,
+                             int numChannels)
+  {
+    const int lastChannel = firstChannel + numChannels;
+    int i = firstChannel;
+
+    for (; i + lanes <= lastChannel; i += lanes)
+    {
+      Sample* dest [lanes];
+      typename FilterClass::template StateBase <StateType>* states [lanes];
+
+      for (int l = 0; l < lanes; ++l)
+      {
+        dest[l] = arrayOfChannels[i + l] + offset;
+        states[l] = &m_state[i + l];
+      }
+
+      FilterClass::template processBlockLanes <lanes> (numSamples, dest, states);
+    }
+
+    for (; i + 1 < lastChannel; i += 2)
+      FilterClass::processBlock (numSamples,
+                                 arrayOfChannels[i] + offset, m_state[i],
+                                 arrayOfChannels[i + 1] + offset, m_state[i + 1]);
+
+    if (i < lastChannel)
+      FilterClass::process (numSamples,
+                            arrayOfChannels[i] + offset, m_state[i]);
+  }
+
+  ChannelsState <Channels, channel_state_t> m_state;
 };
 
 }
@@ -0,0 +1,352 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vinnie Falco
+
+Official project location:
+https://github.com/vinniefalco/DSPFilters
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vinnie Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "Common.h"
+#include "FrequencyResponse.h"
+
+namespace Dsp {
+
+namespace {
+
+// points per pass over the stages
+const int chunkSize = 256;
+
+enum GridKind
+{
+  gridNone,
+  gridLinear,
+  gridLogarithmic,
+  gridCustom
+};
+
+}
+
+FrequencyResponse::FrequencyResponse ()
+  : m_count (0)
+  , m_gridKind (gridNone)
+  , m_first (0)
+  , m_last (0)
+  , m_sampleRate (1)
+  , m_twiddlesValid (false)
+{
+}
+
+void FrequencyResponse::resize (int count)
+{
+  m_count = count;
+  m_frequency.resize (count);
+  m_cos1.resize (count);
+  m_sin1.resize (count);
+  m_cos2.resize (count);
+  m_sin2.resize (count);
+  m_re.resize (count);
+  m_im.resize (count);
+  m_numRe.resize (count);
+  m_numIm.resize (count);
+  m_denRe.resize (count);
+  m_denIm.resize (count);
+  m_twiddlesValid = false;
+}
+
+void FrequencyResponse::setLinear (int count, double first, double last)
+{
+  if (count < 0)
+    count = 0;
+
+  // the same grid keeps its twiddles
+  if (m_gridKind == gridLinear && count == m_count && first == m_first && last == m_last)
+    return;
+
+  resize (count);
+  m_gridKind = gridLinear;
+  m_first = first;
+  m_last = last;
+
+  const double step = count > 1 ? (last - first) / (count - 1) : 0;
+  for (int i = 0; i < count; ++i)
+    m_frequency[i] = first + step * i;
+
+  reset ();
+}
+
+void FrequencyResponse::setLogarithmic (int count, double first, double last)
+{
+  if (count < 0)
+    count = 0;
+
+  assert (count == 0 || (first > 0 && last > 0));
+
+  if (m_gridKind == gridLogarithmic && count == m_count && first == m_first && last == m_last)
+    return;
+
+  resize (count);
+  m_gridKind = gridLogarithmic;
+  m_first = first;
+  m_last = last;
+
+  const double logFirst = log (first);
+  const double step = count > 1 ? (log (last) - logFirst) / (count - 1) : 0;
+  for (int i = 0; i < count; ++i)
+    m_frequency[i] = exp (logFirst + step * i);
+
+  reset ();
+}
+
+void FrequencyResponse::setFrequencies (int count, const double* frequencies)
+{
+  if (count < 0)
+    count = 0;
+
+  resize (count);
+  m_gridKind = gridCustom;
+
+  for (int i = 0; i < count; ++i)
+    m_frequency[i] = frequencies[i];
+
+  reset ();
+}
+
+void FrequencyResponse::setSampleRate (double sampleRate)
+{
+  if (sampleRate != m_sampleRate)
+  {
+    m_sampleRate = sampleRate;
+    m_twiddlesValid = false;
+  }
+}
+
+void FrequencyResponse::updateTwiddles ()
+{
+  if (m_twiddlesValid)
+    return;
+
+  const double scale = 2 * doublePi / m_sampleRate;
+  for (int i = 0; i < m_count; ++i)
+  {
+    const double w = m_frequency[i] * scale;
+    m_cos1[i] = cos (w);
+    m_sin1[i] = sin (w);
+
+    // double angle identities, exact enough and cheaper than two more calls
+    m_cos2[i] = m_cos1[i] * m_cos1[i] - m_sin1[i] * m_sin1[i];
+    m_sin2[i] = 2 * m_sin1[i] * m_cos1[i];
+  }
+
+  m_twiddlesValid = true;
+}
+
+void FrequencyResponse::reset ()
+{
+  for (int i = 0; i < m_count; ++i)
+  {
+    m_re[i] = 1;
+    m_im[i] = 0;
+  }
+}
+
+void FrequencyResponse::multiplyStage (int first, int count,
+                                       double b0, double b1, double b2,
+                                       double a1, double a2)
+{
+  const double* c1 = &m_cos1[first];
+  const double* s1 = &m_sin1[first];
+  const double* c2 = &m_cos2[first];
+  const double* s2 = &m_sin2[first];
+  double* numRe = &m_numRe[first];
+  double* numIm = &m_numIm[first];
+  double* denRe = &m_denRe[first];
+  double* denIm = &m_denIm[first];
+
+  // z^-1 = cos w - j sin w
+  for (int i = 0; i < count; ++i)
+  {
+    const double tr = b0 + b1 * c1[i] + b2 * c2[i];
+    const double ti = -(b1 * s1[i] + b2 * s2[i]);
+    const double br = 1 + a1 * c1[i] + a2 * c2[i];
+    const double bi = -(a1 * s1[i] + a2 * s2[i]);
+
+    const double nr = numRe[i] * tr - numIm[i] * ti;
+    const double ni = numRe[i] * ti + numIm[i] * tr;
+    const double dr = denRe[i] * br - denIm[i] * bi;
+    const double di = denRe[i] * bi + denIm[i] * br;
+
+    numRe[i] = nr;
+    numIm[i] = ni;
+    denRe[i] = dr;
+    denIm[i] = di;
+  }
+}
+
+void FrequencyResponse::beginChunk (int first, int count)
+{
+  for (int i = first; i < first + count; ++i)
+  {
+    m_numRe[i] = m_denRe[i] = 1;
+    m_numIm[i] = m_denIm[i] = 0;
+  }
+}
+
+void FrequencyResponse::applyScratch (int first, int count)
+{
+  double* re = &m_re[first];
+  double* im = &m_im[first];
+  const double* numRe = &m_numRe[first];
+  const double* numIm = &m_numIm[first];
+  const double* denRe = &m_denRe[first];
+  const double* denIm = &m_denIm[first];
+
+  // one division per point and filter, as in Cascade::response()
+  for (int i = 0; i < count; ++i)
+  {
+    const double d = denRe[i] * denRe[i] + denIm[i] * denIm[i];
+    const double qr = (numRe[i] * denRe[i] + numIm[i] * denIm[i]) / d;
+    const double qi = (numIm[i] * denRe[i] - numRe[i] * denIm[i]) / d;
+
+    const double r = re[i] * qr - im[i] * qi;
+    im[i] = re[i] * qi + im[i] * qr;
+    re[i] = r;
+  }
+}
+
+void FrequencyResponse::multiply (const Cascade& cascade)
+{
+  if (m_count == 0)
+    return;
+
+  updateTwiddles ();
+
+  const int numStages = cascade.getNumStages ();
+
+  // all stages over a chunk of points, so the scratch stays in cache
+  for (int first = 0; first < m_count; first += chunkSize)
+  {
+    const int count = std::min (chunkSize, m_count - first);
+    beginChunk (first, count);
+
+    for (int s = 0; s < numStages; ++s)
+    {
+      const Cascade::Stage& stage = cascade[s];
+      const double a0 = stage.getA0 ();
+      multiplyStage (first, count,
+                     stage.getB0 () / a0, stage.getB1 () / a0, stage.getB2 () / a0,
+                     stage.getA1 () / a0, stage.getA2 () / a0);
+    }
+
+    applyScratch (first, count);
+  }
+}
+
+void FrequencyResponse::multiply (int numStages, const double* coefficients)
+{
+  if (m_count == 0)
+    return;
+
+  updateTwiddles ();
+
+  for (int first = 0; first < m_count; first += chunkSize)
+  {
+    const int count = std::min (chunkSize, m_count - first);
+    beginChunk (first, count);
+
+    const double* c = coefficients;
+    for (int s = 0; s < numStages; ++s, c += 5)
+      multiplyStage (first, count, c[0], c[1], c[2], c[3], c[4]);
+
+    applyScratch (first, count);
+  }
+}
+
+void FrequencyResponse::multiplyTransversal (int numTaps, const double* taps)
+{
+  if (m_count == 0)
+    return;
+
+  updateTwiddles ();
+
+  const int count = m_count;
+  const double* c1 = &m_cos1[0];
+  const double* s1 = &m_sin1[0];
+
+  // the numerator scratch holds the sum, the denominator scratch the
+  // phasor z^-k of every point, advanced by one rotation per tap
+  double* sumRe = &m_numRe[0];
+  double* sumIm = &m_numIm[0];
+  double* zr = &m_denRe[0];
+  double* zi = &m_denIm[0];
+
+  for (int i = 0; i < count; ++i)
+  {
+    sumRe[i] = sumIm[i] = 0;
+    zr[i] = 1;
+    zi[i] = 0;
+  }
+
+  for (int k = 0; k < numTaps; ++k)
+  {
+    const double h = taps[k];
+    for (int i = 0; i < count; ++i)
+    {
+      sumRe[i] += h * zr[i];
+      sumIm[i] += h * zi[i];
+
+      const double r = zr[i] * c1[i] + zi[i] * s1[i];
+      zi[i] = zi[i] * c1[i] - zr[i] * s1[i];
+      zr[i] = r;
+    }
+  }
+
+  double* re = &m_re[0];
+  double* im = &m_im[0];
+  for (int i = 0; i < count; ++i)
+  {
+    const double r = re[i] * sumRe[i] - im[i] * sumIm[i];
+    im[i] = re[i] * sumIm[i] + im[i] * sumRe[i];
+    re[i] = r;
+  }
+}
+
+void FrequencyResponse::getMagnitude (double* dest) const
+{
+  for (int i = 0; i < m_count; ++i)
+    dest[i] = sqrt (m_re[i] * m_re[i] + m_im[i] * m_im[i]);
+}
+
+void FrequencyResponse::getPhase (double* dest) const
+{
+  for (int i = 0; i < m_count; ++i)
+    dest[i] = atan2 (m_im[i], m_re[i]);
+}
+
+}
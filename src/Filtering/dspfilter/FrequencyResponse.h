@@ -0,0 +1,166 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vinnie Falco
+
+Official project location:
+https://github.com/vinniefalco/DSPFilters
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vinnie Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+#ifndef DSPFILTERS_FREQUENCYRESPONSE_H
+#define DSPFILTERS_FREQUENCYRESPONSE_H
+
+#include "Common.h"
+#include "Biquad.h"
+#include "Cascade.h"
+#include "MathSupplement.h"
+
+namespace Dsp {
+
+/*
+ * Batch frequency response
+ *
+ * Evaluates the complex response of a chain of filters over a grid of
+ * frequencies in one pass per stage. The twiddles z^-1 and z^-2 of every
+ * grid point are computed once and shared by all stages of all filters;
+ * they are kept between evaluations until the grid or the sample rate
+ * changes, so redrawing a plot after a parameter change only costs the
+ * stage arithmetic. Data is stored as separate arrays of real and
+ * imaginary parts so the per-point loops vectorize.
+ *
+ * Usage:
+ *
+ *  response.setLogarithmic (1000, 0.1, 250); // grid in Hz
+ *  response.setSampleRate (500);
+ *  response.reset ();
+ *  response.multiply (highPass);  // any Cascade
+ *  response.multiply (notch);
+ *  response.getMagnitude (magnitude);
+ *
+ */
+
+class FrequencyResponse
+{
+public:
+  FrequencyResponse ();
+
+  // Evenly spaced grid from first to last inclusive, in any unit
+  // (normalized frequency = frequency / sample rate). A new grid starts
+  // with a response of 1, repeating the current one changes nothing.
+  void setLinear (int count, double first, double last);
+
+  // Logarithmically spaced grid, first must be positive.
+  void setLogarithmic (int count, double first, double last);
+
+  // Arbitrary grid
+  void setFrequencies (int count, const double* frequencies);
+
+  // Sample rate in grid units, 1 for grids of normalized frequencies.
+  void setSampleRate (double sampleRate);
+
+  // Set the response of every point to 1 (empty chain).
+  void reset ();
+
+  // Chain a cascade of biquads.
+  void multiply (const Cascade& cascade);
+
+  // Chain second order sections given as { b0, b1, b2, a1, a2 } per
+  // stage with a0 = 1 (for example quantized coefficients).
+  void multiply (int numStages, const double* coefficients);
+
+  // Chain a transversal (FIR) filter.
+  void multiplyTransversal (int numTaps, const double* taps);
+
+  int getCount () const
+  {
+    return m_count;
+  }
+
+  const double* getFrequencies () const
+  {
+    return m_count ? &m_frequency[0] : 0;
+  }
+
+  complex_t getResponse (int index) const
+  {
+    return complex_t (m_re[index], m_im[index]);
+  }
+
+  // Magnitude of every point
+  void getMagnitude (double* dest) const;
+
+  // Phase of every point in radians, wrapped to (-pi, pi]
+  void getPhase (double* dest) const;
+
+private:
+  void resize (int count);
+  void updateTwiddles ();
+
+  // Set the scratch products of a range of points to 1
+  void beginChunk (int first, int count);
+
+  // Multiply the response of a range of points by num/den of the
+  // scratch products
+  void applyScratch (int first, int count);
+
+  // Accumulate one second order section into the scratch products
+  void multiplyStage (int first, int count,
+                      double b0, double b1, double b2,
+                      double a1, double a2);
+
+private:
+  int m_count;
+  int m_gridKind;
+  double m_first;
+  double m_last;
+  double m_sampleRate;
+  bool m_twiddlesValid;
+
+  std::vector<double> m_frequency;
+
+  // cos/sin of w and 2w for every point
+  std::vector<double> m_cos1;
+  std::vector<double> m_sin1;
+  std::vector<double> m_cos2;
+  std::vector<double> m_sin2;
+
+  // accumulated response
+  std::vector<double> m_re;
+  std::vector<double> m_im;
+
+  // numerator and denominator products of the filter being chained
+  std::vector<double> m_numRe;
+  std::vector<double> m_numIm;
+  std::vector<double> m_denRe;
+  std::vector<double> m_denIm;
+};
+
+}
+
+#endif
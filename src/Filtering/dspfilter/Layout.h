@@ -141,6 +141,18 @@ public:
     m_normalGain = g;
   }
 
+  // Copy the poles, zeros and normalization of another layout
+  // into our own storage.
+  void copyFrom (const LayoutBase& other)
+  {
+    assert (other.m_numPoles <= m_maxPoles);
+    m_numPoles = other.m_numPoles;
+    for (int i = 0; i < (m_numPoles+1)/2; ++i)
+      m_pair[i] = other.m_pair[i];
+    m_normalW = other.m_normalW;
+    m_normalGain = other.m_normalGain;
+  }
+
 private:
   int m_numPoles;
   int m_maxPoles;
@@ -35,6 +35,7 @@ THE SOFTWARE.
 
 #include "Common.h"
 #include "Legendre.h"
+#include "PrototypeCache.h"
 #include "RootFinder.h"
 
 #include <sstream>
@@ -241,6 +242,10 @@ void AnalogLowPass::design (int numPoles,
   {
     m_numPoles = numPoles;
 
+    const PrototypeCache::Key key (PrototypeCache::legendreLowPass, numPoles);
+    if (PrototypeCache::lookup (key, *this))
+      return;
+
     reset ();
 
     PolynomialFinderBase& poly (w->poly);
@@ -274,6 +279,8 @@ void AnalogLowPass::design (int numPoles,
 
     if (numPoles & 1)
       add (poles.root()[pairs].real(), infinity());
+
+    PrototypeCache::store (key, *this);
   }
 }
 
@@ -139,6 +139,13 @@ public:
     return m_v = -m_v;
   }
 
+  // Disabling leaves a zero constant in place, for processing threads
+  // which flush denormals in hardware (FTZ/DAZ) instead.
+  void setDenormalPrevention (bool enabled)
+  {
+    m_v = enabled ? anti_denormal_vsa : 0;
+  }
+
   // small direct current
   static inline double dc ()
   {
@@ -0,0 +1,126 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vinnie Falco
+
+Official project location:
+https://github.com/vinniefalco/DSPFilters
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vinnie Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "Common.h"
+#include "PrototypeCache.h"
+
+#include <map>
+#include <mutex>
+
+namespace Dsp {
+
+namespace {
+
+struct Entry
+{
+  std::vector<PoleZeroPair> pairs;
+  LayoutBase layout;
+};
+
+struct Storage
+{
+  std::mutex mutex;
+  std::map<PrototypeCache::Key, Entry> entries;
+};
+
+// constructed on first use, so designs done during static
+// initialization of other translation units are safe
+Storage& getStorage ()
+{
+  static Storage storage;
+  return storage;
+}
+
+}
+
+bool PrototypeCache::Key::operator< (const Key& other) const
+{
+  if (kind != other.kind)
+    return kind < other.kind;
+  if (numPoles != other.numPoles)
+    return numPoles < other.numPoles;
+  if (param1 != other.param1)
+    return param1 < other.param1;
+  return param2 < other.param2;
+}
+
+bool PrototypeCache::lookup (const Key& key, LayoutBase& dest)
+{
+  Storage& storage = getStorage ();
+  std::lock_guard<std::mutex> lock (storage.mutex);
+
+  std::map<Key, Entry>::const_iterator i = storage.entries.find (key);
+  if (i == storage.entries.end ())
+    return false;
+
+  dest.copyFrom (i->second.layout);
+  return true;
+}
+
+void PrototypeCache::store (const Key& key, const LayoutBase& layout)
+{
+  Storage& storage = getStorage ();
+  std::lock_guard<std::mutex> lock (storage.mutex);
+
+  if (storage.entries.find (key) != storage.entries.end ())
+    return;
+
+  if (int (storage.entries.size ()) >= maxEntries)
+    storage.entries.clear ();
+
+  // map nodes never move, so the layout may point into its own entry
+  Entry& entry = storage.entries[key];
+  entry.pairs.resize ((layout.getNumPoles () + 1) / 2 + 1);
+  entry.layout = LayoutBase (layout.getNumPoles (), &entry.pairs[0]);
+  entry.layout.copyFrom (layout);
+}
+
+void PrototypeCache::clear ()
+{
+  Storage& storage = getStorage ();
+  std::lock_guard<std::mutex> lock (storage.mutex);
+
+  storage.entries.clear ();
+}
+
+int PrototypeCache::getNumEntries ()
+{
+  Storage& storage = getStorage ();
+  std::lock_guard<std::mutex> lock (storage.mutex);
+
+  return int (storage.entries.size ());
+}
+
+}
@@ -0,0 +1,106 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vinnie Falco
+
+Official project location:
+https://github.com/vinniefalco/DSPFilters
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vinnie Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+#ifndef DSPFILTERS_PROTOTYPECACHE_H
+#define DSPFILTERS_PROTOTYPECACHE_H
+
+#include "Common.h"
+#include "Types.h"
+#include "Layout.h"
+
+namespace Dsp {
+
+/*
+ * Analog prototype cache
+ *
+ * The analog prototypes depend only on the order and a few shape
+ * parameters (ripple, rolloff), never on the sample rate or the cutoff.
+ * Prototypes that are expensive to compute (polynomial root finding for
+ * Bessel and Legendre, the iterative solver for Elliptic) store their
+ * layout here the first time it is designed, and every later design with
+ * the same parameters, in any filter instance, only copies it back.
+ * The frequency transform to the digital layout still runs per setup.
+ *
+ * The cache is shared by all threads and guarded by a mutex. It holds at
+ * most maxEntries layouts and starts over when full, so parameters that
+ * change continuously (a ripple slider) cannot grow it without bound.
+ *
+ */
+
+class PrototypeCache
+{
+public:
+  enum Kind
+  {
+    besselLowPass,
+    besselLowShelf,
+    ellipticLowPass,
+    legendreLowPass
+  };
+
+  struct Key
+  {
+    Key (Kind kind_, int numPoles_, double param1_ = 0, double param2_ = 0)
+      : kind (kind_)
+      , numPoles (numPoles_)
+      , param1 (param1_)
+      , param2 (param2_)
+    {
+    }
+
+    bool operator< (const Key& other) const;
+
+    Kind kind;
+    int numPoles;
+    double param1;
+    double param2;
+  };
+
+  static const int maxEntries = 256;
+
+  // Copy the cached layout into dest, returns false if there is none.
+  static bool lookup (const Key& key, LayoutBase& dest);
+
+  // Remember a freshly designed layout.
+  static void store (const Key& key, const LayoutBase& layout);
+
+  static void clear ();
+
+  static int getNumEntries ();
+};
+
+}
+
+#endif
@@ -202,6 +202,31 @@ void AllPass::setup (double sampleRate,
   setCoefficients (a0, a1, a2, b0, b1, b2);
 }
 
+void NotchCombBase::setup (double sampleRate,
+                           double fundamentalFrequency,
+                           int numHarmonics,
+                           double q)
+{
+  int numStages = 0;
+
+  for (int harmonic = 1; harmonic <= numHarmonics; ++harmonic)
+  {
+    const double frequency = fundamentalFrequency * harmonic;
+    if (numStages >= getMaxStages () || frequency >= sampleRate / 2)
+      break;
+
+    BandStop notch;
+    notch.setup (sampleRate, frequency, q);
+    setStage (numStages++, notch);
+  }
+
+  // The cascade always processes its first stage
+  if (numStages == 0)
+    setIdentityStage (numStages++);
+
+  setNumStages (numStages);
+}
+
 }
 
 }
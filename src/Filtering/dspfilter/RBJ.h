@@ -38,6 +38,7 @@ THE SOFTWARE.
 
 #include "Common.h"
 #include "Biquad.h"
+#include "Cascade.h"
 #include "Design.h"
 #include "Filter.h"
 
@@ -126,6 +127,30 @@ struct AllPass : BiquadBase
 
 //------------------------------------------------------------------------------
 
+// Band stop sections at a fundamental frequency and its harmonics,
+// executed as one cascade. Harmonics at or above Nyquist are skipped.
+// Every notch has the same q, so the absolute width grows with the
+// harmonic number.
+class NotchCombBase : public Cascade
+{
+public:
+  void setup (double sampleRate,
+              double fundamentalFrequency,
+              int numHarmonics,
+              double q);
+};
+
+template <int MaxHarmonics>
+struct NotchComb : NotchCombBase, CascadeStages <MaxHarmonics>
+{
+  NotchComb ()
+  {
+    NotchCombBase::setCascadeStorage (this->getCascadeStorage());
+  }
+};
+
+//------------------------------------------------------------------------------
+
 //
 // Gui-friendly Design layer
 //
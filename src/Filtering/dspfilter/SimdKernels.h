@@ -0,0 +1,275 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vinnie Falco
+
+Official project location:
+https://github.com/vinniefalco/DSPFilters
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vinnie Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+#ifndef DSPFILTERS_SIMDKERNELS_H
+#define DSPFILTERS_SIMDKERNELS_H
+
+#include "Common.h"
+
+//
+// Internal header for SimdUtilities.cpp and SimdUtilitiesAvx.cpp
+//
+// The kernels are written once against an "Ops" policy describing one
+// vector type of one instruction set:
+//
+//   typedef ... Type;                 // float or double
+//   typedef ... Vector;
+//   static const int width;           // lanes per vector, 8 at most
+//   static Vector load (float const*);   // converting loads
+//   static Vector load (double const*);
+//   static void store (Type*, Vector);
+//   static Vector add (Vector, Vector);
+//   static Vector mul (Vector, Vector);
+//   static Vector set1 (Type);
+//   static void transpose (Vector* rows);  // width x width in place
+//
+//   // Loads width 24 bit little endian signed integers (3 * width bytes),
+//   // may read up to int24Overread bytes past them
+//   static Vector loadInt24 (unsigned char const*);
+//
+//   // Loads width rows (converting) and transposes them, the policy may
+//   // fuse both steps when that is cheaper than a register transpose
+//   template <typename Ts>
+//   static void loadTransposed (Vector* rows, Ts const* const* pointers);
+//
+// Every file including this header compiles its own copy of the kernels
+// (unnamed namespace), so code generated for one instruction set never
+// leaks into another through template instantiation.
+//
+
+namespace Dsp {
+
+namespace Simd {
+
+// Table of dispatched kernels for one instruction set
+struct Kernels
+{
+  void (*addFloat) (int samples, float* dest, float const* src);
+  void (*addDouble) (int samples, double* dest, double const* src);
+  void (*copyToFloat) (int samples, float* dest, double const* src);
+  void (*copyToDouble) (int samples, double* dest, float const* src);
+  void (*multiplyFloat) (int samples, float* dest, float factor);
+  void (*multiplyDouble) (int samples, double* dest, double factor);
+  void (*convertInt24Float) (int samples, float* dest, unsigned char const* src, float scale, float offset);
+  void (*convertInt24Double) (int samples, double* dest, unsigned char const* src, double scale, double offset);
+
+  // channels must be a multiple of 8, deinterleaveFloatDouble is null
+  // where the scalar loop is faster
+  void (*deinterleaveFloatFloat) (int channels, int samples, float* const* dest, float const* src);
+  void (*deinterleaveFloatDouble) (int channels, int samples, float* const* dest, double const* src);
+  void (*deinterleaveDoubleFloat) (int channels, int samples, double* const* dest, float const* src);
+  void (*deinterleaveDoubleDouble) (int channels, int samples, double* const* dest, double const* src);
+  void (*interleaveFloatFloat) (int channels, size_t samples, float* dest, float const* const* src);
+  void (*interleaveFloatDouble) (int channels, size_t samples, float* dest, double const* const* src);
+  void (*interleaveDoubleFloat) (int channels, size_t samples, double* dest, float const* const* src);
+  void (*interleaveDoubleDouble) (int channels, size_t samples, double* dest, double const* const* src);
+};
+
+// Kernel tables, null if the instruction set is not available in this build.
+// getAvxKernels may only be called on a CPU with AVX.
+const Kernels* getSse2Kernels ();
+const Kernels* getAvxKernels ();
+
+// Channels per interleaving block handled by the kernels
+const int interleaveBlock = 8;
+
+// Bytes loadInt24 may read past its samples
+const int int24Overread = 4;
+
+// One 24 bit little endian signed integer
+inline int unpackInt24 (unsigned char const* p)
+{
+  int value = (p[2] << 16) | (p[1] << 8) | p[0];
+  if (value >= 0x800000)
+    value -= 0x1000000;
+  return value;
+}
+
+namespace {
+
+template <class Ops, typename Ts>
+void copyKernel (int samples, typename Ops::Type* dest, Ts const* src)
+{
+  typedef typename Ops::Type T;
+  int i = 0;
+  for (; i + Ops::width <= samples; i += Ops::width)
+    Ops::store (dest + i, Ops::load (src + i));
+  for (; i < samples; ++i)
+    dest[i] = static_cast<T>(src[i]);
+}
+
+template <class Ops>
+void addKernel (int samples, typename Ops::Type* dest, typename Ops::Type const* src)
+{
+  int i = 0;
+  for (; i + Ops::width <= samples; i += Ops::width)
+    Ops::store (dest + i, Ops::add (Ops::load (dest + i), Ops::load (src + i)));
+  for (; i < samples; ++i)
+    dest[i] += src[i];
+}
+
+template <class Ops>
+void multiplyKernel (int samples, typename Ops::Type* dest, typename Ops::Type factor)
+{
+  const typename Ops::Vector f = Ops::set1 (factor);
+  int i = 0;
+  for (; i + Ops::width <= samples; i += Ops::width)
+    Ops::store (dest + i, Ops::mul (Ops::load (dest + i), f));
+  for (; i < samples; ++i)
+    dest[i] = dest[i] * factor;
+}
+
+// Vectors stop early enough for the over-read of loadInt24 to stay
+// inside the source, the rest is converted one sample at a time.
+template <class Ops>
+void convertInt24Kernel (int samples,
+                         typename Ops::Type* dest,
+                         unsigned char const* src,
+                         typename Ops::Type scale,
+                         typename Ops::Type offset)
+{
+  typedef typename Ops::Type T;
+  const typename Ops::Vector s = Ops::set1 (scale);
+  const typename Ops::Vector o = Ops::set1 (offset);
+  const int overreadSamples = (int24Overread + 2) / 3;
+  int i = 0;
+  for (; i + Ops::width + overreadSamples <= samples; i += Ops::width)
+    Ops::store (dest + i, Ops::add (Ops::mul (Ops::loadInt24 (src + size_t(i) * 3), s), o));
+  for (; i < samples; ++i)
+    dest[i] = static_cast<T>(unpackInt24 (src + size_t(i) * 3)) * scale + offset;
+}
+
+// Interleaved frames are read width x width at a time, transposed in
+// registers and written as width consecutive samples of width channels.
+template <class Ops, typename Ts>
+void deinterleaveKernel (int channels,
+                         int samples,
+                         typename Ops::Type* const* dest,
+                         Ts const* src)
+{
+  typedef typename Ops::Type T;
+  const int width = Ops::width;
+  typename Ops::Vector rows[width];
+  Ts const* pointers[width];
+
+  int i = 0;
+  for (; i + width <= samples; i += width)
+  {
+    for (int c = 0; c < channels; c += width)
+    {
+      Ts const* s = src + size_t(i) * channels + c;
+      for (int r = 0; r < width; ++r)
+        pointers[r] = s + size_t(r) * channels;
+      Ops::loadTransposed (rows, pointers);
+      for (int r = 0; r < width; ++r)
+        Ops::store (dest[c + r] + i, rows[r]);
+    }
+  }
+
+  for (; i < samples; ++i)
+  {
+    Ts const* s = src + size_t(i) * channels;
+    for (int c = 0; c < channels; ++c)
+      dest[c][i] = static_cast<T>(s[c]);
+  }
+}
+
+template <class Ops, typename Ts>
+void interleaveKernel (int channels,
+                       size_t samples,
+                       typename Ops::Type* dest,
+                       Ts const* const* src)
+{
+  typedef typename Ops::Type T;
+  const size_t width = Ops::width;
+  typename Ops::Vector rows[Ops::width];
+  Ts const* pointers[Ops::width];
+
+  size_t i = 0;
+  for (; i + width <= samples; i += width)
+  {
+    for (int c = 0; c < channels; c += Ops::width)
+    {
+      for (int r = 0; r < Ops::width; ++r)
+        pointers[r] = src[c + r] + i;
+      Ops::loadTransposed (rows, pointers);
+      T* d = dest + i * channels + c;
+      for (int r = 0; r < Ops::width; ++r)
+        Ops::store (d + size_t(r) * channels, rows[r]);
+    }
+  }
+
+  for (; i < samples; ++i)
+  {
+    T* d = dest + i * channels;
+    for (int c = 0; c < channels; ++c)
+      d[c] = static_cast<T>(src[c][i]);
+  }
+}
+
+// Fills a kernel table from the policies of one instruction set. The
+// double interleaving kernels may use a narrower policy than the other
+// double kernels; policies not used for interleaving need neither
+// transpose nor loadTransposed, nor loadInt24.
+template <class FloatOps, class DoubleOps, class DoubleInterleaveOps>
+Kernels makeKernels ()
+{
+  Kernels k;
+  k.addFloat = &addKernel<FloatOps>;
+  k.addDouble = &addKernel<DoubleOps>;
+  k.copyToFloat = &copyKernel<FloatOps, double>;
+  k.copyToDouble = &copyKernel<DoubleOps, float>;
+  k.multiplyFloat = &multiplyKernel<FloatOps>;
+  k.multiplyDouble = &multiplyKernel<DoubleOps>;
+  k.convertInt24Float = &convertInt24Kernel<FloatOps>;
+  k.convertInt24Double = &convertInt24Kernel<DoubleOps>;
+  k.deinterleaveFloatFloat = &deinterleaveKernel<FloatOps, float>;
+  k.deinterleaveFloatDouble = &deinterleaveKernel<FloatOps, double>;
+  k.deinterleaveDoubleFloat = &deinterleaveKernel<DoubleInterleaveOps, float>;
+  k.deinterleaveDoubleDouble = &deinterleaveKernel<DoubleInterleaveOps, double>;
+  k.interleaveFloatFloat = &interleaveKernel<FloatOps, float>;
+  k.interleaveFloatDouble = &interleaveKernel<FloatOps, double>;
+  k.interleaveDoubleFloat = &interleaveKernel<DoubleInterleaveOps, float>;
+  k.interleaveDoubleDouble = &interleaveKernel<DoubleInterleaveOps, double>;
+  return k;
+}
+
+}
+
+}
+
+}
+
+#endif
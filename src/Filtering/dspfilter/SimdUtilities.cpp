@@ -0,0 +1,510 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vinnie Falco
+
+Official project location:
+https://github.com/vinniefalco/DSPFilters
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vinnie Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "Common.h"
+#include "Utilities.h"
+#include "SimdKernels.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#  define DSP_SIMD_X86 1
+#  ifdef _MSC_VER
+#    include <intrin.h>
+#  else
+#    include <cpuid.h>
+#  endif
+#endif
+
+// SSE2 is used only where it is part of the compilation target
+// (always on x86-64, with /arch:SSE2 or -msse2 on 32 bit x86)
+#if defined(DSP_SIMD_X86) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#  define DSP_SIMD_SSE2 1
+#  include <emmintrin.h>
+#endif
+
+namespace Dsp {
+
+namespace Simd {
+
+#ifdef DSP_SIMD_SSE2
+
+namespace {
+
+// SSE2 has no byte shuffle: each sample is read as 4 bytes into the top
+// of a lane and sign extended by the arithmetic shift. The lanes are
+// combined in registers, a store and vector reload would stall.
+inline __m128i loadInt24Lane (unsigned char const* p)
+{
+  int value;
+  memcpy (&value, p, 4);
+  return _mm_cvtsi32_si128 (value);
+}
+
+inline __m128i signExtendInt24 (__m128i v)
+{
+  return _mm_srai_epi32 (_mm_slli_epi32 (v, 8), 8);
+}
+
+inline __m128i loadInt24x2 (unsigned char const* p)
+{
+  return signExtendInt24 (_mm_unpacklo_epi32 (loadInt24Lane (p), loadInt24Lane (p + 3)));
+}
+
+inline __m128i loadInt24x4 (unsigned char const* p)
+{
+  __m128i lo = _mm_unpacklo_epi32 (loadInt24Lane (p), loadInt24Lane (p + 3));
+  __m128i hi = _mm_unpacklo_epi32 (loadInt24Lane (p + 6), loadInt24Lane (p + 9));
+  return signExtendInt24 (_mm_unpacklo_epi64 (lo, hi));
+}
+
+struct Sse2Float
+{
+  typedef float Type;
+  typedef __m128 Vector;
+  static const int width = 4;
+
+  static Vector load (float const* p) { return _mm_loadu_ps (p); }
+  static Vector load (double const* p)
+  {
+    return _mm_movelh_ps (_mm_cvtpd_ps (_mm_loadu_pd (p)), _mm_cvtpd_ps (_mm_loadu_pd (p + 2)));
+  }
+  static void store (float* p, Vector v) { _mm_storeu_ps (p, v); }
+  static Vector add (Vector a, Vector b) { return _mm_add_ps (a, b); }
+  static Vector mul (Vector a, Vector b) { return _mm_mul_ps (a, b); }
+  static Vector set1 (float v) { return _mm_set1_ps (v); }
+  static Vector loadInt24 (unsigned char const* p) { return _mm_cvtepi32_ps (loadInt24x4 (p)); }
+  static void transpose (Vector* r) { _MM_TRANSPOSE4_PS (r[0], r[1], r[2], r[3]); }
+
+  template <typename Ts>
+  static void loadTransposed (Vector* rows, Ts const* const* p)
+  {
+    for (int r = 0; r < width; ++r)
+      rows[r] = load (p[r]);
+    transpose (rows);
+  }
+};
+
+struct Sse2Double
+{
+  typedef double Type;
+  typedef __m128d Vector;
+  static const int width = 2;
+
+  static Vector load (float const* p)
+  {
+    return _mm_cvtps_pd (_mm_castsi128_ps (_mm_loadl_epi64 (reinterpret_cast<__m128i const*>(p))));
+  }
+  static Vector load (double const* p) { return _mm_loadu_pd (p); }
+  static void store (double* p, Vector v) { _mm_storeu_pd (p, v); }
+  static Vector add (Vector a, Vector b) { return _mm_add_pd (a, b); }
+  static Vector mul (Vector a, Vector b) { return _mm_mul_pd (a, b); }
+  static Vector set1 (double v) { return _mm_set1_pd (v); }
+  static Vector loadInt24 (unsigned char const* p) { return _mm_cvtepi32_pd (loadInt24x2 (p)); }
+  static void transpose (Vector* r)
+  {
+    Vector t = _mm_unpacklo_pd (r[0], r[1]);
+    r[1] = _mm_unpackhi_pd (r[0], r[1]);
+    r[0] = t;
+  }
+
+  template <typename Ts>
+  static void loadTransposed (Vector* rows, Ts const* const* p)
+  {
+    for (int r = 0; r < width; ++r)
+      rows[r] = load (p[r]);
+    transpose (rows);
+  }
+};
+
+// Deinterleaving doubles into floats converts and transposes 4 x 4 blocks,
+// which is bound by shuffles and loses to the scalar loop at every channel
+// count, so that kernel is left to the scalar path.
+Kernels makeSse2Kernels ()
+{
+  Kernels k = makeKernels<Sse2Float, Sse2Double, Sse2Double> ();
+  k.deinterleaveFloatDouble = 0;
+  return k;
+}
+
+}
+
+const Kernels* getSse2Kernels ()
+{
+  static const Kernels kernels = makeSse2Kernels ();
+  return &kernels;
+}
+
+#else
+
+const Kernels* getSse2Kernels ()
+{
+  return 0;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+bool cpuSupportsAvx ()
+{
+#ifdef DSP_SIMD_X86
+  unsigned int ecx = 0;
+
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid (info, 1);
+  ecx = static_cast<unsigned int>(info[2]);
+#else
+  unsigned int eax, ebx, edx;
+  if (!__get_cpuid (1, &eax, &ebx, &ecx, &edx))
+    return false;
+#endif
+
+  // AVX instructions and OS support for saving the YMM registers
+  const unsigned int osxsave = 1u << 27;
+  const unsigned int avx = 1u << 28;
+  if ((ecx & (osxsave | avx)) != (osxsave | avx))
+    return false;
+
+#ifdef _MSC_VER
+  unsigned long long xcr0 = _xgetbv (0);
+#else
+  unsigned int xcr0lo, xcr0hi;
+  __asm__ ("xgetbv" : "=a" (xcr0lo), "=d" (xcr0hi) : "c" (0));
+  unsigned long long xcr0 = xcr0lo;
+#endif
+
+  return (xcr0 & 6) == 6;
+#else
+  return false;
+#endif
+}
+
+const Kernels* kernelsForLevel (Level level)
+{
+  switch (level)
+  {
+  case levelAvx: return getAvxKernels ();
+  case levelSse2: return getSse2Kernels ();
+  default:
+    break;
+  };
+
+  return 0;
+}
+
+struct Dispatch
+{
+  Level supported;
+  Level level;
+  const Kernels* kernels;
+
+  Dispatch ()
+  {
+    supported = levelScalar;
+    if (getSse2Kernels ())
+      supported = levelSse2;
+    // getAvxKernels itself is compiled for AVX, the CPU is checked first
+    if (cpuSupportsAvx () && getAvxKernels ())
+      supported = levelAvx;
+
+    level = supported;
+    kernels = kernelsForLevel (level);
+  }
+};
+
+Dispatch& dispatch ()
+{
+  static Dispatch d;
+  return d;
+}
+
+inline const Kernels* kernels ()
+{
+  return dispatch ().kernels;
+}
+
+}
+
+Level getSupportedLevel ()
+{
+  return dispatch ().supported;
+}
+
+Level getLevel ()
+{
+  return dispatch ().level;
+}
+
+void setLevel (Level level)
+{
+  Dispatch& d = dispatch ();
+  if (level > d.supported)
+    level = d.supported;
+  if (level < levelScalar)
+    level = levelScalar;
+  d.level = level;
+  d.kernels = kernelsForLevel (level);
+}
+
+const char* getLevelName (Level level)
+{
+  switch (level)
+  {
+  case levelSse2: return "sse2";
+  case levelAvx: return "avx";
+  default:
+    break;
+  };
+
+  return "scalar";
+}
+
+}
+
+//------------------------------------------------------------------------------
+
+void add (int samples,
+          float* dest,
+          float const* src,
+          int destSkip,
+          int srcSkip)
+{
+  const Simd::Kernels* k = Simd::kernels ();
+  if (k && destSkip == 0 && srcSkip == 0)
+    k->addFloat (samples, dest, src);
+  else
+    add<float, float> (samples, dest, src, destSkip, srcSkip);
+}
+
+void add (int samples,
+          double* dest,
+          double const* src,
+          int destSkip,
+          int srcSkip)
+{
+  const Simd::Kernels* k = Simd::kernels ();
+  if (k && destSkip == 0 && srcSkip == 0)
+    k->addDouble (samples, dest, src);
+  else
+    add<double, double> (samples, dest, src, destSkip, srcSkip);
+}
+
+void copy (int samples,
+           float* dest,
+           double const* src,
+           int destSkip,
+           int srcSkip)
+{
+  const Simd::Kernels* k = Simd::kernels ();
+  if (k && destSkip == 0 && srcSkip == 0)
+    k->copyToFloat (samples, dest, src);
+  else
+    copy<float, double> (samples, dest, src, destSkip, srcSkip);
+}
+
+void copy (int samples,
+           double* dest,
+           float const* src,
+           int destSkip,
+           int srcSkip)
+{
+  const Simd::Kernels* k = Simd::kernels ();
+  if (k && destSkip == 0 && srcSkip == 0)
+    k->copyToDouble (samples, dest, src);
+  else
+    copy<double, float> (samples, dest, src, destSkip, srcSkip);
+}
+
+void multiply (int samples,
+               float* dest,
+               float factor,
+               int destSkip)
+{
+  const Simd::Kernels* k = Simd::kernels ();
+  if (k && destSkip == 0)
+    k->multiplyFloat (samples, dest, factor);
+  else
+    multiply<float, float> (samples, dest, factor, destSkip);
+}
+
+void multiply (int samples,
+               double* dest,
+               double factor,
+               int destSkip)
+{
+  const Simd::Kernels* k = Simd::kernels ();
+  if (k && destSkip == 0)
+    k->multiplyDouble (samples, dest, factor);
+  else
+    multiply<double, double> (samples, dest, factor, destSkip);
+}
+
+void convertInt24 (int samples,
+                   float* dest,
+                   unsigned char const* src,
+                   float scale,
+                   float offset)
+{
+  const Simd::Kernels* k = Simd::kernels ();
+  if (k)
+    k->convertInt24Float (samples, dest, src, scale, offset);
+  else
+    for (int i = 0; i < samples; ++i)
+      dest[i] = float (Simd::unpackInt24 (src + size_t(i) * 3)) * scale + offset;
+}
+
+void convertInt24 (int samples,
+                   double* dest,
+                   unsigned char const* src,
+                   double scale,
+                   double offset)
+{
+  const Simd::Kernels* k = Simd::kernels ();
+  if (k)
+    k->convertInt24Double (samples, dest, src, scale, offset);
+  else
+    for (int i = 0; i < samples; ++i)
+      dest[i] = double (Simd::unpackInt24 (src + size_t(i) * 3)) * scale + offset;
+}
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+inline bool isInterleaveBlock (int channels)
+{
+  return channels > 0 && (channels % Simd::interleaveBlock) == 0;
+}
+
+// A single channel is a plain copy, which the generic templates assert on.
+// The stereo Duff's device of the generic deinterleave needs samples > 0.
+template <typename Td, typename Ts>
+void deinterleaveFallback (int channels, int samples, Td* const* dest, Ts const* src)
+{
+  if (samples <= 0)
+    return;
+
+  if (channels == 1)
+    copy (samples, dest[0], src);
+  else
+    deinterleave<Td, Ts> (channels, samples, dest, src);
+}
+
+template <typename Td, typename Ts>
+void interleaveFallback (int channels, size_t samples, Td* dest, Ts const* const* src)
+{
+  if (channels == 1)
+    copy (int(samples), dest, src[0]);
+  else
+    interleave<Td, Ts> (channels, samples, dest, src);
+}
+
+}
+
+void deinterleave (int channels, int samples, float* const* dest, float const* src)
+{
+  const Simd::Kernels* k = Simd::kernels ();
+  if (k && isInterleaveBlock (channels))
+    k->deinterleaveFloatFloat (channels, samples, dest, src);
+  else
+    deinterleaveFallback (channels, samples, dest, src);
+}
+
+void deinterleave (int channels, int samples, float* const* dest, double const* src)
+{
+  const Simd::Kernels* k = Simd::kernels ();
+  if (k && k->deinterleaveFloatDouble && isInterleaveBlock (channels))
+    k->deinterleaveFloatDouble (channels, samples, dest, src);
+  else
+    deinterleaveFallback (channels, samples, dest, src);
+}
+
+void deinterleave (int channels, int samples, double* const* dest, float const* src)
+{
+  const Simd::Kernels* k = Simd::kernels ();
+  if (k && isInterleaveBlock (channels))
+    k->deinterleaveDoubleFloat (channels, samples, dest, src);
+  else
+    deinterleaveFallback (channels, samples, dest, src);
+}
+
+void deinterleave (int channels, int samples, double* const* dest, double const* src)
+{
+  const Simd::Kernels* k = Simd::kernels ();
+  if (k && isInterleaveBlock (channels))
+    k->deinterleaveDoubleDouble (channels, samples, dest, src);
+  else
+    deinterleaveFallback (channels, samples, dest, src);
+}
+
+void interleave (int channels, size_t samples, float* dest, float const* const* src)
+{
+  const Simd::Kernels* k = Simd::kernels ();
+  if (k && isInterleaveBlock (channels))
+    k->interleaveFloatFloat (channels, samples, dest, src);
+  else
+    interleaveFallback (channels, samples, dest, src);
+}
+
+void interleave (int channels, size_t samples, float* dest, double const* const* src)
+{
+  const Simd::Kernels* k = Simd::kernels ();
+  if (k && isInterleaveBlock (channels))
+    k->interleaveFloatDouble (channels, samples, dest, src);
+  else
+    interleaveFallback (channels, samples, dest, src);
+}
+
+void interleave (int channels, size_t samples, double* dest, float const* const* src)
+{
+  const Simd::Kernels* k = Simd::kernels ();
+  if (k && isInterleaveBlock (channels))
+    k->interleaveDoubleFloat (channels, samples, dest, src);
+  else
+    interleaveFallback (channels, samples, dest, src);
+}
+
+void interleave (int channels, size_t samples, double* dest, double const* const* src)
+{
+  const Simd::Kernels* k = Simd::kernels ();
+  if (k && isInterleaveBlock (channels))
+    k->interleaveDoubleDouble (channels, samples, dest, src);
+  else
+    interleaveFallback (channels, samples, dest, src);
+}
+
+}
@@ -0,0 +1,148 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vinnie Falco
+
+Official project location:
+https://github.com/vinniefalco/DSPFilters
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vinnie Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+#ifndef DSPFILTERS_SIMDUTILITIES_H
+#define DSPFILTERS_SIMDUTILITIES_H
+
+#include "Common.h"
+
+namespace Dsp {
+
+/*
+ * SIMD buffer kernels
+ *
+ * Non-template overloads of the routines in Utilities.h for float and
+ * double buffers. Being exact matches, they are preferred over the
+ * generic templates, including calls made from the multichannel
+ * templates. The instruction set is chosen at run time.
+ *
+ * Vectorized cases:
+ *  - copy with float<->double conversion, add and multiply without skip
+ *  - conversion of 24 bit integers (BDF samples) to float or double
+ *  - deinterleave and interleave of 8, 16, 32 (any multiple of 8)
+ *    channels, with or without float<->double conversion
+ *
+ * Everything else falls through to the generic templates. Results are
+ * identical to the scalar code for every instruction set.
+ *
+ */
+
+namespace Simd {
+
+enum Level
+{
+  levelScalar = 0,
+  levelSse2,
+  levelAvx
+};
+
+// Highest instruction set supported by this CPU and build
+Level getSupportedLevel ();
+
+// Instruction set currently used by the kernels
+Level getLevel ();
+
+// Restrict the kernels to an instruction set (clamped to the supported
+// level). Intended for benchmarks and comparisons, not thread safe with
+// respect to kernels running concurrently.
+void setLevel (Level level);
+
+const char* getLevelName (Level level);
+
+}
+
+//------------------------------------------------------------------------------
+
+void add (int samples,
+          float* dest,
+          float const* src,
+          int destSkip = 0,
+          int srcSkip = 0);
+
+void add (int samples,
+          double* dest,
+          double const* src,
+          int destSkip = 0,
+          int srcSkip = 0);
+
+void copy (int samples,
+           float* dest,
+           double const* src,
+           int destSkip = 0,
+           int srcSkip = 0);
+
+void copy (int samples,
+           double* dest,
+           float const* src,
+           int destSkip = 0,
+           int srcSkip = 0);
+
+void multiply (int samples,
+               float* dest,
+               float factor,
+               int destSkip = 0);
+
+void multiply (int samples,
+               double* dest,
+               double factor,
+               int destSkip = 0);
+
+// Signed 24 bit little endian integers, packed 3 bytes per sample as in
+// BDF files and device packets: dest[i] = value * scale + offset
+void convertInt24 (int samples,
+                   float* dest,
+                   unsigned char const* src,
+                   float scale = 1,
+                   float offset = 0);
+
+void convertInt24 (int samples,
+                   double* dest,
+                   unsigned char const* src,
+                   double scale = 1,
+                   double offset = 0);
+
+void deinterleave (int channels, int samples, float* const* dest, float const* src);
+void deinterleave (int channels, int samples, float* const* dest, double const* src);
+void deinterleave (int channels, int samples, double* const* dest, float const* src);
+void deinterleave (int channels, int samples, double* const* dest, double const* src);
+
+void interleave (int channels, size_t samples, float* dest, float const* const* src);
+void interleave (int channels, size_t samples, float* dest, double const* const* src);
+void interleave (int channels, size_t samples, double* dest, float const* const* src);
+void interleave (int channels, size_t samples, double* dest, double const* const* src);
+
+}
+
+#endif
@@ -0,0 +1,223 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vinnie Falco
+
+Official project location:
+https://github.com/vinniefalco/DSPFilters
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vinnie Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+//
+// AVX kernels. Only this file is compiled for AVX, the instruction set is
+// enabled here rather than in the project settings so that the rest of
+// the library keeps running on CPUs without it. The kernels are called
+// only after the run time check in SimdUtilities.cpp.
+//
+// The target switch comes after all other includes: inline functions of
+// the standard headers must not be compiled for AVX here, the linker could
+// pick that copy for the whole program.
+//
+
+#include "Common.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || ((defined(_M_IX86) || defined(__i386__)) && (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#  if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))) || (defined(_MSC_VER) && _MSC_VER >= 1600)
+#    define DSP_SIMD_AVX 1
+#    include <immintrin.h>
+#  endif
+#endif
+
+#ifdef DSP_SIMD_AVX
+#  if defined(__clang__)
+#    pragma clang attribute push (__attribute__((target("avx"))), apply_to = function)
+#  elif defined(__GNUC__)
+#    pragma GCC push_options
+#    pragma GCC target ("avx")
+#  endif
+#endif
+
+#include "SimdKernels.h"
+
+namespace Dsp {
+
+namespace Simd {
+
+#ifdef DSP_SIMD_AVX
+
+namespace {
+
+// Four samples from 16 bytes: the shuffle moves each sample to the top
+// of its lane, the arithmetic shift sign extends it
+inline __m128i loadInt24Lanes (unsigned char const* p)
+{
+  const __m128i shuffle = _mm_setr_epi8 (-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+  __m128i v = _mm_loadu_si128 (reinterpret_cast<__m128i const*>(p));
+  return _mm_srai_epi32 (_mm_shuffle_epi8 (v, shuffle), 8);
+}
+
+struct AvxFloat
+{
+  typedef float Type;
+  typedef __m256 Vector;
+  static const int width = 8;
+
+  static Vector load (float const* p) { return _mm256_loadu_ps (p); }
+  static Vector load (double const* p)
+  {
+    __m128 lo = _mm256_cvtpd_ps (_mm256_loadu_pd (p));
+    __m128 hi = _mm256_cvtpd_ps (_mm256_loadu_pd (p + 4));
+    return _mm256_insertf128_ps (_mm256_castps128_ps256 (lo), hi, 1);
+  }
+  static void store (float* p, Vector v) { _mm256_storeu_ps (p, v); }
+  static Vector add (Vector a, Vector b) { return _mm256_add_ps (a, b); }
+  static Vector mul (Vector a, Vector b) { return _mm256_mul_ps (a, b); }
+  static Vector set1 (float v) { return _mm256_set1_ps (v); }
+  static Vector loadInt24 (unsigned char const* p)
+  {
+    __m256i v = _mm256_insertf128_si256 (_mm256_castsi128_si256 (loadInt24Lanes (p)), loadInt24Lanes (p + 12), 1);
+    return _mm256_cvtepi32_ps (v);
+  }
+
+  static void transpose (Vector* r)
+  {
+    __m256 t0 = _mm256_unpacklo_ps (r[0], r[1]);
+    __m256 t1 = _mm256_unpackhi_ps (r[0], r[1]);
+    __m256 t2 = _mm256_unpacklo_ps (r[2], r[3]);
+    __m256 t3 = _mm256_unpackhi_ps (r[2], r[3]);
+    __m256 t4 = _mm256_unpacklo_ps (r[4], r[5]);
+    __m256 t5 = _mm256_unpackhi_ps (r[4], r[5]);
+    __m256 t6 = _mm256_unpacklo_ps (r[6], r[7]);
+    __m256 t7 = _mm256_unpackhi_ps (r[6], r[7]);
+
+    __m256 s0 = _mm256_shuffle_ps (t0, t2, _MM_SHUFFLE (1, 0, 1, 0));
+    __m256 s1 = _mm256_shuffle_ps (t0, t2, _MM_SHUFFLE (3, 2, 3, 2));
+    __m256 s2 = _mm256_shuffle_ps (t1, t3, _MM_SHUFFLE (1, 0, 1, 0));
+    __m256 s3 = _mm256_shuffle_ps (t1, t3, _MM_SHUFFLE (3, 2, 3, 2));
+    __m256 s4 = _mm256_shuffle_ps (t4, t6, _MM_SHUFFLE (1, 0, 1, 0));
+    __m256 s5 = _mm256_shuffle_ps (t4, t6, _MM_SHUFFLE (3, 2, 3, 2));
+    __m256 s6 = _mm256_shuffle_ps (t5, t7, _MM_SHUFFLE (1, 0, 1, 0));
+    __m256 s7 = _mm256_shuffle_ps (t5, t7, _MM_SHUFFLE (3, 2, 3, 2));
+
+    r[0] = _mm256_permute2f128_ps (s0, s4, 0x20);
+    r[1] = _mm256_permute2f128_ps (s1, s5, 0x20);
+    r[2] = _mm256_permute2f128_ps (s2, s6, 0x20);
+    r[3] = _mm256_permute2f128_ps (s3, s7, 0x20);
+    r[4] = _mm256_permute2f128_ps (s0, s4, 0x31);
+    r[5] = _mm256_permute2f128_ps (s1, s5, 0x31);
+    r[6] = _mm256_permute2f128_ps (s2, s6, 0x31);
+    r[7] = _mm256_permute2f128_ps (s3, s7, 0x31);
+  }
+
+  template <typename Ts>
+  static void loadTransposed (Vector* rows, Ts const* const* p)
+  {
+    for (int r = 0; r < width; ++r)
+      rows[r] = load (p[r]);
+    transpose (rows);
+  }
+};
+
+struct AvxDouble
+{
+  typedef double Type;
+  typedef __m256d Vector;
+  static const int width = 4;
+
+  static Vector load (float const* p) { return _mm256_cvtps_pd (_mm_loadu_ps (p)); }
+  static Vector load (double const* p) { return _mm256_loadu_pd (p); }
+  static void store (double* p, Vector v) { _mm256_storeu_pd (p, v); }
+  static Vector add (Vector a, Vector b) { return _mm256_add_pd (a, b); }
+  static Vector mul (Vector a, Vector b) { return _mm256_mul_pd (a, b); }
+  static Vector set1 (double v) { return _mm256_set1_pd (v); }
+  static Vector loadInt24 (unsigned char const* p) { return _mm256_cvtepi32_pd (loadInt24Lanes (p)); }
+};
+
+// Double interleaving stays 128 bit wide: a 4x4 double transpose needs
+// lane crossing permutes and measured slower than 2x2 unpacks (see the
+// SimdUtilities benchmark). Compiled here, the same code is VEX encoded
+// and does not mix with the 256 bit kernels at SSE/AVX transitions.
+struct AvxDouble128
+{
+  typedef double Type;
+  typedef __m128d Vector;
+  static const int width = 2;
+
+  static Vector load (float const* p)
+  {
+    return _mm_cvtps_pd (_mm_castsi128_ps (_mm_loadl_epi64 (reinterpret_cast<__m128i const*>(p))));
+  }
+  static Vector load (double const* p) { return _mm_loadu_pd (p); }
+  static void store (double* p, Vector v) { _mm_storeu_pd (p, v); }
+  static Vector add (Vector a, Vector b) { return _mm_add_pd (a, b); }
+  static Vector mul (Vector a, Vector b) { return _mm_mul_pd (a, b); }
+  static Vector set1 (double v) { return _mm_set1_pd (v); }
+  static void transpose (Vector* r)
+  {
+    Vector t = _mm_unpacklo_pd (r[0], r[1]);
+    r[1] = _mm_unpackhi_pd (r[0], r[1]);
+    r[0] = t;
+  }
+
+  template <typename Ts>
+  static void loadTransposed (Vector* rows, Ts const* const* p)
+  {
+    for (int r = 0; r < width; ++r)
+      rows[r] = load (p[r]);
+    transpose (rows);
+  }
+};
+
+}
+
+const Kernels* getAvxKernels ()
+{
+  static const Kernels kernels = makeKernels<AvxFloat, AvxDouble, AvxDouble128> ();
+  return &kernels;
+}
+
+#else
+
+const Kernels* getAvxKernels ()
+{
+  return 0;
+}
+
+#endif
+
+}
+
+}
+
+#ifdef DSP_SIMD_AVX
+#  if defined(__clang__)
+#    pragma clang attribute pop
+#  elif defined(__GNUC__)
+#    pragma GCC pop_options
+#  endif
+#endif
@@ -37,6 +37,7 @@ THE SOFTWARE.
 #define DSPFILTERS_SMOOTHEDFILTER_H
 
 #include "Common.h"
+#include "Cascade.h"
 #include "Filter.h"
 
 namespace Dsp {
@@ -149,6 +150,136 @@ protected:
   int m_remainingSamples;        // remaining transition samples
 };
 
+//------------------------------------------------------------------------------
+
+/*
+ * Smooth parameter changes for raw cascade filters
+ *
+ * Unlike SmoothedFilterDesign, the new response is designed once per
+ * setup() and the transition interpolates the second order sections
+ * directly. Channel states are left untouched, so a retune while
+ * streaming produces neither a reset nor a transient.
+ *
+ */
+template <class FilterClass,
+          int Channels,
+          class StateType = DirectFormII>
+class SmoothedFilter : public SimpleFilter <FilterClass,
+                                            Channels,
+                                            StateType>
+{
+public:
+  SmoothedFilter (int transitionSamples = 0)
+    : m_transitionSamples (transitionSamples)
+    , m_remainingSamples (0)
+  {
+  }
+
+  // Length of the transitions started by subsequent setup() calls.
+  // Zero switches to the new coefficients immediately.
+  void setTransitionSamples (int transitionSamples)
+  {
+    m_transitionSamples = transitionSamples;
+  }
+
+  int getTransitionSamples () const
+  {
+    return m_transitionSamples;
+  }
+
+  bool isInTransition () const
+  {
+    return m_remainingSamples > 0;
+  }
+
+  template <typename... Args>
+  void setup (Args... args)
+  {
+    const bool smooth = (m_transitionSamples > 0 &&
+                         this->getNumStages () > 0);
+
+    // Start from whatever is currently in effect, including
+    // the middle of a transition that has not finished yet.
+    if (smooth && m_remainingSamples <= 0)
+      m_transition.assign (*this);
+
+    FilterClass::setup (args...);
+
+    if (smooth && m_transition.begin (*this, m_transitionSamples))
+      m_remainingSamples = m_transitionSamples;
+    else
+      m_remainingSamples = 0;
+  }
+
+  void reset ()
+  {
+    SimpleFilter <FilterClass, Channels, StateType>::reset ();
+    m_remainingSamples = 0;
+  }
+
+  template <typename Sample>
+  void process (int numSamples, Sample* const* arrayOfChannels)
+  {
+    processChannels (numSamples, arrayOfChannels, 0, Channels);
+    advance (numSamples);
+  }
+
+  // Process a range of channels without touching the shared transition,
+  // so disjoint ranges may run concurrently. Once every channel of the
+  // block has been processed, advance() must be called exactly once.
+  template <typename Sample>
+  void processChannels (int numSamples,
+                        Sample* const* arrayOfChannels,
+                        int firstChannel,
+                        int numChannels)
+  {
+    assert (firstChannel >= 0 && firstChannel + numChannels <= Channels);
+
+    const int remainingSamples = std::min (m_remainingSamples, numSamples);
+    const int lastChannel = firstChannel + numChannels;
+
+    if (remainingSamples > 0)
+    {
+      CascadeTransition <FilterClass::MaxStageCount> transition;
+      transition.assign (m_transition);
+
+      for (int n = 0; n < remainingSamples; ++n)
+      {
+        transition.step ();
+
+        for (int i = firstChannel; i < lastChannel; ++i)
+        {
+          Sample* dest = arrayOfChannels[i] + n;
+          *dest = this->m_state[i].process (*dest, transition);
+        }
+      }
+    }
+
+    if (numSamples - remainingSamples > 0)
+      this->processChannelsBlock (numSamples - remainingSamples,
+                                  arrayOfChannels,
+                                  remainingSamples,
+                                  firstChannel,
+                                  numChannels);
+  }
+
+  void advance (int numSamples)
+  {
+    const int remainingSamples = std::min (m_remainingSamples, numSamples);
+
+    for (int n = 0; n < remainingSamples; ++n)
+      m_transition.step ();
+
+    if (remainingSamples > 0)
+      m_remainingSamples -= remainingSamples;
+  }
+
+protected:
+  CascadeTransition <FilterClass::MaxStageCount> m_transition;
+  int m_transitionSamples;
+  int m_remainingSamples;
+};
+
 }
 
 #endif
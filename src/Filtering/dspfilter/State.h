@@ -51,6 +51,18 @@ namespace Dsp {
 
 //------------------------------------------------------------------------------
 
+// Steady state (DC) gain of a second order section. A section with a pole
+// at DC has no finite steady state; it is treated as blocking DC.
+inline double steadyStateGain (const BiquadBase& s)
+{
+  const double den = 1 + s.m_a1 + s.m_a2;
+  if (fabs (den) < 1e-30)
+    return 0;
+  return (s.m_b0 + s.m_b1 + s.m_b2) / den;
+}
+
+//------------------------------------------------------------------------------
+
 /*
  * State for applying a second order section to a sample using Direct Form I
  *
@@ -58,11 +70,17 @@ namespace Dsp {
  *
  *  y[n] = (b0/a0)*x[n] + (b1/a0)*x[n-1] + (b2/a0)*x[n-2]
  *                      - (a1/a0)*y[n-1] - (a2/a0)*y[n-2]  
+ *
+ * Value is the type of the delay elements and of the arithmetic, see
+ * "Float state" below for the single precision variants.
  */
-class DirectFormI
+template <typename Value>
+class BasicDirectFormI
 {
 public:
-  DirectFormI ()
+  typedef Value value_type;
+
+  BasicDirectFormI ()
   {
     reset();
   }
@@ -80,24 +98,91 @@ public:
                           const BiquadBase& s,
                           const double vsa) // very small amount
   {
-    double out = s.m_b0*in + s.m_b1*m_x1 + s.m_b2*m_x2
-                           - s.m_a1*m_y1 - s.m_a2*m_y2
-                           + vsa;
+    const Value x = static_cast<Value> (in);
+    Value out = Value (s.m_b0)*x + Value (s.m_b1)*m_x1 + Value (s.m_b2)*m_x2
+                                 - Value (s.m_a1)*m_y1 - Value (s.m_a2)*m_y2
+                                 + Value (vsa);
     m_x2 = m_x1;
     m_y2 = m_y1;
-    m_x1 = in;
+    m_x1 = x;
     m_y1 = out;
 
     return static_cast<Sample> (out);
   }
 
+  // Sets the state reached after an infinitely long constant input
+  // (lfilter_zi style initial conditions) and returns the matching output.
+  double setSteadyState (const double in, const BiquadBase& s)
+  {
+    const double out = in * steadyStateGain (s);
+    m_x1 = m_x2 = static_cast<Value> (in);
+    m_y1 = m_y2 = static_cast<Value> (out);
+    return out;
+  }
+
+  // One stage over a chunk of Lanes channels side by side, see
+  // Cascade::StateBase::processBlockLanes(). The delay elements are
+  // held in per-lane arrays so every operation covers all lanes.
+  template <int Lanes>
+  static void processLanes (int numSamples,
+                            Value (*buffer)[Lanes],
+                            BasicDirectFormI* states,
+                            const BiquadBase& s,
+                            Value* vsaLanes)
+  {
+    const Value b0 = Value (s.m_b0);
+    const Value b1 = Value (s.m_b1);
+    const Value b2 = Value (s.m_b2);
+    const Value a1 = Value (s.m_a1);
+    const Value a2 = Value (s.m_a2);
+    Value x1 [Lanes], x2 [Lanes], y1 [Lanes], y2 [Lanes], vsa [Lanes];
+
+    for (int l = 0; l < Lanes; ++l)
+    {
+      vsa[l] = vsaLanes[l];
+      x1[l] = states[l].m_x1;
+      x2[l] = states[l].m_x2;
+      y1[l] = states[l].m_y1;
+      y2[l] = states[l].m_y2;
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+      Value* lanes = buffer[i];
+      for (int l = 0; l < Lanes; ++l)
+      {
+        const Value x = lanes[l];
+        const Value out = b0*x + b1*x1[l] + b2*x2[l]
+                               - a1*y1[l] - a2*y2[l]
+                               + vsa[l];
+        x2[l] = x1[l];
+        y2[l] = y1[l];
+        x1[l] = x;
+        y1[l] = out;
+        lanes[l] = out;
+        vsa[l] = -vsa[l];
+      }
+    }
+
+    for (int l = 0; l < Lanes; ++l)
+    {
+      vsaLanes[l] = vsa[l];
+      states[l].m_x1 = x1[l];
+      states[l].m_x2 = x2[l];
+      states[l].m_y1 = y1[l];
+      states[l].m_y2 = y2[l];
+    }
+  }
+
 protected:
-  double m_x2; // x[n-2]
-  double m_y2; // y[n-2]
-  double m_x1; // x[n-1]
-  double m_y1; // y[n-1]
+  Value m_x2; // x[n-2]
+  Value m_y2; // y[n-2]
+  Value m_x1; // x[n-1]
+  Value m_y1; // y[n-1]
 };
 
+typedef BasicDirectFormI <double> DirectFormI;
+
 //------------------------------------------------------------------------------
 
 /*
@@ -109,10 +194,13 @@ protected:
  *  y(n) = (b0/a0)*v[n] + (b1/a0)*v[n-1] + (b2/a0)*v[n-2]
  *
  */
-class DirectFormII
+template <typename Value>
+class BasicDirectFormII
 {
 public:
-  DirectFormII ()
+  typedef Value value_type;
+
+  BasicDirectFormII ()
   {
     reset ();
   }
@@ -128,8 +216,8 @@ public:
                    const BiquadBase& s,
                    const double vsa)
   {
-    double w   = in - s.m_a1*m_v1 - s.m_a2*m_v2 + vsa;
-    double out =      s.m_b0*w    + s.m_b1*m_v1 + s.m_b2*m_v2;
+    Value w   = static_cast<Value> (in) - Value (s.m_a1)*m_v1 - Value (s.m_a2)*m_v2 + Value (vsa);
+    Value out =        Value (s.m_b0)*w + Value (s.m_b1)*m_v1 + Value (s.m_b2)*m_v2;
 
     m_v2 = m_v1;
     m_v1 = w;
@@ -137,11 +225,63 @@ public:
     return static_cast<Sample> (out);
   }
 
+  double setSteadyState (const double in, const BiquadBase& s)
+  {
+    const double den = 1 + s.m_a1 + s.m_a2;
+    const double w = (fabs (den) < 1e-30) ? 0 : in / den;
+    m_v1 = m_v2 = static_cast<Value> (w);
+    return (s.m_b0 + s.m_b1 + s.m_b2) * w;
+  }
+
+  template <int Lanes>
+  static void processLanes (int numSamples,
+                            Value (*buffer)[Lanes],
+                            BasicDirectFormII* states,
+                            const BiquadBase& s,
+                            Value* vsaLanes)
+  {
+    const Value b0 = Value (s.m_b0);
+    const Value b1 = Value (s.m_b1);
+    const Value b2 = Value (s.m_b2);
+    const Value a1 = Value (s.m_a1);
+    const Value a2 = Value (s.m_a2);
+    Value v1 [Lanes], v2 [Lanes], vsa [Lanes];
+
+    for (int l = 0; l < Lanes; ++l)
+    {
+      vsa[l] = vsaLanes[l];
+      v1[l] = states[l].m_v1;
+      v2[l] = states[l].m_v2;
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+      Value* lanes = buffer[i];
+      for (int l = 0; l < Lanes; ++l)
+      {
+        const Value w = lanes[l] - a1*v1[l] - a2*v2[l] + vsa[l];
+        lanes[l] = b0*w + b1*v1[l] + b2*v2[l];
+        v2[l] = v1[l];
+        v1[l] = w;
+        vsa[l] = -vsa[l];
+      }
+    }
+
+    for (int l = 0; l < Lanes; ++l)
+    {
+      vsaLanes[l] = vsa[l];
+      states[l].m_v1 = v1[l];
+      states[l].m_v2 = v2[l];
+    }
+  }
+
 private:
-  double m_v1; // v[-1]
-  double m_v2; // v[-2]
+  Value m_v1; // v[-1]
+  Value m_v2; // v[-2]
 };
 
+typedef BasicDirectFormII <double> DirectFormII;
+
 //------------------------------------------------------------------------------
 
 /*
@@ -157,6 +297,8 @@ private:
 class TransposedDirectFormI
 {
 public:
+  typedef double value_type;
+
   TransposedDirectFormI ()
   {
     reset ();
@@ -198,6 +340,23 @@ public:
     return static_cast<Sample> (out);
   }
 
+  template <int Lanes>
+  static void processLanes (int numSamples,
+                            double (*buffer)[Lanes],
+                            TransposedDirectFormI* states,
+                            const BiquadBase& s,
+                            double* vsa)
+  {
+    for (int i = 0; i < numSamples; ++i)
+    {
+      for (int l = 0; l < Lanes; ++l)
+      {
+        buffer[i][l] = states[l].process1 (buffer[i][l], s, vsa[l]);
+        vsa[l] = -vsa[l];
+      }
+    }
+  }
+
 private:
   double m_v;
   double m_s1;
@@ -212,10 +371,13 @@ private:
 
 //------------------------------------------------------------------------------
 
-class TransposedDirectFormII
+template <typename Value>
+class BasicTransposedDirectFormII
 {
 public:
-  TransposedDirectFormII ()
+  typedef Value value_type;
+
+  BasicTransposedDirectFormII ()
   {
     reset ();
   }
@@ -233,24 +395,109 @@ public:
                           const BiquadBase& s,
                           const double vsa)
   {
-    double out;
+    const Value x = static_cast<Value> (in);
+    Value out;
 
-    out = m_s1_1 + s.m_b0*in + vsa;
-    m_s1 = m_s2_1 + s.m_b1*in - s.m_a1*out;
-    m_s2 = s.m_b2*in - s.m_a2*out;
+    out = m_s1_1 + Value (s.m_b0)*x + Value (vsa);
+    m_s1 = m_s2_1 + Value (s.m_b1)*x - Value (s.m_a1)*out;
+    m_s2 = Value (s.m_b2)*x - Value (s.m_a2)*out;
     m_s1_1 = m_s1;
     m_s2_1 = m_s2;
 
     return static_cast<Sample> (out);
   }
 
+  double setSteadyState (const double in, const BiquadBase& s)
+  {
+    const double out = in * steadyStateGain (s);
+    m_s1 = m_s1_1 = static_cast<Value> (out - s.m_b0*in);
+    m_s2 = m_s2_1 = static_cast<Value> (s.m_b2*in - s.m_a2*out);
+    return out;
+  }
+
+  template <int Lanes>
+  static void processLanes (int numSamples,
+                            Value (*buffer)[Lanes],
+                            BasicTransposedDirectFormII* states,
+                            const BiquadBase& s,
+                            Value* vsaLanes)
+  {
+    const Value b0 = Value (s.m_b0);
+    const Value b1 = Value (s.m_b1);
+    const Value b2 = Value (s.m_b2);
+    const Value a1 = Value (s.m_a1);
+    const Value a2 = Value (s.m_a2);
+    Value s1 [Lanes], s2 [Lanes], vsa [Lanes];
+
+    for (int l = 0; l < Lanes; ++l)
+    {
+      vsa[l] = vsaLanes[l];
+      s1[l] = states[l].m_s1_1;
+      s2[l] = states[l].m_s2_1;
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+      Value* lanes = buffer[i];
+      for (int l = 0; l < Lanes; ++l)
+      {
+        const Value x = lanes[l];
+        const Value out = s1[l] + b0*x + vsa[l];
+        s1[l] = s2[l] + b1*x - a1*out;
+        s2[l] = b2*x - a2*out;
+        lanes[l] = out;
+        vsa[l] = -vsa[l];
+      }
+    }
+
+    for (int l = 0; l < Lanes; ++l)
+    {
+      vsaLanes[l] = vsa[l];
+      states[l].m_s1 = states[l].m_s1_1 = s1[l];
+      states[l].m_s2 = states[l].m_s2_1 = s2[l];
+    }
+  }
+
 private:
-  double m_s1;
-  double m_s1_1;
-  double m_s2;
-  double m_s2_1;
+  Value m_s1;
+  Value m_s1_1;
+  Value m_s2;
+  Value m_s2_1;
 };
 
+typedef BasicTransposedDirectFormII <double> TransposedDirectFormII;
+
+//------------------------------------------------------------------------------
+
+/*
+ * Float state
+ *
+ * Single precision delay elements and arithmetic. The state of a
+ * 16th order band pass cascade shrinks from 256 to 128 bytes per
+ * channel (Direct Form I), and with float samples the stage-major
+ * chunk buffers and the lane-parallel processing in
+ * Cascade::StateBase hold 8 channels per AVX register instead of 4.
+ *
+ * The coefficients stay double and are rounded on use, so the design
+ * itself is unchanged; what is lost is the precision of the recursion.
+ * Rounding noise is amplified by the poles, roughly by 1/(1-|p|), and
+ * grows as the band moves towards DC relative to the sample rate.
+ * Measured against the double state (benchmarks/FloatState, band pass
+ * orders 2-8, peak relative error of the settled output): with EEG
+ * bands from 1 Hz Direct Form I stays within 1e-4 at 250 and 500 Hz
+ * and 5e-4 at 1000 Hz, Transposed Direct Form II within 2e-4 and
+ * 9e-4. A 0.5 Hz low edge costs about a factor of two, a 0.1 Hz one
+ * reaches 0.5-2.5%. Direct Form II is the least accurate form here
+ * (0.1-2% from 1 Hz) because its internal node has the full gain of
+ * the poles. For bands below about 0.5 Hz, or orders above 8 with
+ * narrow bands, keep the double state.
+ *
+ */
+
+typedef BasicDirectFormI <float> DirectFormIFloat;
+typedef BasicDirectFormII <float> DirectFormIIFloat;
+typedef BasicTransposedDirectFormII <float> TransposedDirectFormIIFloat;
+
 //------------------------------------------------------------------------------
 
 // Holds an array of states suitable for multi-channel processing
@@ -279,6 +526,12 @@ public:
     return m_state[index];
   }
 
+  const StateType& operator[] (int index) const
+  {
+    assert (index >= 0 && index < Channels);
+    return m_state[index];
+  }
+
   template <class Filter, typename Sample>
   void process (int numSamples,
                 Sample* const* arrayOfChannels,
@@ -37,6 +37,7 @@ THE SOFTWARE.
 #define DSPFILTERS_UTILITIES_H
 
 #include "Common.h"
+#include "SimdUtilities.h"
 
 namespace Dsp {
 
@@ -108,7 +109,7 @@ void copy (int samples,
       ++destSkip;
       while (--samples >= 0)
       {
-        *dest++ = *src++;
+        *dest = *src;
         dest += destSkip;
         src += srcSkip;
       }
@@ -118,7 +119,7 @@ void copy (int samples,
       ++srcSkip;
       while (--samples >= 0)
       {
-        *dest++ = *src++;
+        *dest++ = *src;
         src += srcSkip;
       }
     }
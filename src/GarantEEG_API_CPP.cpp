@@ -8,6 +8,12 @@
 //----------------------------------------------------------------------------------
 #include "include/GarantEEG_API_CPP.h"
 #include "src/EEG8.h"
+#include "src/EegReplay.h"
+#include "src/Filtering/ZeroPhaseFilter.h"
+#include "src/Filtering/dspfilter/Butterworth.h"
+#include "src/Recording/BdfHeader.h"
+#include "src/Recording/BdfRepair.h"
+#include "src/Recording/GcrConvert.h"
 //----------------------------------------------------------------------------------
 namespace GarantEEG
 {
@@ -18,6 +24,8 @@ extern "C" __declspec(dllexport) IGarantEEG* __cdecl CreateDevice(GARANT_EEG_DEV
     {
         case DT_GARANT:
             return new CEeg8();
+        case DT_REPLAY:
+            return new CEegReplay();
         default:
             break;
     }
@@ -25,5 +33,73 @@ extern "C" __declspec(dllexport) IGarantEEG* __cdecl CreateDevice(GARANT_EEG_DEV
     return nullptr;
 }
 //----------------------------------------------------------------------------------
+extern "C" __declspec(dllexport) bool __cdecl FilterRecordZeroPhase(const char *inputFilePath, const char *outputFilePath, int type, int order, int lowFrequency, int hightFrequency, int channelsCount, const int *channelsList, int threadsCount)
+{
+    if (type != FT_BUTTERWORTH || order < 1 || order > 8 || lowFrequency <= 0 || lowFrequency >= hightFrequency || channelsCount < 1 || channelsList == nullptr)
+        return false;
+
+    FILE *file = fopen(inputFilePath, "rb");
+
+    if (file == nullptr)
+        return false;
+
+    CBdfHeader header;
+    bool headerValid = header.Read(file);
+    fclose(file);
+
+    if (!headerValid)
+        return false;
+
+    double rate = header.SignalRate(channelsList[0] - 1);
+
+    //все фильтруемые каналы должны иметь одинаковую частоту дискретизации
+    for (int i = 1; i < channelsCount; i++)
+    {
+        if (header.SignalRate(channelsList[i] - 1) != rate)
+            return false;
+    }
+
+    if (rate <= 0.0 || hightFrequency * 2.0 >= rate)
+        return false;
+
+    Dsp::Butterworth::BandPass<8> design;
+    design.setup(order, rate, (lowFrequency + hightFrequency) / 2.0, (double)(hightFrequency - lowFrequency));
+
+    CZeroPhaseFilter filter(design);
+    filter.SetThreadsCount(threadsCount);
+
+    return filter.ProcessFile(inputFilePath, outputFilePath, channelsCount, channelsList);
+}
+//----------------------------------------------------------------------------------
+extern "C" __declspec(dllexport) bool __cdecl RepairRecord(const char *filePath, GARANT_EEG_RECORD_REPAIR_RESULT *result)
+{
+    if (filePath == nullptr)
+        return false;
+
+    GARANT_EEG_RECORD_REPAIR_RESULT repairResult;
+    bool repaired = RepairBdfFile(filePath, repairResult);
+
+    if (result != nullptr)
+        *result = repairResult;
+
+    return repaired;
+}
+//----------------------------------------------------------------------------------
+extern "C" __declspec(dllexport) bool __cdecl CompressRecord(const char *bdfFilePath, const char *gcrFilePath, int chunkRecords)
+{
+    if (bdfFilePath == nullptr || gcrFilePath == nullptr)
+        return false;
+
+    return CompressBdfFile(bdfFilePath, gcrFilePath, chunkRecords);
+}
+//----------------------------------------------------------------------------------
+extern "C" __declspec(dllexport) bool __cdecl DecompressRecord(const char *gcrFilePath, const char *bdfFilePath)
+{
+    if (gcrFilePath == nullptr || bdfFilePath == nullptr)
+        return false;
+
+    return DecompressGcrFile(gcrFilePath, bdfFilePath);
+}
+//----------------------------------------------------------------------------------
 } //namespace GarantEEG
 //----------------------------------------------------------------------------------
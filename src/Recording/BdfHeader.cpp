@@ -0,0 +1,303 @@
+/**
+@file BdfHeader.cpp
+
+@brief Класс для разбора заголовка BDF файла
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include "BdfHeader.h"
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+static string ReadBdfField(const char *data, int size)
+{
+    string result(data, size);
+
+    size_t end = result.find_last_not_of(' ');
+
+    if (end == string::npos)
+        return "";
+
+    result.resize(end + 1);
+
+    return result;
+}
+//----------------------------------------------------------------------------------
+bool CBdfHeader::Parse(const char *data, int size)
+{
+    m_Signals.clear();
+    m_HeaderSize = 0;
+    m_RecordSize = 0;
+
+    if (data == nullptr || size < BDF_MAIN_HEADER_SIZE)
+        return false;
+
+    int headerSize = atoi(ReadBdfField(data + 184, 8).c_str());
+    int signalsCount = atoi(ReadBdfField(data + 252, 4).c_str());
+
+    if (signalsCount < 1 || headerSize != BDF_MAIN_HEADER_SIZE + signalsCount * BDF_SIGNAL_HEADER_SIZE || size < headerSize)
+        return false;
+
+    m_RecordsCount = atoll(ReadBdfField(data + BDF_RECORDS_COUNT_OFFSET, 8).c_str());
+    m_RecordDuration = atof(ReadBdfField(data + 244, 8).c_str());
+
+    if (m_RecordsCount < 0)
+        m_RecordsCount = -1;
+
+    m_Signals.resize(signalsCount);
+
+    const char *ptr = data + BDF_MAIN_HEADER_SIZE;
+    const int ns = signalsCount;
+
+    for (int i = 0; i < ns; i++)
+    {
+        BDF_SIGNAL_INFO &signal = m_Signals[i];
+
+        signal.Label = ReadBdfField(ptr + (16 * i), 16);
+        signal.PhysicalMinimum = atof(ReadBdfField(ptr + (104 * ns) + (8 * i), 8).c_str());
+        signal.PhysicalMaximum = atof(ReadBdfField(ptr + (112 * ns) + (8 * i), 8).c_str());
+        signal.DigitalMinimum = atoi(ReadBdfField(ptr + (120 * ns) + (8 * i), 8).c_str());
+        signal.DigitalMaximum = atoi(ReadBdfField(ptr + (128 * ns) + (8 * i), 8).c_str());
+        signal.SamplesPerRecord = atoi(ReadBdfField(ptr + (216 * ns) + (8 * i), 8).c_str());
+        signal.Offset = m_RecordSize;
+
+        if (signal.SamplesPerRecord < 0)
+            return false;
+
+        m_RecordSize += signal.SamplesPerRecord * 3;
+    }
+
+    if (m_RecordSize < 1)
+        return false;
+
+    m_HeaderSize = headerSize;
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+bool CBdfHeader::Read(FILE *file)
+{
+    if (file == nullptr || !FileSeek64(file, 0))
+        return false;
+
+    vector<char> data(BDF_MAIN_HEADER_SIZE);
+
+    if (fread(&data[0], BDF_MAIN_HEADER_SIZE, 1, file) != 1)
+        return false;
+
+    int headerSize = atoi(ReadBdfField(&data[184], 8).c_str());
+
+    if (headerSize <= BDF_MAIN_HEADER_SIZE)
+        return false;
+
+    data.resize(headerSize);
+
+    if (fread(&data[BDF_MAIN_HEADER_SIZE], headerSize - BDF_MAIN_HEADER_SIZE, 1, file) != 1)
+        return false;
+
+    return Parse(&data[0], headerSize);
+}
+//----------------------------------------------------------------------------------
+double CBdfHeader::SignalRate(int index) const
+{
+    if (index < 0 || index >= (int)m_Signals.size() || m_RecordDuration <= 0.0)
+        return 0.0;
+
+    return m_Signals[index].SamplesPerRecord / m_RecordDuration;
+}
+//----------------------------------------------------------------------------------
+long long CBdfHeader::RecordsCountBySize(long long fileSize) const
+{
+    if (m_RecordSize < 1 || fileSize < m_HeaderSize)
+        return 0;
+
+    return (fileSize - m_HeaderSize) / m_RecordSize;
+}
+//----------------------------------------------------------------------------------
+static void WriteBdfField(char *data, int size, const string &text)
+{
+    memset(data, ' ', size);
+    memcpy(data, text.c_str(), std::min((int)text.length(), size));
+}
+//----------------------------------------------------------------------------------
+bool MakeBdfHeader(const vector<char> &source, const vector<BDF_SIGNAL_TEMPLATE> &signals, vector<char> &header)
+{
+    CBdfHeader sourceHeader;
+
+    if (source.empty() || signals.empty() || !sourceHeader.Parse(&source[0], (int)source.size()))
+        return false;
+
+    const int sourceCount = sourceHeader.SignalsCount();
+    const int count = (int)signals.size();
+
+    header.assign(BDF_MAIN_HEADER_SIZE + count * BDF_SIGNAL_HEADER_SIZE, ' ');
+    memcpy(&header[0], &source[0], BDF_MAIN_HEADER_SIZE);
+
+    char text[32] = { 0 };
+
+    sprintf(text, "%i", (int)header.size());
+    WriteBdfField(&header[184], 8, text);
+    WriteBdfField(&header[BDF_RECORDS_COUNT_OFFSET], 8, "-1");
+    sprintf(text, "%i", count);
+    WriteBdfField(&header[252], 4, text);
+
+    //Поля сигналов в заголовке сгруппированы по полям: все названия, все типы датчиков и т.д. (смещение поля, размер)
+    const int fields[][2] = { { 0, 16 }, { 16, 80 }, { 96, 8 }, { 104, 8 }, { 112, 8 }, { 120, 8 }, { 128, 8 }, { 136, 80 }, { 216, 8 }, { 224, 32 } };
+    const char *sourceSignals = &source[BDF_MAIN_HEADER_SIZE];
+    char *destSignals = &header[BDF_MAIN_HEADER_SIZE];
+
+    for (int i = 0; i < count; i++)
+    {
+        const BDF_SIGNAL_TEMPLATE &signal = signals[i];
+
+        if (signal.Source < 0 || signal.Source >= sourceCount || signal.SamplesPerRecord < 1)
+            return false;
+
+        for (const auto &field : fields)
+            memcpy(destSignals + field[0] * count + field[1] * i, sourceSignals + field[0] * sourceCount + field[1] * signal.Source, field[1]);
+
+        WriteBdfField(destSignals + 16 * i, 16, signal.Label);
+        WriteBdfField(destSignals + 136 * count + 80 * i, 80, signal.Prefiltering);
+        sprintf(text, "%i", signal.SamplesPerRecord);
+        WriteBdfField(destSignals + 216 * count + 8 * i, 8, text);
+    }
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+//Номер дня от 01.01.1970 по дате григорианского календаря
+static long long DaysFromCivil(int year, int month, int day)
+{
+    year -= (month <= 2 ? 1 : 0);
+
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const int yearOfEra = year - era * 400;
+    const int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+
+    return (long long)era * 146097 + dayOfEra - 719468;
+}
+//----------------------------------------------------------------------------------
+//Дата григорианского календаря по номеру дня от 01.01.1970
+static void CivilFromDays(long long days, int &year, int &month, int &day)
+{
+    days += 719468;
+
+    const long long era = (days >= 0 ? days : days - 146096) / 146097;
+    const int dayOfEra = (int)(days - era * 146097);
+    const int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const int monthIndex = (5 * dayOfYear + 2) / 153;
+
+    day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    month = monthIndex + (monthIndex < 10 ? 3 : -9);
+    year = (int)(yearOfEra + era * 400) + (month <= 2 ? 1 : 0);
+}
+//----------------------------------------------------------------------------------
+bool ShiftBdfStartTime(vector<char> &header, long long seconds)
+{
+    if (header.size() < (size_t)BDF_MAIN_HEADER_SIZE)
+        return false;
+
+    //Дата "dd.mm.yy" (168) и время "hh.mm.ss" (176), годы 85-99 относятся к 19xx (спецификация EDF)
+    string date(&header[168], 8);
+    string time(&header[176], 8);
+    int day = 0, month = 0, year = 0, hour = 0, minute = 0, second = 0;
+
+    if (sscanf(date.c_str(), "%d.%d.%d", &day, &month, &year) != 3 || sscanf(time.c_str(), "%d.%d.%d", &hour, &minute, &second) != 3)
+        return false;
+
+    if (day < 1 || day > 31 || month < 1 || month > 12 || year < 0 || year > 99 || hour > 23 || minute > 59 || second > 59)
+        return false;
+
+    year += (year >= 85 ? 1900 : 2000);
+
+    long long total = (DaysFromCivil(year, month, day) * 86400LL) + hour * 3600 + minute * 60 + second + seconds;
+    long long days = total / 86400;
+    int daySeconds = (int)(total % 86400);
+
+    if (daySeconds < 0)
+    {
+        daySeconds += 86400;
+        days--;
+    }
+
+    CivilFromDays(days, year, month, day);
+
+    char text[32] = { 0 };
+
+    sprintf(text, "%02i.%02i.%02i", day, month, year % 100);
+    WriteBdfField(&header[168], 8, text);
+    sprintf(text, "%02i.%02i.%02i", daySeconds / 3600, (daySeconds / 60) % 60, daySeconds % 60);
+    WriteBdfField(&header[176], 8, text);
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+bool FileSeek64(FILE *file, long long offset)
+{
+#ifdef _WIN32
+    return (_fseeki64(file, offset, SEEK_SET) == 0);
+#else
+    return (fseeko(file, (off_t)offset, SEEK_SET) == 0);
+#endif
+}
+//----------------------------------------------------------------------------------
+long long FileSize64(FILE *file)
+{
+#ifdef _WIN32
+    long long position = _ftelli64(file);
+
+    if (_fseeki64(file, 0, SEEK_END) != 0)
+        return -1;
+
+    long long size = _ftelli64(file);
+    _fseeki64(file, position, SEEK_SET);
+#else
+    off_t position = ftello(file);
+
+    if (fseeko(file, 0, SEEK_END) != 0)
+        return -1;
+
+    long long size = (long long)ftello(file);
+    fseeko(file, position, SEEK_SET);
+#endif
+
+    return size;
+}
+//----------------------------------------------------------------------------------
+long long FileTell64(FILE *file)
+{
+#ifdef _WIN32
+    return _ftelli64(file);
+#else
+    return (long long)ftello(file);
+#endif
+}
+//----------------------------------------------------------------------------------
+bool FileSync(FILE *file)
+{
+    if (fflush(file) != 0)
+        return false;
+
+#ifdef _WIN32
+    return (_commit(_fileno(file)) == 0);
+#elif defined(__APPLE__)
+    return (fsync(fileno(file)) == 0);
+#else
+    return (fdatasync(fileno(file)) == 0);
+#endif
+}
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
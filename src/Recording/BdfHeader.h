@@ -0,0 +1,237 @@
+/**
+@file BdfHeader.h
+
+@brief Класс для разбора заголовка BDF файла
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#ifndef BDFHEADER_H
+#define BDFHEADER_H
+//----------------------------------------------------------------------------------
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include <stdio.h>
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+//! Смещение поля количества записей данных в заголовке BDF
+const int BDF_RECORDS_COUNT_OFFSET = 236;
+//----------------------------------------------------------------------------------
+//! Размер основной части заголовка BDF
+const int BDF_MAIN_HEADER_SIZE = 256;
+//----------------------------------------------------------------------------------
+//! Размер заголовка BDF на один сигнал
+const int BDF_SIGNAL_HEADER_SIZE = 256;
+//----------------------------------------------------------------------------------
+//! Описание сигнала из заголовка BDF
+struct BDF_SIGNAL_INFO
+{
+	//! Название сигнала
+    string Label;
+
+	//! Количество отсчетов в одной записи данных
+    int SamplesPerRecord;
+
+	//! Смещение данных сигнала от начала записи данных (в байтах)
+    int Offset;
+
+	//! Минимальное физическое значение
+    double PhysicalMinimum;
+
+	//! Максимальное физическое значение
+    double PhysicalMaximum;
+
+	//! Минимальное цифровое значение
+    int DigitalMinimum;
+
+	//! Максимальное цифровое значение
+    int DigitalMaximum;
+};
+//----------------------------------------------------------------------------------
+//! Описание сигнала для сборки заголовка BDF на основе сигнала другого заголовка
+struct BDF_SIGNAL_TEMPLATE
+{
+	//! Индекс сигнала исходного заголовка (копируются тип датчика, единицы и диапазоны значений)
+    int Source;
+
+	//! Название сигнала (до 16 символов)
+    string Label;
+
+	//! Описание предварительной фильтрации (до 80 символов)
+    string Prefiltering;
+
+	//! Количество отсчетов в одной записи данных
+    int SamplesPerRecord;
+};
+//----------------------------------------------------------------------------------
+//! Класс для разбора заголовка BDF файла
+class CBdfHeader
+{
+protected:
+	//! Размер заголовка
+    int m_HeaderSize = 0;
+
+	//! Количество записей данных (-1 если не известно)
+    long long m_RecordsCount = -1;
+
+	//! Длительность одной записи данных в секундах
+    double m_RecordDuration = 0.0;
+
+	//! Размер одной записи данных в байтах
+    int m_RecordSize = 0;
+
+	//! Список сигналов
+    vector<BDF_SIGNAL_INFO> m_Signals;
+
+public:
+	/**
+	 * @brief Parse Разобрать заголовок
+	 * @param data Указатель на данные заголовка
+	 * @param size Размер данных
+	 * @return true если заголовок корректен
+	 */
+    bool Parse(const char *data, int size);
+
+	/**
+	 * @brief Read Прочитать и разобрать заголовок из файла (позиция файла остается на первой записи данных)
+	 * @param file Файл
+	 * @return true если заголовок корректен
+	 */
+    bool Read(FILE *file);
+
+	/**
+	 * @brief HeaderSize Получить размер заголовка в байтах
+	 * @return Размер заголовка
+	 */
+    int HeaderSize() const { return m_HeaderSize; }
+
+	/**
+	 * @brief RecordsCount Получить количество записей данных, указанное в заголовке
+	 * @return Количество записей или -1 если запись не была корректно завершена
+	 */
+    long long RecordsCount() const { return m_RecordsCount; }
+
+	/**
+	 * @brief RecordDuration Получить длительность одной записи данных
+	 * @return Длительность в секундах
+	 */
+    double RecordDuration() const { return m_RecordDuration; }
+
+	/**
+	 * @brief RecordSize Получить размер одной записи данных
+	 * @return Размер в байтах
+	 */
+    int RecordSize() const { return m_RecordSize; }
+
+	/**
+	 * @brief SignalsCount Получить количество сигналов
+	 * @return Количество сигналов
+	 */
+    int SignalsCount() const { return (int)m_Signals.size(); }
+
+	/**
+	 * @brief Signal Получить описание сигнала
+	 * @param index Индекс сигнала
+	 * @return Описание сигнала
+	 */
+    const BDF_SIGNAL_INFO &Signal(int index) const { return m_Signals[index]; }
+
+	/**
+	 * @brief SignalRate Получить частоту дискретизации сигнала
+	 * @param index Индекс сигнала
+	 * @return Частота дискретизации
+	 */
+    double SignalRate(int index) const;
+
+	/**
+	 * @brief RecordsCountBySize Вычислить количество целых записей данных по размеру файла
+	 * @param fileSize Размер файла
+	 * @return Количество записей
+	 */
+    long long RecordsCountBySize(long long fileSize) const;
+};
+//----------------------------------------------------------------------------------
+/**
+ * @brief Unpack24BitValue Функция преобразования 24-битного отсчета BDF в целое (Little Endian)
+ * @param buf Буфер
+ * @return Значение отсчета
+ */
+inline int Unpack24BitValue(const unsigned char *buf)
+{
+    int value = ((buf[2] << 16) | (buf[1] << 8) | buf[0]);
+
+    if (value >= 8388608)
+        value -= 16777216;
+
+    return value;
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief Pack24BitValue Функция записи целого в 24-битный отсчет BDF (Little Endian)
+ * @param buf Буфер
+ * @param value Значение отсчета
+ */
+inline void Pack24BitValue(unsigned char *buf, int value)
+{
+    buf[0] = (unsigned char)(value & 0xFF);
+    buf[1] = (unsigned char)((value >> 8) & 0xFF);
+    buf[2] = (unsigned char)((value >> 16) & 0xFF);
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief MakeBdfHeader Функция сборки заголовка BDF из сигналов другого заголовка (основная часть копируется,
+ * количество записей данных устанавливается в -1)
+ * @param source Данные исходного заголовка
+ * @param signals Сигналы нового заголовка
+ * @param header Данные нового заголовка
+ * @return true если исходный заголовок корректен и индексы сигналов в его пределах
+ */
+bool MakeBdfHeader(const vector<char> &source, const vector<BDF_SIGNAL_TEMPLATE> &signals, vector<char> &header);
+
+/**
+ * @brief ShiftBdfStartTime Сдвинуть дату и время начала записи в заголовке BDF (например, для следующего сегмента записи)
+ * @param header Данные заголовка
+ * @param seconds Сдвиг в секундах
+ * @return true если дата и время в заголовке корректны и сдвинуты
+ */
+bool ShiftBdfStartTime(vector<char> &header, long long seconds);
+//----------------------------------------------------------------------------------
+/**
+ * @brief FileSeek64 Функция установки позиции в файле с поддержкой файлов больше 2 ГБ
+ * @param file Файл
+ * @param offset Смещение от начала файла
+ * @return true если успешно
+ */
+bool FileSeek64(FILE *file, long long offset);
+//----------------------------------------------------------------------------------
+/**
+ * @brief FileSize64 Функция получения размера файла с поддержкой файлов больше 2 ГБ
+ * @param file Файл
+ * @return Размер файла или -1 в случае ошибки
+ */
+long long FileSize64(FILE *file);
+//----------------------------------------------------------------------------------
+/**
+ * @brief FileTell64 Функция получения позиции в файле с поддержкой файлов больше 2 ГБ
+ * @param file Файл
+ * @return Позиция или -1 в случае ошибки
+ */
+long long FileTell64(FILE *file);
+//----------------------------------------------------------------------------------
+/**
+ * @brief FileSync Функция передачи буфера файла системе и принудительной записи данных файла на диск
+ * @param file Файл
+ * @return true если успешно
+ */
+bool FileSync(FILE *file);
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
+#endif // BDFHEADER_H
+//----------------------------------------------------------------------------------
@@ -0,0 +1,257 @@
+/**
+@file BdfReader.cpp
+
+@brief Класс для чтения BDF файла через отображение в память с произвольным доступом к записям данных и отсчетам сигналов
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include "BdfReader.h"
+#include "../Filtering/dspfilter/Utilities.h"
+#include <algorithm>
+#include <string.h>
+#include <math.h>
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+CBdfReader::~CBdfReader()
+{
+    Close();
+}
+//----------------------------------------------------------------------------------
+bool CBdfReader::Open(const string &filePath)
+{
+    Close();
+
+    FILE *file = fopen(filePath.c_str(), "rb");
+
+    if (file == nullptr)
+        return false;
+
+    bool headerValid = m_Header.Read(file);
+    fclose(file);
+
+    if (!headerValid || !m_File.Open(filePath, true))
+        return false;
+
+    const long long fileSize = m_File.Size();
+    const int recordSize = m_Header.RecordSize();
+
+    m_RecordsCount = m_Header.RecordsCountBySize(fileSize);
+
+    //Количество из заголовка учитывается, только если соответствующие данные есть в файле (запись могла быть прервана)
+    if (m_Header.RecordsCount() >= 0 && m_Header.RecordsCount() < m_RecordsCount)
+        m_RecordsCount = m_Header.RecordsCount();
+
+    m_DataEnd = m_Header.HeaderSize() + m_RecordsCount * recordSize;
+
+    //Первый участок отображается сразу, чтобы ошибка отображения обнаруживалась при открытии
+    if (m_RecordsCount > 0 && MapRecord(0) == nullptr)
+    {
+        Close();
+        return false;
+    }
+
+    const int signalsCount = m_Header.SignalsCount();
+
+    m_Gains.resize(signalsCount);
+    m_Offsets.resize(signalsCount);
+
+    for (int i = 0; i < signalsCount; i++)
+    {
+        const BDF_SIGNAL_INFO &signal = m_Header.Signal(i);
+
+        if (signal.DigitalMaximum != signal.DigitalMinimum)
+        {
+            m_Gains[i] = (signal.PhysicalMaximum - signal.PhysicalMinimum) / (double)(signal.DigitalMaximum - signal.DigitalMinimum);
+            m_Offsets[i] = signal.PhysicalMinimum - signal.DigitalMinimum * m_Gains[i];
+        }
+        else
+        {
+            m_Gains[i] = 1.0;
+            m_Offsets[i] = 0.0;
+        }
+    }
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+void CBdfReader::Close()
+{
+    for (const BDF_READER_VIEW &view : m_Views)
+        m_File.Unmap((char*)view.Data, view.Size);
+
+    m_Views.clear();
+    m_ViewsUseCounter = 0;
+    m_File.Close();
+
+    m_RecordsCount = 0;
+    m_DataEnd = 0;
+    m_Gains.clear();
+    m_Offsets.clear();
+}
+//----------------------------------------------------------------------------------
+const unsigned char *CBdfReader::MapRecord(long long index) const
+{
+    const long long offset = m_Header.HeaderSize() + index * m_Header.RecordSize();
+    const long long viewIndex = offset / BDF_READER_VIEW_SIZE;
+    const long long viewOffset = viewIndex * BDF_READER_VIEW_SIZE;
+
+    m_ViewsUseCounter++;
+
+    for (BDF_READER_VIEW &view : m_Views)
+    {
+        if (view.Index == viewIndex)
+        {
+            view.LastUse = m_ViewsUseCounter;
+            return view.Data + (offset - viewOffset);
+        }
+    }
+
+    //Участок отображается с запасом на одну запись, чтобы запись, начинающаяся в участке, не пересекала его границу
+    const int size = (int)std::min((long long)BDF_READER_VIEW_SIZE + m_Header.RecordSize(), m_DataEnd - viewOffset);
+
+    //Давно не использованный участок освобождается до отображения нового, чтобы не занимать лишнее адресное пространство
+    if ((int)m_Views.size() >= BDF_READER_CACHED_VIEWS)
+    {
+        vector<BDF_READER_VIEW>::iterator oldest = m_Views.begin();
+
+        for (vector<BDF_READER_VIEW>::iterator i = m_Views.begin(); i != m_Views.end(); ++i)
+        {
+            if (i->LastUse < oldest->LastUse)
+                oldest = i;
+        }
+
+        m_File.Unmap((char*)oldest->Data, oldest->Size);
+        m_Views.erase(oldest);
+    }
+
+    const unsigned char *data = (const unsigned char*)m_File.Map(viewOffset, size);
+
+    if (data == nullptr)
+        return nullptr;
+
+    m_Views.push_back({ viewIndex, data, size, m_ViewsUseCounter });
+
+    return data + (offset - viewOffset);
+}
+//----------------------------------------------------------------------------------
+const unsigned char *CBdfReader::Record(long long index) const
+{
+    if (index < 0 || index >= m_RecordsCount)
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(m_ViewsMutex);
+
+    return MapRecord(index);
+}
+//----------------------------------------------------------------------------------
+int CBdfReader::ReadRecords(long long firstRecord, int count, char *dest) const
+{
+    if (dest == nullptr || firstRecord < 0 || count < 1 || firstRecord >= m_RecordsCount)
+        return 0;
+
+    count = (int)std::min((long long)count, m_RecordsCount - firstRecord);
+
+    const int recordSize = m_Header.RecordSize();
+
+    std::lock_guard<std::mutex> lock(m_ViewsMutex);
+
+    //Записи копируются подряд до границы участка, затем из следующего участка
+    for (int done = 0; done < count;)
+    {
+        const unsigned char *data = MapRecord(firstRecord + done);
+
+        if (data == nullptr)
+            return done;
+
+        const long long offset = m_Header.HeaderSize() + (firstRecord + done) * recordSize;
+        const long long viewEnd = (offset / BDF_READER_VIEW_SIZE + 1) * BDF_READER_VIEW_SIZE;
+        const int length = (int)std::min((long long)(count - done), (viewEnd - offset - 1) / recordSize + 1);
+
+        memcpy(dest + (size_t)done * recordSize, data, (size_t)length * recordSize);
+        done += length;
+    }
+
+    return count;
+}
+//----------------------------------------------------------------------------------
+long long CBdfReader::SamplesCount(int signal) const
+{
+    if (signal < 0 || signal >= m_Header.SignalsCount())
+        return 0;
+
+    return m_RecordsCount * m_Header.Signal(signal).SamplesPerRecord;
+}
+//----------------------------------------------------------------------------------
+long long CBdfReader::SampleIndex(int signal, double time) const
+{
+    if (signal < 0 || signal >= m_Header.SignalsCount() || time <= 0.0)
+        return 0;
+
+    return (long long)floor(time * m_Header.SignalRate(signal) + 0.5);
+}
+//----------------------------------------------------------------------------------
+template<class T>
+int CBdfReader::ReadSamples(int signal, long long firstSample, int samplesCount, T *dest) const
+{
+    const long long totalCount = SamplesCount(signal);
+
+    if (dest == nullptr || firstSample < 0 || samplesCount < 1 || firstSample >= totalCount)
+        return 0;
+
+    const BDF_SIGNAL_INFO &info = m_Header.Signal(signal);
+    const int spr = info.SamplesPerRecord;
+    const int count = (int)std::min((long long)samplesCount, totalCount - firstSample);
+    const T gain = (T)m_Gains[signal];
+    const T offset = (T)m_Offsets[signal];
+
+    long long record = firstSample / spr;
+    int position = (int)(firstSample % spr);
+
+    std::lock_guard<std::mutex> lock(m_ViewsMutex);
+
+    for (int done = 0; done < count; record++, position = 0)
+    {
+        const unsigned char *data = MapRecord(record);
+
+        if (data == nullptr)
+            return done;
+
+        const int length = std::min(spr - position, count - done);
+
+        Dsp::convertInt24(length, dest + done, data + info.Offset + position * 3, gain, offset);
+        done += length;
+    }
+
+    return count;
+}
+//----------------------------------------------------------------------------------
+int CBdfReader::ReadSignal(int signal, long long firstSample, int samplesCount, float *dest) const
+{
+    return ReadSamples(signal, firstSample, samplesCount, dest);
+}
+//----------------------------------------------------------------------------------
+int CBdfReader::ReadSignal(int signal, long long firstSample, int samplesCount, double *dest) const
+{
+    return ReadSamples(signal, firstSample, samplesCount, dest);
+}
+//----------------------------------------------------------------------------------
+int CBdfReader::ReadSignalTime(int signal, double startTime, double duration, vector<float> &dest) const
+{
+    const long long firstSample = SampleIndex(signal, startTime);
+    const long long count = std::max(0LL, std::min(SampleIndex(signal, startTime + duration), SamplesCount(signal)) - firstSample);
+
+    dest.resize((size_t)std::min(count, (long long)0x7FFFFFFF));
+
+    if (dest.empty())
+        return 0;
+
+    dest.resize(ReadSignal(signal, firstSample, (int)dest.size(), &dest[0]));
+
+    return (int)dest.size();
+}
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
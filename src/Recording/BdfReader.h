@@ -0,0 +1,204 @@
+/**
+@file BdfReader.h
+
+@brief Класс для чтения BDF файла через отображение в память с произвольным доступом к записям данных и отсчетам сигналов
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#ifndef BDFREADER_H
+#define BDFREADER_H
+//----------------------------------------------------------------------------------
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include <mutex>
+//----------------------------------------------------------------------------------
+#include "BdfHeader.h"
+#include "MappedFile.h"
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+//! Размер участка файла, отображаемого одним видом (кратен гранулярности отображения Windows)
+const int BDF_READER_VIEW_SIZE = 64 * 1024 * 1024;
+
+//! Максимальное количество одновременно отображенных участков (ограничивает занятое адресное пространство)
+const int BDF_READER_CACHED_VIEWS = 4;
+//----------------------------------------------------------------------------------
+//! Класс для чтения BDF файла. Заголовок разбирается один раз при открытии, участки файла по BDF_READER_VIEW_SIZE
+//! отображаются в память при первом обращении к ним, отображенными остаются не больше BDF_READER_CACHED_VIEWS
+//! последних использованных участков. Открытие и занятое адресное пространство не зависят от размера файла
+//! (многогигабайтные записи читаются и в 32-битной сборке), каждая запись данных целиком лежит в одном участке.
+//! После открытия функции чтения могут вызываться из нескольких потоков (набор участков защищен мьютексом).
+class CBdfReader
+{
+private:
+	//! Отображенный участок файла
+    struct BDF_READER_VIEW
+    {
+		//! Номер участка (участок k начинается со смещения k * BDF_READER_VIEW_SIZE)
+        long long Index;
+
+		//! Данные участка
+        const unsigned char *Data;
+
+		//! Размер участка
+        int Size;
+
+		//! Значение счетчика обращений при последнем использовании
+        unsigned long long LastUse;
+    };
+
+	//! Файл (участки отображаются при чтении)
+    mutable CMappedFile m_File;
+
+	//! Заголовок файла
+    CBdfHeader m_Header;
+
+	//! Отображенные участки (не больше BDF_READER_CACHED_VIEWS)
+    mutable vector<BDF_READER_VIEW> m_Views;
+
+	//! Счетчик обращений к участкам для вытеснения давно не использованного
+    mutable unsigned long long m_ViewsUseCounter = 0;
+
+	//! Мьютекс доступа к отображенным участкам
+    mutable std::mutex m_ViewsMutex;
+
+	//! Конец данных последней доступной записи в файле
+    long long m_DataEnd = 0;
+
+	//! Количество доступных записей данных
+    long long m_RecordsCount = 0;
+
+	//! Множители перевода цифровых значений сигналов в физические
+    vector<double> m_Gains;
+
+	//! Смещения перевода цифровых значений сигналов в физические
+    vector<double> m_Offsets;
+
+	/**
+	 * @brief MapRecord Получить запись данных, отобразив ее участок при необходимости (вызывается под m_ViewsMutex)
+	 * @param index Номер записи (от 0 до m_RecordsCount - 1)
+	 * @return Указатель на данные записи или nullptr если участок не удалось отобразить
+	 */
+    const unsigned char *MapRecord(long long index) const;
+
+	/**
+	 * @brief ReadSamples Прочитать отсчеты сигнала в физических величинах
+	 */
+    template<class T>
+    int ReadSamples(int signal, long long firstSample, int samplesCount, T *dest) const;
+
+public:
+	/**
+	 * @brief CBdfReader Конструктор
+	 */
+    CBdfReader() {}
+
+	/**
+	 * @brief ~CBdfReader Деструктор
+	 */
+    ~CBdfReader();
+
+	/**
+	 * @brief Open Открыть файл и разобрать заголовок
+	 * @param filePath Путь к файлу
+	 * @return true если файл открыт и заголовок корректен
+	 */
+    bool Open(const string &filePath);
+
+	/**
+	 * @brief Close Закрыть файл (указатели на записи данных становятся недействительными)
+	 */
+    void Close();
+
+	/**
+	 * @brief IsOpened Проверить, открыт ли файл
+	 * @return true если открыт
+	 */
+    bool IsOpened() const { return m_File.IsOpened(); }
+
+	/**
+	 * @brief Header Получить заголовок файла
+	 * @return Ссылка на заголовок
+	 */
+    const CBdfHeader &Header() const { return m_Header; }
+
+	/**
+	 * @brief RecordsCount Получить количество доступных записей данных (по заголовку, если оно указано и не больше количества
+	 * целых записей в файле, иначе по размеру файла)
+	 * @return Количество записей
+	 */
+    long long RecordsCount() const { return m_RecordsCount; }
+
+	/**
+	 * @brief Record Получить запись данных без копирования. Указатель действителен, пока участок записи не вытеснен
+	 * обращениями к другим участкам (в том числе из других потоков), для параллельного чтения используется ReadRecords
+	 * @param index Номер записи
+	 * @return Указатель на данные записи (размером Header().RecordSize()) или nullptr если записи нет
+	 */
+    const unsigned char *Record(long long index) const;
+
+	/**
+	 * @brief ReadRecords Прочитать записи данных
+	 * @param firstRecord Номер первой записи
+	 * @param count Количество записей
+	 * @param dest Буфер размером count * Header().RecordSize()
+	 * @return Количество прочитанных записей (меньше count у конца файла)
+	 */
+    int ReadRecords(long long firstRecord, int count, char *dest) const;
+
+	/**
+	 * @brief SamplesCount Получить количество отсчетов сигнала во всех записях данных
+	 * @param signal Индекс сигнала
+	 * @return Количество отсчетов
+	 */
+    long long SamplesCount(int signal) const;
+
+	/**
+	 * @brief SampleIndex Получить номер отсчета сигнала по времени от начала записи
+	 * @param signal Индекс сигнала
+	 * @param time Время в секундах
+	 * @return Номер отсчета
+	 */
+    long long SampleIndex(int signal, double time) const;
+
+	/**
+	 * @brief ReadSignal Прочитать отсчеты сигнала в физических величинах
+	 * @param signal Индекс сигнала
+	 * @param firstSample Номер первого отсчета
+	 * @param samplesCount Количество отсчетов
+	 * @param dest Буфер для отсчетов
+	 * @return Количество прочитанных отсчетов (меньше samplesCount у конца файла)
+	 */
+    int ReadSignal(int signal, long long firstSample, int samplesCount, float *dest) const;
+
+	/**
+	 * @brief ReadSignal Прочитать отсчеты сигнала в физических величинах
+	 * @param signal Индекс сигнала
+	 * @param firstSample Номер первого отсчета
+	 * @param samplesCount Количество отсчетов
+	 * @param dest Буфер для отсчетов
+	 * @return Количество прочитанных отсчетов (меньше samplesCount у конца файла)
+	 */
+    int ReadSignal(int signal, long long firstSample, int samplesCount, double *dest) const;
+
+	/**
+	 * @brief ReadSignalTime Прочитать отсчеты сигнала за интервал времени в физических величинах
+	 * @param signal Индекс сигнала
+	 * @param startTime Начало интервала в секундах от начала записи
+	 * @param duration Длительность интервала в секундах
+	 * @param dest Вектор для отсчетов (размер устанавливается по количеству прочитанных отсчетов)
+	 * @return Количество прочитанных отсчетов
+	 */
+    int ReadSignalTime(int signal, double startTime, double duration, vector<float> &dest) const;
+};
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
+#endif // BDFREADER_H
+//----------------------------------------------------------------------------------
@@ -0,0 +1,87 @@
+/**
+@file BdfRepair.cpp
+
+@brief Восстановление BDF файла, запись которого не была корректно завершена
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include "BdfRepair.h"
+#include "BdfHeader.h"
+#include "MappedFile.h"
+#include <string.h>
+#include <algorithm>
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+bool RepairBdfFile(const string &filePath, GARANT_EEG_RECORD_REPAIR_RESULT &result)
+{
+    memset(&result, 0, sizeof(result));
+    result.HeaderRecordsCount = -1;
+
+    FILE *file = fopen(filePath.c_str(), "rb");
+
+    if (file == nullptr)
+        return false;
+
+    CBdfHeader header;
+    long long fileSize = -1;
+
+    if (header.Read(file))
+        fileSize = FileSize64(file);
+
+    if (fileSize < header.HeaderSize() || header.HeaderSize() < 1)
+    {
+        fclose(file);
+        return false;
+    }
+
+    const int recordSize = header.RecordSize();
+    long long recordsCount = header.RecordsCountBySize(fileSize);
+
+    //Участок, выделенный с запасом и не заполненный до сбоя, содержит нули. Данные до указанного в заголовке количества
+    //уже были записаны, поэтому проверяются только записи за ним.
+    vector<char> record(recordSize);
+
+    while (recordsCount > std::max(header.RecordsCount(), 0LL))
+    {
+        if (!FileSeek64(file, header.HeaderSize() + (recordsCount - 1) * recordSize) || fread(&record[0], recordSize, 1, file) != 1)
+            break;
+
+        if (std::find_if(record.begin(), record.end(), [](char value){ return (value != 0); }) != record.end())
+            break;
+
+        recordsCount--;
+    }
+
+    fclose(file);
+
+    const long long repairedSize = header.HeaderSize() + recordsCount * recordSize;
+
+    result.HeaderRecordsCount = header.RecordsCount();
+    result.RecordsCount = recordsCount;
+    result.OriginalSize = fileSize;
+    result.RepairedSize = repairedSize;
+
+    if (repairedSize == fileSize && recordsCount == header.RecordsCount())
+        return true;
+
+    CMappedFile output;
+
+    if (!output.Open(filePath, false))
+        return false;
+
+    char recordsCountText[32] = { 0 };
+    sprintf(recordsCountText, "%-8lld", recordsCount);
+
+    bool repaired = (repairedSize == fileSize || output.Truncate(repairedSize));
+    repaired = (repaired && output.WriteAt(BDF_RECORDS_COUNT_OFFSET, &recordsCountText[0], 8) && output.Sync());
+
+    output.Close();
+
+    return repaired;
+}
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
@@ -0,0 +1,32 @@
+/**
+@file BdfRepair.h
+
+@brief Восстановление BDF файла, запись которого не была корректно завершена
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#ifndef BDFREPAIR_H
+#define BDFREPAIR_H
+//----------------------------------------------------------------------------------
+#include <string>
+using std::string;
+//----------------------------------------------------------------------------------
+#include "../GarantEEG_API/include/GarantEEG_API_Types.h"
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+/**
+ * @brief RepairBdfFile Восстановить BDF файл: отбросить недописанную запись данных в конце файла и нулевые записи
+ * за указанным в заголовке количеством (место, выделенное с запасом при RM_MAPPED), исправить количество записей в заголовке
+ * @param filePath Путь к файлу
+ * @param result Результат восстановления
+ * @return true если файл корректен или восстановлен
+ */
+bool RepairBdfFile(const string &filePath, GARANT_EEG_RECORD_REPAIR_RESULT &result);
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
+#endif // BDFREPAIR_H
+//----------------------------------------------------------------------------------
@@ -0,0 +1,641 @@
+/**
+@file BdfWriter.cpp
+
+@brief Класс для асинхронной записи BDF файла отдельным потоком (несколько буферов или отображение файла в память)
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include "BdfWriter.h"
+#include "BdfHeader.h"
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+static double ElapsedMilliseconds(const std::chrono::steady_clock::time_point &start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+//----------------------------------------------------------------------------------
+CBdfWriter::CBdfWriter()
+: m_WrittenSize(0)
+{
+    memset(&m_Statistics, 0, sizeof(m_Statistics));
+}
+//----------------------------------------------------------------------------------
+CBdfWriter::~CBdfWriter()
+{
+    Close();
+}
+//----------------------------------------------------------------------------------
+bool CBdfWriter::Open(const string &filePath, const vector<char> &header, int recordSize, const BDF_WRITER_SETTINGS &settings)
+{
+    if (IsOpened() || header.empty() || recordSize < 1)
+        return false;
+
+    m_Settings = settings;
+    memset(&m_Statistics, 0, sizeof(m_Statistics));
+
+    m_HeaderSize = (int)header.size();
+    m_RecordSize = recordSize;
+    m_RecordsCount = 0;
+    m_Stop = false;
+
+    m_NextCommit = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_Settings.CommitInterval);
+    m_NextSync = std::chrono::steady_clock::now();
+    m_CommittedCount = 0;
+    m_SyncedCount = 0;
+
+    if (m_Settings.Mode == RM_MAPPED)
+    {
+        if (!OpenMapped(filePath, header))
+            return false;
+
+        m_Thread = thread(&CBdfWriter::MappedLoop, this);
+
+        return true;
+    }
+
+    if (m_Settings.BufferRecords < 1)
+        return false;
+
+    if (m_Settings.Mode == RM_COMPRESSED)
+    {
+        if (!m_CompressedFile.Open(filePath, header, m_Settings.ChunkRecords))
+            return false;
+
+        if (m_CompressedFile.RecordSize() != recordSize)
+        {
+            m_CompressedFile.Close();
+            remove(filePath.c_str());
+            return false;
+        }
+    }
+    else
+    {
+        m_File = fopen(filePath.c_str(), "wb");
+
+        if (m_File == nullptr)
+            return false;
+
+        if (fwrite(&header[0], header.size(), 1, m_File) != 1)
+            m_Statistics.WriteErrors++;
+    }
+
+    const int buffersCount = std::max(BDF_WRITER_MIN_BUFFERS_COUNT, std::min(m_Settings.BuffersCount, BDF_WRITER_MAX_BUFFERS_COUNT));
+
+    //Буферы сохраняются между записями, если их размер не изменился
+    m_Buffers.resize(buffersCount);
+    m_FreeBuffers.clear();
+    m_FilledBuffers.clear();
+
+    for (int i = 0; i < buffersCount; i++)
+    {
+        m_Buffers[i].resize((size_t)recordSize * m_Settings.BufferRecords);
+        m_FreeBuffers.push_back(i);
+    }
+
+    m_CurrentBuffer = -1;
+    m_CurrentSize = 0;
+
+    m_Thread = thread(&CBdfWriter::WriterLoop, this);
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+void CBdfWriter::AcquireBuffer()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    if (m_FreeBuffers.empty())
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        m_FreeCondition.wait(lock, [this]{ return !m_FreeBuffers.empty(); });
+
+        double time = ElapsedMilliseconds(start);
+
+        m_Statistics.StallsCount++;
+        m_Statistics.StallTime += time;
+        m_Statistics.MaxStallTime = std::max(m_Statistics.MaxStallTime, time);
+    }
+
+    m_CurrentBuffer = m_FreeBuffers.back();
+    m_FreeBuffers.pop_back();
+    m_CurrentSize = 0;
+}
+//----------------------------------------------------------------------------------
+void CBdfWriter::SubmitBuffer(bool commit)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_FilledBuffers.push_back({ m_CurrentBuffer, m_CurrentSize, commit, m_RecordsCount });
+        m_Statistics.MaxQueueDepth = std::max(m_Statistics.MaxQueueDepth, (int)m_FilledBuffers.size());
+    }
+
+    m_FilledCondition.notify_one();
+
+    m_CurrentBuffer = -1;
+    m_CurrentSize = 0;
+}
+//----------------------------------------------------------------------------------
+void CBdfWriter::Write(const void *record)
+{
+    if (m_Settings.Mode == RM_MAPPED)
+    {
+        if (m_MappedFile.IsOpened())
+            WriteMapped(record);
+
+        return;
+    }
+
+    if (m_File == nullptr && !m_CompressedFile.IsOpened())
+        return;
+
+    if (m_CurrentBuffer < 0)
+        AcquireBuffer();
+
+    memcpy(&m_Buffers[m_CurrentBuffer][m_CurrentSize], record, m_RecordSize);
+    m_CurrentSize += m_RecordSize;
+    m_RecordsCount++;
+
+    const bool filled = (m_CurrentSize + m_RecordSize > (int)m_Buffers[m_CurrentBuffer].size());
+    bool commit = false;
+
+    if (m_Settings.Durability != RD_NONE)
+    {
+        auto now = std::chrono::steady_clock::now();
+
+        //Неполный буфер передается на запись, чтобы заголовок не отставал от данных больше чем на интервал обновления
+        if (now >= m_NextCommit)
+        {
+            //Время следующей передачи отсчитывается от расписания, чтобы интервал не удлинялся до следующего пакета
+            commit = true;
+            m_NextCommit += std::chrono::milliseconds(m_Settings.CommitInterval);
+
+            if (m_NextCommit <= now)
+                m_NextCommit = now + std::chrono::milliseconds(m_Settings.CommitInterval);
+        }
+    }
+
+    if (filled || commit)
+        SubmitBuffer(commit);
+}
+//----------------------------------------------------------------------------------
+void CBdfWriter::Commit()
+{
+    //RM_MAPPED: данные уже в файле, заголовок обновляет поток записи по времени
+    if ((m_File == nullptr && !m_CompressedFile.IsOpened()) || m_Settings.Durability == RD_NONE || m_CurrentBuffer < 0 || m_CurrentSize < 1)
+        return;
+
+    SubmitBuffer(true);
+    m_NextCommit = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_Settings.CommitInterval);
+}
+//----------------------------------------------------------------------------------
+void CBdfWriter::WriterLoop()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    while (true)
+    {
+        m_FilledCondition.wait(lock, [this]{ return (m_Stop || !m_FilledBuffers.empty()); });
+
+        if (m_FilledBuffers.empty())
+            break;
+
+        FILLED_BUFFER buffer = m_FilledBuffers.front();
+        m_FilledBuffers.pop_front();
+
+        lock.unlock();
+
+        auto start = std::chrono::steady_clock::now();
+        long long size = buffer.Size;
+        bool written = false;
+
+        if (m_File != nullptr)
+            written = (fwrite(&m_Buffers[buffer.Index][0], buffer.Size, 1, m_File) == 1);
+        else
+        {
+            //Блоки сжимаются и пишутся по мере заполнения, неполный блок остается до следующего буфера
+            size = m_CompressedFile.Size();
+            written = m_CompressedFile.Write(&m_Buffers[buffer.Index][0], buffer.Size / m_RecordSize);
+            size = m_CompressedFile.Size() - size;
+        }
+
+        double time = ElapsedMilliseconds(start);
+
+        lock.lock();
+
+        m_Statistics.BuffersWritten++;
+        m_Statistics.WriteTime += time;
+        m_Statistics.MaxWriteTime = std::max(m_Statistics.MaxWriteTime, time);
+
+        if (written)
+            m_Statistics.BytesWritten += size;
+        else
+            m_Statistics.WriteErrors++;
+
+        m_FreeBuffers.push_back(buffer.Index);
+        m_FreeCondition.notify_one();
+
+        //После ошибки записи заголовок больше не обновляется, чтобы не указывать на недописанные данные
+        if (buffer.Commit && m_Statistics.WriteErrors == 0)
+            CommitHeader(lock, buffer.RecordsCount);
+    }
+}
+//----------------------------------------------------------------------------------
+bool CBdfWriter::WriteRecordsCount(long long recordsCount)
+{
+    char recordsCountText[32] = { 0 };
+    sprintf(recordsCountText, "%-8lld", recordsCount);
+
+    if (m_Settings.Mode == RM_MAPPED)
+        return m_MappedFile.WriteAt(BDF_RECORDS_COUNT_OFFSET, &recordsCountText[0], 8);
+
+    //GCR: количество записей и оглавление записываются при закрытии, до этого блоки находятся просмотром файла
+    if (m_Settings.Mode == RM_COMPRESSED)
+        return true;
+
+    //После записи заголовка позиция возвращается в конец данных (смена позиции передает буфер файла системе)
+    const long long position = FileTell64(m_File);
+    bool written = (position >= 0 && FileSeek64(m_File, BDF_RECORDS_COUNT_OFFSET) && fwrite(&recordsCountText[0], 8, 1, m_File) == 1);
+
+    if (position >= 0 && !FileSeek64(m_File, position))
+        written = false;
+
+    return written;
+}
+//----------------------------------------------------------------------------------
+void CBdfWriter::CommitHeader(std::unique_lock<std::mutex> &lock, long long recordsCount)
+{
+    //Запись на диск выполняется при обновлении, ближайшем к сроку, чтобы задержка пакетов не пропускала интервал целиком
+    const auto now = std::chrono::steady_clock::now();
+    const bool sync = (m_Settings.Durability == RD_SYNC && recordsCount != m_SyncedCount && now + std::chrono::milliseconds(m_Settings.CommitInterval / 2) >= m_NextSync);
+
+    //RD_SYNC: заголовок обновляется только после записи данных на диск, иначе после отключения питания он может указывать на потерянные данные
+    const bool update = (recordsCount != m_CommittedCount && (m_Settings.Durability != RD_SYNC || sync));
+
+    lock.unlock();
+
+    bool committed = true;
+    double syncTime = 0.0;
+
+    if (sync)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        if (m_File != nullptr)
+            committed = FileSync(m_File);
+        else if (m_CompressedFile.IsOpened())
+            committed = m_CompressedFile.Sync();
+        else
+            committed = m_MappedFile.Sync();
+
+        syncTime = ElapsedMilliseconds(start);
+    }
+    else if (m_File != nullptr)
+        committed = (fflush(m_File) == 0);
+    else if (m_CompressedFile.IsOpened())
+        committed = m_CompressedFile.Flush();
+
+    if (committed && update)
+        committed = WriteRecordsCount(recordsCount);
+
+    lock.lock();
+
+    if (!committed)
+    {
+        m_Statistics.WriteErrors++;
+        return;
+    }
+
+    if (sync)
+    {
+        m_SyncedCount = recordsCount;
+        m_NextSync = now + std::chrono::milliseconds(m_Settings.SyncInterval);
+
+        m_Statistics.SyncsCount++;
+        m_Statistics.SyncTime += syncTime;
+        m_Statistics.MaxSyncTime = std::max(m_Statistics.MaxSyncTime, syncTime);
+    }
+
+    if (update)
+    {
+        m_CommittedCount = recordsCount;
+        m_Statistics.CommitsCount++;
+    }
+}
+//----------------------------------------------------------------------------------
+bool CBdfWriter::OpenMapped(const string &filePath, const vector<char> &header)
+{
+    if ((int)header.size() > BDF_WRITER_MAPPED_EXTENT_SIZE || BDF_WRITER_MAPPED_EXTENT_SIZE % CMappedFile::AllocationGranularity() != 0)
+        return false;
+
+    if (!m_MappedFile.Create(filePath))
+        return false;
+
+    char *data = nullptr;
+
+    if (m_MappedFile.Allocate(BDF_WRITER_MAPPED_EXTENT_SIZE))
+        data = m_MappedFile.Map(0, BDF_WRITER_MAPPED_EXTENT_SIZE, true);
+
+    if (data == nullptr)
+    {
+        m_MappedFile.Close();
+        remove(filePath.c_str());
+        return false;
+    }
+
+    memcpy(data, &header[0], header.size());
+
+    m_Views.clear();
+    m_Views.push_back({ data, 0 });
+
+    m_ViewData = data;
+    m_ViewOffset = 0;
+    m_ViewPosition = (int)header.size();
+    m_NextViewReady = false;
+    m_MapFailed = false;
+    m_WrittenSize = (long long)header.size();
+    m_FlushedSize = 0;
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+bool CBdfWriter::AcquireView()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    if (!m_NextViewReady && !m_MapFailed)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        m_FreeCondition.wait(lock, [this]{ return (m_NextViewReady || m_MapFailed); });
+
+        double time = ElapsedMilliseconds(start);
+
+        m_Statistics.StallsCount++;
+        m_Statistics.StallTime += time;
+        m_Statistics.MaxStallTime = std::max(m_Statistics.MaxStallTime, time);
+    }
+
+    if (!m_NextViewReady)
+        return false;
+
+    //Следующий участок всегда последний в списке, поток записи сразу начинает готовить новый
+    m_ViewData = m_Views.back().Data;
+    m_ViewOffset = m_Views.back().Offset;
+    m_ViewPosition = 0;
+    m_NextViewReady = false;
+
+    lock.unlock();
+    m_FilledCondition.notify_one();
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+void CBdfWriter::WriteMapped(const void *record)
+{
+    const char *data = (const char*)record;
+    int size = m_RecordSize;
+
+    while (size > 0)
+    {
+        if (m_ViewPosition == BDF_WRITER_MAPPED_EXTENT_SIZE && !AcquireView())
+        {
+            //Место на диске не выделено: запись данных теряется, размер файла остается по последней целой записи
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Statistics.WriteErrors++;
+            return;
+        }
+
+        int count = std::min(size, BDF_WRITER_MAPPED_EXTENT_SIZE - m_ViewPosition);
+        memcpy(m_ViewData + m_ViewPosition, data, count);
+
+        m_ViewPosition += count;
+        data += count;
+        size -= count;
+    }
+
+    m_RecordsCount++;
+    m_WrittenSize.store(m_ViewOffset + m_ViewPosition, std::memory_order_release);
+}
+//----------------------------------------------------------------------------------
+void CBdfWriter::PrepareView(std::unique_lock<std::mutex> &lock)
+{
+    long long offset = m_Views.back().Offset + BDF_WRITER_MAPPED_EXTENT_SIZE;
+
+    lock.unlock();
+
+    auto start = std::chrono::steady_clock::now();
+    char *data = nullptr;
+
+    if (m_MappedFile.Allocate(offset + BDF_WRITER_MAPPED_EXTENT_SIZE))
+        data = m_MappedFile.Map(offset, BDF_WRITER_MAPPED_EXTENT_SIZE, true);
+
+    double time = ElapsedMilliseconds(start);
+
+    lock.lock();
+
+    m_Statistics.WriteTime += time;
+    m_Statistics.MaxWriteTime = std::max(m_Statistics.MaxWriteTime, time);
+
+    if (data != nullptr)
+    {
+        m_Views.push_back({ data, offset });
+        m_NextViewReady = true;
+    }
+    else
+        m_MapFailed = true;
+
+    m_FreeCondition.notify_one();
+}
+//----------------------------------------------------------------------------------
+void CBdfWriter::FlushViews(std::unique_lock<std::mutex> &lock)
+{
+    const long long writtenSize = m_WrittenSize.load(std::memory_order_acquire);
+
+    if (writtenSize <= m_FlushedSize)
+        return;
+
+    //Полностью записанные участки больше не нужны потоку приема: он переходит на следующий участок до записи в него
+    vector<MAPPED_VIEW> views(m_Views.begin(), m_Views.end());
+    size_t retiredCount = 0;
+
+    while (retiredCount < m_Views.size() && m_Views[retiredCount].Offset + BDF_WRITER_MAPPED_EXTENT_SIZE <= writtenSize)
+        retiredCount++;
+
+    m_Views.erase(m_Views.begin(), m_Views.begin() + retiredCount);
+
+    lock.unlock();
+
+    auto start = std::chrono::steady_clock::now();
+    bool flushed = true;
+
+    for (size_t i = 0; i < views.size(); i++)
+    {
+        const long long first = std::max(m_FlushedSize, views[i].Offset);
+        const long long last = std::min(writtenSize, views[i].Offset + BDF_WRITER_MAPPED_EXTENT_SIZE);
+
+        if (first < last)
+            flushed &= m_MappedFile.Flush(views[i].Data + (first - views[i].Offset), (int)(last - first));
+
+        if (i < retiredCount)
+            m_MappedFile.Unmap(views[i].Data, BDF_WRITER_MAPPED_EXTENT_SIZE);
+    }
+
+    double time = ElapsedMilliseconds(start);
+
+    lock.lock();
+
+    m_Statistics.BuffersWritten++;
+    m_Statistics.WriteTime += time;
+    m_Statistics.MaxWriteTime = std::max(m_Statistics.MaxWriteTime, time);
+
+    if (flushed)
+        m_Statistics.BytesWritten += writtenSize - m_FlushedSize;
+    else
+        m_Statistics.WriteErrors++;
+
+    m_FlushedSize = writtenSize;
+}
+//----------------------------------------------------------------------------------
+void CBdfWriter::MappedLoop()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    const auto interval = std::chrono::milliseconds(std::max(1, m_Settings.FlushInterval));
+    auto nextFlush = std::chrono::steady_clock::now() + interval;
+
+    const bool durable = (m_Settings.Durability != RD_NONE);
+    const auto commitInterval = std::chrono::milliseconds(std::max(1, m_Settings.CommitInterval));
+    auto nextCommit = std::chrono::steady_clock::now() + commitInterval;
+
+    while (true)
+    {
+        if (!m_Stop && !m_NextViewReady && !m_MapFailed)
+        {
+            PrepareView(lock);
+            continue;
+        }
+
+        m_FilledCondition.wait_until(lock, (durable ? std::min(nextFlush, nextCommit) : nextFlush), [this]{ return (m_Stop || (!m_NextViewReady && !m_MapFailed)); });
+
+        const auto now = std::chrono::steady_clock::now();
+        const bool commit = (durable && !m_Stop && now >= nextCommit);
+
+        if (m_Stop || commit || now >= nextFlush)
+        {
+            FlushViews(lock);
+            nextFlush = std::chrono::steady_clock::now() + interval;
+        }
+
+        if (commit)
+        {
+            //Сброшенный размер всегда соответствует целому количеству записей данных
+            if (m_Statistics.WriteErrors == 0)
+                CommitHeader(lock, (m_FlushedSize - m_HeaderSize) / m_RecordSize);
+
+            nextCommit = std::chrono::steady_clock::now() + commitInterval;
+        }
+
+        if (m_Stop)
+            break;
+    }
+}
+//----------------------------------------------------------------------------------
+int CBdfWriter::CloseMapped()
+{
+    int errors = 0;
+
+    for (const MAPPED_VIEW &view : m_Views)
+        m_MappedFile.Unmap(view.Data, BDF_WRITER_MAPPED_EXTENT_SIZE);
+
+    m_Views.clear();
+    m_ViewData = nullptr;
+
+    //Место, выделенное с запасом за последней записью данных, отбрасывается
+    if (!m_MappedFile.Truncate(m_WrittenSize.load()))
+        errors++;
+
+    if (m_RecordsCount > 0 && !WriteRecordsCount(m_RecordsCount))
+        errors++;
+
+    if (m_Settings.Durability == RD_SYNC && !m_MappedFile.Sync())
+        errors++;
+
+    m_MappedFile.Close();
+
+    return errors;
+}
+//----------------------------------------------------------------------------------
+bool CBdfWriter::Close()
+{
+    if (!IsOpened())
+        return false;
+
+    if (m_CurrentBuffer >= 0)
+    {
+        if (m_CurrentSize > 0)
+            SubmitBuffer(false);
+        else
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_FreeBuffers.push_back(m_CurrentBuffer);
+            m_CurrentBuffer = -1;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+
+    m_FilledCondition.notify_one();
+
+    if (m_Thread.joinable())
+        m_Thread.join();
+
+    int errors = 0;
+
+    if (m_Settings.Mode == RM_MAPPED)
+        errors = CloseMapped();
+    else if (m_Settings.Mode == RM_COMPRESSED)
+    {
+        if (!m_CompressedFile.Close(m_Settings.Durability == RD_SYNC))
+            errors++;
+    }
+    else
+    {
+        if (m_RecordsCount > 0 && !WriteRecordsCount(m_RecordsCount))
+            errors++;
+
+        if (!(m_Settings.Durability == RD_SYNC ? FileSync(m_File) : fflush(m_File) == 0))
+            errors++;
+
+        fclose(m_File);
+        m_File = nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    m_Statistics.WriteErrors += errors;
+    m_Statistics.RecordsCount = m_RecordsCount;
+
+    return (m_Statistics.WriteErrors == 0);
+}
+//----------------------------------------------------------------------------------
+void CBdfWriter::GetStatistics(GARANT_EEG_RECORDING_STATISTICS &statistics)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    statistics = m_Statistics;
+    statistics.RecordsCount = m_RecordsCount;
+}
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
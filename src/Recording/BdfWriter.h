@@ -0,0 +1,335 @@
+/**
+@file BdfWriter.h
+
+@brief Класс для асинхронной записи BDF файла отдельным потоком (несколько буферов или отображение файла в память)
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#ifndef BDFWRITER_H
+#define BDFWRITER_H
+//----------------------------------------------------------------------------------
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include <deque>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+using std::thread;
+
+#include <chrono>
+
+#include <stdio.h>
+//----------------------------------------------------------------------------------
+#include "../GarantEEG_API/include/GarantEEG_API_Types.h"
+#include "MappedFile.h"
+#include "GcrFile.h"
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+//! Количество буферов записи по умолчанию (один заполняется, один пишется, один в запасе)
+const int BDF_WRITER_DEFAULT_BUFFERS_COUNT = 3;
+
+//! Минимальное количество буферов записи
+const int BDF_WRITER_MIN_BUFFERS_COUNT = 2;
+
+//! Максимальное количество буферов записи
+const int BDF_WRITER_MAX_BUFFERS_COUNT = 8;
+
+//! Размер участка файла, выделяемого и отображаемого за один раз (RM_MAPPED, кратен гранулярности отображения Windows)
+const int BDF_WRITER_MAPPED_EXTENT_SIZE = 32 * 1024 * 1024;
+//----------------------------------------------------------------------------------
+//! Настройки записи BDF файла
+struct BDF_WRITER_SETTINGS
+{
+	//! Способ записи из GARANT_EEG_RECORDING_MODE
+    int Mode = RM_BUFFERED;
+
+	//! Количество буферов записи (RM_BUFFERED, RM_COMPRESSED)
+    int BuffersCount = BDF_WRITER_DEFAULT_BUFFERS_COUNT;
+
+	//! Количество записей данных в одном буфере (RM_BUFFERED, RM_COMPRESSED)
+    int BufferRecords = 50;
+
+	//! Количество записей данных в одном блоке сжатого файла (RM_COMPRESSED)
+    int ChunkRecords = GCR_DEFAULT_CHUNK_RECORDS;
+
+	//! Интервал асинхронного сброса данных на диск в миллисекундах (RM_MAPPED)
+    int FlushInterval = 1000;
+
+	//! Политика сохранности из GARANT_EEG_RECORDING_DURABILITY
+    int Durability = RD_NONE;
+
+	//! Интервал обновления количества записей в заголовке в миллисекундах (RD_COMMIT, RD_SYNC)
+    int CommitInterval = 1000;
+
+	//! Минимальный интервал между принудительными записями на диск в миллисекундах (RD_SYNC)
+    int SyncInterval = 10000;
+};
+//----------------------------------------------------------------------------------
+//! Класс для записи BDF файла отдельным потоком.
+//! RM_BUFFERED: поток приема копирует записи данных в буфер и передает заполненные буферы потоку записи,
+//! ждет только если все буферы в очереди на запись (ожидания учитываются в статистике).
+//! RM_MAPPED: поток приема копирует записи данных прямо в отображенный участок файла, поток записи заранее
+//! выделяет и отображает следующий участок, периодически сбрасывает данные на диск и освобождает заполненные участки.
+//! RM_COMPRESSED: как RM_BUFFERED, поток записи сжимает буферы блоками GCR (CGcrWriter).
+//! RD_COMMIT, RD_SYNC: количество записей в заголовке периодически обновляется и указывает только на данные, уже переданные
+//! системе (RD_COMMIT, файл корректен после сбоя программы) или уже записанные на диск (RD_SYNC, также после отключения питания).
+//! При RM_COMPRESSED вместо обновления заголовка дописывается неполный блок: файл без оглавления читается до последнего целого блока.
+class CBdfWriter
+{
+private:
+	//! Заполненный буфер в очереди записи
+    struct FILLED_BUFFER
+    {
+		//! Индекс буфера
+        int Index;
+
+		//! Размер данных
+        int Size;
+
+		//! Флаг обновления заголовка после записи буфера
+        bool Commit;
+
+		//! Количество записей данных в файле после записи буфера
+        long long RecordsCount;
+    };
+
+	//! Отображенный участок файла (RM_MAPPED)
+    struct MAPPED_VIEW
+    {
+		//! Данные участка
+        char *Data;
+
+		//! Смещение участка в файле
+        long long Offset;
+    };
+
+	//! Настройки записи
+    BDF_WRITER_SETTINGS m_Settings;
+
+	//! Файл записи (RM_BUFFERED)
+    FILE *m_File = nullptr;
+
+	//! Файл записи (RM_MAPPED)
+    CMappedFile m_MappedFile;
+
+	//! Файл записи (RM_COMPRESSED)
+    CGcrWriter m_CompressedFile;
+
+	//! Отображенные участки в порядке смещений, включая текущий и подготовленный следующий (RM_MAPPED)
+    std::deque<MAPPED_VIEW> m_Views;
+
+	//! Данные текущего участка (RM_MAPPED, только поток приема)
+    char *m_ViewData = nullptr;
+
+	//! Смещение текущего участка в файле (RM_MAPPED, только поток приема)
+    long long m_ViewOffset = 0;
+
+	//! Позиция записи в текущем участке (RM_MAPPED, только поток приема)
+    int m_ViewPosition = 0;
+
+	//! Флаг готовности следующего участка (RM_MAPPED)
+    bool m_NextViewReady = false;
+
+	//! Флаг ошибки выделения следующего участка (RM_MAPPED)
+    bool m_MapFailed = false;
+
+	//! Размер записанных данных файла вместе с заголовком (RM_MAPPED, публикуется потоком приема)
+    std::atomic<long long> m_WrittenSize;
+
+	//! Размер сброшенных на диск данных файла (RM_MAPPED, только поток записи)
+    long long m_FlushedSize = 0;
+
+	//! Поток записи
+    thread m_Thread;
+
+	//! Мьютекс доступа к очередям и статистике
+    std::mutex m_Mutex;
+
+	//! Условие появления заполненного буфера или остановки
+    std::condition_variable m_FilledCondition;
+
+	//! Условие освобождения буфера
+    std::condition_variable m_FreeCondition;
+
+	//! Буферы записи
+    vector<vector<char>> m_Buffers;
+
+	//! Свободные буферы
+    vector<int> m_FreeBuffers;
+
+	//! Заполненные буферы в порядке записи
+    std::deque<FILLED_BUFFER> m_FilledBuffers;
+
+	//! Индекс заполняемого буфера (-1 если не взят)
+    int m_CurrentBuffer = -1;
+
+	//! Размер данных в заполняемом буфере
+    int m_CurrentSize = 0;
+
+	//! Размер заголовка
+    int m_HeaderSize = 0;
+
+	//! Размер одной записи данных
+    int m_RecordSize = 0;
+
+	//! Количество переданных на запись записей данных
+    long long m_RecordsCount = 0;
+
+	//! Флаг остановки потока записи
+    bool m_Stop = false;
+
+	//! Время следующей передачи неполного буфера с обновлением заголовка (RM_BUFFERED, RM_COMPRESSED, только поток приема)
+    std::chrono::steady_clock::time_point m_NextCommit;
+
+	//! Время, после которого разрешена следующая принудительная запись на диск (только поток записи)
+    std::chrono::steady_clock::time_point m_NextSync;
+
+	//! Количество записей данных, указанное в заголовке при последнем обновлении (только поток записи)
+    long long m_CommittedCount = 0;
+
+	//! Количество записей данных, записанных на диск при последней принудительной записи (только поток записи)
+    long long m_SyncedCount = 0;
+
+	//! Статистика записи
+    GARANT_EEG_RECORDING_STATISTICS m_Statistics;
+
+	/**
+	 * @brief WriterLoop Функция потока записи (RM_BUFFERED, RM_COMPRESSED)
+	 */
+    void WriterLoop();
+
+	/**
+	 * @brief MappedLoop Функция потока записи (RM_MAPPED)
+	 */
+    void MappedLoop();
+
+	/**
+	 * @brief PrepareView Выделить и отобразить следующий участок файла (RM_MAPPED, поток записи)
+	 * @param lock Захваченный m_Mutex (освобождается на время работы с файлом)
+	 */
+    void PrepareView(std::unique_lock<std::mutex> &lock);
+
+	/**
+	 * @brief FlushViews Сбросить записанные данные на диск и освободить заполненные участки (RM_MAPPED, поток записи)
+	 * @param lock Захваченный m_Mutex (освобождается на время работы с файлом)
+	 */
+    void FlushViews(std::unique_lock<std::mutex> &lock);
+
+	/**
+	 * @brief WriteRecordsCount Записать количество записей данных в заголовок файла
+	 * @param recordsCount Количество записей
+	 * @return true если успешно
+	 */
+    bool WriteRecordsCount(long long recordsCount);
+
+	/**
+	 * @brief CommitHeader Передать записанные данные системе (при необходимости записать на диск) и обновить количество записей в заголовке (поток записи)
+	 * @param lock Захваченный m_Mutex (освобождается на время работы с файлом)
+	 * @param recordsCount Количество записей данных, полностью записанных в файл
+	 */
+    void CommitHeader(std::unique_lock<std::mutex> &lock, long long recordsCount);
+
+	/**
+	 * @brief AcquireView Перейти на следующий участок файла (с ожиданием, если он еще не готов)
+	 * @return true если участок получен, false если выделить участок не удалось
+	 */
+    bool AcquireView();
+
+	/**
+	 * @brief OpenMapped Создать файл с отображением в память и записать заголовок
+	 * @return true если файл создан
+	 */
+    bool OpenMapped(const string &filePath, const vector<char> &header);
+
+	/**
+	 * @brief WriteMapped Скопировать запись данных в отображенный файл
+	 * @param record Указатель на запись данных
+	 */
+    void WriteMapped(const void *record);
+
+	/**
+	 * @brief CloseMapped Освободить участки, установить точный размер файла и исправить количество записей в заголовке
+	 * @return Количество ошибок
+	 */
+    int CloseMapped();
+
+	/**
+	 * @brief AcquireBuffer Взять свободный буфер для заполнения (с ожиданием, если свободных нет)
+	 */
+    void AcquireBuffer();
+
+	/**
+	 * @brief SubmitBuffer Передать заполняемый буфер потоку записи
+	 * @param commit Обновить заголовок после записи буфера
+	 */
+    void SubmitBuffer(bool commit);
+
+public:
+	/**
+	 * @brief CBdfWriter Конструктор
+	 */
+    CBdfWriter();
+
+	/**
+	 * @brief ~CBdfWriter Деструктор
+	 */
+    ~CBdfWriter();
+
+	/**
+	 * @brief Open Создать файл, записать заголовок и запустить поток записи
+	 * @param filePath Путь к файлу
+	 * @param header Данные заголовка BDF
+	 * @param recordSize Размер одной записи данных
+	 * @param settings Настройки записи
+	 * @return true если файл создан
+	 */
+    bool Open(const string &filePath, const vector<char> &header, int recordSize, const BDF_WRITER_SETTINGS &settings);
+
+	/**
+	 * @brief Write Добавить запись данных (копируется в текущий буфер или участок файла)
+	 * @param record Указатель на запись данных размером recordSize
+	 */
+    void Write(const void *record);
+
+	/**
+	 * @brief Commit Передать неполный буфер на запись с обновлением заголовка (RD_COMMIT, RD_SYNC; например, при паузе записи, когда новых записей нет)
+	 */
+    void Commit();
+
+	/**
+	 * @brief Close Дописать оставшиеся данные, остановить поток записи, исправить количество записей в заголовке и закрыть файл
+	 * @return true если все данные записаны без ошибок
+	 */
+    bool Close();
+
+	/**
+	 * @brief IsOpened Проверить, открыт ли файл
+	 * @return true если открыт
+	 */
+    bool IsOpened() const { return (m_File != nullptr || m_MappedFile.IsOpened() || m_CompressedFile.IsOpened()); }
+
+	/**
+	 * @brief RecordsCount Получить количество переданных на запись записей данных
+	 * @return Количество записей
+	 */
+    long long RecordsCount() const { return m_RecordsCount; }
+
+	/**
+	 * @brief GetStatistics Получить статистику записи (текущей или последней)
+	 * @param statistics Ссылка на статистику
+	 */
+    void GetStatistics(GARANT_EEG_RECORDING_STATISTICS &statistics);
+};
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
+#endif // BDFWRITER_H
+//----------------------------------------------------------------------------------
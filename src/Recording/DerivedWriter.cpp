@@ -0,0 +1,108 @@
+/**
+@file DerivedWriter.cpp
+
+@brief Класс для записи производных сигналов (отфильтрованные каналы, другой референт, пониженная частота) в дополнительный файл
+с той же шкалой времени, что и исходная запись
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include "DerivedWriter.h"
+#include <math.h>
+#include <algorithm>
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+bool CDerivedWriter::Open(const string &filePath, const vector<char> &sourceHeader, const vector<BDF_SIGNAL_TEMPLATE> &signals, const BDF_WRITER_SETTINGS &settings, long long segmentRecords)
+{
+    vector<char> header;
+
+    if (IsOpened() || !MakeBdfHeader(sourceHeader, signals, header))
+        return false;
+
+    const int signalsCount = (int)signals.size();
+    int recordSize = 0;
+
+    m_SamplesPerRecord.resize(signalsCount);
+    m_Offsets.resize(signalsCount);
+    m_Pending.assign(signalsCount, vector<int>());
+
+    for (int i = 0; i < signalsCount; i++)
+    {
+        m_SamplesPerRecord[i] = signals[i].SamplesPerRecord;
+        m_Offsets[i] = recordSize;
+        m_Pending[i].reserve((size_t)signals[i].SamplesPerRecord * 2);
+
+        recordSize += signals[i].SamplesPerRecord * 3;
+    }
+
+    m_Record.resize(recordSize);
+
+    return m_Writer.Open(filePath, header, recordSize, settings, segmentRecords, nullptr, nullptr, true);
+}
+//----------------------------------------------------------------------------------
+void CDerivedWriter::Append(int signal, const double *samples, int count, int stride, double scale)
+{
+    if (signal < 0 || signal >= (int)m_Pending.size() || count < 1)
+        return;
+
+    vector<int> &pending = m_Pending[signal];
+    const double factor = 1.0 / scale;
+
+    for (int i = 0; i < count; i++, samples += stride)
+    {
+        double value = floor(*samples * factor + 0.5);
+
+        //Значение за пределами 24 бит ограничивается, как при насыщении АЦП
+        value = std::max(-8388608.0, std::min(8388607.0, value));
+        pending.push_back((int)value);
+    }
+
+    //Если другой сигнал перестал поступать, старые отсчеты отбрасываются, чтобы не накапливать их без ограничения
+    const int limit = m_SamplesPerRecord[signal] * DERIVED_WRITER_MAX_PENDING_RECORDS;
+
+    if ((int)pending.size() > limit)
+        pending.erase(pending.begin(), pending.end() - limit);
+}
+//----------------------------------------------------------------------------------
+void CDerivedWriter::Write()
+{
+    if (!IsOpened())
+        return;
+
+    const int signalsCount = (int)m_Pending.size();
+
+    while (true)
+    {
+        for (int i = 0; i < signalsCount; i++)
+        {
+            if ((int)m_Pending[i].size() < m_SamplesPerRecord[i])
+                return;
+        }
+
+        for (int i = 0; i < signalsCount; i++)
+        {
+            vector<int> &pending = m_Pending[i];
+            unsigned char *dest = &m_Record[m_Offsets[i]];
+
+            for (int j = 0; j < m_SamplesPerRecord[i]; j++, dest += 3)
+                Pack24BitValue(dest, pending[j]);
+
+            pending.erase(pending.begin(), pending.begin() + m_SamplesPerRecord[i]);
+        }
+
+        m_Writer.Write(&m_Record[0]);
+    }
+}
+//----------------------------------------------------------------------------------
+bool CDerivedWriter::Close()
+{
+    for (vector<int> &pending : m_Pending)
+        pending.clear();
+
+    return m_Writer.Close();
+}
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
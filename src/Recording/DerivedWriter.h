@@ -0,0 +1,121 @@
+/**
+@file DerivedWriter.h
+
+@brief Класс для записи производных сигналов (отфильтрованные каналы, другой референт, пониженная частота) в дополнительный файл
+с той же шкалой времени, что и исходная запись
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#ifndef DERIVEDWRITER_H
+#define DERIVEDWRITER_H
+//----------------------------------------------------------------------------------
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+//----------------------------------------------------------------------------------
+#include "BdfHeader.h"
+#include "SegmentedWriter.h"
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+//! Максимальное количество записей данных, накапливаемых для одного сигнала, пока остальные сигналы отстают
+const int DERIVED_WRITER_MAX_PENDING_RECORDS = 50;
+//----------------------------------------------------------------------------------
+//! Класс для записи производных сигналов. Длительность записи данных - как у исходного файла, отсчеты каждого сигнала
+//! накапливаются, и запись данных передается CSegmentedWriter, как только у всех сигналов набралось по записи
+//! (количество отсчетов от фрэйма к фрэйму может меняться, например, после понижения частоты).
+//! Цифровые значения - отсчеты в шаге АЦП исходного сигнала, поэтому диапазоны в заголовке копируются из исходного сигнала.
+//! Все функции, кроме GetStatistics, вызываются из одного потока (или под общей блокировкой).
+class CDerivedWriter
+{
+private:
+	//! Асинхронная запись файла (сегменты меняются на границах, переданных AddSegmentBoundary при смене сегмента исходной записи)
+    CSegmentedWriter m_Writer;
+
+	//! Количество отсчетов сигналов в одной записи данных
+    vector<int> m_SamplesPerRecord;
+
+	//! Смещения сигналов в записи данных (в байтах)
+    vector<int> m_Offsets;
+
+	//! Накопленные отсчеты сигналов
+    vector<vector<int>> m_Pending;
+
+	//! Собираемая запись данных
+    vector<unsigned char> m_Record;
+
+public:
+	/**
+	 * @brief CDerivedWriter Конструктор
+	 */
+    CDerivedWriter() {}
+
+	/**
+	 * @brief ~CDerivedWriter Деструктор
+	 */
+    ~CDerivedWriter() {}
+
+	/**
+	 * @brief Open Собрать заголовок, создать файл и запустить поток записи
+	 * @param filePath Путь к файлу
+	 * @param sourceHeader Данные заголовка исходной записи
+	 * @param signals Производные сигналы
+	 * @param settings Настройки записи
+	 * @param segmentRecords Ожидаемое количество записей данных в одном сегменте (0 - без сегментации)
+	 * @return true если файл создан
+	 */
+    bool Open(const string &filePath, const vector<char> &sourceHeader, const vector<BDF_SIGNAL_TEMPLATE> &signals, const BDF_WRITER_SETTINGS &settings, long long segmentRecords);
+
+	/**
+	 * @brief Append Добавить отсчеты сигнала
+	 * @param signal Индекс производного сигнала
+	 * @param samples Отсчеты
+	 * @param count Количество отсчетов
+	 * @param stride Шаг между отсчетами (в элементах)
+	 * @param scale Физическое значение шага АЦП (отсчеты делятся на него и округляются)
+	 */
+    void Append(int signal, const double *samples, int count, int stride, double scale);
+
+	/**
+	 * @brief Write Передать на запись все записи данных, для которых накоплены отсчеты всех сигналов
+	 */
+    void Write();
+
+	/**
+	 * @brief AddSegmentBoundary Сообщить о смене сегмента исходной записи (следующий сегмент этого файла начнется с той же секунды)
+	 * @param firstRecord Номер записи данных этого файла, соответствующей первой записи нового сегмента исходной записи
+	 */
+    void AddSegmentBoundary(long long firstRecord) { m_Writer.AddSegmentBoundary(firstRecord); }
+
+	/**
+	 * @brief Commit Передать неполный буфер на запись с обновлением заголовка (см. CBdfWriter::Commit)
+	 */
+    void Commit() { m_Writer.Commit(); }
+
+	/**
+	 * @brief Close Дописать данные и закрыть файл (неполная запись данных отбрасывается)
+	 * @return true если все данные записаны без ошибок
+	 */
+    bool Close();
+
+	/**
+	 * @brief IsOpened Проверить, открыт ли файл
+	 * @return true если открыт
+	 */
+    bool IsOpened() const { return m_Writer.IsOpened(); }
+
+	/**
+	 * @brief GetStatistics Получить статистику записи
+	 * @param statistics Ссылка на статистику
+	 */
+    void GetStatistics(GARANT_EEG_RECORDING_STATISTICS &statistics) { m_Writer.GetStatistics(statistics); }
+};
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
+#endif // DERIVEDWRITER_H
+//----------------------------------------------------------------------------------
@@ -0,0 +1,87 @@
+/**
+@file GcrConvert.cpp
+
+@brief Преобразование записей между форматами BDF и GCR (сжатие без потерь)
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include "GcrConvert.h"
+#include "BdfReader.h"
+#include <algorithm>
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+bool CompressBdfFile(const string &bdfPath, const string &gcrPath, int chunkRecords)
+{
+    CBdfReader reader;
+
+    if (!reader.Open(bdfPath))
+        return false;
+
+    //Заголовок переносится без изменений, разобранный заголовок читателя не хранит исходных данных
+    vector<char> header(reader.Header().HeaderSize());
+    FILE *file = fopen(bdfPath.c_str(), "rb");
+
+    if (file == nullptr)
+        return false;
+
+    bool headerRead = (fread(&header[0], header.size(), 1, file) == 1);
+    fclose(file);
+
+    CGcrWriter writer;
+
+    if (!headerRead || !writer.Open(gcrPath, header, chunkRecords))
+        return false;
+
+    const int recordSize = reader.Header().RecordSize();
+    const long long recordsCount = reader.RecordsCount();
+    vector<char> buffer((size_t)chunkRecords * recordSize);
+    bool written = true;
+
+    //Записи копируются блоками: участки отображения читателя могут быть вытеснены при переходе к следующим
+    for (long long first = 0; first < recordsCount && written; first += chunkRecords)
+    {
+        const int count = (int)std::min((long long)chunkRecords, recordsCount - first);
+
+        written = (reader.ReadRecords(first, count, &buffer[0]) == count && writer.Write(&buffer[0], count));
+    }
+
+    return (writer.Close() && written);
+}
+//----------------------------------------------------------------------------------
+bool DecompressGcrFile(const string &gcrPath, const string &bdfPath)
+{
+    CGcrReader reader;
+
+    if (!reader.Open(gcrPath))
+        return false;
+
+    FILE *file = fopen(bdfPath.c_str(), "wb");
+
+    if (file == nullptr)
+        return false;
+
+    const vector<char> header = reader.HeaderData();
+    bool written = (fwrite(&header[0], header.size(), 1, file) == 1);
+
+    const int recordSize = reader.Header().RecordSize();
+    const int bufferRecords = GCR_MAX_CHUNK_RECORDS;
+    vector<char> buffer((size_t)bufferRecords * recordSize);
+
+    for (long long first = 0; first < reader.RecordsCount() && written; first += bufferRecords)
+    {
+        const int count = (int)std::min((long long)bufferRecords, reader.RecordsCount() - first);
+
+        written = (reader.ReadRecords(first, count, &buffer[0]) == count && fwrite(&buffer[0], (size_t)count * recordSize, 1, file) == 1);
+    }
+
+    if (fclose(file) != 0)
+        written = false;
+
+    return written;
+}
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
@@ -0,0 +1,40 @@
+/**
+@file GcrConvert.h
+
+@brief Преобразование записей между форматами BDF и GCR (сжатие без потерь)
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#ifndef GCRCONVERT_H
+#define GCRCONVERT_H
+//----------------------------------------------------------------------------------
+#include <string>
+using std::string;
+//----------------------------------------------------------------------------------
+#include "GcrFile.h"
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+/**
+ * @brief CompressBdfFile Сжать BDF файл в GCR (количество записей - как при чтении CBdfReader)
+ * @param bdfPath Путь к BDF файлу
+ * @param gcrPath Путь к создаваемому GCR файлу
+ * @param chunkRecords Количество записей данных в блоке (от 1 до GCR_MAX_CHUNK_RECORDS)
+ * @return true если файл сжат без ошибок
+ */
+bool CompressBdfFile(const string &bdfPath, const string &gcrPath, int chunkRecords = GCR_DEFAULT_CHUNK_RECORDS);
+//----------------------------------------------------------------------------------
+/**
+ * @brief DecompressGcrFile Восстановить BDF файл из GCR (в заголовке указывается фактическое количество записей данных)
+ * @param gcrPath Путь к GCR файлу
+ * @param bdfPath Путь к создаваемому BDF файлу
+ * @return true если все записи данных восстановлены без ошибок
+ */
+bool DecompressGcrFile(const string &gcrPath, const string &bdfPath);
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
+#endif // GCRCONVERT_H
+//----------------------------------------------------------------------------------
@@ -0,0 +1,469 @@
+/**
+@file GcrFile.cpp
+
+@brief Сжатый без потерь файл записи GCR (GarantEEG Compressed Recording): запись и чтение с произвольным доступом по блокам
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include "GcrFile.h"
+#include <string.h>
+#include <algorithm>
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+/**
+ * @brief PutLittleEndian Записать целое в порядке little-endian
+ * @param dest Буфер
+ * @param value Значение
+ * @param size Размер в байтах
+ */
+static void PutLittleEndian(unsigned char *dest, unsigned long long value, int size)
+{
+    for (int i = 0; i < size; i++)
+        dest[i] = (unsigned char)(value >> (8 * i));
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief GetLittleEndian Прочитать целое в порядке little-endian
+ * @param src Буфер
+ * @param size Размер в байтах
+ * @return Значение
+ */
+static unsigned long long GetLittleEndian(const unsigned char *src, int size)
+{
+    unsigned long long value = 0;
+
+    for (int i = 0; i < size; i++)
+        value |= (unsigned long long)src[i] << (8 * i);
+
+    return value;
+}
+//----------------------------------------------------------------------------------
+CGcrWriter::~CGcrWriter()
+{
+    Close();
+}
+//----------------------------------------------------------------------------------
+bool CGcrWriter::Open(const string &filePath, const vector<char> &header, int chunkRecords)
+{
+    if (IsOpened() || header.empty() || chunkRecords < 1 || chunkRecords > GCR_MAX_CHUNK_RECORDS)
+        return false;
+
+    if (!m_Header.Parse(&header[0], (int)header.size()) || m_Header.RecordSize() < 1)
+        return false;
+
+    m_File = fopen(filePath.c_str(), "wb");
+
+    if (m_File == nullptr)
+        return false;
+
+    m_ChunkRecords = chunkRecords;
+    m_Chunk.resize((size_t)chunkRecords * m_Header.RecordSize());
+    m_ChunkCount = 0;
+    m_Index.clear();
+    m_RecordsCount = 0;
+
+    unsigned char fileHeader[GCR_FILE_HEADER_SIZE] = { 0 };
+    memcpy(&fileHeader[0], GCR_FILE_MAGIC, sizeof(GCR_FILE_MAGIC));
+    PutLittleEndian(&fileHeader[8], header.size(), 4);
+    PutLittleEndian(&fileHeader[12], (unsigned int)m_Header.RecordSize(), 4);
+    PutLittleEndian(&fileHeader[16], (unsigned int)chunkRecords, 4);
+    PutLittleEndian(&fileHeader[24], (unsigned long long)-1LL, 8);
+
+    m_Error = (fwrite(&fileHeader[0], GCR_FILE_HEADER_SIZE, 1, m_File) != 1 || fwrite(&header[0], header.size(), 1, m_File) != 1);
+    m_Size = GCR_FILE_HEADER_SIZE + (long long)header.size();
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+bool CGcrWriter::WriteChunk(const char *records, int count)
+{
+    //После ошибки записи позиция в файле неизвестна, следующие блоки не пишутся, чтобы оглавление не указывало на чужие данные
+    if (m_Error)
+        return false;
+
+    const int recordSize = m_Header.RecordSize();
+
+    m_Encoder.Clear();
+
+    for (int s = 0; s < m_Header.SignalsCount(); s++)
+    {
+        const BDF_SIGNAL_INFO &signal = m_Header.Signal(s);
+        const int samplesCount = signal.SamplesPerRecord * count;
+
+        if (samplesCount < 1)
+            continue;
+
+        if ((int)m_Samples.size() < samplesCount)
+            m_Samples.resize(samplesCount);
+
+        int *samples = &m_Samples[0];
+
+        for (int r = 0; r < count; r++)
+        {
+            const unsigned char *src = (const unsigned char*)records + (size_t)r * recordSize + signal.Offset;
+
+            for (int i = 0; i < signal.SamplesPerRecord; i++, src += 3)
+                *samples++ = Unpack24BitValue(src);
+        }
+
+        RiceEncode(m_Encoder, &m_Samples[0], samplesCount, 24);
+    }
+
+    const vector<unsigned char> &payload = m_Encoder.Finish();
+
+    unsigned char chunkHeader[GCR_CHUNK_HEADER_SIZE] = { 0 };
+    PutLittleEndian(&chunkHeader[0], GCR_CHUNK_MAGIC, 4);
+    PutLittleEndian(&chunkHeader[4], payload.size(), 4);
+    PutLittleEndian(&chunkHeader[8], (unsigned int)count, 4);
+
+    if (fwrite(&chunkHeader[0], GCR_CHUNK_HEADER_SIZE, 1, m_File) != 1 || (!payload.empty() && fwrite(&payload[0], payload.size(), 1, m_File) != 1))
+    {
+        m_Error = true;
+        return false;
+    }
+
+    m_Index.push_back({ m_Size, m_RecordsCount });
+    m_Size += GCR_CHUNK_HEADER_SIZE + (long long)payload.size();
+    m_RecordsCount += count;
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+bool CGcrWriter::Write(const char *records, int count)
+{
+    if (m_File == nullptr)
+        return false;
+
+    const int recordSize = m_Header.RecordSize();
+
+    while (count > 0)
+    {
+        //Целые блоки сжимаются прямо из переданных данных
+        if (m_ChunkCount == 0 && count >= m_ChunkRecords)
+        {
+            WriteChunk(records, m_ChunkRecords);
+            records += (size_t)m_ChunkRecords * recordSize;
+            count -= m_ChunkRecords;
+            continue;
+        }
+
+        const int part = std::min(count, m_ChunkRecords - m_ChunkCount);
+        memcpy(&m_Chunk[(size_t)m_ChunkCount * recordSize], records, (size_t)part * recordSize);
+
+        m_ChunkCount += part;
+        records += (size_t)part * recordSize;
+        count -= part;
+
+        if (m_ChunkCount == m_ChunkRecords)
+        {
+            WriteChunk(&m_Chunk[0], m_ChunkCount);
+            m_ChunkCount = 0;
+        }
+    }
+
+    return !m_Error;
+}
+//----------------------------------------------------------------------------------
+bool CGcrWriter::Flush()
+{
+    if (m_File == nullptr)
+        return false;
+
+    if (m_ChunkCount > 0)
+    {
+        WriteChunk(&m_Chunk[0], m_ChunkCount);
+        m_ChunkCount = 0;
+    }
+
+    return (fflush(m_File) == 0 && !m_Error);
+}
+//----------------------------------------------------------------------------------
+bool CGcrWriter::Sync()
+{
+    return (Flush() && FileSync(m_File));
+}
+//----------------------------------------------------------------------------------
+bool CGcrWriter::Close(bool sync)
+{
+    if (m_File == nullptr)
+        return false;
+
+    bool written = Flush();
+
+    if (written)
+    {
+        vector<unsigned char> index(8 + m_Index.size() * 16);
+        PutLittleEndian(&index[0], GCR_INDEX_MAGIC, 4);
+        PutLittleEndian(&index[4], m_Index.size(), 4);
+
+        for (size_t i = 0; i < m_Index.size(); i++)
+        {
+            PutLittleEndian(&index[8 + i * 16], (unsigned long long)m_Index[i].Offset, 8);
+            PutLittleEndian(&index[16 + i * 16], (unsigned long long)m_Index[i].FirstRecord, 8);
+        }
+
+        unsigned char counts[16] = { 0 };
+        PutLittleEndian(&counts[0], (unsigned long long)m_RecordsCount, 8);
+        PutLittleEndian(&counts[8], (unsigned long long)m_Size, 8);
+
+        //Оглавление указывается в заголовке только после того, как оно целиком записано
+        written = (fwrite(&index[0], index.size(), 1, m_File) == 1 && fflush(m_File) == 0);
+        written = (written && FileSeek64(m_File, 24) && fwrite(&counts[0], sizeof(counts), 1, m_File) == 1);
+
+        if (written)
+            m_Size += (long long)index.size();
+    }
+
+    if (sync && !FileSync(m_File))
+        written = false;
+
+    if (fclose(m_File) != 0)
+        written = false;
+
+    m_File = nullptr;
+
+    return written;
+}
+//----------------------------------------------------------------------------------
+CGcrReader::~CGcrReader()
+{
+    Close();
+}
+//----------------------------------------------------------------------------------
+bool CGcrReader::Open(const string &filePath)
+{
+    Close();
+
+    m_File = fopen(filePath.c_str(), "rb");
+
+    if (m_File == nullptr)
+        return false;
+
+    unsigned char fileHeader[GCR_FILE_HEADER_SIZE] = { 0 };
+
+    if (fread(&fileHeader[0], GCR_FILE_HEADER_SIZE, 1, m_File) != 1 || memcmp(&fileHeader[0], GCR_FILE_MAGIC, sizeof(GCR_FILE_MAGIC)) != 0)
+    {
+        Close();
+        return false;
+    }
+
+    const int headerSize = (int)GetLittleEndian(&fileHeader[8], 4);
+    const int recordSize = (int)GetLittleEndian(&fileHeader[12], 4);
+    const long long recordsCount = (long long)GetLittleEndian(&fileHeader[24], 8);
+    const long long indexOffset = (long long)GetLittleEndian(&fileHeader[32], 8);
+
+    if (headerSize < BDF_MAIN_HEADER_SIZE || headerSize > BDF_MAIN_HEADER_SIZE + 9999 * BDF_SIGNAL_HEADER_SIZE)
+    {
+        Close();
+        return false;
+    }
+
+    m_HeaderData.resize(headerSize);
+
+    if (fread(&m_HeaderData[0], headerSize, 1, m_File) != 1 || !m_Header.Parse(&m_HeaderData[0], headerSize) || m_Header.RecordSize() != recordSize || recordSize < 1)
+    {
+        Close();
+        return false;
+    }
+
+    if (indexOffset <= 0 || !ReadIndex(indexOffset, recordsCount))
+        ScanChunks();
+
+    m_RecordsCount = (m_Chunks.empty() ? 0 : m_Chunks.back().FirstRecord + m_Chunks.back().RecordsCount);
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+void CGcrReader::Close()
+{
+    if (m_File != nullptr)
+    {
+        fclose(m_File);
+        m_File = nullptr;
+    }
+
+    m_HeaderData.clear();
+    m_Chunks.clear();
+    m_RecordsCount = 0;
+    m_CachedChunk = -1;
+}
+//----------------------------------------------------------------------------------
+bool CGcrReader::ReadIndex(long long offset, long long recordsCount)
+{
+    unsigned char indexHeader[8] = { 0 };
+
+    if (!FileSeek64(m_File, offset) || fread(&indexHeader[0], sizeof(indexHeader), 1, m_File) != 1 || GetLittleEndian(&indexHeader[0], 4) != GCR_INDEX_MAGIC)
+        return false;
+
+    const long long chunksCount = (long long)GetLittleEndian(&indexHeader[4], 4);
+
+    if (chunksCount * 16 > FileSize64(m_File) - offset)
+        return false;
+
+    vector<unsigned char> index((size_t)chunksCount * 16 + 1);
+
+    if (chunksCount > 0 && fread(&index[0], (size_t)chunksCount * 16, 1, m_File) != 1)
+        return false;
+
+    m_Chunks.resize((size_t)chunksCount);
+
+    for (size_t i = 0; i < m_Chunks.size(); i++)
+    {
+        m_Chunks[i].Offset = (long long)GetLittleEndian(&index[i * 16], 8);
+        m_Chunks[i].FirstRecord = (long long)GetLittleEndian(&index[i * 16 + 8], 8);
+    }
+
+    for (size_t i = 0; i < m_Chunks.size(); i++)
+    {
+        const long long next = (i + 1 < m_Chunks.size() ? m_Chunks[i + 1].FirstRecord : recordsCount);
+        const long long count = next - m_Chunks[i].FirstRecord;
+
+        if (count < 1 || count > GCR_MAX_CHUNK_RECORDS || m_Chunks[i].Offset >= offset)
+        {
+            m_Chunks.clear();
+            return false;
+        }
+
+        m_Chunks[i].RecordsCount = (int)count;
+    }
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+void CGcrReader::ScanChunks()
+{
+    m_Chunks.clear();
+
+    const long long fileSize = FileSize64(m_File);
+    long long offset = GCR_FILE_HEADER_SIZE + (long long)m_HeaderData.size();
+    long long firstRecord = 0;
+
+    while (offset + GCR_CHUNK_HEADER_SIZE <= fileSize)
+    {
+        unsigned char chunkHeader[GCR_CHUNK_HEADER_SIZE] = { 0 };
+
+        if (!FileSeek64(m_File, offset) || fread(&chunkHeader[0], GCR_CHUNK_HEADER_SIZE, 1, m_File) != 1 || GetLittleEndian(&chunkHeader[0], 4) != GCR_CHUNK_MAGIC)
+            break;
+
+        const long long size = (long long)GetLittleEndian(&chunkHeader[4], 4);
+        const int count = (int)GetLittleEndian(&chunkHeader[8], 4);
+
+        if (count < 1 || count > GCR_MAX_CHUNK_RECORDS || offset + GCR_CHUNK_HEADER_SIZE + size > fileSize)
+            break;
+
+        m_Chunks.push_back({ offset, firstRecord, count });
+
+        offset += GCR_CHUNK_HEADER_SIZE + size;
+        firstRecord += count;
+    }
+
+    //Последний блок мог быть записан не полностью (например, заполнен нулями после отключения питания)
+    while (!m_Chunks.empty() && !DecodeChunk((int)m_Chunks.size() - 1))
+        m_Chunks.pop_back();
+}
+//----------------------------------------------------------------------------------
+bool CGcrReader::DecodeChunk(int index)
+{
+    if (index == m_CachedChunk)
+        return true;
+
+    m_CachedChunk = -1;
+
+    const CHUNK_INFO &info = m_Chunks[index];
+    const int recordSize = m_Header.RecordSize();
+    unsigned char chunkHeader[GCR_CHUNK_HEADER_SIZE] = { 0 };
+
+    if (!FileSeek64(m_File, info.Offset) || fread(&chunkHeader[0], GCR_CHUNK_HEADER_SIZE, 1, m_File) != 1)
+        return false;
+
+    const long long size = (long long)GetLittleEndian(&chunkHeader[4], 4);
+
+    //Сжатые данные не бывают больше исходных с учетом заголовков разделов
+    if (GetLittleEndian(&chunkHeader[0], 4) != GCR_CHUNK_MAGIC || (int)GetLittleEndian(&chunkHeader[8], 4) != info.RecordsCount || size > 2LL * info.RecordsCount * recordSize + 4096)
+        return false;
+
+    m_Payload.resize((size_t)size + 1);
+
+    if (size > 0 && fread(&m_Payload[0], (size_t)size, 1, m_File) != 1)
+        return false;
+
+    m_ChunkData.resize((size_t)info.RecordsCount * recordSize);
+
+    CBitReader reader(&m_Payload[0], (size_t)size);
+
+    for (int s = 0; s < m_Header.SignalsCount(); s++)
+    {
+        const BDF_SIGNAL_INFO &signal = m_Header.Signal(s);
+        const int samplesCount = signal.SamplesPerRecord * info.RecordsCount;
+
+        if (samplesCount < 1)
+            continue;
+
+        if ((int)m_Samples.size() < samplesCount)
+            m_Samples.resize(samplesCount);
+
+        if (!RiceDecode(reader, &m_Samples[0], samplesCount, 24))
+            return false;
+
+        const int *samples = &m_Samples[0];
+
+        for (int r = 0; r < info.RecordsCount; r++)
+        {
+            unsigned char *dest = (unsigned char*)&m_ChunkData[(size_t)r * recordSize + signal.Offset];
+
+            for (int i = 0; i < signal.SamplesPerRecord; i++, dest += 3)
+                Pack24BitValue(dest, *samples++);
+        }
+    }
+
+    m_CachedChunk = index;
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+vector<char> CGcrReader::HeaderData() const
+{
+    vector<char> header = m_HeaderData;
+
+    if ((int)header.size() >= BDF_MAIN_HEADER_SIZE)
+    {
+        char recordsCountText[32] = { 0 };
+        sprintf(recordsCountText, "%-8lld", m_RecordsCount);
+        memcpy(&header[BDF_RECORDS_COUNT_OFFSET], &recordsCountText[0], 8);
+    }
+
+    return header;
+}
+//----------------------------------------------------------------------------------
+int CGcrReader::ReadRecords(long long firstRecord, int count, char *dest)
+{
+    if (m_File == nullptr || firstRecord < 0 || firstRecord >= m_RecordsCount || count < 1)
+        return 0;
+
+    count = (int)std::min((long long)count, m_RecordsCount - firstRecord);
+
+    const int recordSize = m_Header.RecordSize();
+    auto chunk = std::upper_bound(m_Chunks.begin(), m_Chunks.end(), firstRecord, [](long long record, const CHUNK_INFO &info){ return (record < info.FirstRecord); });
+    int index = (int)(chunk - m_Chunks.begin()) - 1;
+    int read = 0;
+
+    while (read < count && index < (int)m_Chunks.size() && DecodeChunk(index))
+    {
+        const CHUNK_INFO &info = m_Chunks[index];
+        const int start = (int)(firstRecord + read - info.FirstRecord);
+        const int part = std::min(count - read, info.RecordsCount - start);
+
+        memcpy(dest + (size_t)read * recordSize, &m_ChunkData[(size_t)start * recordSize], (size_t)part * recordSize);
+
+        read += part;
+        index++;
+    }
+
+    return read;
+}
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
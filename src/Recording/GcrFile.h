@@ -0,0 +1,310 @@
+/**
+@file GcrFile.h
+
+@brief Сжатый без потерь файл записи GCR (GarantEEG Compressed Recording): запись и чтение с произвольным доступом по блокам
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#ifndef GCRFILE_H
+#define GCRFILE_H
+//----------------------------------------------------------------------------------
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include <stdio.h>
+//----------------------------------------------------------------------------------
+#include "BdfHeader.h"
+#include "RiceCoder.h"
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+//! Формат файла (числа little-endian):
+//! заголовок GCR_FILE_HEADER_SIZE байт: сигнатура (8), размер заголовка BDF (4), размер записи данных (4),
+//! записей в блоке (4), резерв (4), количество записей (8, -1 до закрытия), смещение оглавления (8, 0 до закрытия);
+//! заголовок BDF без изменений;
+//! блоки: сигнатура GCR_CHUNK_MAGIC (4), размер сжатых данных (4), количество записей (4), сжатые данные -
+//! отсчеты каждого сигнала за все записи блока подряд, сжатые RiceEncode (24 бита);
+//! оглавление: сигнатура GCR_INDEX_MAGIC (4), количество блоков (4), для каждого блока смещение (8) и номер первой записи (8).
+//! Блоки независимы, поэтому для чтения любой записи распаковывается только ее блок.
+//! Если файл не был закрыт (нет оглавления), блоки находятся последовательным просмотром до первого неполного.
+//----------------------------------------------------------------------------------
+//! Сигнатура файла
+const char GCR_FILE_MAGIC[8] = { 'G', 'E', 'E', 'G', 'G', 'C', 'R', '1' };
+
+//! Сигнатура блока ("GCRK")
+const unsigned int GCR_CHUNK_MAGIC = 0x4B524347;
+
+//! Сигнатура оглавления ("GCRI")
+const unsigned int GCR_INDEX_MAGIC = 0x49524347;
+
+//! Размер заголовка файла (без заголовка BDF)
+const int GCR_FILE_HEADER_SIZE = 40;
+
+//! Размер заголовка блока
+const int GCR_CHUNK_HEADER_SIZE = 12;
+
+//! Количество записей данных в блоке по умолчанию (1 секунда для записей по 100 мс)
+const int GCR_DEFAULT_CHUNK_RECORDS = 10;
+
+//! Максимальное количество записей данных в блоке
+const int GCR_MAX_CHUNK_RECORDS = 600;
+//----------------------------------------------------------------------------------
+//! Класс для записи GCR файла. Записи данных накапливаются до заполнения блока, блок сжимается и пишется в файл.
+//! Все функции вызываются из одного потока.
+class CGcrWriter
+{
+private:
+	//! Описание блока для оглавления
+    struct CHUNK_INFO
+    {
+		//! Смещение блока в файле
+        long long Offset;
+
+		//! Номер первой записи данных блока
+        long long FirstRecord;
+    };
+
+	//! Файл
+    FILE *m_File = nullptr;
+
+	//! Заголовок BDF
+    CBdfHeader m_Header;
+
+	//! Количество записей данных в блоке
+    int m_ChunkRecords = GCR_DEFAULT_CHUNK_RECORDS;
+
+	//! Записи данных текущего блока
+    vector<char> m_Chunk;
+
+	//! Количество записей данных в текущем блоке
+    int m_ChunkCount = 0;
+
+	//! Отсчеты одного сигнала текущего блока
+    vector<int> m_Samples;
+
+	//! Поток бит сжатых данных блока
+    CBitWriter m_Encoder;
+
+	//! Оглавление
+    vector<CHUNK_INFO> m_Index;
+
+	//! Количество записанных в блоки записей данных
+    long long m_RecordsCount = 0;
+
+	//! Размер записанных данных файла
+    long long m_Size = 0;
+
+	//! Флаг ошибки записи
+    bool m_Error = false;
+
+	/**
+	 * @brief WriteChunk Сжать и записать блок
+	 * @param records Указатель на записи данных блока
+	 * @param count Количество записей
+	 * @return true если успешно
+	 */
+    bool WriteChunk(const char *records, int count);
+
+public:
+	/**
+	 * @brief CGcrWriter Конструктор
+	 */
+    CGcrWriter() {}
+
+	/**
+	 * @brief ~CGcrWriter Деструктор
+	 */
+    ~CGcrWriter();
+
+	/**
+	 * @brief Open Создать файл и записать заголовки
+	 * @param filePath Путь к файлу
+	 * @param header Данные заголовка BDF
+	 * @param chunkRecords Количество записей данных в блоке (от 1 до GCR_MAX_CHUNK_RECORDS)
+	 * @return true если файл создан и заголовок BDF корректен
+	 */
+    bool Open(const string &filePath, const vector<char> &header, int chunkRecords = GCR_DEFAULT_CHUNK_RECORDS);
+
+	/**
+	 * @brief Write Добавить записи данных
+	 * @param records Указатель на записи данных
+	 * @param count Количество записей
+	 * @return true если ошибок записи не было
+	 */
+    bool Write(const char *records, int count);
+
+	/**
+	 * @brief Flush Записать неполный блок и передать данные системе
+	 * @return true если успешно
+	 */
+    bool Flush();
+
+	/**
+	 * @brief Sync Записать неполный блок и дождаться записи данных на диск
+	 * @return true если успешно
+	 */
+    bool Sync();
+
+	/**
+	 * @brief Close Записать неполный блок и оглавление, указать количество записей в заголовке и закрыть файл
+	 * @param sync Дождаться записи данных на диск
+	 * @return true если все данные записаны без ошибок
+	 */
+    bool Close(bool sync = false);
+
+	/**
+	 * @brief IsOpened Проверить, открыт ли файл
+	 * @return true если открыт
+	 */
+    bool IsOpened() const { return (m_File != nullptr); }
+
+	/**
+	 * @brief RecordSize Получить размер одной записи данных
+	 * @return Размер в байтах
+	 */
+    int RecordSize() const { return m_Header.RecordSize(); }
+
+	/**
+	 * @brief Size Получить размер записанных в файл данных
+	 * @return Размер в байтах
+	 */
+    long long Size() const { return m_Size; }
+};
+//----------------------------------------------------------------------------------
+//! Класс для чтения GCR файла. Последний распакованный блок сохраняется, поэтому последовательное чтение
+//! распаковывает каждый блок один раз. Функции чтения изменяют этот блок и не должны вызываться из нескольких потоков одновременно.
+class CGcrReader
+{
+private:
+	//! Описание блока
+    struct CHUNK_INFO
+    {
+		//! Смещение блока в файле
+        long long Offset;
+
+		//! Номер первой записи данных блока
+        long long FirstRecord;
+
+		//! Количество записей данных блока
+        int RecordsCount;
+    };
+
+	//! Файл
+    FILE *m_File = nullptr;
+
+	//! Данные заголовка BDF
+    vector<char> m_HeaderData;
+
+	//! Заголовок BDF
+    CBdfHeader m_Header;
+
+	//! Блоки в порядке записи
+    vector<CHUNK_INFO> m_Chunks;
+
+	//! Количество записей данных
+    long long m_RecordsCount = 0;
+
+	//! Индекс распакованного блока (-1 если нет)
+    int m_CachedChunk = -1;
+
+	//! Записи данных распакованного блока
+    vector<char> m_ChunkData;
+
+	//! Сжатые данные блока
+    vector<unsigned char> m_Payload;
+
+	//! Отсчеты одного сигнала блока
+    vector<int> m_Samples;
+
+	/**
+	 * @brief ReadIndex Прочитать оглавление
+	 * @param offset Смещение оглавления
+	 * @param recordsCount Количество записей данных из заголовка
+	 * @return true если оглавление корректно
+	 */
+    bool ReadIndex(long long offset, long long recordsCount);
+
+	/**
+	 * @brief ScanChunks Найти блоки последовательным просмотром (файл не был закрыт)
+	 */
+    void ScanChunks();
+
+	/**
+	 * @brief DecodeChunk Прочитать и распаковать блок
+	 * @param index Индекс блока
+	 * @return true если успешно
+	 */
+    bool DecodeChunk(int index);
+
+public:
+	/**
+	 * @brief CGcrReader Конструктор
+	 */
+    CGcrReader() {}
+
+	/**
+	 * @brief ~CGcrReader Деструктор
+	 */
+    ~CGcrReader();
+
+	/**
+	 * @brief Open Открыть файл, прочитать заголовки и оглавление
+	 * @param filePath Путь к файлу
+	 * @return true если файл открыт и заголовки корректны
+	 */
+    bool Open(const string &filePath);
+
+	/**
+	 * @brief Close Закрыть файл
+	 */
+    void Close();
+
+	/**
+	 * @brief IsOpened Проверить, открыт ли файл
+	 * @return true если открыт
+	 */
+    bool IsOpened() const { return (m_File != nullptr); }
+
+	/**
+	 * @brief Header Получить заголовок BDF
+	 * @return Ссылка на заголовок
+	 */
+    const CBdfHeader &Header() const { return m_Header; }
+
+	/**
+	 * @brief HeaderData Получить данные заголовка BDF с фактическим количеством записей данных
+	 * @return Данные заголовка
+	 */
+    vector<char> HeaderData() const;
+
+	/**
+	 * @brief RecordsCount Получить количество записей данных
+	 * @return Количество записей
+	 */
+    long long RecordsCount() const { return m_RecordsCount; }
+
+	/**
+	 * @brief ChunksCount Получить количество блоков
+	 * @return Количество блоков
+	 */
+    int ChunksCount() const { return (int)m_Chunks.size(); }
+
+	/**
+	 * @brief ReadRecords Прочитать записи данных в формате BDF
+	 * @param firstRecord Номер первой записи
+	 * @param count Количество записей
+	 * @param dest Буфер размером count * Header().RecordSize()
+	 * @return Количество прочитанных записей (меньше count у конца файла или при повреждении блока)
+	 */
+    int ReadRecords(long long firstRecord, int count, char *dest);
+};
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
+#endif // GCRFILE_H
+//----------------------------------------------------------------------------------
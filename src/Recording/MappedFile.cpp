@@ -0,0 +1,331 @@
+/**
+@file MappedFile.cpp
+
+@brief Класс для работы с файлом через отображение в память (Windows - file mapping, POSIX - mmap)
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include "MappedFile.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+CMappedFile::~CMappedFile()
+{
+    Close();
+}
+//----------------------------------------------------------------------------------
+#ifdef _WIN32
+//----------------------------------------------------------------------------------
+bool CMappedFile::Create(const string &filePath)
+{
+    Close();
+
+    HANDLE handle = CreateFileA(filePath.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (handle == INVALID_HANDLE_VALUE)
+        return false;
+
+    m_Handle = handle;
+    m_ReadOnly = false;
+    m_Size = 0;
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+bool CMappedFile::Open(const string &filePath, bool readOnly)
+{
+    Close();
+
+    DWORD access = (readOnly ? GENERIC_READ : GENERIC_READ | GENERIC_WRITE);
+    HANDLE handle = CreateFileA(filePath.c_str(), access, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (handle == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx(handle, &size))
+    {
+        CloseHandle(handle);
+        return false;
+    }
+
+    m_Handle = handle;
+    m_ReadOnly = readOnly;
+    m_Size = size.QuadPart;
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+void CMappedFile::Close()
+{
+    if (m_Handle != nullptr)
+    {
+        CloseHandle((HANDLE)m_Handle);
+        m_Handle = nullptr;
+    }
+
+    m_Size = 0;
+}
+//----------------------------------------------------------------------------------
+bool CMappedFile::Truncate(long long size)
+{
+    if (m_Handle == nullptr || m_ReadOnly)
+        return false;
+
+    LARGE_INTEGER position;
+    position.QuadPart = size;
+
+    if (!SetFilePointerEx((HANDLE)m_Handle, position, nullptr, FILE_BEGIN) || !SetEndOfFile((HANDLE)m_Handle))
+        return false;
+
+    m_Size = size;
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+bool CMappedFile::Allocate(long long size)
+{
+    //NTFS выделяет кластеры при установке конца файла, заполнение нулями откладывается до записи
+    if (size <= m_Size)
+        return true;
+
+    return Truncate(size);
+}
+//----------------------------------------------------------------------------------
+char *CMappedFile::Map(long long offset, int size, bool prefault)
+{
+    if (m_Handle == nullptr || size < 1 || offset + size > m_Size)
+        return nullptr;
+
+    //Объект отображения нужен только для создания вида, вид удерживает его до UnmapViewOfFile
+    long long mappingSize = offset + size;
+    HANDLE mapping = CreateFileMappingA((HANDLE)m_Handle, nullptr, (m_ReadOnly ? PAGE_READONLY : PAGE_READWRITE), (DWORD)(mappingSize >> 32), (DWORD)(mappingSize & 0xFFFFFFFF), nullptr);
+
+    if (mapping == nullptr)
+        return nullptr;
+
+    void *data = MapViewOfFile(mapping, (m_ReadOnly ? FILE_MAP_READ : FILE_MAP_WRITE), (DWORD)(offset >> 32), (DWORD)(offset & 0xFFFFFFFF), size);
+    CloseHandle(mapping);
+
+    if (data != nullptr && prefault)
+    {
+        //Чтение по одному байту со страницы подгружает участок (PrefetchVirtualMemory доступна не во всех версиях Windows)
+        volatile const char *pages = (const char*)data;
+        char value = 0;
+
+        for (int i = 0; i < size; i += 4096)
+            value ^= pages[i];
+
+        (void)value;
+    }
+
+    return (char*)data;
+}
+//----------------------------------------------------------------------------------
+void CMappedFile::Unmap(char *data, int size)
+{
+    (void)size;
+
+    if (data != nullptr)
+        UnmapViewOfFile(data);
+}
+//----------------------------------------------------------------------------------
+bool CMappedFile::Flush(char *data, int size)
+{
+    if (data == nullptr || size < 1)
+        return true;
+
+    return (FlushViewOfFile(data, size) != 0);
+}
+//----------------------------------------------------------------------------------
+bool CMappedFile::Sync()
+{
+    if (m_Handle == nullptr)
+        return false;
+
+    return (FlushFileBuffers((HANDLE)m_Handle) != 0);
+}
+//----------------------------------------------------------------------------------
+bool CMappedFile::WriteAt(long long offset, const void *data, int size)
+{
+    if (m_Handle == nullptr || m_ReadOnly)
+        return false;
+
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = (DWORD)(offset & 0xFFFFFFFF);
+    overlapped.OffsetHigh = (DWORD)(offset >> 32);
+
+    DWORD written = 0;
+
+    return (WriteFile((HANDLE)m_Handle, data, size, &written, &overlapped) && (int)written == size);
+}
+//----------------------------------------------------------------------------------
+int CMappedFile::AllocationGranularity()
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+
+    return (int)info.dwAllocationGranularity;
+}
+//----------------------------------------------------------------------------------
+#else
+//----------------------------------------------------------------------------------
+bool CMappedFile::Create(const string &filePath)
+{
+    Close();
+
+    int handle = open(filePath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+    if (handle < 0)
+        return false;
+
+    m_Handle = handle;
+    m_ReadOnly = false;
+    m_Size = 0;
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+bool CMappedFile::Open(const string &filePath, bool readOnly)
+{
+    Close();
+
+    int handle = open(filePath.c_str(), (readOnly ? O_RDONLY : O_RDWR));
+
+    if (handle < 0)
+        return false;
+
+    struct stat info;
+
+    if (fstat(handle, &info) != 0)
+    {
+        close(handle);
+        return false;
+    }
+
+    m_Handle = handle;
+    m_ReadOnly = readOnly;
+    m_Size = (long long)info.st_size;
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+void CMappedFile::Close()
+{
+    if (m_Handle >= 0)
+    {
+        close(m_Handle);
+        m_Handle = -1;
+    }
+
+    m_Size = 0;
+}
+//----------------------------------------------------------------------------------
+bool CMappedFile::Truncate(long long size)
+{
+    if (m_Handle < 0 || m_ReadOnly || ftruncate(m_Handle, (off_t)size) != 0)
+        return false;
+
+    m_Size = size;
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+bool CMappedFile::Allocate(long long size)
+{
+    if (size <= m_Size)
+        return true;
+
+    if (m_Handle < 0 || m_ReadOnly)
+        return false;
+
+    //Файловые системы без поддержки fallocate получают разреженный файл нужного размера
+    int result = posix_fallocate(m_Handle, (off_t)m_Size, (off_t)(size - m_Size));
+
+    if (result != 0 && result != EOPNOTSUPP && result != EINVAL)
+        return false;
+
+    if (result != 0 && ftruncate(m_Handle, (off_t)size) != 0)
+        return false;
+
+    m_Size = size;
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+char *CMappedFile::Map(long long offset, int size, bool prefault)
+{
+    if (m_Handle < 0 || size < 1 || offset + size > m_Size)
+        return nullptr;
+
+    int flags = MAP_SHARED;
+
+#ifdef MAP_POPULATE
+    if (prefault)
+        flags |= MAP_POPULATE;
+#endif
+
+    void *data = mmap(nullptr, size, (m_ReadOnly ? PROT_READ : PROT_READ | PROT_WRITE), flags, m_Handle, (off_t)offset);
+
+    return (data == MAP_FAILED ? nullptr : (char*)data);
+}
+//----------------------------------------------------------------------------------
+void CMappedFile::Unmap(char *data, int size)
+{
+    if (data != nullptr)
+        munmap(data, size);
+}
+//----------------------------------------------------------------------------------
+bool CMappedFile::Flush(char *data, int size)
+{
+    if (data == nullptr || size < 1)
+        return true;
+
+    //msync требует адрес, выровненный на страницу
+    static const long pageSize = sysconf(_SC_PAGESIZE);
+    char *start = (char*)((size_t)data & ~(size_t)(pageSize - 1));
+
+    return (msync(start, (size_t)(data + size - start), MS_ASYNC) == 0);
+}
+//----------------------------------------------------------------------------------
+bool CMappedFile::Sync()
+{
+    if (m_Handle < 0)
+        return false;
+
+#ifdef __APPLE__
+    return (fsync(m_Handle) == 0);
+#else
+    return (fdatasync(m_Handle) == 0);
+#endif
+}
+//----------------------------------------------------------------------------------
+bool CMappedFile::WriteAt(long long offset, const void *data, int size)
+{
+    if (m_Handle < 0 || m_ReadOnly)
+        return false;
+
+    return (pwrite(m_Handle, data, size, (off_t)offset) == size);
+}
+//----------------------------------------------------------------------------------
+int CMappedFile::AllocationGranularity()
+{
+    return (int)sysconf(_SC_PAGESIZE);
+}
+//----------------------------------------------------------------------------------
+#endif
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
@@ -0,0 +1,146 @@
+/**
+@file MappedFile.h
+
+@brief Класс для работы с файлом через отображение в память (Windows - file mapping, POSIX - mmap)
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+//----------------------------------------------------------------------------------
+#include <string>
+using std::string;
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+//! Файл с отображением произвольных участков в память. Смещения участков должны быть кратны AllocationGranularity().
+class CMappedFile
+{
+private:
+#ifdef _WIN32
+	//! Дескриптор файла (HANDLE)
+    void *m_Handle = nullptr;
+#else
+	//! Дескриптор файла
+    int m_Handle = -1;
+#endif
+
+	//! Флаг открытия только для чтения
+    bool m_ReadOnly = true;
+
+	//! Размер файла
+    long long m_Size = 0;
+
+public:
+	/**
+	 * @brief CMappedFile Конструктор
+	 */
+    CMappedFile() {}
+
+	/**
+	 * @brief ~CMappedFile Деструктор
+	 */
+    ~CMappedFile();
+
+	/**
+	 * @brief Create Создать файл для записи (существующий файл перезаписывается)
+	 * @param filePath Путь к файлу
+	 * @return true если файл создан
+	 */
+    bool Create(const string &filePath);
+
+	/**
+	 * @brief Open Открыть существующий файл
+	 * @param filePath Путь к файлу
+	 * @param readOnly Открыть только для чтения
+	 * @return true если файл открыт
+	 */
+    bool Open(const string &filePath, bool readOnly);
+
+	/**
+	 * @brief Close Закрыть файл (все участки должны быть освобождены)
+	 */
+    void Close();
+
+	/**
+	 * @brief IsOpened Проверить, открыт ли файл
+	 * @return true если открыт
+	 */
+#ifdef _WIN32
+    bool IsOpened() const { return (m_Handle != nullptr); }
+#else
+    bool IsOpened() const { return (m_Handle >= 0); }
+#endif
+
+	/**
+	 * @brief Size Получить размер файла
+	 * @return Размер в байтах
+	 */
+    long long Size() const { return m_Size; }
+
+	/**
+	 * @brief Allocate Выделить место на диске до указанного размера (файл только увеличивается)
+	 * @param size Новый размер файла
+	 * @return true если место выделено
+	 */
+    bool Allocate(long long size);
+
+	/**
+	 * @brief Truncate Установить точный размер файла (все участки за новым концом должны быть освобождены)
+	 * @param size Новый размер файла
+	 * @return true если успешно
+	 */
+    bool Truncate(long long size);
+
+	/**
+	 * @brief Map Отобразить участок файла в память
+	 * @param offset Смещение участка (кратно AllocationGranularity())
+	 * @param size Размер участка (участок должен быть внутри файла)
+	 * @param prefault Подгрузить страницы участка сразу, чтобы первое обращение к ним не ждало диска (для участков, которые будут заполнены целиком)
+	 * @return Указатель на данные участка или nullptr в случае ошибки
+	 */
+    char *Map(long long offset, int size, bool prefault = false);
+
+	/**
+	 * @brief Unmap Освободить участок
+	 * @param data Указатель, полученный от Map
+	 * @param size Размер участка
+	 */
+    void Unmap(char *data, int size);
+
+	/**
+	 * @brief Flush Начать асинхронную запись измененных страниц участка на диск
+	 * @param data Указатель на данные внутри участка
+	 * @param size Размер данных
+	 * @return true если успешно
+	 */
+    bool Flush(char *data, int size);
+
+	/**
+	 * @brief Sync Дождаться записи всех данных файла на диск
+	 * @return true если успешно
+	 */
+    bool Sync();
+
+	/**
+	 * @brief WriteAt Записать данные по смещению (минуя отображение)
+	 * @param offset Смещение в файле
+	 * @param data Указатель на данные
+	 * @param size Размер данных
+	 * @return true если все данные записаны
+	 */
+    bool WriteAt(long long offset, const void *data, int size);
+
+	/**
+	 * @brief AllocationGranularity Получить кратность смещений участков отображения
+	 * @return Кратность в байтах
+	 */
+    static int AllocationGranularity();
+};
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
+#endif // MAPPEDFILE_H
+//----------------------------------------------------------------------------------
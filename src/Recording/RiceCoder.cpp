@@ -0,0 +1,293 @@
+/**
+@file RiceCoder.cpp
+
+@brief Сжатие без потерь последовательностей целых отсчетов: фиксированное линейное предсказание и коды Райса
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include "RiceCoder.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+//! Способы записи последовательности (3 бита): 0-3 - порядок предсказателя
+enum RICE_MODE
+{
+    RM_RICE_CONSTANT = 4,
+    RM_RICE_VERBATIM = 7
+};
+//----------------------------------------------------------------------------------
+/**
+ * @brief LeadingZeros64 Получить количество старших нулевых бит
+ * @param value Значение (не 0)
+ * @return Количество нулевых бит
+ */
+static inline int LeadingZeros64(unsigned long long value)
+{
+#ifdef _MSC_VER
+    //_BitScanReverse64 доступна только в 64-битных сборках
+    unsigned long index = 0;
+
+    if (_BitScanReverse(&index, (unsigned long)(value >> 32)))
+        return 31 - (int)index;
+
+    _BitScanReverse(&index, (unsigned long)value);
+
+    return 63 - (int)index;
+#else
+    return __builtin_clzll(value);
+#endif
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief Predict Получить предсказание отсчета фиксированным предсказателем
+ * @param samples Отсчеты
+ * @param index Индекс отсчета (не меньше order)
+ * @param order Порядок предсказателя
+ * @return Предсказанное значение
+ */
+static inline int Predict(const int *samples, int index, int order)
+{
+    switch (order)
+    {
+        case 1:
+            return samples[index - 1];
+        case 2:
+            return 2 * samples[index - 1] - samples[index - 2];
+        case 3:
+            return 3 * (samples[index - 1] - samples[index - 2]) + samples[index - 3];
+        default:
+            break;
+    }
+
+    return 0;
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief RiceCost Получить длину кодов Райса раздела в битах
+ * @param values Остатки раздела
+ * @param count Количество остатков
+ * @param k Параметр Райса
+ * @return Длина в битах
+ */
+static long long RiceCost(const unsigned int *values, int count, int k)
+{
+    long long cost = (long long)count * (k + 1);
+
+    for (int i = 0; i < count; i++)
+    {
+        unsigned int quotient = values[i] >> k;
+
+        if (quotient < (unsigned int)RICE_ESCAPE_QUOTIENT)
+            cost += quotient;
+        else
+            cost += 64 - 1 - k;
+    }
+
+    return cost;
+}
+//----------------------------------------------------------------------------------
+const vector<unsigned char> &CBitWriter::Finish()
+{
+    if (m_Count > 0)
+        Put(0, 8 - m_Count);
+
+    return m_Data;
+}
+//----------------------------------------------------------------------------------
+unsigned int CBitReader::GetUnary(int limit)
+{
+    unsigned long long inverted = ~m_Bits;
+    int ones = (inverted == 0 ? 64 : LeadingZeros64(inverted));
+
+    if (ones >= limit)
+    {
+        Get(limit);
+        return (unsigned int)limit;
+    }
+
+    Get(ones + 1);
+
+    return (unsigned int)ones;
+}
+//----------------------------------------------------------------------------------
+void RiceEncode(CBitWriter &writer, const int *samples, int count, int bits)
+{
+    if (count < 1)
+        return;
+
+    //Выбор порядка по сумме модулей остатков (первые отсчеты предсказываются меньшими порядками и не учитываются)
+    long long sums[RICE_MAX_PREDICTOR_ORDER + 1] = { 0, 0, 0, 0 };
+    bool constant = true;
+
+    for (int i = 0; i < count; i++)
+    {
+        constant &= (samples[i] == samples[0]);
+
+        if (i < RICE_MAX_PREDICTOR_ORDER)
+            continue;
+
+        for (int order = 0; order <= RICE_MAX_PREDICTOR_ORDER; order++)
+        {
+            long long residual = (long long)samples[i] - Predict(samples, i, order);
+            sums[order] += (residual < 0 ? -residual : residual);
+        }
+    }
+
+    if (constant)
+    {
+        writer.Put(RM_RICE_CONSTANT, 3);
+        writer.Put((unsigned int)samples[0], bits);
+        return;
+    }
+
+    int order = 0;
+
+    for (int i = 1; i <= RICE_MAX_PREDICTOR_ORDER; i++)
+    {
+        if (sums[i] < sums[order])
+            order = i;
+    }
+
+    //Остатки со знаком отображаются в неотрицательные: 0, -1, 1, -2, 2...
+    vector<unsigned int> residuals(count);
+
+    for (int i = 0; i < count; i++)
+    {
+        int residual = samples[i] - Predict(samples, i, (i < order ? i : order));
+        residuals[i] = ((unsigned int)residual << 1) ^ (unsigned int)(residual >> 31);
+    }
+
+    int partitions = (count + RICE_PARTITION_SIZE - 1) / RICE_PARTITION_SIZE;
+    vector<int> parameters(partitions);
+    long long cost = 3 + partitions * 5;
+
+    for (int p = 0; p < partitions; p++)
+    {
+        const unsigned int *values = &residuals[p * RICE_PARTITION_SIZE];
+        int size = (p == partitions - 1 ? count - p * RICE_PARTITION_SIZE : RICE_PARTITION_SIZE);
+
+        //Оценка параметра по среднему, уточняется по точной длине соседних значений
+        unsigned long long sum = 0;
+
+        for (int i = 0; i < size; i++)
+            sum += values[i];
+
+        int k = 0;
+
+        while (k < 30 && ((unsigned long long)size << (k + 1)) <= sum)
+            k++;
+
+        int best = k;
+        long long bestCost = RiceCost(values, size, k);
+
+        for (int candidate = (k > 0 ? k - 1 : k + 1); candidate <= k + 1; candidate += 2)
+        {
+            long long candidateCost = RiceCost(values, size, candidate);
+
+            if (candidateCost < bestCost)
+            {
+                best = candidate;
+                bestCost = candidateCost;
+            }
+        }
+
+        parameters[p] = best;
+        cost += bestCost;
+    }
+
+    if (cost >= 3 + (long long)count * bits)
+    {
+        writer.Put(RM_RICE_VERBATIM, 3);
+
+        for (int i = 0; i < count; i++)
+            writer.Put((unsigned int)samples[i], bits);
+
+        return;
+    }
+
+    writer.Put((unsigned int)order, 3);
+
+    for (int p = 0; p < partitions; p++)
+    {
+        int k = parameters[p];
+        int end = (p == partitions - 1 ? count : (p + 1) * RICE_PARTITION_SIZE);
+
+        writer.Put((unsigned int)k, 5);
+
+        for (int i = p * RICE_PARTITION_SIZE; i < end; i++)
+        {
+            unsigned int quotient = residuals[i] >> k;
+
+            if (quotient < (unsigned int)RICE_ESCAPE_QUOTIENT)
+            {
+                writer.Put(((1u << quotient) - 1) << 1, (int)quotient + 1);
+                writer.Put(residuals[i], k);
+            }
+            else
+            {
+                writer.Put(0xFFFFFFFF, RICE_ESCAPE_QUOTIENT);
+                writer.Put(residuals[i], 32);
+            }
+        }
+    }
+}
+//----------------------------------------------------------------------------------
+bool RiceDecode(CBitReader &reader, int *samples, int count, int bits)
+{
+    if (count < 1)
+        return true;
+
+    int shift = 32 - bits;
+    unsigned int mode = reader.Get(3);
+
+    if (mode == RM_RICE_CONSTANT || mode == RM_RICE_VERBATIM)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            if (mode == RM_RICE_VERBATIM || !i)
+                samples[i] = (int)(reader.Get(bits) << shift) >> shift;
+            else
+                samples[i] = samples[0];
+        }
+
+        return !reader.IsOverrun();
+    }
+
+    if (mode > (unsigned int)RICE_MAX_PREDICTOR_ORDER)
+        return false;
+
+    int order = (int)mode;
+
+    for (int start = 0; start < count; start += RICE_PARTITION_SIZE)
+    {
+        int k = (int)reader.Get(5);
+        int end = (count - start > RICE_PARTITION_SIZE ? start + RICE_PARTITION_SIZE : count);
+
+        for (int i = start; i < end; i++)
+        {
+            unsigned int quotient = reader.GetUnary(RICE_ESCAPE_QUOTIENT);
+            unsigned int value = 0;
+
+            if (quotient < (unsigned int)RICE_ESCAPE_QUOTIENT)
+                value = (quotient << k) | reader.Get(k);
+            else
+                value = reader.Get(32);
+
+            int residual = (int)(value >> 1) ^ -(int)(value & 1);
+            samples[i] = residual + Predict(samples, i, (i < order ? i : order));
+        }
+
+        if (reader.IsOverrun())
+            return false;
+    }
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
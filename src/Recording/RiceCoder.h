@@ -0,0 +1,181 @@
+/**
+@file RiceCoder.h
+
+@brief Сжатие без потерь последовательностей целых отсчетов: фиксированное линейное предсказание и коды Райса
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#ifndef RICECODER_H
+#define RICECODER_H
+//----------------------------------------------------------------------------------
+#include <vector>
+using std::vector;
+
+#include <stddef.h>
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+//! Максимальный порядок фиксированного предсказателя
+const int RICE_MAX_PREDICTOR_ORDER = 3;
+
+//! Количество отсчетов в разделе с собственным параметром Райса
+const int RICE_PARTITION_SIZE = 256;
+
+//! Частное, начиная с которого остаток записывается без кода Райса (32 бита)
+const int RICE_ESCAPE_QUOTIENT = 32;
+//----------------------------------------------------------------------------------
+//! Запись потока бит (старшие биты первыми)
+class CBitWriter
+{
+private:
+	//! Данные
+    vector<unsigned char> m_Data;
+
+	//! Накопленные биты (младшие m_Count бит)
+    unsigned long long m_Bits = 0;
+
+	//! Количество накопленных бит
+    int m_Count = 0;
+
+public:
+	/**
+	 * @brief Clear Очистить поток
+	 */
+    void Clear() { m_Data.clear(); m_Bits = 0; m_Count = 0; }
+
+	/**
+	 * @brief Put Записать биты
+	 * @param value Значение (младшие count бит)
+	 * @param count Количество бит (до 32)
+	 */
+    inline void Put(unsigned int value, int count)
+    {
+        m_Bits = (m_Bits << count) | (value & (unsigned int)((1ull << count) - 1));
+        m_Count += count;
+
+        while (m_Count >= 8)
+        {
+            m_Count -= 8;
+            m_Data.push_back((unsigned char)(m_Bits >> m_Count));
+        }
+    }
+
+	/**
+	 * @brief Finish Дописать неполный байт нулевыми битами
+	 * @return Данные потока
+	 */
+    const vector<unsigned char> &Finish();
+};
+//----------------------------------------------------------------------------------
+//! Чтение потока бит (старшие биты первыми). Чтение за концом данных возвращает нули и отмечается флагом
+class CBitReader
+{
+private:
+	//! Данные
+    const unsigned char *m_Data = nullptr;
+
+	//! Размер данных
+    size_t m_Size = 0;
+
+	//! Позиция следующего байта
+    size_t m_Position = 0;
+
+	//! Окно бит (старшие m_Count бит)
+    unsigned long long m_Bits = 0;
+
+	//! Количество бит в окне
+    int m_Count = 0;
+
+	//! Количество байт, добавленных в окно за концом данных
+    size_t m_Overrun = 0;
+
+	/**
+	 * @brief Refill Дополнить окно до 57 и более бит
+	 */
+    inline void Refill()
+    {
+        while (m_Count <= 56)
+        {
+            unsigned long long byte = 0;
+
+            if (m_Position < m_Size)
+                byte = m_Data[m_Position++];
+            else
+                m_Overrun++;
+
+            m_Bits |= byte << (56 - m_Count);
+            m_Count += 8;
+        }
+    }
+
+public:
+	/**
+	 * @brief CBitReader Конструктор
+	 * @param data Данные
+	 * @param size Размер данных
+	 */
+    CBitReader(const unsigned char *data, size_t size)
+    : m_Data(data), m_Size(size)
+    {
+        Refill();
+    }
+
+	/**
+	 * @brief Get Прочитать биты
+	 * @param count Количество бит (до 32)
+	 * @return Значение
+	 */
+    inline unsigned int Get(int count)
+    {
+        if (count == 0)
+            return 0;
+
+        unsigned int value = (unsigned int)(m_Bits >> (64 - count));
+        m_Bits <<= count;
+        m_Count -= count;
+        Refill();
+
+        return value;
+    }
+
+	/**
+	 * @brief GetUnary Прочитать количество единиц до первого нуля (не больше limit, ноль после limit единиц не читается)
+	 * @param limit Максимальное количество единиц (до 32)
+	 * @return Количество единиц
+	 */
+    unsigned int GetUnary(int limit);
+
+	/**
+	 * @brief IsOverrun Проверить, было ли чтение за концом данных
+	 * @return true если было
+	 */
+    bool IsOverrun() const { return (m_Overrun * 8 > (size_t)m_Count); }
+};
+//----------------------------------------------------------------------------------
+/**
+ * @brief RiceEncode Сжать последовательность отсчетов: выбирается порядок предсказателя (0-3) с наименьшей суммой
+ * модулей остатков, остатки записываются кодами Райса с параметром на раздел из RICE_PARTITION_SIZE отсчетов.
+ * Если коды длиннее исходных данных, отсчеты записываются без сжатия (bits бит на отсчет).
+ * @param writer Поток бит
+ * @param samples Отсчеты
+ * @param count Количество отсчетов
+ * @param bits Разрядность отсчетов (до 24)
+ */
+void RiceEncode(CBitWriter &writer, const int *samples, int count, int bits);
+//----------------------------------------------------------------------------------
+/**
+ * @brief RiceDecode Восстановить последовательность отсчетов, сжатую RiceEncode
+ * @param reader Поток бит
+ * @param samples Буфер для отсчетов
+ * @param count Количество отсчетов
+ * @param bits Разрядность отсчетов (как при сжатии)
+ * @return true если данные корректны
+ */
+bool RiceDecode(CBitReader &reader, int *samples, int count, int bits);
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
+#endif // RICECODER_H
+//----------------------------------------------------------------------------------
@@ -0,0 +1,403 @@
+/**
+@file SegmentedWriter.cpp
+
+@brief Класс для записи BDF файла сегментами (ротация файлов по длительности или размеру без потери записей данных)
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include "SegmentedWriter.h"
+#include "BdfHeader.h"
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+static void AddStatistics(GARANT_EEG_RECORDING_STATISTICS &total, const GARANT_EEG_RECORDING_STATISTICS &statistics)
+{
+    total.RecordsCount += statistics.RecordsCount;
+    total.BytesWritten += statistics.BytesWritten;
+    total.BuffersWritten += statistics.BuffersWritten;
+    total.MaxQueueDepth = std::max(total.MaxQueueDepth, statistics.MaxQueueDepth);
+    total.StallsCount += statistics.StallsCount;
+    total.StallTime += statistics.StallTime;
+    total.MaxStallTime = std::max(total.MaxStallTime, statistics.MaxStallTime);
+    total.WriteTime += statistics.WriteTime;
+    total.MaxWriteTime = std::max(total.MaxWriteTime, statistics.MaxWriteTime);
+    total.WriteErrors += statistics.WriteErrors;
+    total.CommitsCount += statistics.CommitsCount;
+    total.SyncsCount += statistics.SyncsCount;
+    total.SyncTime += statistics.SyncTime;
+    total.MaxSyncTime = std::max(total.MaxSyncTime, statistics.MaxSyncTime);
+}
+//----------------------------------------------------------------------------------
+string SegmentFilePath(const string &filePath, int index)
+{
+    char number[16] = { 0 };
+    sprintf(number, "_%04i", index + 1);
+
+    size_t dot = filePath.find_last_of('.');
+    size_t slash = filePath.find_last_of("/\\");
+
+    if (dot == string::npos || (slash != string::npos && dot < slash))
+        return filePath + number;
+
+    return filePath.substr(0, dot) + number + filePath.substr(dot);
+}
+//----------------------------------------------------------------------------------
+CSegmentedWriter::CSegmentedWriter()
+{
+    memset(&m_ClosedStatistics, 0, sizeof(m_ClosedStatistics));
+}
+//----------------------------------------------------------------------------------
+CSegmentedWriter::~CSegmentedWriter()
+{
+    Close();
+}
+//----------------------------------------------------------------------------------
+bool CSegmentedWriter::Open(const string &filePath, const vector<char> &header, int recordSize, const BDF_WRITER_SETTINGS &settings, long long segmentRecords, BDF_ON_SEGMENT_CLOSED *callback, void *userData, bool externalRotation)
+{
+    if (IsOpened() || header.empty() || segmentRecords < 0)
+        return false;
+
+    CBdfHeader bdfHeader;
+
+    m_FilePath = filePath;
+    m_Header = header;
+    m_RecordSize = recordSize;
+    m_RecordDuration = (bdfHeader.Parse(&header[0], (int)header.size()) ? bdfHeader.RecordDuration() : 0.0);
+    m_Settings = settings;
+    m_SegmentRecords = segmentRecords;
+    m_SegmentIndex = 0;
+    m_SegmentRecordsCount = 0;
+    m_SegmentLimit = segmentRecords;
+    m_RecordsCount = 0;
+    m_ExternalRotation = externalRotation;
+    m_Boundaries.clear();
+    m_Callback = callback;
+    m_CallbackUserData = userData;
+    m_Stop = false;
+    m_PrepareIndex = -1;
+    m_PreparedIndex = -1;
+    m_Preparing = false;
+    memset(&m_ClosedStatistics, 0, sizeof(m_ClosedStatistics));
+
+    m_Writer = OpenSegment(0, 0, m_SegmentPath);
+
+    if (m_Writer == nullptr)
+        return false;
+
+    if (m_SegmentRecords > 0)
+    {
+        m_PrepareIndex = 1;
+        m_PrepareRecord = m_SegmentRecords;
+
+        m_Thread = thread(&CSegmentedWriter::ServiceLoop, this);
+    }
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+std::unique_ptr<CBdfWriter> CSegmentedWriter::OpenSegment(int index, long long firstRecord, string &filePath)
+{
+    vector<char> header = m_Header;
+
+    if (m_SegmentRecords > 0)
+    {
+        filePath = SegmentFilePath(m_FilePath, index);
+        ShiftBdfStartTime(header, (long long)floor(firstRecord * m_RecordDuration + 0.5));
+    }
+    else
+        filePath = m_FilePath;
+
+    std::unique_ptr<CBdfWriter> writer(new CBdfWriter());
+
+    if (!writer->Open(filePath, header, m_RecordSize, m_Settings))
+        return nullptr;
+
+    return writer;
+}
+//----------------------------------------------------------------------------------
+void CSegmentedWriter::ServiceLoop()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    while (true)
+    {
+        m_Condition.wait(lock, [this]{ return (m_Stop || m_PrepareIndex >= 0 || !m_Closing.empty()); });
+
+        //Ненужный заранее открытый файл имеет тот же путь, что и повторная попытка, поэтому он удаляется до нее
+        const bool discardPending = std::any_of(m_Closing.begin(), m_Closing.end(), [](const CLOSING_SEGMENT &segment) { return segment.Discard; });
+
+        //Следующий сегмент открывается раньше закрытия предыдущего, чтобы успеть к концу текущего
+        if (m_PrepareIndex >= 0 && !m_Stop && !discardPending)
+        {
+            const int index = m_PrepareIndex;
+            const long long firstRecord = m_PrepareRecord;
+            m_PrepareIndex = -1;
+            m_Preparing = true;
+
+            lock.unlock();
+
+            string filePath;
+            std::unique_ptr<CBdfWriter> writer = OpenSegment(index, firstRecord, filePath);
+
+            lock.lock();
+
+            m_NextWriter = std::move(writer);
+            m_NextPath = filePath;
+            m_NextRecord = firstRecord;
+            m_PreparedIndex = index;
+            m_Preparing = false;
+
+            m_Condition.notify_all();
+        }
+        else if (!m_Closing.empty())
+        {
+            //Сегмент остается в очереди до конца закрытия, чтобы его статистика учитывалась в GetStatistics
+            CLOSING_SEGMENT &segment = m_Closing.front();
+
+            lock.unlock();
+
+            bool success = segment.Writer->Close();
+
+            GARANT_EEG_RECORDING_STATISTICS statistics;
+            segment.Writer->GetStatistics(statistics);
+
+            //Сегмент без записей данных (внешняя ротация во время записи истории) не сохраняется
+            const bool discard = (segment.Discard || statistics.RecordsCount == 0);
+
+            if (discard)
+                remove(segment.FilePath.c_str());
+
+            lock.lock();
+
+            string filePath = segment.FilePath;
+
+            if (!discard)
+                AddStatistics(m_ClosedStatistics, statistics);
+
+            m_Closing.pop_front();
+
+            lock.unlock();
+
+            if (!discard && m_Callback != nullptr)
+                m_Callback(m_CallbackUserData, filePath, success);
+
+            lock.lock();
+        }
+        else if (m_Stop)
+            break;
+    }
+}
+//----------------------------------------------------------------------------------
+bool CSegmentedWriter::Rotate()
+{
+    const int index = m_SegmentIndex + 1;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        //Файл еще готовится: запись продолжается в текущий сегмент, проверка повторяется со следующей записью
+        if (m_PreparedIndex != index)
+            return false;
+
+        if (m_NextWriter == nullptr || m_NextRecord != m_RecordsCount)
+        {
+            //Файл не создан или готов с опозданием (время начала в заголовке не совпадает): повторная попытка примерно через секунду
+            const long long retryRecords = (m_RecordDuration > 0.0 ? std::max(1LL, (long long)ceil(1.0 / m_RecordDuration)) : 1LL);
+
+            if (m_NextWriter != nullptr)
+                m_Closing.push_back({ std::move(m_NextWriter), m_NextPath, true });
+
+            m_SegmentLimit = m_SegmentRecordsCount + retryRecords;
+            m_PreparedIndex = -1;
+            m_PrepareIndex = index;
+            m_PrepareRecord = m_RecordsCount + retryRecords;
+        }
+        else
+        {
+            m_Closing.push_back({ std::move(m_Writer), m_SegmentPath, false });
+
+            m_Writer = std::move(m_NextWriter);
+            m_SegmentPath = m_NextPath;
+            m_SegmentIndex = index;
+            m_SegmentRecordsCount = 0;
+            m_SegmentLimit = m_SegmentRecords;
+
+            m_PreparedIndex = -1;
+            m_PrepareIndex = index + 1;
+            m_PrepareRecord = m_RecordsCount + m_SegmentRecords;
+        }
+    }
+
+    m_Condition.notify_all();
+
+    return (m_SegmentIndex == index);
+}
+//----------------------------------------------------------------------------------
+void CSegmentedWriter::SwitchSegment()
+{
+    const int index = m_SegmentIndex + 1;
+    std::unique_ptr<CBdfWriter> writer;
+    std::unique_ptr<CBdfWriter> staleWriter;
+    string filePath;
+
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+
+        //Файл, который уже открывается, дожидается здесь, чтобы тот же сегмент не был открыт дважды
+        m_Condition.wait(lock, [this]{ return !m_Preparing; });
+
+        if (m_PreparedIndex == index && m_NextWriter != nullptr && m_NextRecord == m_RecordsCount)
+        {
+            writer = std::move(m_NextWriter);
+            filePath = m_NextPath;
+        }
+        else if (m_NextWriter != nullptr)
+        {
+            staleWriter = std::move(m_NextWriter);
+            filePath = m_NextPath;
+        }
+
+        //Пока файл готовится, поток обслуживания не трогает следующий сегмент
+        m_PrepareIndex = -1;
+        m_PreparedIndex = -1;
+    }
+
+    //Файл открыт для другой границы (время начала в заголовке не совпадает) и удаляется сразу, так как путь тот же
+    if (staleWriter != nullptr)
+    {
+        staleWriter->Close();
+        staleWriter.reset();
+
+        remove(filePath.c_str());
+    }
+
+    //Граница задана другой записью и не может быть отложена: файл, не открытый заранее, открывается в этом потоке
+    if (writer == nullptr)
+        writer = OpenSegment(index, m_RecordsCount, filePath);
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        //Если файл не создан, запись продолжается в текущий сегмент
+        if (writer != nullptr)
+        {
+            m_Closing.push_back({ std::move(m_Writer), m_SegmentPath, false });
+
+            m_Writer = std::move(writer);
+            m_SegmentPath = filePath;
+            m_SegmentIndex = index;
+            m_SegmentRecordsCount = 0;
+        }
+
+        m_PrepareIndex = m_SegmentIndex + 1;
+        m_PrepareRecord = m_RecordsCount + m_SegmentRecords;
+    }
+
+    m_Condition.notify_all();
+}
+//----------------------------------------------------------------------------------
+void CSegmentedWriter::Write(const void *record)
+{
+    if (!IsOpened())
+        return;
+
+    //Сегмент меняется перед записью, а не после, чтобы при остановке не оставался пустой сегмент
+    if (m_SegmentRecords > 0 && m_ExternalRotation)
+    {
+        while (!m_Boundaries.empty() && m_Boundaries.front() <= m_RecordsCount)
+        {
+            m_Boundaries.pop_front();
+            SwitchSegment();
+        }
+    }
+    else if (m_SegmentRecords > 0 && m_SegmentRecordsCount >= m_SegmentLimit)
+        Rotate();
+
+    m_Writer->Write(record);
+
+    m_SegmentRecordsCount++;
+    m_RecordsCount++;
+}
+//----------------------------------------------------------------------------------
+void CSegmentedWriter::Commit()
+{
+    if (IsOpened())
+        m_Writer->Commit();
+}
+//----------------------------------------------------------------------------------
+bool CSegmentedWriter::Close()
+{
+    if (!IsOpened())
+        return false;
+
+    if (m_Thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stop = true;
+        }
+
+        m_Condition.notify_all();
+        m_Thread.join();
+    }
+
+    //Заранее открытый сегмент не содержит записей данных
+    if (m_NextWriter != nullptr)
+    {
+        m_NextWriter->Close();
+        m_NextWriter.reset();
+
+        remove(m_NextPath.c_str());
+    }
+
+    bool success = m_Writer->Close();
+
+    GARANT_EEG_RECORDING_STATISTICS statistics;
+    m_Writer->GetStatistics(statistics);
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        AddStatistics(m_ClosedStatistics, statistics);
+        m_Writer.reset();
+    }
+
+    if (m_SegmentRecords > 0 && m_Callback != nullptr)
+        m_Callback(m_CallbackUserData, m_SegmentPath, success);
+
+    return (m_ClosedStatistics.WriteErrors == 0);
+}
+//----------------------------------------------------------------------------------
+void CSegmentedWriter::GetStatistics(GARANT_EEG_RECORDING_STATISTICS &statistics)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    statistics = m_ClosedStatistics;
+
+    GARANT_EEG_RECORDING_STATISTICS segmentStatistics;
+
+    for (const CLOSING_SEGMENT &segment : m_Closing)
+    {
+        if (segment.Discard)
+            continue;
+
+        segment.Writer->GetStatistics(segmentStatistics);
+        AddStatistics(statistics, segmentStatistics);
+    }
+
+    if (m_Writer != nullptr)
+    {
+        m_Writer->GetStatistics(segmentStatistics);
+        AddStatistics(statistics, segmentStatistics);
+
+        statistics.RecordsCount = m_RecordsCount;
+    }
+}
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
@@ -0,0 +1,259 @@
+/**
+@file SegmentedWriter.h
+
+@brief Класс для записи BDF файла сегментами (ротация файлов по длительности или размеру без потери записей данных)
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#ifndef SEGMENTEDWRITER_H
+#define SEGMENTEDWRITER_H
+//----------------------------------------------------------------------------------
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+using std::thread;
+//----------------------------------------------------------------------------------
+#include "BdfWriter.h"
+//----------------------------------------------------------------------------------
+namespace GarantEEG
+{
+//----------------------------------------------------------------------------------
+/**
+ * @brief BDF_ON_SEGMENT_CLOSED Сегмент записи закрыт (вызывается из потока обслуживания сегментов или из Close)
+ * @param userData Пользовательские данные
+ * @param filePath Путь к файлу сегмента
+ * @param success true если все данные сегмента записаны без ошибок
+ */
+typedef void BDF_ON_SEGMENT_CLOSED(void *userData, const string &filePath, bool success);
+//----------------------------------------------------------------------------------
+//! Класс для записи BDF файла сегментами. Каждый сегмент - отдельный файл с полным заголовком
+//! (дата и время начала сдвинуты на начало сегмента), количество записей данных в сегменте фиксировано.
+//! Поток обслуживания заранее открывает файл следующего сегмента и закрывает заполненные сегменты,
+//! поэтому поток приема при смене сегмента только переключает CBdfWriter и никогда не ждет диска
+//! (если файл еще не готов, запись продолжается в текущий сегмент).
+//! Без сегментации (segmentRecords == 0) пишется один файл с исходным именем, как CBdfWriter.
+//! С внешней ротацией (дополнительный файл записи) сегменты меняются только на границах, переданных AddSegmentBoundary,
+//! чтобы сегменты обоих файлов покрывали одни и те же интервалы времени.
+class CSegmentedWriter
+{
+private:
+	//! Заполненный сегмент в очереди закрытия
+    struct CLOSING_SEGMENT
+    {
+		//! Запись сегмента
+        std::unique_ptr<CBdfWriter> Writer;
+
+		//! Путь к файлу сегмента
+        string FilePath;
+
+		//! Флаг удаления файла (заранее открытый сегмент, который не понадобился)
+        bool Discard;
+    };
+
+	//! Запись текущего сегмента (только поток приема)
+    std::unique_ptr<CBdfWriter> m_Writer;
+
+	//! Путь к файлу текущего сегмента
+    string m_SegmentPath;
+
+	//! Заранее открытая запись следующего сегмента
+    std::unique_ptr<CBdfWriter> m_NextWriter;
+
+	//! Путь к файлу заранее открытого сегмента
+    string m_NextPath;
+
+	//! Номер первой записи данных заранее открытого сегмента
+    long long m_NextRecord = 0;
+
+	//! Индекс сегмента, для которого нужно заранее открыть файл (-1 если не нужно)
+    int m_PrepareIndex = -1;
+
+	//! Номер первой записи данных сегмента, для которого нужно заранее открыть файл (для времени начала в заголовке)
+    long long m_PrepareRecord = 0;
+
+	//! Индекс сегмента последней попытки заранее открыть файл (m_NextWriter == nullptr если попытка неудачна)
+    int m_PreparedIndex = -1;
+
+	//! Поток обслуживания открывает файл следующего сегмента
+    bool m_Preparing = false;
+
+	//! Заполненные сегменты в порядке закрытия
+    std::deque<CLOSING_SEGMENT> m_Closing;
+
+	//! Поток обслуживания сегментов
+    thread m_Thread;
+
+	//! Мьютекс доступа к очередям и статистике
+    std::mutex m_Mutex;
+
+	//! Условие появления работы для потока обслуживания или остановки
+    std::condition_variable m_Condition;
+
+	//! Флаг остановки потока обслуживания
+    bool m_Stop = false;
+
+	//! Путь к файлу записи (без номера сегмента)
+    string m_FilePath;
+
+	//! Данные заголовка первого сегмента
+    vector<char> m_Header;
+
+	//! Размер одной записи данных
+    int m_RecordSize = 0;
+
+	//! Длительность одной записи данных в секундах
+    double m_RecordDuration = 0.0;
+
+	//! Настройки записи
+    BDF_WRITER_SETTINGS m_Settings;
+
+	//! Количество записей данных в одном сегменте (0 - без сегментации)
+    long long m_SegmentRecords = 0;
+
+	//! Индекс текущего сегмента
+    int m_SegmentIndex = 0;
+
+	//! Количество записей данных в текущем сегменте
+    long long m_SegmentRecordsCount = 0;
+
+	//! Количество записей данных, после которого текущий сегмент закрывается (больше m_SegmentRecords, если следующий файл не удалось создать)
+    long long m_SegmentLimit = 0;
+
+	//! Количество записей данных во всех сегментах
+    long long m_RecordsCount = 0;
+
+	//! Сегменты меняются только на переданных границах (решение о смене принимает другая запись)
+    bool m_ExternalRotation = false;
+
+	//! Номера первых записей данных следующих сегментов при внешней ротации (только поток приема)
+    std::deque<long long> m_Boundaries;
+
+	//! Статистика закрытых сегментов
+    GARANT_EEG_RECORDING_STATISTICS m_ClosedStatistics;
+
+	//! Коллбэк закрытия сегмента
+    BDF_ON_SEGMENT_CLOSED *m_Callback = nullptr;
+
+	//! Пользовательские данные коллбэка закрытия сегмента
+    void *m_CallbackUserData = nullptr;
+
+	/**
+	 * @brief ServiceLoop Функция потока обслуживания сегментов
+	 */
+    void ServiceLoop();
+
+	/**
+	 * @brief OpenSegment Открыть файл сегмента
+	 * @param index Индекс сегмента
+	 * @param firstRecord Номер первой записи данных сегмента
+	 * @param filePath Ссылка на путь к файлу сегмента
+	 * @return Запись сегмента или nullptr в случае ошибки
+	 */
+    std::unique_ptr<CBdfWriter> OpenSegment(int index, long long firstRecord, string &filePath);
+
+	/**
+	 * @brief Rotate Перейти на следующий сегмент, если его файл готов (поток приема)
+	 * @return true если переход выполнен
+	 */
+    bool Rotate();
+
+	/**
+	 * @brief SwitchSegment Перейти на следующий сегмент при внешней ротации (если заранее открытый файл не подходит, файл открывается сразу)
+	 */
+    void SwitchSegment();
+
+public:
+	/**
+	 * @brief CSegmentedWriter Конструктор
+	 */
+    CSegmentedWriter();
+
+	/**
+	 * @brief ~CSegmentedWriter Деструктор
+	 */
+    ~CSegmentedWriter();
+
+	/**
+	 * @brief Open Создать файл первого сегмента и запустить потоки записи
+	 * @param filePath Путь к файлу (при сегментации к имени добавляется номер сегмента: "запись_0001.bdf")
+	 * @param header Данные заголовка BDF
+	 * @param recordSize Размер одной записи данных
+	 * @param settings Настройки записи
+	 * @param segmentRecords Количество записей данных в одном сегменте (0 - без сегментации)
+	 * @param callback Коллбэк закрытия сегмента (только при сегментации, может быть nullptr)
+	 * @param userData Пользовательские данные коллбэка
+	 * @param externalRotation Менять сегменты только на границах из AddSegmentBoundary (segmentRecords - ожидаемая длина сегмента)
+	 * @return true если файл создан
+	 */
+    bool Open(const string &filePath, const vector<char> &header, int recordSize, const BDF_WRITER_SETTINGS &settings, long long segmentRecords, BDF_ON_SEGMENT_CLOSED *callback, void *userData, bool externalRotation = false);
+
+	/**
+	 * @brief AddSegmentBoundary Добавить границу следующего сегмента при внешней ротации
+	 * @param firstRecord Номер первой записи данных следующего сегмента (границы до уже записанных записей применяются со следующей записью,
+	 * сегмент без записей данных удаляется)
+	 */
+    void AddSegmentBoundary(long long firstRecord) { m_Boundaries.push_back(firstRecord); }
+
+	/**
+	 * @brief Write Добавить запись данных (при заполнении сегмента запись идет в следующий сегмент)
+	 * @param record Указатель на запись данных размером recordSize
+	 */
+    void Write(const void *record);
+
+	/**
+	 * @brief Commit Передать неполный буфер текущего сегмента на запись с обновлением заголовка (см. CBdfWriter::Commit)
+	 */
+    void Commit();
+
+	/**
+	 * @brief Close Закрыть все сегменты (заранее открытый пустой сегмент удаляется)
+	 * @return true если все данные записаны без ошибок
+	 */
+    bool Close();
+
+	/**
+	 * @brief IsOpened Проверить, открыт ли файл
+	 * @return true если открыт
+	 */
+    bool IsOpened() const { return (m_Writer != nullptr); }
+
+	/**
+	 * @brief RecordsCount Получить количество переданных на запись записей данных во всех сегментах
+	 * @return Количество записей
+	 */
+    long long RecordsCount() const { return m_RecordsCount; }
+
+	/**
+	 * @brief SegmentIndex Получить индекс текущего сегмента
+	 * @return Индекс сегмента (с 0)
+	 */
+    int SegmentIndex() const { return m_SegmentIndex; }
+
+	/**
+	 * @brief GetStatistics Получить статистику записи всех сегментов (текущей или последней записи)
+	 * @param statistics Ссылка на статистику
+	 */
+    void GetStatistics(GARANT_EEG_RECORDING_STATISTICS &statistics);
+};
+//----------------------------------------------------------------------------------
+/**
+ * @brief SegmentFilePath Получить путь к файлу сегмента (номер добавляется перед расширением)
+ * @param filePath Путь к файлу записи
+ * @param index Индекс сегмента (с 0, в имени файла - с 1)
+ * @return Путь к файлу сегмента
+ */
+string SegmentFilePath(const string &filePath, int index);
+//----------------------------------------------------------------------------------
+} //namespace GarantEEG
+//----------------------------------------------------------------------------------
+#endif // SEGMENTEDWRITER_H
+//----------------------------------------------------------------------------------
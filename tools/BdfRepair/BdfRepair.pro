@@ -0,0 +1,9 @@
+include(../tools.pri)
+
+TARGET = BdfRepair
+
+SOURCES += \
+    main.cpp \
+    $$PWD/../../src/Recording/BdfHeader.cpp \
+    $$PWD/../../src/Recording/BdfRepair.cpp \
+    $$PWD/../../src/Recording/MappedFile.cpp
@@ -0,0 +1,47 @@
+/**
+@file main.cpp
+
+@brief Восстановление BDF файлов после аварийного завершения записи (сбой программы, отключение питания).
+Недописанная запись данных в конце файла отбрасывается, количество записей в заголовке исправляется по количеству целых записей.
+
+Использование: BdfRepair <путь к файлу> [<путь к файлу> ...]
+Код возврата 0 если все файлы корректны или восстановлены.
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include <stdio.h>
+#include "../../src/Recording/BdfRepair.h"
+//----------------------------------------------------------------------------------
+using namespace GarantEEG;
+//----------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: BdfRepair <file.bdf> [<file.bdf> ...]\n");
+        return 2;
+    }
+
+    int failed = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        GARANT_EEG_RECORD_REPAIR_RESULT result;
+
+        if (!RepairBdfFile(argv[i], result))
+        {
+            fprintf(stderr, "%s: can not repair file\n", argv[i]);
+            failed++;
+            continue;
+        }
+
+        if (result.RepairedSize == result.OriginalSize && result.RecordsCount == result.HeaderRecordsCount)
+            printf("%s: ok, %lld records\n", argv[i], result.RecordsCount);
+        else
+            printf("%s: repaired, %lld records (header %lld), size %lld -> %lld\n", argv[i], result.RecordsCount, result.HeaderRecordsCount, result.OriginalSize, result.RepairedSize);
+    }
+
+    return (failed > 0 ? 1 : 0);
+}
+//----------------------------------------------------------------------------------
@@ -0,0 +1,9 @@
+include(../tools.pri)
+
+TARGET = EegEmulator
+
+win32: LIBS += -lwsock32
+
+SOURCES += \
+    main.cpp \
+    $$PWD/../../src/Recording/BdfHeader.cpp
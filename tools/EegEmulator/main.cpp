@@ -0,0 +1,862 @@
+/**
+@file main.cpp
+
+@brief Эмулятор устройства EEG8 для нагрузочной проверки приема данных (CEeg8 вместе с сокетами).
+Каждый экземпляр - TCP сервер на своем порту: после подключения передается сообщение синхронизации времени (40 байт),
+по команде "start -protect eeg.rate N" - пакет заголовка (тип 1) и пакеты данных (тип 2) каждые 100 мс
+с идентификатором 0x55AA55AA, длиной, счетчиком и CRC32, по команде "stop" передача приостанавливается.
+Данные - синтетический сигнал или записи BDF файла, записанного библиотекой (по кругу).
+Для проверки восстановления приема в пакеты данных вносятся ошибки с заданной вероятностью.
+
+Использование: EegEmulator [-port N] [-instances N] [-file <файл.bdf>] [-seconds N] [-seed N]
+                           [-flip P] [-drop P] [-skip P] [-split P] [-truncate P]
+Код возврата 0 если все экземпляры работали без ошибок сокетов.
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#ifdef _WIN32
+#include <winsock.h>
+#include <windows.h>
+#else
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+#include <signal.h>
+
+typedef int SOCKET;
+#define INVALID_SOCKET (-1)
+#define closesocket close
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include "../../src/Recording/BdfHeader.h"
+//----------------------------------------------------------------------------------
+using namespace GarantEEG;
+//----------------------------------------------------------------------------------
+//! Идентификатор пакета
+static const unsigned int PACKET_ID = 0x55AA55AA;
+
+//! Тип пакета заголовка
+static const int PACKET_TYPE_HEADER = 1;
+
+//! Тип пакета данных
+static const int PACKET_TYPE_DATA = 2;
+
+//! Размер сообщения синхронизации времени
+static const int NTP_MESSAGE_SIZE = 40;
+
+//! Размер аннотаций (JSON) в конце фрэйма данных
+static const int ANNOTATIONS_SIZE = 90;
+
+//! Количество сигналов заголовка устройства
+static const int SIGNALS_COUNT = 22;
+//----------------------------------------------------------------------------------
+//! Параметры эмулятора
+struct EMULATOR_SETTINGS
+{
+	//! Порт первого экземпляра
+    int Port = 12345;
+
+	//! Количество экземпляров (порты Port, Port + 1, ...)
+    int Instances = 1;
+
+	//! Время работы в секундах (0 - без ограничения)
+    int Seconds = 0;
+
+	//! Начальное значение генератора ошибок (для экземпляра прибавляется его индекс)
+    unsigned int Seed = 1;
+
+	//! Путь к BDF файлу (пустой - синтетический сигнал)
+    const char *FilePath = nullptr;
+
+	//! Вероятность инвертирования случайного бита пакета данных
+    double FlipProbability = 0.0;
+
+	//! Вероятность потери пакета данных
+    double DropProbability = 0.0;
+
+	//! Вероятность пропуска значения счетчика
+    double SkipProbability = 0.0;
+
+	//! Вероятность передачи пакета данных несколькими частями с паузами
+    double SplitProbability = 0.0;
+
+	//! Вероятность передачи только начала пакета данных
+    double TruncateProbability = 0.0;
+};
+//----------------------------------------------------------------------------------
+//! Статистика подключения
+struct CONNECTION_STATISTICS
+{
+	//! Количество сформированных пакетов данных
+    long long Packets = 0;
+
+	//! Количество потерянных пакетов
+    long long Dropped = 0;
+
+	//! Количество пакетов с инвертированным битом
+    long long Flipped = 0;
+
+	//! Количество пропусков счетчика
+    long long Skipped = 0;
+
+	//! Количество пакетов, переданных частями
+    long long Split = 0;
+
+	//! Количество пакетов, переданных не полностью
+    long long Truncated = 0;
+};
+//----------------------------------------------------------------------------------
+static EMULATOR_SETTINGS g_Settings;
+
+//! Заголовки для частот 250, 500 и 1000 Гц (при воспроизведении файла - только для частоты файла)
+static vector<char> g_Headers[3];
+
+//! Частота дискретизации файла (0 - синтетический сигнал)
+static int g_FileRate = 0;
+
+//! Флаг остановки всех экземпляров
+static std::atomic<bool> g_Stop(false);
+
+//! Количество экземпляров, завершенных из-за ошибки сокета
+static std::atomic<int> g_Failed(0);
+//----------------------------------------------------------------------------------
+/**
+ * @brief RateIndex Получить индекс частоты дискретизации
+ * @param rate Частота дискретизации
+ * @return Индекс или -1 если частота не поддерживается устройством
+ */
+static int RateIndex(int rate)
+{
+    if (rate == 250)
+        return 0;
+    else if (rate == 500)
+        return 1;
+    else if (rate == 1000)
+        return 2;
+
+    return -1;
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief DataSize Получить размер фрэйма данных (100 мс)
+ * @param rate Частота дискретизации
+ * @return Размер в байтах: 8 основных каналов, акселерометр, сопротивления и аннотации
+ */
+static int DataSize(int rate)
+{
+    return 8 * (rate / 10) * 3 + 3 * 5 * 3 + 10 * 3 + ANNOTATIONS_SIZE;
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief SetHeaderField Записать текстовое поле заголовка BDF (дополняется пробелами)
+ * @param header Данные заголовка
+ * @param offset Смещение поля
+ * @param size Размер поля
+ * @param text Текст
+ */
+static void SetHeaderField(vector<char> &header, int offset, int size, const char *text)
+{
+    const int length = (int)strlen(text);
+
+    memset(&header[offset], ' ', size);
+    memcpy(&header[offset], text, (length < size ? length : size));
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief MakeSyntheticHeader Собрать заголовок BDF синтетического сигнала в формате устройства
+ * @param rate Частота дискретизации
+ * @param header Данные заголовка
+ */
+static void MakeSyntheticHeader(int rate, vector<char> &header)
+{
+    const int count = SIGNALS_COUNT;
+    char text[32] = { 0 };
+
+    header.assign(256 * (count + 1), ' ');
+
+    header[0] = (char)0xFF;
+    SetHeaderField(header, 1, 7, "BIOSEMI");
+    SetHeaderField(header, 8, 80, "X X X Emulator");
+    SetHeaderField(header, 88, 80, "Startdate X X EegEmulator X");
+
+    time_t now = time(nullptr);
+    tm *local = localtime(&now);
+
+    sprintf(text, "%02i.%02i.%02i", local->tm_mday, local->tm_mon + 1, local->tm_year % 100);
+    SetHeaderField(header, 168, 8, text);
+
+    sprintf(text, "%02i.%02i.%02i", local->tm_hour, local->tm_min, local->tm_sec);
+    SetHeaderField(header, 176, 8, text);
+
+    sprintf(text, "%i", (int)header.size());
+    SetHeaderField(header, 184, 8, text);
+    SetHeaderField(header, 192, 44, "24BIT");
+    SetHeaderField(header, 236, 8, "-1");
+    SetHeaderField(header, 244, 8, "0.1");
+
+    sprintf(text, "%i", count);
+    SetHeaderField(header, 252, 4, text);
+
+    for (int i = 0; i < count; i++)
+    {
+        const char *dimension = "uV";
+        const char *physicalRange = "374967";
+        int samples = rate / 10;
+
+        if (i < 8)
+            sprintf(text, "EEG %i", i + 1);
+        else if (i < 11)
+        {
+            sprintf(text, "Accel %c", 'X' + (i - 8));
+            dimension = "";
+            physicalRange = "8388607";
+            samples = 5;
+        }
+        else if (i < 21)
+        {
+            if (i < 19)
+                sprintf(text, "Rx %i", i - 10);
+            else
+                strcpy(text, (i == 19 ? "Rx Ref" : "Rx Ground"));
+
+            dimension = "kOhm";
+            physicalRange = "56790";
+            samples = 1;
+        }
+        else
+        {
+            strcpy(text, "Annotations");
+            dimension = "";
+            physicalRange = "1";
+            samples = ANNOTATIONS_SIZE / 3;
+        }
+
+        const int base = 256;
+
+        SetHeaderField(header, base + 16 * i, 16, text);
+        SetHeaderField(header, base + 96 * count + 8 * i, 8, dimension);
+
+        sprintf(text, "-%s", physicalRange);
+        SetHeaderField(header, base + 104 * count + 8 * i, 8, text);
+        SetHeaderField(header, base + 112 * count + 8 * i, 8, physicalRange);
+        SetHeaderField(header, base + 120 * count + 8 * i, 8, "-8388608");
+        SetHeaderField(header, base + 128 * count + 8 * i, 8, "8388607");
+
+        sprintf(text, "%i", samples);
+        SetHeaderField(header, base + 216 * count + 8 * i, 8, text);
+    }
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief LoadFileHeader Прочитать заголовок BDF файла и определить частоту по размеру записи данных
+ * @param filePath Путь к файлу
+ * @param header Данные заголовка
+ * @param rate Ссылка на частоту дискретизации
+ * @return true если файл записан устройством (22 сигнала, фрэйм одной из частот)
+ */
+static bool LoadFileHeader(const char *filePath, vector<char> &header, int &rate)
+{
+    FILE *file = fopen(filePath, "rb");
+
+    if (file == nullptr)
+        return false;
+
+    CBdfHeader bdfHeader;
+    bool result = (bdfHeader.Read(file) && bdfHeader.SignalsCount() == SIGNALS_COUNT);
+
+    rate = 0;
+
+    for (int candidate : { 250, 500, 1000 })
+    {
+        if (bdfHeader.RecordSize() == DataSize(candidate))
+            rate = candidate;
+    }
+
+    if (result && rate != 0)
+    {
+        header.resize(bdfHeader.HeaderSize());
+        result = (FileSeek64(file, 0) && fread(&header[0], header.size(), 1, file) == 1);
+    }
+    else
+        result = false;
+
+    fclose(file);
+
+    return result;
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief MakeSyntheticFrame Сформировать фрэйм данных синтетического сигнала
+ * @param rate Частота дискретизации
+ * @param frameIndex Индекс фрэйма с начала передачи
+ * @param blockTime Время фрэйма для аннотаций (секунды с 01.01.1970)
+ * @param frame Буфер фрэйма размером DataSize(rate)
+ */
+static void MakeSyntheticFrame(int rate, long long frameIndex, double blockTime, unsigned char *frame)
+{
+    const double pi = 3.1415926535897932384626433832795028841971;
+    const int samplesCount = rate / 10;
+    unsigned char *ptr = frame;
+
+    //Основные каналы: синусоиды 2, 4, ... 16 Гц с амплитудой от 45 до 360 мкВ
+    for (int i = 0; i < 8; i++)
+    {
+        for (int j = 0; j < samplesCount; j++, ptr += 3)
+        {
+            const double time = (double)(frameIndex * samplesCount + j) / rate;
+            Pack24BitValue(ptr, (int)lrint(1000.0 * (i + 1) * sin(2.0 * pi * 2.0 * (i + 1) * time)));
+        }
+    }
+
+    //Акселерометр: устройство неподвижно
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 5; j++, ptr += 3)
+            Pack24BitValue(ptr, (i == 2 ? 4096 : 0));
+    }
+
+    //Сопротивления электродов около 5 кОм
+    for (int i = 0; i < 10; i++, ptr += 3)
+        Pack24BitValue(ptr, 740 + i);
+
+    memset(ptr, 0, ANNOTATIONS_SIZE);
+    snprintf((char*)ptr, ANNOTATIONS_SIZE, "{\"FW Version\":\"emulator\",\"Battery %%\":\"100\",\"Block's Time\":\"%.1f\"}", blockTime);
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief ReadFileFrame Прочитать следующую запись данных файла (после последней записи чтение начинается сначала)
+ * @param file Файл
+ * @param headerSize Размер заголовка
+ * @param frame Буфер фрэйма
+ * @param size Размер фрэйма
+ * @return true если запись прочитана
+ */
+static bool ReadFileFrame(FILE *file, int headerSize, unsigned char *frame, int size)
+{
+    if (fread(frame, size, 1, file) == 1)
+        return true;
+
+    return (FileSeek64(file, headerSize) && fread(frame, size, 1, file) == 1);
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief PackUInt32LE Записать 32-битное значение (Little Endian)
+ * @param buf Буфер
+ * @param value Значение
+ */
+static void PackUInt32LE(unsigned char *buf, unsigned int value)
+{
+    buf[0] = (unsigned char)(value & 0xFF);
+    buf[1] = (unsigned char)((value >> 8) & 0xFF);
+    buf[2] = (unsigned char)((value >> 16) & 0xFF);
+    buf[3] = (unsigned char)((value >> 24) & 0xFF);
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief PacketCrc32 Вычислить CRC32 пакета так же, как устройство (см. CEeg8::ValidatePacket)
+ * @param buf Данные пакета без CRC
+ * @param size Размер данных
+ * @return CRC32
+ */
+static unsigned int PacketCrc32(const unsigned char *buf, int size)
+{
+    const unsigned int crc32Table[16] =
+    {
+        0x00000000, 0x04C11DB7, 0x09823B6E, 0x0D4326D9,
+        0x130476DC, 0x17C56B6B, 0x1A864DB2, 0x1E475005,
+        0x2608EDB8, 0x22C9F00F, 0x2F8AD6D6, 0x2B4BCB61,
+        0x350C9B64, 0x31CD86D3, 0x3C8EA00A, 0x384FBDBD
+    };
+
+    unsigned int crc = 0xFFFFFFFF;
+
+    for (int i = 0; i < size; i++)
+    {
+        crc ^= buf[i];
+
+        for (int j = 0; j < 8; j++)
+        {
+            int index = (crc >> 28) & 0x0F;
+            crc = (crc << 4) ^ crc32Table[index];
+        }
+    }
+
+    return crc;
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief MakePacket Сформировать пакет: идентификатор, длина пакета, тип, счетчик, данные, CRC32
+ * @param type Тип пакета
+ * @param counter Значение счетчика
+ * @param data Данные
+ * @param size Размер данных
+ * @param packet Буфер пакета
+ */
+static void MakePacket(int type, unsigned char counter, const unsigned char *data, int size, vector<unsigned char> &packet)
+{
+    const int length = size + 12;
+
+    packet.resize(length);
+
+    PackUInt32LE(&packet[0], PACKET_ID);
+    packet[4] = (unsigned char)(length & 0xFF);
+    packet[5] = (unsigned char)((length >> 8) & 0xFF);
+    packet[6] = (unsigned char)type;
+    packet[7] = counter;
+
+    memcpy(&packet[8], data, size);
+
+    PackUInt32LE(&packet[length - 4], PacketCrc32(&packet[0], length - 4));
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief SendAll Передать данные полностью
+ * @param socket Сокет
+ * @param data Данные
+ * @param size Размер данных
+ * @return true если данные переданы
+ */
+static bool SendAll(SOCKET socket, const unsigned char *data, int size)
+{
+    while (size > 0)
+    {
+        int sent = send(socket, (const char*)data, size, 0);
+
+        if (sent <= 0)
+            return false;
+
+        data += sent;
+        size -= sent;
+    }
+
+    return true;
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief WaitForData Ожидать поступления данных (или входящего подключения)
+ * @param socket Сокет
+ * @param milliseconds Время ожидания
+ * @return 1 если данные есть, 0 по истечении времени, -1 в случае ошибки
+ */
+static int WaitForData(SOCKET socket, int milliseconds)
+{
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    FD_SET(socket, &readSet);
+
+    timeval timeout = { milliseconds / 1000, (milliseconds % 1000) * 1000 };
+
+    int result = select((int)socket + 1, &readSet, nullptr, nullptr, &timeout);
+
+    return (result < 0 ? -1 : (result > 0 ? 1 : 0));
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief ServeConnection Обслуживание подключенного клиента до отключения
+ * @param client Сокет клиента
+ * @param port Порт экземпляра (для сообщений)
+ * @param random Генератор ошибок экземпляра
+ */
+static void ServeConnection(SOCKET client, int port, std::mt19937 &random)
+{
+    using namespace std::chrono;
+
+    CONNECTION_STATISTICS statistics;
+    std::uniform_real_distribution<double> probability(0.0, 1.0);
+
+    auto happens = [&](double value) { return (value > 0.0 && probability(random) < value); };
+
+    FILE *file = nullptr;
+
+    if (g_FileRate != 0)
+    {
+        file = fopen(g_Settings.FilePath, "rb");
+
+        if (file == nullptr || !FileSeek64(file, (long long)g_Headers[RateIndex(g_FileRate)].size()))
+        {
+            fprintf(stderr, "port %i: can not open %s\n", port, g_Settings.FilePath);
+
+            if (file != nullptr)
+                fclose(file);
+
+            return;
+        }
+    }
+
+    //Сообщение синхронизации времени передается сразу после подключения, команды клиент отправляет после него
+    char ntpMessage[NTP_MESSAGE_SIZE + 1] = { 0 };
+    snprintf(ntpMessage, sizeof(ntpMessage), "ntp %-36.3f", duration<double>(system_clock::now().time_since_epoch()).count());
+
+    bool connected = SendAll(client, (const unsigned char*)ntpMessage, NTP_MESSAGE_SIZE);
+    bool streaming = false;
+    bool headerSent = false;
+    int rate = 0;
+    unsigned char counter = 0;
+    long long frameIndex = 0;
+    double streamTime = 0.0;
+    string commands;
+    vector<unsigned char> frame;
+    vector<unsigned char> packet;
+    auto nextFrame = steady_clock::now();
+
+    while (connected && !g_Stop)
+    {
+        int waitTime = 100;
+
+        if (streaming)
+        {
+            auto now = steady_clock::now();
+            waitTime = (now < nextFrame ? (int)duration_cast<milliseconds>(nextFrame - now).count() : 0);
+        }
+
+        int ready = WaitForData(client, waitTime);
+
+        if (ready < 0)
+            break;
+        else if (ready > 0)
+        {
+            char buffer[1024];
+            int size = recv(client, buffer, sizeof(buffer), 0);
+
+            if (size <= 0)
+                break;
+
+            commands.append(buffer, size);
+
+            size_t end = 0;
+
+            while (connected && (end = commands.find('\n')) != string::npos)
+            {
+                string command = commands.substr(0, end);
+                commands.erase(0, end + 1);
+
+                if (!command.empty() && command[command.size() - 1] == '\r')
+                    command.erase(command.size() - 1);
+
+                if (!strncmp(command.c_str(), "start", 5))
+                {
+                    const char *ratePos = strstr(command.c_str(), "eeg.rate");
+                    const int requestedRate = (ratePos != nullptr ? atoi(ratePos + 8) : 500);
+
+                    if (RateIndex(requestedRate) < 0 || (g_FileRate != 0 && requestedRate != g_FileRate))
+                    {
+                        printf("port %i: rate %i is not available, start ignored\n", port, requestedRate);
+                        continue;
+                    }
+
+                    //Клиент хранит заголовок до переподключения, поэтому он передается один раз
+                    if (!headerSent)
+                    {
+                        const vector<char> &header = g_Headers[RateIndex(requestedRate)];
+                        MakePacket(PACKET_TYPE_HEADER, 0, (const unsigned char*)&header[0], (int)header.size(), packet);
+
+                        connected = SendAll(client, &packet[0], (int)packet.size());
+                        headerSent = true;
+                    }
+
+                    rate = requestedRate;
+                    frame.resize(DataSize(rate));
+                    streaming = true;
+                    streamTime = duration<double>(system_clock::now().time_since_epoch()).count();
+                    nextFrame = steady_clock::now();
+
+                    printf("port %i: streaming at %i Hz\n", port, rate);
+                }
+                else if (command == "stop")
+                {
+                    streaming = false;
+                    printf("port %i: stopped\n", port);
+                }
+                else if (command == "device powerdown")
+                {
+                    connected = false;
+                    printf("port %i: power down\n", port);
+                }
+                else if (!command.empty())
+                    printf("port %i: command \"%s\"\n", port, command.c_str());
+            }
+        }
+
+        if (!connected || !streaming || steady_clock::now() < nextFrame)
+            continue;
+
+        if (file != nullptr)
+        {
+            if (!ReadFileFrame(file, (int)g_Headers[RateIndex(rate)].size(), &frame[0], (int)frame.size()))
+            {
+                fprintf(stderr, "port %i: can not read %s\n", port, g_Settings.FilePath);
+                break;
+            }
+        }
+        else
+            MakeSyntheticFrame(rate, frameIndex, streamTime, &frame[0]);
+
+        frameIndex++;
+        streamTime += 0.1;
+
+        //Пропуск значения счетчика: пакет корректен, но клиент видит разрыв последовательности
+        if (happens(g_Settings.SkipProbability))
+        {
+            counter++;
+            statistics.Skipped++;
+        }
+
+        counter++;
+        statistics.Packets++;
+
+        MakePacket(PACKET_TYPE_DATA, counter, &frame[0], (int)frame.size(), packet);
+
+        nextFrame += milliseconds(100);
+
+        //Клиент не успевает читать (передача блокируется): темп отсчитывается заново, без передачи накопившихся фрэймов подряд
+        if (steady_clock::now() - nextFrame > seconds(1))
+            nextFrame = steady_clock::now();
+
+        if (happens(g_Settings.DropProbability))
+        {
+            statistics.Dropped++;
+            continue;
+        }
+
+        if (happens(g_Settings.FlipProbability))
+        {
+            const int bit = std::uniform_int_distribution<int>(0, (int)packet.size() * 8 - 1)(random);
+            packet[bit / 8] ^= (unsigned char)(1 << (bit % 8));
+            statistics.Flipped++;
+        }
+
+        int size = (int)packet.size();
+
+        if (happens(g_Settings.TruncateProbability))
+        {
+            size = std::uniform_int_distribution<int>(1, size - 1)(random);
+            statistics.Truncated++;
+        }
+
+        if (happens(g_Settings.SplitProbability))
+        {
+            const int parts = std::uniform_int_distribution<int>(2, 4)(random);
+            int offset = 0;
+
+            statistics.Split++;
+
+            for (int i = 0; i < parts && connected; i++)
+            {
+                const int partSize = (i == parts - 1 ? size - offset : size / parts);
+
+                connected = SendAll(client, &packet[offset], partSize);
+                offset += partSize;
+
+                if (i != parts - 1)
+                    std::this_thread::sleep_for(milliseconds(std::uniform_int_distribution<int>(1, 20)(random)));
+            }
+        }
+        else
+            connected = SendAll(client, &packet[0], size);
+    }
+
+    if (file != nullptr)
+        fclose(file);
+
+    printf("port %i: disconnected, packets %lld, dropped %lld, flipped %lld, counter skips %lld, split %lld, truncated %lld\n",
+           port, statistics.Packets, statistics.Dropped, statistics.Flipped, statistics.Skipped, statistics.Split, statistics.Truncated);
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief InstanceThreadFunction Функция потока экземпляра: прием подключений на порту, клиенты обслуживаются по одному, как устройством
+ * @param port Порт
+ * @param seed Начальное значение генератора ошибок
+ */
+static void InstanceThreadFunction(int port, unsigned int seed)
+{
+    SOCKET server = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+    if (server == INVALID_SOCKET)
+    {
+        fprintf(stderr, "port %i: can not create socket\n", port);
+        g_Failed++;
+        return;
+    }
+
+    int reuse = 1;
+    setsockopt(server, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons((unsigned short)port);
+
+    if (bind(server, (sockaddr*)&address, sizeof(address)) != 0 || listen(server, 1) != 0)
+    {
+        fprintf(stderr, "port %i: can not listen\n", port);
+        closesocket(server);
+        g_Failed++;
+        return;
+    }
+
+    std::mt19937 random(seed);
+
+    while (!g_Stop)
+    {
+        int ready = WaitForData(server, 100);
+
+        if (ready < 0)
+        {
+            fprintf(stderr, "port %i: accept error\n", port);
+            g_Failed++;
+            break;
+        }
+        else if (ready == 0)
+            continue;
+
+        SOCKET client = accept(server, nullptr, nullptr);
+
+        if (client == INVALID_SOCKET)
+            continue;
+
+        //Пакеты передаются сразу, без объединения, чтобы передача частями доходила до клиента частями
+        int noDelay = 1;
+        setsockopt(client, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+
+        printf("port %i: connected\n", port);
+
+        ServeConnection(client, port, random);
+
+        closesocket(client);
+    }
+
+    closesocket(server);
+}
+//----------------------------------------------------------------------------------
+/**
+ * @brief ParseProbability Разобрать значение вероятности
+ * @param text Текст
+ * @param value Ссылка на значение
+ * @return true если значение от 0 до 1
+ */
+static bool ParseProbability(const char *text, double &value)
+{
+    char *end = nullptr;
+    value = strtod(text, &end);
+
+    return (end != text && *end == 0 && value >= 0.0 && value <= 1.0);
+}
+//----------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    bool valid = true;
+
+    for (int i = 1; i < argc && valid; i += 2)
+    {
+        const char *name = argv[i];
+        const char *value = (i + 1 < argc ? argv[i + 1] : nullptr);
+
+        if (value == nullptr)
+            valid = false;
+        else if (!strcmp(name, "-port"))
+            g_Settings.Port = atoi(value);
+        else if (!strcmp(name, "-instances"))
+            g_Settings.Instances = atoi(value);
+        else if (!strcmp(name, "-file"))
+            g_Settings.FilePath = value;
+        else if (!strcmp(name, "-seconds"))
+            g_Settings.Seconds = atoi(value);
+        else if (!strcmp(name, "-seed"))
+            g_Settings.Seed = (unsigned int)strtoul(value, nullptr, 10);
+        else if (!strcmp(name, "-flip"))
+            valid = ParseProbability(value, g_Settings.FlipProbability);
+        else if (!strcmp(name, "-drop"))
+            valid = ParseProbability(value, g_Settings.DropProbability);
+        else if (!strcmp(name, "-skip"))
+            valid = ParseProbability(value, g_Settings.SkipProbability);
+        else if (!strcmp(name, "-split"))
+            valid = ParseProbability(value, g_Settings.SplitProbability);
+        else if (!strcmp(name, "-truncate"))
+            valid = ParseProbability(value, g_Settings.TruncateProbability);
+        else
+            valid = false;
+    }
+
+    if (!valid || g_Settings.Instances < 1 || g_Settings.Instances > 1000 || g_Settings.Port < 1 || g_Settings.Port + g_Settings.Instances - 1 > 65535 || g_Settings.Seconds < 0)
+    {
+        fprintf(stderr, "usage: EegEmulator [-port N] [-instances N] [-file <file.bdf>] [-seconds N] [-seed N]\n");
+        fprintf(stderr, "                   [-flip P] [-drop P] [-skip P] [-split P] [-truncate P]\n");
+        fprintf(stderr, "  -port       port of the first instance (default 12345), instance i listens on port + i\n");
+        fprintf(stderr, "  -file       stream records of a BDF file written by the library (rate is taken from the file)\n");
+        fprintf(stderr, "  -seconds    run time (default unlimited)\n");
+        fprintf(stderr, "  -flip P     probability of a flipped bit in a data packet\n");
+        fprintf(stderr, "  -drop P     probability of a lost data packet\n");
+        fprintf(stderr, "  -skip P     probability of a skipped counter value\n");
+        fprintf(stderr, "  -split P    probability of a data packet sent in several parts with pauses\n");
+        fprintf(stderr, "  -truncate P probability of a data packet cut short\n");
+        return 2;
+    }
+
+    if (g_Settings.FilePath != nullptr)
+    {
+        vector<char> header;
+
+        if (!LoadFileHeader(g_Settings.FilePath, header, g_FileRate))
+        {
+            fprintf(stderr, "%s: not a recording of the device\n", g_Settings.FilePath);
+            return 1;
+        }
+
+        g_Headers[RateIndex(g_FileRate)] = header;
+    }
+    else
+    {
+        MakeSyntheticHeader(250, g_Headers[0]);
+        MakeSyntheticHeader(500, g_Headers[1]);
+        MakeSyntheticHeader(1000, g_Headers[2]);
+    }
+
+#ifdef _WIN32
+    WSADATA wsaData;
+
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData))
+    {
+        fprintf(stderr, "can not initialize sockets\n");
+        return 1;
+    }
+#else
+    //Отключение клиента во время передачи обрабатывается по результату send
+    signal(SIGPIPE, SIG_IGN);
+#endif
+
+    vector<std::thread> instances;
+
+    for (int i = 0; i < g_Settings.Instances; i++)
+        instances.push_back(std::thread(InstanceThreadFunction, g_Settings.Port + i, g_Settings.Seed + (unsigned int)i));
+
+    printf("%i instance(s) on ports %i-%i, %s\n", g_Settings.Instances, g_Settings.Port, g_Settings.Port + g_Settings.Instances - 1, (g_Settings.FilePath != nullptr ? g_Settings.FilePath : "synthetic signal"));
+
+    if (g_Settings.Seconds > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::seconds(g_Settings.Seconds));
+        g_Stop = true;
+    }
+
+    for (std::thread &instance : instances)
+        instance.join();
+
+#ifdef _WIN32
+    WSACleanup();
+#endif
+
+    return (g_Failed == 0 ? 0 : 1);
+}
+//----------------------------------------------------------------------------------
@@ -0,0 +1,76 @@
+/**
+@file main.cpp
+
+@brief Преобразование записей между форматами BDF и GCR (сжатие без потерь, блоки с произвольным доступом).
+GCR файл, запись которого не была закрыта, восстанавливается до последнего целого блока.
+
+Использование: GcrConvert compress <файл.bdf> <файл.gcr> [записей в блоке]
+               GcrConvert decompress <файл.gcr> <файл.bdf>
+Код возврата 0 если преобразование прошло без ошибок.
+
+@author Мустакимов Т.Р.
+**/
+//----------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../src/Recording/GcrConvert.h"
+//----------------------------------------------------------------------------------
+using namespace GarantEEG;
+//----------------------------------------------------------------------------------
+/**
+ * @brief FileSize Получить размер файла
+ * @param path Путь к файлу
+ * @return Размер или -1 если файл не открывается
+ */
+static long long FileSize(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+
+    if (file == nullptr)
+        return -1;
+
+    long long size = FileSize64(file);
+    fclose(file);
+
+    return size;
+}
+//----------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    const bool compress = (argc >= 4 && argc <= 5 && !strcmp(argv[1], "compress"));
+    const bool decompress = (argc == 4 && !strcmp(argv[1], "decompress"));
+
+    if (!compress && !decompress)
+    {
+        fprintf(stderr, "usage: GcrConvert compress <file.bdf> <file.gcr> [chunk records]\n");
+        fprintf(stderr, "       GcrConvert decompress <file.gcr> <file.bdf>\n");
+        return 2;
+    }
+
+    const int chunkRecords = (argc == 5 ? atoi(argv[4]) : GCR_DEFAULT_CHUNK_RECORDS);
+
+    if (chunkRecords < 1 || chunkRecords > GCR_MAX_CHUNK_RECORDS)
+    {
+        fprintf(stderr, "chunk records must be from 1 to %i\n", GCR_MAX_CHUNK_RECORDS);
+        return 2;
+    }
+
+    bool converted = (compress ? CompressBdfFile(argv[2], argv[3], chunkRecords) : DecompressGcrFile(argv[2], argv[3]));
+
+    if (!converted)
+    {
+        fprintf(stderr, "%s: can not %s file\n", argv[2], argv[1]);
+        return 1;
+    }
+
+    const long long inputSize = FileSize(argv[2]);
+    const long long outputSize = FileSize(argv[3]);
+    const long long bdfSize = (compress ? inputSize : outputSize);
+    const long long gcrSize = (compress ? outputSize : inputSize);
+
+    printf("%s -> %s: %lld -> %lld bytes, ratio %.2f\n", argv[2], argv[3], inputSize, outputSize, (gcrSize > 0 ? (double)bdfSize / gcrSize : 0.0));
+
+    return 0;
+}
+//----------------------------------------------------------------------------------
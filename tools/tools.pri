@@ -0,0 +1,10 @@
+QT       -= core gui
+
+CONFIG   += console c++11
+CONFIG   -= app_bundle qt
+
+#Заголовки библиотеки подключаются как "../GarantEEG_API/include/...", поэтому каталог библиотеки должен называться GarantEEG_API
+INCLUDEPATH += $$PWD/..
+
+unix: DEFINES += __cdecl=
+unix: LIBS += -lpthread